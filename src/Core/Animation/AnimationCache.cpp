@@ -0,0 +1,42 @@
+#include <Core/Animation/AnimationCache.hpp>
+
+#include <Core/Utils/StdUtils.hpp>
+
+#include <cmath>
+#include <cstring>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+size_t PoseKey::hash() const {
+    size_t seed = 0;
+    Utils::hash_combine( seed, m_asset );
+    Utils::hash_combine( seed, m_animation );
+    Utils::hash_combine( seed, m_time );
+    return seed;
+}
+
+size_t SkinKey::hash() const {
+    size_t seed = m_pose.hash();
+    Utils::hash_combine( seed, m_mesh );
+    Utils::hash_combine( seed, m_method );
+    return seed;
+}
+
+PoseKey PoseCache::getKey( size_t asset, size_t animation, Scalar& time ) const {
+    PoseKey key { asset, animation, 0 };
+    if ( m_timeStep > 0_ra ) {
+        key.m_time = std::llround( time / m_timeStep );
+        time       = Scalar( key.m_time ) * m_timeStep;
+    }
+    else {
+        // exact times, keyed by their bits.
+        std::memcpy( &key.m_time, &time, sizeof( Scalar ) );
+    }
+    return key;
+}
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <Core/Animation/Pose.hpp>
+#include <Core/Containers/VectorArray.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+/**
+ * Key of a local skeleton pose played from an animation.
+ * Identical characters, i.e. with the same skeleton and animations, playing the same animation
+ * at the same quantized time share the same key, and thus the same pose.
+ */
+struct RA_CORE_API PoseKey {
+    /// The key of the skeleton and its animations, 0 if the pose is not cacheable.
+    size_t m_asset { 0 };
+    /// The index of the animation.
+    size_t m_animation { 0 };
+    /// The quantized animation time.
+    int64_t m_time { 0 };
+
+    /// Returns true if the pose can be cached.
+    inline bool isValid() const { return m_asset != 0; }
+
+    inline bool operator==( const PoseKey& other ) const {
+        return m_asset == other.m_asset && m_animation == other.m_animation &&
+               m_time == other.m_time;
+    }
+
+    size_t hash() const;
+};
+
+/**
+ * Key of the vertices of a mesh skinned by a pose.
+ */
+struct RA_CORE_API SkinKey {
+    /// The key of the mesh and its skinning weights, 0 if the skinned vertices are not cacheable.
+    size_t m_mesh { 0 };
+    /// The key of the skinning pose.
+    PoseKey m_pose;
+    /// The skinning method and normal skinning method.
+    int m_method { 0 };
+
+    /// Returns true if the skinned vertices can be cached.
+    inline bool isValid() const { return m_mesh != 0 && m_pose.isValid(); }
+
+    inline bool operator==( const SkinKey& other ) const {
+        return m_mesh == other.m_mesh && m_pose == other.m_pose && m_method == other.m_method;
+    }
+
+    size_t hash() const;
+};
+
+/// The vertex data of a skinned mesh.
+struct SkinnedVertices {
+    Vector3Array m_position;
+    Vector3Array m_normal;
+    Vector3Array m_tangent;
+    Vector3Array m_bitangent;
+};
+
+/// Appends the bytes of the \p count values \p data to \p content, to build the content of an
+/// asset for AnimationCache::getContentKey().
+template <typename T>
+inline void appendBytes( std::string& content, const T* data, size_t count ) {
+    static_assert( std::is_trivially_copyable<T>::value, "Values must be trivially copyable" );
+    content.append( reinterpret_cast<const char*>( data ), count * sizeof( T ) );
+}
+
+/**
+ * Thread safe cache of animation data, counting the cache hits and misses.
+ *
+ * The keys identify the animated assets (e.g. a skeleton and its animations, or a skinned mesh)
+ * by the keys getContentKey() gives to their content, which are equal if and only if the contents
+ * are equal.
+ * \tparam Key must provide a hash() method.
+ */
+template <typename Key, typename Value>
+class AnimationCache
+{
+  public:
+    using ValuePtr = std::shared_ptr<const Value>;
+
+    /// Returns the value cached for \p key, nullptr if none.
+    /// Counts a hit or a miss.
+    inline ValuePtr find( const Key& key ) const;
+
+    /// Caches \p value for \p key, keeping the already cached value if any.
+    inline ValuePtr insert( const Key& key, Value value );
+
+    /// Erases the cached values, keeping the hit and miss counters.
+    inline void clear();
+
+    /// Returns the number of cached values.
+    inline size_t size() const;
+
+    /// Returns the number of successful calls to find().
+    inline size_t getHitCount() const { return m_hits; }
+
+    /// Returns the number of failed calls to find().
+    inline size_t getMissCount() const { return m_misses; }
+
+    /// Resets the hit and miss counters.
+    inline void resetCounters();
+
+    /// Handle on the key of an asset content, see getContentKey().
+    using ContentKey = std::shared_ptr<const size_t>;
+
+    /// Returns the key of the asset whose content, serialized as bytes (see appendBytes()), is
+    /// \p content. Assets get the same key if their contents are equal byte per byte, the hash
+    /// of a content only selecting the contents it is compared to, so that a hash collision
+    /// cannot make different assets share their cached values. Keys are never 0 nor reused.
+    /// \note A content is kept by the cache while a handle on its key is alive, i.e. once per
+    /// distinct living asset, and released with the last handle, which may outlive the cache.
+    inline ContentKey getContentKey( std::string content );
+
+    /// Returns the number of contents kept for the living content keys.
+    inline size_t getContentCount() const;
+
+  private:
+    struct KeyHasher {
+        size_t operator()( const Key& key ) const { return key.hash(); }
+    };
+
+    /// The contents of the living content keys, shared with the deleters of the key handles.
+    struct ContentKeys {
+        struct Entry {
+            std::weak_ptr<const size_t> m_handle;
+            size_t m_key { 0 };
+        };
+        std::mutex m_mutex;
+        std::unordered_map<std::string, Entry> m_entries;
+        /// The content of each living key, to release it with the last handle on the key.
+        std::unordered_map<size_t, const std::string*> m_contents;
+        size_t m_lastKey { 0 };
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<Key, ValuePtr, KeyHasher> m_values;
+    std::shared_ptr<ContentKeys> m_contentKeys { std::make_shared<ContentKeys>() };
+    mutable std::atomic<size_t> m_hits { 0 };
+    mutable std::atomic<size_t> m_misses { 0 };
+};
+
+/**
+ * Cache of the local poses played from animations, at a quantized time.
+ */
+class RA_CORE_API PoseCache : public AnimationCache<PoseKey, Pose>
+{
+  public:
+    /// Quantize the animation time by \p timeStep, or not at all if \p timeStep is 0.
+    explicit PoseCache( Scalar timeStep = 0_ra ) : m_timeStep( timeStep ) {}
+
+    /// Sets the time quantization step, 0 for exact times.
+    inline void setTimeStep( Scalar timeStep ) { m_timeStep = timeStep; }
+
+    /// Returns the time quantization step.
+    inline Scalar getTimeStep() const { return m_timeStep; }
+
+    /// Returns the key of the pose of animation \p animation of asset \p asset at time \p time,
+    /// and sets \p time to the quantized time, at which the pose must be evaluated.
+    PoseKey getKey( size_t asset, size_t animation, Scalar& time ) const;
+
+  private:
+    Scalar m_timeStep;
+};
+
+/// Cache of the skinned vertices of meshes.
+using SkinCache = AnimationCache<SkinKey, SkinnedVertices>;
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
+
+#include <Core/Animation/AnimationCache.inl>
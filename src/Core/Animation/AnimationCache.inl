@@ -0,0 +1,85 @@
+#pragma once
+#include <Core/Animation/AnimationCache.hpp>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+template <typename Key, typename Value>
+inline typename AnimationCache<Key, Value>::ValuePtr
+AnimationCache<Key, Value>::find( const Key& key ) const {
+    ValuePtr value;
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        auto it = m_values.find( key );
+        if ( it != m_values.end() ) { value = it->second; }
+    }
+    ++( value ? m_hits : m_misses );
+    return value;
+}
+
+template <typename Key, typename Value>
+inline typename AnimationCache<Key, Value>::ValuePtr
+AnimationCache<Key, Value>::insert( const Key& key, Value value ) {
+    auto ptr = std::make_shared<const Value>( std::move( value ) );
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_values.emplace( key, std::move( ptr ) ).first->second;
+}
+
+template <typename Key, typename Value>
+inline void AnimationCache<Key, Value>::clear() {
+    std::lock_guard<std::mutex> lock( m_mutex );
+    m_values.clear();
+}
+
+template <typename Key, typename Value>
+inline size_t AnimationCache<Key, Value>::size() const {
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_values.size();
+}
+
+template <typename Key, typename Value>
+inline void AnimationCache<Key, Value>::resetCounters() {
+    m_hits   = 0;
+    m_misses = 0;
+}
+
+template <typename Key, typename Value>
+inline typename AnimationCache<Key, Value>::ContentKey
+AnimationCache<Key, Value>::getContentKey( std::string content ) {
+    auto& keys = *m_contentKeys;
+    std::lock_guard<std::mutex> lock( keys.m_mutex );
+    auto it     = keys.m_entries.try_emplace( std::move( content ) ).first;
+    auto& entry = it->second;
+    if ( auto handle = entry.m_handle.lock() ) { return handle; }
+
+    // new content, or content whose last handle is being released.
+    keys.m_contents.erase( entry.m_key );
+    entry.m_key = ++keys.m_lastKey;
+    keys.m_contents.emplace( entry.m_key, &it->first );
+    std::weak_ptr<ContentKeys> weakKeys = m_contentKeys;
+    ContentKey handle( new size_t( entry.m_key ), [weakKeys]( const size_t* key ) {
+        if ( auto keys = weakKeys.lock() ) {
+            std::lock_guard<std::mutex> lock( keys->m_mutex );
+            // not found if the content got a new key meanwhile.
+            auto contentIt = keys->m_contents.find( *key );
+            if ( contentIt != keys->m_contents.end() ) {
+                keys->m_entries.erase( *contentIt->second );
+                keys->m_contents.erase( contentIt );
+            }
+        }
+        delete key;
+    } );
+    entry.m_handle = handle;
+    return handle;
+}
+
+template <typename Key, typename Value>
+inline size_t AnimationCache<Key, Value>::getContentCount() const {
+    std::lock_guard<std::mutex> lock( m_contentKeys->m_mutex );
+    return m_contentKeys->m_entries.size();
+}
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
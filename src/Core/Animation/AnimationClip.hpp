@@ -0,0 +1,90 @@
+#pragma once
+
+#include <Core/Animation/KeyFramedValue.hpp>
+#include <Core/Animation/KeyFramedValueInterpolators.hpp>
+#include <Core/RaCore.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+/**
+ * An AnimationClip plays a set of keyframed tracks, e.g. the per-bone transforms of a skeleton
+ * animation.
+ *
+ * The clip keeps the time interval of the tracks, and one playback cursor per track so that
+ * sampling the tracks forward in time is amortized O(1) per track, the interpolation being
+ * chosen at compile time by INTERPOLATOR (see LinearInterpolator).
+ * Sampling does not allocate memory.
+ *
+ * \note The clip does not own the tracks, which must outlive it.
+ *       Edits of the tracks are taken into account by the next call to setTracks().
+ */
+template <typename VALUE_TYPE, typename INTERPOLATOR = LinearInterpolator>
+class AnimationClip
+{
+  public:
+    using Track  = KeyFramedValue<VALUE_TYPE>;
+    using Tracks = std::vector<Track>;
+
+    AnimationClip() = default;
+
+    explicit AnimationClip( const Tracks* tracks ) { setTracks( tracks ); }
+
+    /// Plays \p tracks, updating the time interval if they changed since the last call.
+    /// \note This is O(number of tracks), the cursors being kept if the tracks are the same.
+    inline void setTracks( const Tracks* tracks );
+
+    /// Returns the played tracks.
+    inline const Tracks* getTracks() const { return m_tracks; }
+
+    /// Returns the number of played tracks.
+    inline size_t getNumTracks() const { return m_tracks ? m_tracks->size() : 0; }
+
+    /// Returns the time of the first keyframe of the tracks.
+    inline Scalar getStartTime() const { return m_startTime; }
+
+    /// Returns the time of the last keyframe of the tracks.
+    inline Scalar getEndTime() const { return m_endTime; }
+
+    /// Returns the duration of the clip.
+    inline Scalar getDuration() const { return m_endTime - m_startTime; }
+
+    /// Returns the value of track \p i at time \p t.
+    inline VALUE_TYPE sample( size_t i, Scalar t );
+
+    /// Fills \p values with the values of the tracks at time \p t.
+    /// \p values must have getNumTracks() elements.
+    template <typename CONTAINER>
+    inline void sample( Scalar t, CONTAINER& values );
+
+    /// Moves the cursors back to the first keyframes.
+    inline void resetCursors();
+
+  private:
+    /// Returns the sum of the versions of \p tracks.
+    static inline size_t computeVersion( const Tracks& tracks );
+
+    /// The played tracks.
+    const Tracks* m_tracks { nullptr };
+
+    /// The sum of the versions of the tracks.
+    size_t m_version { 0 };
+
+    /// The playback cursor of each track.
+    std::vector<size_t> m_cursors;
+
+    /// The time interval of the tracks.
+    Scalar m_startTime { 0_ra };
+    Scalar m_endTime { 0_ra };
+};
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
+
+#include <Core/Animation/AnimationClip.inl>
@@ -0,0 +1,60 @@
+#pragma once
+#include <Core/Animation/AnimationClip.hpp>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+template <typename VALUE_TYPE, typename INTERPOLATOR>
+inline void AnimationClip<VALUE_TYPE, INTERPOLATOR>::setTracks( const Tracks* tracks ) {
+    const size_t version = tracks ? computeVersion( *tracks ) : 0;
+    if ( tracks == m_tracks && version == m_version && m_cursors.size() == getNumTracks() ) {
+        return;
+    }
+    m_tracks  = tracks;
+    m_version = version;
+    m_cursors.assign( getNumTracks(), 0 );
+    m_startTime = 0_ra;
+    m_endTime   = 0_ra;
+    if ( getNumTracks() == 0 ) { return; }
+    m_startTime = std::numeric_limits<Scalar>::max();
+    m_endTime   = std::numeric_limits<Scalar>::lowest();
+    for ( const auto& track : *m_tracks ) {
+        m_startTime = std::min( m_startTime, track.getKeyFrames().front().first );
+        m_endTime   = std::max( m_endTime, track.getKeyFrames().back().first );
+    }
+}
+
+template <typename VALUE_TYPE, typename INTERPOLATOR>
+inline VALUE_TYPE AnimationClip<VALUE_TYPE, INTERPOLATOR>::sample( size_t i, Scalar t ) {
+    CORE_ASSERT( i < getNumTracks(), "Out of bound track index." );
+    return ( *m_tracks )[i].template at<INTERPOLATOR>( t, m_cursors[i] );
+}
+
+template <typename VALUE_TYPE, typename INTERPOLATOR>
+template <typename CONTAINER>
+inline void AnimationClip<VALUE_TYPE, INTERPOLATOR>::sample( Scalar t, CONTAINER& values ) {
+    CORE_ASSERT( values.size() == getNumTracks(), "Wrong number of values." );
+    for ( size_t i = 0; i < getNumTracks(); ++i ) {
+        values[i] = ( *m_tracks )[i].template at<INTERPOLATOR>( t, m_cursors[i] );
+    }
+}
+
+template <typename VALUE_TYPE, typename INTERPOLATOR>
+inline void AnimationClip<VALUE_TYPE, INTERPOLATOR>::resetCursors() {
+    std::fill( m_cursors.begin(), m_cursors.end(), 0 );
+}
+
+template <typename VALUE_TYPE, typename INTERPOLATOR>
+inline size_t AnimationClip<VALUE_TYPE, INTERPOLATOR>::computeVersion( const Tracks& tracks ) {
+    // the versions only grow, so that their sum changes whenever a track is edited.
+    size_t version = tracks.size();
+    for ( const auto& track : tracks ) {
+        version += track.getVersion();
+    }
+    return version;
+}
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,150 @@
+#include <Core/Animation/CompactPose.hpp>
+
+#include <algorithm>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+void QTPose::resize( size_t n ) {
+    m_rotations.resize( n, Quaternion::Identity() );
+    m_translations.resize( n, Vector3::Zero() );
+    m_scales.resize( n, Vector3::Ones() );
+}
+
+void QTPose::clear() {
+    m_rotations.clear();
+    m_translations.clear();
+    m_scales.clear();
+}
+
+Transform QTPose::getTransform( size_t i ) const {
+    CORE_ASSERT( i < size(), "Index i out of bounds" );
+    Transform T;
+    T.fromPositionOrientationScale( m_translations[i], m_rotations[i], m_scales[i] );
+    return T;
+}
+
+void QTPose::setTransform( size_t i, const Transform& T ) {
+    CORE_ASSERT( i < size(), "Index i out of bounds" );
+    Matrix3 R;
+    Matrix3 S;
+    T.computeRotationScaling( &R, &S );
+    m_rotations[i]    = Quaternion( R ).normalized();
+    m_translations[i] = T.translation();
+    m_scales[i]       = S.diagonal();
+}
+
+void QTPose::setPose( const Pose& pose ) {
+    resize( pose.size() );
+    for ( size_t i = 0; i < pose.size(); ++i ) {
+        setTransform( i, pose[i] );
+    }
+}
+
+void QTPose::getPose( Pose& pose ) const {
+    pose.resize( size() );
+    for ( size_t i = 0; i < size(); ++i ) {
+        pose[i] = getTransform( i );
+    }
+}
+
+void QTPose::getPackedPose( PackedPose& packed ) const {
+    packed.resize( size() );
+    for ( size_t i = 0; i < size(); ++i ) {
+        packed[i].leftCols<3>() = m_rotations[i].toRotationMatrix() * m_scales[i].asDiagonal();
+        packed[i].col( 3 )      = m_translations[i];
+    }
+}
+
+void toPackedPose( const Pose& pose, PackedPose& packed ) {
+    packed.resize( pose.size() );
+    for ( size_t i = 0; i < pose.size(); ++i ) {
+        packed[i] = toTransform3x4( pose[i] );
+    }
+}
+
+void toPose( const PackedPose& packed, Pose& pose ) {
+    pose.resize( packed.size() );
+    for ( size_t i = 0; i < packed.size(); ++i ) {
+        pose[i] = toTransform( packed[i] );
+    }
+}
+
+void localToModel( const PackedPose& local,
+                   const AlignedStdVector<int>& parents,
+                   PackedPose& model ) {
+    CORE_ASSERT( local.size() == parents.size(), "Pose and hierarchy sizes mismatch" );
+    model.resize( local.size() );
+    for ( size_t i = 0; i < local.size(); ++i ) {
+        const int parent = parents[i];
+        CORE_ASSERT( parent < int( i ), "Parents must come before their children" );
+        model[i] = ( parent == -1 ) ? local[i] : compose( model[parent], local[i] );
+    }
+}
+
+void modelToLocal( const PackedPose& model,
+                   const AlignedStdVector<int>& parents,
+                   PackedPose& local ) {
+    CORE_ASSERT( model.size() == parents.size(), "Pose and hierarchy sizes mismatch" );
+    local.resize( model.size() );
+    for ( size_t i = 0; i < model.size(); ++i ) {
+        const int parent = parents[i];
+        local[i] =
+            ( parent == -1 ) ? model[i] : compose( affineInverse( model[parent] ), model[i] );
+    }
+}
+
+void relativePose( const PackedPose& modelPose, const PackedPose& restPose, PackedPose& relative ) {
+    CORE_ASSERT( modelPose.size() == restPose.size(), "Poses with different size" );
+    relative.resize( modelPose.size() );
+    for ( size_t i = 0; i < modelPose.size(); ++i ) {
+        relative[i] = compose( modelPose[i], affineInverse( restPose[i] ) );
+    }
+}
+
+void applyTransformation( const PackedPose& pose,
+                          const PackedPose& transform,
+                          PackedPose& result ) {
+    result.resize( std::min( pose.size(), transform.size() ) );
+    for ( size_t i = 0; i < result.size(); ++i ) {
+        result[i] = compose( transform[i], pose[i] );
+    }
+}
+
+void skinningMatrices( const PackedPose& modelPose,
+                       const PackedPose& bindMatrices,
+                       const Transform3x4& meshTransformInverse,
+                       PackedPose& matrices ) {
+    CORE_ASSERT( modelPose.size() == bindMatrices.size(), "Pose and bind matrices mismatch" );
+    matrices.resize( modelPose.size() );
+    for ( size_t i = 0; i < modelPose.size(); ++i ) {
+        matrices[i] = compose( compose( meshTransformInverse, modelPose[i] ), bindMatrices[i] );
+    }
+}
+
+void interpolatePoses( const QTPose& a, const QTPose& b, const Scalar t, QTPose& result ) {
+    CORE_ASSERT( ( a.size() == b.size() ), "Poses are wrong" );
+    CORE_ASSERT( ( ( t >= Scalar( 0. ) ) && ( t <= Scalar( 1. ) ) ), "T is wrong" );
+    result.resize( a.size() );
+    if ( a.size() == 0 ) { return; }
+
+    const Scalar s = 1_ra - t;
+
+    // translations and scales are blended as whole arrays
+    result.m_translations.getMap() = s * a.m_translations.getMap() + t * b.m_translations.getMap();
+    result.m_scales.getMap()       = s * a.m_scales.getMap() + t * b.m_scales.getMap();
+
+    // rotations are blended on their 4 coefficients, along the shortest path
+    for ( size_t i = 0; i < a.size(); ++i ) {
+        const auto& qa = a.m_rotations[i].coeffs();
+        const auto& qb = b.m_rotations[i].coeffs();
+        const Scalar w = qa.dot( qb ) < 0_ra ? -t : t;
+
+        result.m_rotations[i].coeffs() = ( s * qa + w * qb ).normalized();
+    }
+}
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <Core/Animation/Pose.hpp>
+#include <Core/Containers/AlignedStdVector.hpp>
+#include <Core/Containers/VectorArray.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+/// \name Compact pose representations
+/// \{
+
+/**
+ * Affine transform packed as its 3 first rows, the last row ( 0, 0, 0, 1 ) being implicit.
+ *
+ * Rows are stored contiguously so that each row fits a SIMD register (in single precision),
+ * the products below then being computed one row at a time.
+ */
+using Transform3x4 = Eigen::Matrix<Scalar, 3, 4, Eigen::RowMajor>;
+
+/// A Pose stored as packed 3x4 affine transforms (48 bytes per bone instead of 64 in single
+/// precision).
+using PackedPose = AlignedStdVector<Transform3x4>;
+
+/// Returns the packed version of \p T.
+inline Transform3x4 toTransform3x4( const Transform& T ) {
+    return T.matrix().topRows<3>();
+}
+
+/// Returns the Transform corresponding to \p M.
+inline Transform toTransform( const Transform3x4& M ) {
+    Transform T;
+    T.matrix().topRows<3>() = M;
+    T.makeAffine();
+    return T;
+}
+
+/// Returns the product \p a * \p b.
+inline Transform3x4 compose( const Transform3x4& a, const Transform3x4& b ) {
+    Transform3x4 res;
+    for ( int i = 0; i < 3; ++i ) {
+        res.row( i ) = a( i, 0 ) * b.row( 0 ) + a( i, 1 ) * b.row( 1 ) + a( i, 2 ) * b.row( 2 );
+        res( i, 3 ) += a( i, 3 );
+    }
+    return res;
+}
+
+/// Returns the inverse of the affine transform \p M.
+inline Transform3x4 affineInverse( const Transform3x4& M ) {
+    Transform3x4 res;
+    res.leftCols<3>() = M.leftCols<3>().inverse();
+    res.col( 3 )      = -res.leftCols<3>() * M.col( 3 );
+    return res;
+}
+
+/**
+ * Structure of arrays Pose: the rotation, translation and scale of each transform are stored in
+ * separate arrays (40 bytes per bone instead of 64 in single precision).
+ *
+ * The transforms are expected not to contain shear, the scale being along the local axes. Since
+ * the product of such transforms may contain shear, hierarchy propagation is done on the
+ * PackedPose obtained with getPackedPose().
+ */
+class RA_CORE_API QTPose
+{
+  public:
+    QTPose() = default;
+
+    /// Creates a pose of \p n identity transforms.
+    explicit QTPose( size_t n ) { resize( n ); }
+
+    /// Creates the compact representation of \p pose, see setPose().
+    explicit QTPose( const Pose& pose ) { setPose( pose ); }
+
+    /// Returns the number of transforms.
+    inline size_t size() const { return m_rotations.size(); }
+
+    /// Resizes the pose, new transforms being set to identity.
+    void resize( size_t n );
+
+    /// Removes all the transforms.
+    void clear();
+
+    /// Returns the \p i-th transform.
+    Transform getTransform( size_t i ) const;
+
+    /// Sets the \p i-th transform from \p T, decomposed as T = Translation * Rotation * Scale.
+    void setTransform( size_t i, const Transform& T );
+
+    /// Sets all the transforms from \p pose, see setTransform().
+    void setPose( const Pose& pose );
+
+    /// Fills \p pose with the transforms.
+    void getPose( Pose& pose ) const;
+
+    /// Fills \p packed with the transforms.
+    void getPackedPose( PackedPose& packed ) const;
+
+    /// Rotation of each transform.
+    AlignedStdVector<Quaternion> m_rotations;
+
+    /// Translation of each transform.
+    Vector3Array m_translations;
+
+    /// Scale factors of each transform.
+    Vector3Array m_scales;
+};
+
+/// Fills \p packed with the packed transforms of \p pose.
+RA_CORE_API void toPackedPose( const Pose& pose, PackedPose& packed );
+
+/// Fills \p pose with the transforms of \p packed.
+RA_CORE_API void toPose( const PackedPose& packed, Pose& pose );
+
+/**
+ * Computes the Model-space pose from the Local-space pose \p local, given the parent index of
+ * each transform (-1 for roots), e.g. Skeleton::m_graph.parents().
+ * \note Parents must come before their children, which AdjacencyList guarantees.
+ */
+RA_CORE_API void localToModel( const PackedPose& local,
+                               const AlignedStdVector<int>& parents,
+                               PackedPose& model );
+
+/// Computes the Local-space pose from the Model-space pose \p model, see localToModel().
+RA_CORE_API void modelToLocal( const PackedPose& model,
+                               const AlignedStdVector<int>& parents,
+                               PackedPose& local );
+
+/// Computes relative[i] = modelPose[i] * restPose[i]^-1.
+RA_CORE_API void relativePose( const PackedPose& modelPose,
+                               const PackedPose& restPose,
+                               PackedPose& relative );
+
+/// Computes result[i] = transform[i] * pose[i].
+RA_CORE_API void applyTransformation( const PackedPose& pose,
+                                      const PackedPose& transform,
+                                      PackedPose& result );
+
+/**
+ * Computes the skinning matrices matrices[i] = meshTransformInverse * modelPose[i] *
+ * bindMatrices[i].
+ */
+RA_CORE_API void skinningMatrices( const PackedPose& modelPose,
+                                   const PackedPose& bindMatrices,
+                                   const Transform3x4& meshTransformInverse,
+                                   PackedPose& matrices );
+
+/**
+ * Interpolates the poses \p a and \p b into \p result.
+ *
+ * Translations and scales are linearly interpolated, rotations are normalized-linearly
+ * interpolated along the shortest path: they match the spherical interpolation of
+ * interpolatePoses( const Pose&, const Pose&, const Scalar ) for t in {0, 0.5, 1}, and stay close
+ * to it in between for the small angles found between keyframes.
+ */
+RA_CORE_API void interpolatePoses( const QTPose& a,
+                                   const QTPose& b,
+                                   const Scalar t,
+                                   QTPose& result );
+
+/// \}
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,294 @@
+#include <Core/Animation/CompressedAnimation.hpp>
+
+#include <Core/Math/Interpolation.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+namespace {
+using QuantizedQuaternion = std::array<uint16_t, 3>;
+
+/// The range of the 3 smallest coefficients of a unit quaternion is [-1/sqrt(2), 1/sqrt(2)].
+constexpr Scalar s_quaternionRange = Scalar( 0.70710678118654752440 );
+/// The quantized coefficients are stored on 15 bits.
+constexpr Scalar s_quaternionSteps = Scalar( ( 1 << 15 ) - 1 );
+
+QuantizedQuaternion quantize( const Quaternion& quaternion ) {
+    Vector4 c = quaternion.normalized().coeffs();
+    int largest;
+    c.cwiseAbs().maxCoeff( &largest );
+    // q and -q are the same rotation, the largest coefficient is made positive so that it can
+    // be recovered from the others.
+    if ( c[largest] < 0_ra ) { c = -c; }
+    QuantizedQuaternion result;
+    for ( int i = 0, k = 0; i < 4; ++i ) {
+        if ( i == largest ) { continue; }
+        const Scalar v  = std::clamp( c[i] / s_quaternionRange, -1_ra, 1_ra );
+        const long bits = std::lround( ( v * 0.5_ra + 0.5_ra ) * s_quaternionSteps );
+        result[k++]     = uint16_t( bits << 1 );
+    }
+    // the index of the largest coefficient is stored in the lowest bits.
+    result[0] |= uint16_t( largest & 1 );
+    result[1] |= uint16_t( ( largest >> 1 ) & 1 );
+    return result;
+}
+
+Quaternion dequantize( const QuantizedQuaternion& quantized ) {
+    const int largest = ( quantized[0] & 1 ) | ( ( quantized[1] & 1 ) << 1 );
+    Vector4 c;
+    Scalar norm = 0_ra;
+    for ( int i = 0, k = 0; i < 4; ++i ) {
+        if ( i == largest ) { continue; }
+        c[i] = ( Scalar( quantized[k++] >> 1 ) / s_quaternionSteps * 2_ra - 1_ra ) *
+               s_quaternionRange;
+        norm += c[i] * c[i];
+    }
+    c[largest] = std::sqrt( std::max( 0_ra, 1_ra - norm ) );
+    return Quaternion( c ).normalized();
+}
+
+/// Returns the index i of the key at or before \p t and the linear parameter of \p t between
+/// the keys i and i + 1, stepping forward from the key \p cursor.
+std::pair<size_t, Scalar> locate( const std::vector<Scalar>& times, Scalar t, size_t& cursor ) {
+    const size_t n = times.size();
+    if ( n == 1 || t <= times.front() ) {
+        cursor = 0;
+        return { 0, 0_ra };
+    }
+    if ( t >= times.back() ) {
+        cursor = n - 1;
+        return { n - 1, 0_ra };
+    }
+    // here times[0] < t < times[n - 1], so that i < n - 1.
+    static constexpr size_t s_maxSteps = 4;
+    size_t i                           = std::min( cursor, n - 1 );
+    if ( times[i] > t ) { i = 0; }
+    for ( size_t step = 0; times[i + 1] <= t; ++step ) {
+        if ( step == s_maxSteps ) {
+            auto upper = std::upper_bound( times.begin() + i + 1, times.end(), t );
+            i          = size_t( std::distance( times.begin(), upper ) ) - 1;
+            break;
+        }
+        ++i;
+    }
+    cursor = i;
+    return { i, ( t - times[i] ) / ( times[i + 1] - times[i] ) };
+}
+
+/// Returns the value of \p channel at time \p t.
+template <typename CHANNEL, typename DECODE>
+auto sampleChannel( const CHANNEL& channel, Scalar t, size_t& cursor, DECODE decode ) {
+    const auto [i, u] = locate( channel.m_times, t, cursor );
+    if ( u == 0_ra ) { return decode( channel.m_values[i] ); }
+    return Math::linearInterpolate(
+        decode( channel.m_values[i] ), decode( channel.m_values[i + 1] ), u );
+}
+
+/// Returns the indices of the keys to keep, so that interpolating the \p decoded values of the
+/// kept keys stays within \p tolerance of the \p original values at all the keys \p times.
+template <typename T, typename DISTANCE>
+std::vector<size_t> reduceKeys( const std::vector<Scalar>& times,
+                                const std::vector<T>& decoded,
+                                const std::vector<T>& original,
+                                Scalar tolerance,
+                                DISTANCE distance ) {
+    const size_t n = times.size();
+    // constant channel
+    bool constant = true;
+    for ( size_t k = 0; k < n && constant; ++k ) {
+        constant = distance( decoded[0], original[k] ) <= tolerance;
+    }
+    if ( constant ) { return { 0 }; }
+
+    // extend the segment from the last kept key as long as it fits the original keys.
+    std::vector<size_t> kept { 0 };
+    size_t i = 0;
+    for ( size_t j = 2; j < n; ++j ) {
+        bool fits = true;
+        for ( size_t k = i + 1; k < j && fits; ++k ) {
+            const Scalar u = ( times[k] - times[i] ) / ( times[j] - times[i] );
+            fits           = distance( Math::linearInterpolate( decoded[i], decoded[j], u ),
+                                       original[k] ) <= tolerance;
+        }
+        if ( !fits ) {
+            i = j - 1;
+            kept.push_back( i );
+        }
+    }
+    kept.push_back( n - 1 );
+    return kept;
+}
+
+template <typename CHANNEL>
+size_t channelMemorySize( const CHANNEL& channel ) {
+    using Value = typename std::decay_t<decltype( channel.m_values )>::value_type;
+    return channel.m_times.capacity() * sizeof( Scalar ) +
+           channel.m_values.capacity() * sizeof( Value );
+}
+
+const auto identity = []( const auto& v ) { return v; };
+
+} // namespace
+
+void CompressedAnimation::compress( const Tracks& tracks, const Settings& settings ) {
+    m_tracks.clear();
+    m_tracks.resize( tracks.size() );
+    m_errors.assign( tracks.size(), Error {} );
+    m_startTime = tracks.empty() ? 0_ra : std::numeric_limits<Scalar>::max();
+    m_endTime   = tracks.empty() ? 0_ra : std::numeric_limits<Scalar>::lowest();
+
+    const auto vectorDistance = []( const Vector3& a, const Vector3& b ) {
+        return ( a - b ).norm();
+    };
+    const auto scaleDistance = []( const Vector3& a, const Vector3& b ) {
+        return ( a - b ).cwiseAbs().maxCoeff();
+    };
+    const auto rotationDistance = []( const Quaternion& a, const Quaternion& b ) {
+        return a.angularDistance( b );
+    };
+
+    for ( size_t b = 0; b < tracks.size(); ++b ) {
+        const auto& keyframes = tracks[b].getKeyFrames();
+        const size_t n        = keyframes.size();
+        m_startTime           = std::min( m_startTime, keyframes.front().first );
+        m_endTime             = std::max( m_endTime, keyframes.back().first );
+
+        // decompose the transforms as done by Math::linearInterpolate.
+        std::vector<Scalar> times( n );
+        std::vector<Vector3> translations( n );
+        std::vector<Quaternion> rotations( n );
+        std::vector<Quaternion> quantizedRotations( n );
+        std::vector<QuantizedQuaternion> encodedRotations( n );
+        std::vector<Vector3> scales( n );
+        for ( size_t k = 0; k < n; ++k ) {
+            Matrix3 R, S;
+            keyframes[k].second.computeRotationScaling( &R, &S );
+            times[k]              = keyframes[k].first;
+            translations[k]       = keyframes[k].second.translation();
+            rotations[k]          = Quaternion( R );
+            encodedRotations[k]   = quantize( rotations[k] );
+            quantizedRotations[k] = dequantize( encodedRotations[k] );
+            scales[k]             = S.diagonal();
+        }
+
+        const auto fillChannel = [&times]( auto& channel, const auto& values, const auto& kept ) {
+            channel.m_times.reserve( kept.size() );
+            channel.m_values.reserve( kept.size() );
+            for ( auto k : kept ) {
+                channel.m_times.push_back( times[k] );
+                channel.m_values.push_back( values[k] );
+            }
+        };
+        auto& track = m_tracks[b];
+        fillChannel( track.m_translation,
+                     translations,
+                     reduceKeys( times,
+                                 translations,
+                                 translations,
+                                 settings.m_translationError,
+                                 vectorDistance ) );
+        fillChannel( track.m_rotation,
+                     encodedRotations,
+                     reduceKeys( times,
+                                 quantizedRotations,
+                                 rotations,
+                                 settings.m_rotationError,
+                                 rotationDistance ) );
+        fillChannel(
+            track.m_scale,
+            scales,
+            reduceKeys( times, scales, scales, settings.m_scaleError, scaleDistance ) );
+
+        // measure the errors at the original keyframes.
+        std::array<size_t, 3> cursors {};
+        auto& error = m_errors[b];
+        for ( size_t k = 0; k < n; ++k ) {
+            const Scalar time  = times[k];
+            const Vector3 t    = sampleChannel( track.m_translation, time, cursors[0], identity );
+            const Quaternion r = sampleChannel( track.m_rotation, time, cursors[1], dequantize );
+            const Vector3 s    = sampleChannel( track.m_scale, time, cursors[2], identity );
+            error.m_translation =
+                std::max( error.m_translation, vectorDistance( t, translations[k] ) );
+            error.m_rotation = std::max( error.m_rotation, rotationDistance( r, rotations[k] ) );
+            error.m_scale    = std::max( error.m_scale, scaleDistance( s, scales[k] ) );
+        }
+    }
+}
+
+size_t CompressedAnimation::getNumKeys( size_t i ) const {
+    CORE_ASSERT( i < m_tracks.size(), "Out of bound track index." );
+    const auto& track = m_tracks[i];
+    return track.m_translation.m_times.size() + track.m_rotation.m_times.size() +
+           track.m_scale.m_times.size();
+}
+
+Transform CompressedAnimation::sampleTrack( const Track& track, Scalar t, size_t* cursors ) {
+    Transform result;
+    result.fromPositionOrientationScale(
+        sampleChannel( track.m_translation, t, cursors[0], identity ),
+        sampleChannel( track.m_rotation, t, cursors[1], dequantize ),
+        sampleChannel( track.m_scale, t, cursors[2], identity ) );
+    return result;
+}
+
+Transform CompressedAnimation::sample( size_t i, Scalar t ) const {
+    CORE_ASSERT( i < m_tracks.size(), "Out of bound track index." );
+    std::array<size_t, 3> cursors {};
+    return sampleTrack( m_tracks[i], t, cursors.data() );
+}
+
+void CompressedAnimation::sample( Scalar t, Cursors& cursors, Pose& pose ) const {
+    CORE_ASSERT( pose.size() == m_tracks.size(), "Wrong pose size." );
+    if ( cursors.size() != 3 * m_tracks.size() ) { cursors.assign( 3 * m_tracks.size(), 0 ); }
+    for ( size_t i = 0; i < m_tracks.size(); ++i ) {
+        pose[i] = sampleTrack( m_tracks[i], t, &cursors[3 * i] );
+    }
+}
+
+CompressedAnimation::Tracks CompressedAnimation::decompress() const {
+    Tracks tracks;
+    tracks.reserve( m_tracks.size() );
+    for ( size_t i = 0; i < m_tracks.size(); ++i ) {
+        const auto& track         = m_tracks[i];
+        std::vector<Scalar> times = track.m_translation.m_times;
+        for ( const auto& channelTimes : { track.m_rotation.m_times, track.m_scale.m_times } ) {
+            times.insert( times.end(), channelTimes.begin(), channelTimes.end() );
+        }
+        std::sort( times.begin(), times.end() );
+        times.erase( std::unique( times.begin(), times.end() ), times.end() );
+
+        std::array<size_t, 3> cursors {};
+        tracks.emplace_back( times[0], sampleTrack( track, times[0], cursors.data() ) );
+        for ( size_t k = 1; k < times.size(); ++k ) {
+            const Transform value = sampleTrack( track, times[k], cursors.data() );
+            tracks.back().insertKeyFrame( times[k], value );
+        }
+    }
+    return tracks;
+}
+
+size_t CompressedAnimation::getMemorySize() const {
+    size_t size = sizeof( *this ) + m_tracks.capacity() * sizeof( Track ) +
+                  m_errors.capacity() * sizeof( Error );
+    for ( const auto& track : m_tracks ) {
+        size += channelMemorySize( track.m_translation ) + channelMemorySize( track.m_rotation ) +
+                channelMemorySize( track.m_scale );
+    }
+    return size;
+}
+
+size_t CompressedAnimation::getMemorySize( const Tracks& tracks ) {
+    size_t size = sizeof( Tracks ) + tracks.capacity() * sizeof( KeyFramedValue<Transform> );
+    for ( const auto& track : tracks ) {
+        size += track.getKeyFrames().capacity() * sizeof( KeyFramedValue<Transform>::KeyFrame );
+    }
+    return size;
+}
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <Core/Animation/KeyFramedValue.hpp>
+#include <Core/Animation/Pose.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+/**
+ * Compressed storage of keyframed transform tracks, e.g. the per-bone tracks of a skeleton
+ * animation.
+ *
+ * Each track is decomposed into translation, rotation and scale channels, interpolated the same
+ * way as Math::linearInterpolate() interpolates transforms. The rotations are quantized on
+ * 48 bits with the smallest-three encoding. The keys of each channel are then removed as long as
+ * the channel stays within the error bounds at the original keyframes. A constant channel thus
+ * keeps a single key.
+ *
+ * The maximal errors of each track at its original keyframes are measured after compression.
+ */
+class RA_CORE_API CompressedAnimation
+{
+  public:
+    using Tracks = std::vector<KeyFramedValue<Transform>>;
+
+    /// The error bounds of the compression.
+    struct Settings {
+        Scalar m_translationError { 1e-4_ra }; ///< In model units.
+        Scalar m_rotationError { 1e-3_ra };    ///< In radians.
+        Scalar m_scaleError { 1e-4_ra };       ///< As a scale factor.
+    };
+
+    /// The maximal errors of a compressed track at its original keyframes.
+    struct Error {
+        Scalar m_translation { 0_ra };
+        Scalar m_rotation { 0_ra };
+        Scalar m_scale { 0_ra };
+    };
+
+    /// The playback cursors of the channels, see sample( Scalar, Cursors&, Pose& ).
+    using Cursors = std::vector<size_t>;
+
+    CompressedAnimation() = default;
+
+    /// Compresses \p tracks, see compress().
+    CompressedAnimation( const Tracks& tracks, const Settings& settings ) {
+        compress( tracks, settings );
+    }
+
+    /// Compresses \p tracks with the default error bounds.
+    explicit CompressedAnimation( const Tracks& tracks ) { compress( tracks, Settings {} ); }
+
+    /// Compresses \p tracks within the error bounds of \p settings.
+    void compress( const Tracks& tracks, const Settings& settings );
+
+    /// Returns the number of tracks.
+    inline size_t getNumTracks() const { return m_tracks.size(); }
+
+    /// Returns the time of the first keyframe of the tracks.
+    inline Scalar getStartTime() const { return m_startTime; }
+
+    /// Returns the time of the last keyframe of the tracks.
+    inline Scalar getEndTime() const { return m_endTime; }
+
+    /// Returns the number of keys kept for track \p i, over its 3 channels.
+    size_t getNumKeys( size_t i ) const;
+
+    /// Returns the maximal errors of each track at its original keyframes.
+    inline const std::vector<Error>& getErrors() const { return m_errors; }
+
+    /// Returns the value of track \p i at time \p t.
+    Transform sample( size_t i, Scalar t ) const;
+
+    /// Fills \p pose with the values of the tracks at time \p t.
+    /// \p cursors are the playback cursors of the channels, initialized at the first call, so
+    /// that sampling forward in time is amortized O(1) and does not allocate memory.
+    void sample( Scalar t, Cursors& cursors, Pose& pose ) const;
+
+    /// Returns keyframed tracks with keys at the times kept by the compression.
+    Tracks decompress() const;
+
+    /// Returns the memory used by the compressed tracks, in bytes.
+    size_t getMemorySize() const;
+
+    /// Returns the memory used by \p tracks, in bytes.
+    static size_t getMemorySize( const Tracks& tracks );
+
+  private:
+    /// Smallest-three quantized quaternion: the 3 smallest coefficients on 15 bits each,
+    /// the index of the largest one on the remaining bits.
+    using QuantizedQuaternion = std::array<uint16_t, 3>;
+
+    /// The keys of a channel, with a single key for a constant channel.
+    template <typename T>
+    struct Channel {
+        std::vector<Scalar> m_times;
+        std::vector<T> m_values;
+    };
+
+    /// The channels of a track.
+    struct Track {
+        Channel<Vector3> m_translation;
+        Channel<QuantizedQuaternion> m_rotation;
+        Channel<Vector3> m_scale;
+    };
+
+    /// Returns the value of \p track at time \p t, given the cursors of its channels.
+    static Transform sampleTrack( const Track& track, Scalar t, size_t* cursors );
+
+    std::vector<Track> m_tracks;
+    std::vector<Error> m_errors;
+    Scalar m_startTime { 0_ra };
+    Scalar m_endTime { 0_ra };
+};
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
@@ -1,6 +1,8 @@
 #include <Core/Animation/DualQuaternionSkinning.hpp>
 
+#include <Core/Animation/HandleWeightOperation.hpp>
 #include <Core/Animation/SkinningData.hpp>
+#include <Core/Tasks/Parallel.hpp>
 
 namespace Ra {
 namespace Core {
@@ -8,54 +10,35 @@ namespace Animation {
 
 DQList computeDQ( const Pose& pose, const Sparse& weight ) {
     CORE_ASSERT( ( pose.size() == size_t( weight.cols() ) ), "pose/weight size mismatch." );
-    DQList DQ( weight.rows(),
-               DualQuaternion( Quaternion( 0, 0, 0, 0 ), Quaternion( 0, 0, 0, 0 ) ) );
+    return computeDQ( pose, packWeights( weight ) );
+}
 
-    // Stores the first non-zero quaternion for each vertex.
-    std::vector<uint> firstNonZero( weight.rows(), std::numeric_limits<uint>::max() );
+DQList computeDQ( const Pose& pose, const PackedWeights& weights ) {
     // Contains the converted dual quaternions from the pose
     std::vector<DualQuaternion> poseDQ( pose.size() );
-
-    // Loop through all transforms Tj
-    for ( int j = 0; j < weight.outerSize(); ++j ) {
-        poseDQ[j] = DualQuaternion( pose[j] );
-        // Count how many vertices are influenced by the given transform
-        const int nonZero = weight.col( j ).nonZeros();
-
-        Sparse::InnerIterator it0( weight, j );
-#pragma omp parallel for
-        // This for loop is here just because OpenMP wants classic for loops.
-        // Since we cannot iterate directly through the non-zero elements using the InnerIterator,
-        // we initialize an InnerIterator to the first element and then we increase it nz times.
-        /*
-         * This crappy piece of code was done in order to avoid the critical section
-         *           DQ[i] += wq;
-         *
-         * that was occurring when parallelizing the main for loop.
-         *
-         * NOTE: this could be definitely improved by using std::thread
-         */
-        // Loop through all vertices vi who depend on Tj
-
-        for ( int nz = 0; nz < nonZero; ++nz ) {
-            Sparse::InnerIterator itn = it0 + Eigen::Index( nz );
-            const uint i              = itn.row();
-            const Scalar w            = itn.value();
-
-            firstNonZero[i] = std::min( firstNonZero[i], uint( j ) );
-            const Scalar sign =
-                Ra::Core::Math::signNZ( poseDQ[j].getQ0().dot( poseDQ[firstNonZero[i]].getQ0() ) );
-
-            const auto wq = poseDQ[j] * w * sign;
-            DQ[i] += wq;
+    parallelFor( 0, int( pose.size() ), [&]( int j ) { poseDQ[j] = DualQuaternion( pose[j] ); } );
+
+    // Each vertex blends the dual quaternions of its influences, independently of the others.
+    DQList DQ( weights.size() );
+    const uint K = weights.m_influenceCount;
+    parallelFor( 0, int( DQ.size() ), [&]( int i ) {
+        const SingleWeight* influences = weights.m_influences.data() + size_t( i ) * K;
+        // Flip the dual quaternion signs according to the most influent one, see Algorithm 2 in
+        // section 4.1 of Kavan , Collins, Zara and O'Sullivan, 2008.
+        uint dominant = 0;
+        for ( uint k = 1; k < K; ++k ) {
+            if ( influences[k].second > influences[dominant].second ) { dominant = k; }
         }
-    }
-
-    // Normalize all dual quats.
-#pragma omp parallel for
-    for ( int i = 0; i < int( DQ.size() ); ++i ) {
-        DQ[i].normalize();
-    }
+        const Quaternion& q0 = poseDQ[influences[dominant].first].getQ0();
+        DualQuaternion dq( Quaternion( 0, 0, 0, 0 ), Quaternion( 0, 0, 0, 0 ) );
+        for ( uint k = 0; k < K; ++k ) {
+            const auto& [j, w] = influences[k];
+            if ( w == 0 ) { continue; }
+            dq += poseDQ[j] * ( w * Ra::Core::Math::signNZ( poseDQ[j].getQ0().dot( q0 ) ) );
+        }
+        dq.normalize();
+        DQ[i] = dq;
+    } );
 
     return DQ;
 }
@@ -69,10 +52,7 @@ DQList computeDQ_naive( const Pose& pose, const Sparse& weight ) {
     std::vector<DualQuaternion> poseDQ( pose.size() );
 
     // 1. Convert all transforms to DQ
-#pragma omp parallel for
-    for ( int j = 0; j < weight.cols(); ++j ) {
-        poseDQ[j] = DualQuaternion( pose[j] );
-    }
+    parallelFor( 0, int( weight.cols() ), [&]( int j ) { poseDQ[j] = DualQuaternion( pose[j] ); } );
 
     // 2. for all vertices, blend the dual quats.
     for ( int i = 0; i < weight.rows(); ++i ) {
@@ -93,20 +73,16 @@ DQList computeDQ_naive( const Pose& pose, const Sparse& weight ) {
     }
 
     // 3. renormalize all dual quats.
-#pragma omp parallel for
-    for ( int i = 0; i < int( DQ.size() ); ++i ) {
-        DQ[i].normalize();
-    }
+    parallelFor( 0, int( DQ.size() ), [&DQ]( int i ) { DQ[i].normalize(); } );
 
     return DQ;
 }
 
 Vector3Array applyDualQuaternions( const DQList& DQ, const Vector3Array& vertices ) {
     Vector3Array out( vertices.size(), Vector3::Zero() );
-#pragma omp parallel for
-    for ( int i = 0; i < int( vertices.size() ); ++i ) {
+    parallelFor( 0, int( vertices.size() ), [&]( int i ) {
         out[i] = DQ[i].transform( vertices[i] );
-    }
+    } );
     return out;
 }
 
@@ -114,25 +90,35 @@ void dualQuaternionSkinning( const SkinningRefData& refData,
                              const Vector3Array& tangents,
                              const Vector3Array& bitangents,
                              SkinningFrameData& frameData ) {
+    dualQuaternionSkinning(
+        refData, packWeights( refData.m_weights ), tangents, bitangents, frameData );
+}
+
+void dualQuaternionSkinning( const SkinningRefData& refData,
+                             const PackedWeights& weights,
+                             const Vector3Array& tangents,
+                             const Vector3Array& bitangents,
+                             SkinningFrameData& frameData ) {
+    CORE_ASSERT( weights.size() == frameData.m_currentPosition.size(),
+                 "Weights are incompatible with mesh." );
     // prepare the pose w.r.t. the bind matrices and the mesh tranform
     auto pose = frameData.m_skeleton.getPose( HandleArray::SpaceType::MODEL );
-#pragma omp parallel for
-    for ( int i = 0; i < int( frameData.m_skeleton.size() ); ++i ) {
+    parallelFor( 0, int( frameData.m_skeleton.size() ), [&]( int i ) {
         pose[i] = refData.m_meshTransformInverse * pose[i] * refData.m_bindMatrices[i];
-    }
+    } );
     // compute the dual quaternion for each vertex
-    const auto DQ = computeDQ( pose, refData.m_weights );
-    // apply DQS
+    const auto DQ = computeDQ( pose, weights );
+    // apply DQS, the rotation matrix and translation of each dual quaternion being computed once
     const auto& vertices = refData.m_referenceMesh.vertices();
     const auto& normals  = refData.m_referenceMesh.normals();
-#pragma omp parallel for
-    for ( int i = 0; i < int( frameData.m_currentPosition.size() ); ++i ) {
+    parallelFor( 0, int( frameData.m_currentPosition.size() ), [&]( int i ) {
         const auto& DQi                 = DQ[i];
-        frameData.m_currentPosition[i]  = DQi.transform( vertices[i] );
-        frameData.m_currentNormal[i]    = DQi.rotate( normals[i] );
-        frameData.m_currentTangent[i]   = DQi.rotate( tangents[i] );
-        frameData.m_currentBitangent[i] = DQi.rotate( bitangents[i] );
-    }
+        const Matrix3 R                 = DQi.getQ0().toRotationMatrix();
+        frameData.m_currentPosition[i]  = DQi.translate( R * vertices[i] );
+        frameData.m_currentNormal[i]    = R * normals[i];
+        frameData.m_currentTangent[i]   = R * tangents[i];
+        frameData.m_currentBitangent[i] = R * bitangents[i];
+    } );
 }
 } // namespace Animation
 } // namespace Core
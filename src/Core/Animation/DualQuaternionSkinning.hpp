@@ -29,6 +29,16 @@ using DQList = AlignedStdVector<DualQuaternion>;
 // clang-format on
 DQList RA_CORE_API computeDQ( const Pose& pose, const WeightMatrix& weight );
 
+/**
+ * \brief Computes the per-vertex dual quaternion from weights packed per vertex (see
+ * packWeights()).
+ *
+ * The dual quaternions of the pose are computed once, then each vertex blends the ones of its
+ * influences in parallel, their signs being aligned on the one of its most influent handle.
+ * The result does not depend on the number of threads.
+ */
+DQList RA_CORE_API computeDQ( const Pose& pose, const PackedWeights& weights );
+
 /**
  * \brief Default non-optimized, non-parallel implementation of computeDQ.
  */
@@ -36,7 +46,7 @@ DQList RA_CORE_API computeDQ_naive( const Pose& pose, const WeightMatrix& weight
 
 /**
  * \brief Applies the given Dual-Quaternions to the given vertices.
- * \note Parallelized loop inside (using openmp).
+ * \note Parallelized loop inside (using parallelFor(), see Core/Tasks/Parallel.hpp).
  */
 Vector3Array RA_CORE_API applyDualQuaternions( const DQList& DQ, const Vector3Array& vertices );
 
@@ -53,13 +63,28 @@ Vector3Array RA_CORE_API applyDualQuaternions( const DQList& DQ, const Vector3Ar
  * \f$\mathbf{v}_i^t = \mathbf{Q}_i(\mathbf{v}_i^0)\f$
  *
  * \note Assumes frameData is well sized.
- * \note Parallelized loop inside (using openmp).
+ * \note Parallelized loop inside (using parallelFor(), see Core/Tasks/Parallel.hpp).
+ * \note Packs refData.m_weights at each call, prefer the overload taking packed weights when
+ * skinning several frames.
  */
 // clang-format on
 void RA_CORE_API dualQuaternionSkinning( const SkinningRefData& refData,
                                          const Vector3Array& tangents,
                                          const Vector3Array& bitangents,
                                          SkinningFrameData& frameData );
+
+/**
+ * \brief Applies Dual-Quaternion skinning to the current frame, with the weights of
+ * refData.m_weights packed per vertex (see packWeights()).
+ *
+ * Each vertex blends its dual quaternion and transforms its position, normal, tangent and
+ * bitangent in a single pass.
+ */
+void RA_CORE_API dualQuaternionSkinning( const SkinningRefData& refData,
+                                         const PackedWeights& weights,
+                                         const Vector3Array& tangents,
+                                         const Vector3Array& bitangents,
+                                         SkinningFrameData& frameData );
 /// \}
 
 } // namespace Animation
@@ -3,6 +3,7 @@
 #include <Core/Containers/AlignedStdVector.hpp>
 #include <Core/Types.hpp>
 #include <map>
+#include <vector>
 
 namespace Ra {
 namespace Core {
@@ -33,6 +34,25 @@ using MeshWeight = AlignedStdVector<VertexWeight>;
  */
 using WeightMatrix = Ra::Core::Sparse;
 
+/**
+ * Defines the skinning weights of a mesh packed per vertex, each vertex having the same number of
+ * (handle, weight) influences, so that the influences of vertex i are
+ *      m_influences[i * m_influenceCount + k], k < m_influenceCount.
+ * Vertices with less influences are padded with null weights on handle 0.
+ */
+struct PackedWeights {
+    /// The number of influences of each vertex.
+    uint m_influenceCount { 0 };
+
+    /// The influences of all the vertices.
+    std::vector<SingleWeight> m_influences;
+
+    /// The number of vertices.
+    inline size_t size() const {
+        return m_influenceCount == 0 ? 0 : m_influences.size() / m_influenceCount;
+    }
+};
+
 } // namespace Animation
 } // Namespace Core
 } // Namespace Ra
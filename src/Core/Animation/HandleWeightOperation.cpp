@@ -1,6 +1,7 @@
 #include <Core/Animation/HandleWeightOperation.hpp>
 #include <Core/Math/LinearAlgebra.hpp> // Math::checkInvalidNumbers
 #include <Core/Utils/Log.hpp>
+#include <algorithm>
 #include <utility>
 
 namespace Ra {
@@ -33,6 +34,24 @@ MeshWeight extractMeshWeight( Eigen::Ref<const WeightMatrix> matrix ) {
     return W;
 }
 
+PackedWeights packWeights( const WeightMatrix& matrix ) {
+    // Row major copy, to iterate over the weights of each vertex.
+    const Eigen::SparseMatrix<Scalar, Eigen::RowMajor> rows = matrix;
+    PackedWeights W;
+    for ( int i = 0; i < rows.outerSize(); ++i ) {
+        W.m_influenceCount = std::max( W.m_influenceCount, uint( rows.row( i ).nonZeros() ) );
+    }
+    W.m_influences.assign( size_t( rows.rows() ) * W.m_influenceCount, SingleWeight( 0, 0_ra ) );
+    for ( int i = 0; i < rows.outerSize(); ++i ) {
+        auto influence = W.m_influences.begin() + i * W.m_influenceCount;
+        for ( Eigen::SparseMatrix<Scalar, Eigen::RowMajor>::InnerIterator it( rows, i ); it;
+              ++it ) {
+            *influence++ = SingleWeight( uint( it.col() ), it.value() );
+        }
+    }
+    return W;
+}
+
 WeightMatrix partitionOfUnity( Eigen::Ref<const WeightMatrix> weights ) {
     WeightMatrix W = weights;
     normalizeWeights( W );
@@ -17,6 +17,12 @@ RA_CORE_API WeightMatrix extractWeightMatrix( const MeshWeight& weight, const ui
  */
 RA_CORE_API MeshWeight extractMeshWeight( Eigen::Ref<const WeightMatrix> matrix );
 
+/*
+ * Return the weights of the given WeightMatrix packed per vertex, the number of influences per
+ * vertex being the maximal number of non-zero weights of a row.
+ */
+RA_CORE_API PackedWeights packWeights( const WeightMatrix& matrix );
+
 /*
  * Return the WeightMatrix holding the partition of unity property.
  * This is obtained by normalizing each row by its l1-norm, assuming:
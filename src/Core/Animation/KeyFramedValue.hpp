@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <map>
 #include <set>
 
@@ -80,7 +81,11 @@ class KeyFramedValue : public KeyFramedValueBase
 
     KeyFramedValue( const KeyFramedValue& keyframe ) = default;
 
-    inline KeyFramedValue& operator=( const KeyFramedValue& keyframe ) = default;
+    inline KeyFramedValue& operator=( const KeyFramedValue& keyframe ) {
+        m_keyframes = keyframe.m_keyframes;
+        ++m_version;
+        return *this;
+    }
 
     inline std::vector<Scalar> getTimes() const override {
         std::vector<Scalar> times( m_keyframes.size() );
@@ -104,6 +109,11 @@ class KeyFramedValue : public KeyFramedValueBase
      */
     const KeyFrames& getKeyFrames() const { return m_keyframes; }
 
+    /**
+     * @returns the number of modifications of the keyframes, to detect their changes.
+     */
+    inline size_t getVersion() const { return m_version; }
+
     /**
      * \returns the \p i-th keyframe.
      */
@@ -114,6 +124,7 @@ class KeyFramedValue : public KeyFramedValueBase
      * \note If a keyframe already exists for \p t, it will be overwritten.
      */
     inline void insertKeyFrame( const Scalar& t, const VALUE_TYPE& frame ) {
+        ++m_version;
         KeyFrame kf( t, frame );
         auto upper = std::upper_bound(
             m_keyframes.begin(), m_keyframes.end(), kf, []( const auto& a, const auto& b ) {
@@ -144,6 +155,7 @@ class KeyFramedValue : public KeyFramedValueBase
     inline bool removeKeyFrame( size_t i ) override {
         if ( size() == 1 ) return false;
         m_keyframes.erase( m_keyframes.begin() + i );
+        ++m_version;
         return true;
     }
 
@@ -166,6 +178,17 @@ class KeyFramedValue : public KeyFramedValueBase
         return interpolator( *this, t );
     }
 
+    /**
+     * \returns the value at time \p t, interpolated from the keyframes using the
+     *          compile time INTERPOLATOR (e.g. Ra::Core::Animation::LinearInterpolator).
+     * \param cursor the playback cursor, see findRange( Scalar, size_t& ).
+     */
+    template <typename INTERPOLATOR>
+    inline VALUE_TYPE at( const Scalar& t, size_t& cursor ) const {
+        auto [i, j, dt] = findRange( t, cursor );
+        return INTERPOLATOR::interpolate( m_keyframes[i].second, m_keyframes[j].second, dt );
+    }
+
     /**
      * Look for the keyframes around time \p t.
      * \param t The time to search for.
@@ -181,33 +204,55 @@ class KeyFramedValue : public KeyFramedValueBase
      *       then \p i = \p j = the index of the keyframe and \p dt = 0.
      */
     std::tuple<size_t, size_t, Scalar> findRange( Scalar t ) const {
+        size_t cursor = 0;
+        return findRange( t, cursor );
+    }
+
+    /**
+     * Look for the keyframes around time \p t, starting from the keyframe \p cursor.
+     * Same as findRange( Scalar ), but \p cursor is updated to the index of the keyframe
+     * preceding \p t, so that playing the keyframes forward in time only looks at the next
+     * keyframes: the search is amortized O(1) for a monotonic time, and O(log n) otherwise.
+     */
+    std::tuple<size_t, size_t, Scalar> findRange( Scalar t, size_t& cursor ) const {
+        const size_t n = m_keyframes.size();
         // before first
-        if ( t < m_keyframes.begin()->first ) { return { 0, 0, 0_ra }; }
+        if ( t < m_keyframes.front().first ) {
+            cursor = 0;
+            return { 0, 0, 0_ra };
+        }
         // after last
-        if ( t > m_keyframes.rbegin()->first ) {
-            const size_t i = m_keyframes.size() - 1;
-            return { i, i, 0_ra };
+        if ( t > m_keyframes.back().first ) {
+            cursor = n - 1;
+            return { n - 1, n - 1, 0_ra };
         }
-        // look for exact match
-        auto kf0   = m_keyframes[0];
-        kf0.first  = t;
-        auto upper = std::upper_bound(
-            m_keyframes.begin(), m_keyframes.end(), kf0, []( const auto& a, const auto& b ) {
-                return a.first < b.first;
-            } );
+        // look for the last keyframe at or before t, stepping forward from the cursor, then
+        // binary searching if t is too far away.
+        static constexpr size_t s_maxSteps = 4;
+        size_t lower                       = std::min( cursor, n - 1 );
+        if ( m_keyframes[lower].first > t ) { lower = 0; }
+        for ( size_t step = 0; lower + 1 < n && m_keyframes[lower + 1].first <= t; ++step ) {
+            if ( step == s_maxSteps ) {
+                auto upper = std::upper_bound(
+                    m_keyframes.begin() + lower + 1,
+                    m_keyframes.end(),
+                    t,
+                    []( const Scalar& a, const KeyFrame& b ) { return a < b.first; } );
+                lower = size_t( std::distance( m_keyframes.begin(), upper ) ) - 1;
+                break;
+            }
+            ++lower;
+        }
+        cursor = lower;
 
-        // here upper > begin() since before first case is already taken into account.
-        auto lower = upper;
-        --lower;
-        if ( Math::areApproxEqual( lower->first, t ) ) {
-            const size_t i = std::distance( m_keyframes.begin(), lower );
-            return { i, i, 0_ra };
+        // look for exact match
+        if ( lower + 1 == n || Math::areApproxEqual( m_keyframes[lower].first, t ) ) {
+            return { lower, lower, 0_ra };
         }
         // in-between
-        const size_t i  = std::distance( m_keyframes.begin(), lower );
-        const Scalar t0 = lower->first;
-        const Scalar t1 = upper->first;
-        return { i, i + 1, ( t - t0 ) / ( t1 - t0 ) };
+        const Scalar t0 = m_keyframes[lower].first;
+        const Scalar t1 = m_keyframes[lower + 1].first;
+        return { lower, lower + 1, ( t - t0 ) / ( t1 - t0 ) };
     }
     /// \}
 
@@ -234,6 +279,9 @@ class KeyFramedValue : public KeyFramedValueBase
   protected:
     /// The list of keyframes.
     KeyFrames m_keyframes;
+
+    /// The number of modifications of the keyframes.
+    size_t m_version { 0 };
 };
 
 } // namespace Animation
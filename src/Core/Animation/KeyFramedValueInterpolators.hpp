@@ -51,6 +51,44 @@ inline Pose linearInterpolate<Pose>( const KeyFramedValue<Pose>& keyframes, Scal
 }
 /// \}
 
+/** \name Predefined compile time interpolators.
+ * To be used with KeyFramedValue::at( const Scalar&, size_t& ) and AnimationClip, they
+ * interpolate the values \p v0 and \p v1 of the keyframes right before and right after the
+ * sampled time, \p dt being its linear parameter between them.
+ */
+/// \{
+/// Linear interpolation, same as linearInterpolate().
+struct LinearInterpolator {
+    template <typename T>
+    static inline T interpolate( const T& v0, const T& v1, Scalar dt ) {
+        return Core::Math::linearInterpolate( v0, v1, dt );
+    }
+
+    /// Force step for booleans.
+    static inline bool interpolate( const bool& v0, const bool& /*v1*/, Scalar /*dt*/ ) {
+        return v0;
+    }
+
+    /// Force step for integers.
+    static inline int interpolate( const int& v0, const int& /*v1*/, Scalar /*dt*/ ) {
+        return v0;
+    }
+
+    /// Specific implementation for Pose.
+    static inline Pose interpolate( const Pose& v0, const Pose& v1, Scalar dt ) {
+        return interpolatePoses( v0, v1, dt );
+    }
+};
+
+/// Step interpolation, holding the value of the keyframe right before the sampled time.
+struct StepInterpolator {
+    template <typename T>
+    static inline T interpolate( const T& v0, const T& /*v1*/, Scalar /*dt*/ ) {
+        return v0;
+    }
+};
+/// \}
+
 } // namespace Animation
 } // namespace Core
 } // namespace Ra
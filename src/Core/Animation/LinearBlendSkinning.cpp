@@ -1,6 +1,9 @@
 #include <Core/Animation/LinearBlendSkinning.hpp>
 
+#include <Core/Animation/CompactPose.hpp>
+#include <Core/Animation/HandleWeightOperation.hpp>
 #include <Core/Animation/SkinningData.hpp>
+#include <Core/Tasks/Parallel.hpp>
 
 namespace Ra {
 namespace Core {
@@ -10,36 +13,44 @@ void linearBlendSkinning( const SkinningRefData& refData,
                           const Vector3Array& tangents,
                           const Vector3Array& bitangents,
                           SkinningFrameData& frameData ) {
-    const auto& W          = refData.m_weights;
+    linearBlendSkinning(
+        refData, packWeights( refData.m_weights ), tangents, bitangents, frameData );
+}
+
+void linearBlendSkinning( const SkinningRefData& refData,
+                          const PackedWeights& weights,
+                          const Vector3Array& tangents,
+                          const Vector3Array& bitangents,
+                          SkinningFrameData& frameData ) {
+    CORE_ASSERT( weights.size() == frameData.m_currentPosition.size(),
+                 "Weights are incompatible with mesh." );
     const auto& vertices   = refData.m_referenceMesh.vertices();
     const auto& normals    = refData.m_referenceMesh.normals();
     const auto& bindMatrix = refData.m_bindMatrices;
     const auto& pose       = frameData.m_skeleton.getPose( HandleArray::SpaceType::MODEL );
-#pragma omp parallel for
-    for ( int i = 0; i < int( frameData.m_currentPosition.size() ); ++i ) {
-        frameData.m_currentPosition[i]  = Vector3::Zero();
-        frameData.m_currentNormal[i]    = Vector3::Zero();
-        frameData.m_currentTangent[i]   = Vector3::Zero();
-        frameData.m_currentBitangent[i] = Vector3::Zero();
-    }
-    for ( int k = 0; k < W.outerSize(); ++k ) {
-        const int nonZero = W.col( k ).nonZeros();
-        WeightMatrix::InnerIterator it0( W, k );
-#pragma omp parallel for
-        for ( int nz = 0; nz < nonZero; ++nz ) {
-            WeightMatrix::InnerIterator it = it0 + Eigen::Index( nz );
-            const uint i                   = it.row();
-            const uint j                   = it.col();
-            const Scalar w                 = it.value();
-            // prepare the pose w.r.t. the bind matrix and the mesh transform
-            const Transform M = refData.m_meshTransformInverse * pose[j] * bindMatrix[j];
-            // apply LBS
-            frameData.m_currentPosition[i] += w * ( M * vertices[i] );
-            frameData.m_currentNormal[i] += w * ( M.linear() * normals[i] );
-            frameData.m_currentTangent[i] += w * ( M.linear() * tangents[i] );
-            frameData.m_currentBitangent[i] += w * ( M.linear() * bitangents[i] );
+
+    // prepare the pose w.r.t. the bind matrix and the mesh transform, on packed 3x4 matrices
+    const Transform3x4 meshTransformInverse = toTransform3x4( refData.m_meshTransformInverse );
+    PackedPose matrices( pose.size() );
+    parallelFor( 0, int( pose.size() ), [&]( int j ) {
+        matrices[j] = compose( compose( meshTransformInverse, toTransform3x4( pose[j] ) ),
+                               toTransform3x4( bindMatrix[j] ) );
+    } );
+
+    // apply LBS, each vertex gathering its influences
+    const uint K = weights.m_influenceCount;
+    parallelFor( 0, int( frameData.m_currentPosition.size() ), [&]( int i ) {
+        const SingleWeight* influences = weights.m_influences.data() + size_t( i ) * K;
+        Transform3x4 M                 = Transform3x4::Zero();
+        for ( uint k = 0; k < K; ++k ) {
+            M += influences[k].second * matrices[influences[k].first];
         }
-    }
+        const auto R                    = M.leftCols<3>();
+        frameData.m_currentPosition[i]  = R * vertices[i] + M.col( 3 );
+        frameData.m_currentNormal[i]    = R * normals[i];
+        frameData.m_currentTangent[i]   = R * tangents[i];
+        frameData.m_currentBitangent[i] = R * bitangents[i];
+    } );
 }
 
 } // namespace Animation
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Core/Animation/HandleWeight.hpp>
 #include <Core/Containers/VectorArray.hpp>
 #include <Core/RaCore.hpp>
 
@@ -24,13 +25,29 @@ struct SkinningFrameData;
  * \f$\mathbf{v}_i^t = \sum_{s\in S}\omega_{is}\mathbf{R}_s\mathbf{v}_i^0\f$
  *
  * \note Assumes frameData is well sized.
- * \note Parallelized loop inside (using openmp).
+ * \note Parallelized loop inside (using parallelFor(), see Core/Tasks/Parallel.hpp).
+ * \note Packs refData.m_weights at each call, prefer the overload taking packed weights when
+ * skinning several frames.
  */
 // clang-format on
 void RA_CORE_API linearBlendSkinning( const SkinningRefData& refData,
                                       const Vector3Array& tangents,
                                       const Vector3Array& bitangents,
                                       SkinningFrameData& frameData );
+
+/**
+ * \brief Applies Linear-Blend skinning to the current frame, with the weights of
+ * refData.m_weights packed per vertex (see packWeights()).
+ *
+ * The skinning matrix \f$\mathbf{M}_s\f$ of each bone is computed once, then each vertex blends
+ * the matrices of its influences and transforms its position, normal, tangent and bitangent in a
+ * single pass.
+ */
+void RA_CORE_API linearBlendSkinning( const SkinningRefData& refData,
+                                      const PackedWeights& weights,
+                                      const Vector3Array& tangents,
+                                      const Vector3Array& bitangents,
+                                      SkinningFrameData& frameData );
 /// \}
 
 } // namespace Animation
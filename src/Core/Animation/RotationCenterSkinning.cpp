@@ -1,14 +1,21 @@
 #include <Core/Animation/RotationCenterSkinning.hpp>
 
 #include <array>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <unordered_map>
 
 #include <Core/Animation/DualQuaternionSkinning.hpp>
 #include <Core/Animation/HandleWeight.hpp>
+#include <Core/Animation/HandleWeightOperation.hpp>
 #include <Core/Animation/Pose.hpp>
 #include <Core/Animation/SkinningData.hpp>
 #include <Core/Geometry/TopologicalMesh.hpp>
+#include <Core/Tasks/Parallel.hpp>
 #include <Core/Utils/Log.hpp>
+#include <Core/Utils/StdUtils.hpp>
 
 namespace Ra {
 namespace Core {
@@ -16,56 +23,124 @@ namespace Animation {
 
 using namespace Utils; // log
 
-Scalar weightSimilarity( const Eigen::SparseVector<Scalar>& v1w,
-                         const Eigen::SparseVector<Scalar>& v2w,
-                         Scalar sigma ) {
-    const Scalar sigmaSq = sigma * sigma;
+namespace {
+// hashing function for Vector3
+struct hash_vec {
+    size_t operator()( const Vector3& lvalue ) const {
+        size_t result = 0;
+        hash_combine( result, lvalue[0] );
+        hash_combine( result, lvalue[1] );
+        hash_combine( result, lvalue[2] );
+        return result;
+    }
+};
+
+/// Weight vectors are clustered by their values quantized with a step of sigma times this ratio,
+/// the similarity varying with the weights at the scale of sigma. The members of a cluster, whose
+/// weights differ by less than a step, have similarities within about 1e-3 relative error of the
+/// ones of the first member, used for the whole cluster.
+constexpr Scalar s_weightQuantumRatio = Scalar( 1e-4 );
+
+/// The sorted (index, quantized weight) pairs of a weight vector.
+using WeightKey = std::vector<std::pair<int, int64_t>>;
+
+struct hash_weights {
+    size_t operator()( const WeightKey& key ) const {
+        size_t result = 0;
+        for ( const auto& w : key ) {
+            hash_combine( result, w.first );
+            hash_combine( result, w.second );
+        }
+        return result;
+    }
+};
 
-    Scalar result = 0;
-    // Iterating over non zero coefficients
-    for ( Eigen::SparseVector<Scalar>::InnerIterator it1( v1w ); it1; ++it1 ) {
-        const uint j      = it1.index();
-        const Scalar& W1j = it1.value();              // This one is necessarily non zero
-        const Scalar& W2j = v2w.coeff( it1.index() ); // This one may be 0.
+WeightKey getWeightKey( const Eigen::SparseVector<Scalar>& w, Scalar quantum ) {
+    WeightKey key;
+    key.reserve( w.nonZeros() );
+    for ( Eigen::SparseVector<Scalar>::InnerIterator it( w ); it; ++it ) {
+        key.emplace_back( int( it.index() ), std::llround( it.value() / quantum ) );
+    }
+    return key;
+}
 
-        if ( W2j > 0 ) {
-            for ( Eigen::SparseVector<Scalar>::InnerIterator it2( v2w ); it2; ++it2 ) {
-                const uint k      = it2.index();
-                const Scalar& W1k = v1w.coeff( it2.index() );
-                const Scalar& W2k = it2.value();
-                if ( j != k && W1k > 0 ) {
-                    const Scalar diff =
-                        std::exp( -Math::ipow<2>( ( W1j * W2k ) - ( W1k * W2j ) ) / ( sigmaSq ) );
-                    result += W1j * W1k * W2j * W2k * diff;
-                }
-            }
+/// Version of the CoR cache file format and of the computeCoR() results, to be increased when
+/// either changes.
+constexpr uint64_t s_corCacheVersion = 3;
+
+/// Header of the CoR cache files: the version, the key, the number of vertices,
+/// sizeof( Scalar ), the number of triangles, the number of handles and the number of non-zero
+/// weights.
+using CoRCacheHeader = std::array<uint64_t, 7>;
+
+size_t getCoRCacheKey( const SkinningRefData& data, Scalar sigma, Scalar weightEpsilon ) {
+    size_t key = 0;
+    hash_combine( key, sigma );
+    hash_combine( key, weightEpsilon );
+    for ( const auto& v : data.m_referenceMesh.vertices() ) {
+        hash_combine( key, hash_vec()( v ) );
+    }
+    for ( const auto& t : data.m_referenceMesh.getIndices() ) {
+        hash_combine( key, t[0] );
+        hash_combine( key, t[1] );
+        hash_combine( key, t[2] );
+    }
+    for ( int k = 0; k < data.m_weights.outerSize(); ++k ) {
+        for ( WeightMatrix::InnerIterator it( data.m_weights, k ); it; ++it ) {
+            hash_combine( key, it.row() );
+            hash_combine( key, it.col() );
+            hash_combine( key, it.value() );
         }
     }
-    return result;
+    return key;
 }
 
-void computeCoR( SkinningRefData& dataInOut, Scalar sigma, Scalar weightEpsilon ) {
-    LOG( logDEBUG ) << "Precomputing CoRs";
-
-    //
-    // First step : subdivide the original mesh until weights are sufficiently close enough.
-    //
+CoRCacheHeader
+getCoRCacheHeader( const SkinningRefData& data, Scalar sigma, Scalar weightEpsilon ) {
+    return { s_corCacheVersion,
+             uint64_t( getCoRCacheKey( data, sigma, weightEpsilon ) ),
+             uint64_t( data.m_referenceMesh.vertices().size() ),
+             uint64_t( sizeof( Scalar ) ),
+             uint64_t( data.m_referenceMesh.getIndices().size() ),
+             uint64_t( data.m_weights.cols() ),
+             uint64_t( data.m_weights.nonZeros() ) };
+}
 
-    // convert the mesh to TopologicalMesh for easy processing.
-    Geometry::TriangleMesh triMesh;
-    triMesh.copy( dataInOut.m_referenceMesh );
-    Geometry::TopologicalMesh topoMesh( triMesh );
+bool loadCoR( const std::string& filename, const CoRCacheHeader& header, Vector3Array& CoR ) {
+    std::ifstream file( filename, std::ios::binary );
+    if ( !file ) { return false; }
+    CoRCacheHeader fileHeader;
+    file.read( reinterpret_cast<char*>( fileHeader.data() ), sizeof( fileHeader ) );
+    if ( !file || fileHeader != header ) { return false; }
+    Vector3Array result( header[2] );
+    for ( auto& cor : result ) {
+        file.read( reinterpret_cast<char*>( cor.data() ), 3 * sizeof( Scalar ) );
+    }
+    if ( !file ) { return false; }
+    CoR = std::move( result );
+    return true;
+}
 
-    // hashing function for Vector3
-    struct hash_vec {
-        size_t operator()( const Ra::Core::Vector3& lvalue ) const {
-            size_t hx = std::hash<Scalar>()( lvalue[0] );
-            size_t hy = std::hash<Scalar>()( lvalue[1] );
-            size_t hz = std::hash<Scalar>()( lvalue[2] );
-            return ( hx ^ ( hy << 1 ) ) ^ hz;
-        }
-    };
+bool saveCoR( const std::string& filename, const CoRCacheHeader& header, const Vector3Array& CoR ) {
+    std::ofstream file( filename, std::ios::binary );
+    file.write( reinterpret_cast<const char*>( header.data() ), sizeof( header ) );
+    for ( const auto& cor : CoR ) {
+        file.write( reinterpret_cast<const char*>( cor.data() ), 3 * sizeof( Scalar ) );
+    }
+    return bool( file );
+}
 
+using RowMajorWeights = Eigen::SparseMatrix<Scalar, Eigen::RowMajor>;
+
+/// Subdivides \p topoMesh, built from the reference mesh of \p data, by repeated edge-split so
+/// that adjacent vertices weights are distant of at most \p weightEpsilon.
+/// Fills \p subdivW with the weights of the vertices of \p topoMesh, and \p vertexIndex with the
+/// index in \p topoMesh of each vertex of the reference mesh.
+void subdivideMesh( const SkinningRefData& data,
+                    Scalar weightEpsilon,
+                    Geometry::TopologicalMesh& topoMesh,
+                    RowMajorWeights& subdivW,
+                    std::vector<int>& vertexIndex ) {
     // fill map from vertex position to handle index, used to access the weight
     // matrix from initial mesh vertices
     std::unordered_map<Ra::Core::Vector3, int, hash_vec> mapV2I;
@@ -75,16 +150,15 @@ void computeCoR( SkinningRefData& dataInOut, Scalar sigma, Scalar weightEpsilon
 
     // Squash weight matrix to fit TopologicalMesh (access through handle indices)
     // Store the weights as row major here because we are going to query the per-vertex weights.
-    Eigen::SparseMatrix<Scalar, Eigen::RowMajor> subdivW;
-    const int numCols = dataInOut.m_weights.cols();
+    const int numCols = data.m_weights.cols();
     subdivW.resize( topoMesh.n_vertices(), numCols );
-    const auto& V = triMesh.vertices();
+    const auto& V = data.m_referenceMesh.vertices();
+    vertexIndex.resize( V.size() );
     for ( std::size_t i = 0; i < V.size(); ++i ) {
-        subdivW.row( mapV2I[V[i]] ) = dataInOut.m_weights.row( int( i ) );
+        vertexIndex[i]                = mapV2I[V[i]];
+        subdivW.row( vertexIndex[i] ) = data.m_weights.row( int( i ) );
     }
 
-    // The mesh will be subdivided by repeated edge-split, so that adjacent vertices
-    // weights are distant of at most `weightEpsilon`.
     // New vertices created by the edge splitting and their new weights are computed
     // and appended to the existing vertices.
     const Scalar wEps2       = weightEpsilon * weightEpsilon;
@@ -92,51 +166,45 @@ void computeCoR( SkinningRefData& dataInOut, Scalar sigma, Scalar weightEpsilon
     do {
         maxWeightDistance = 0;
 
-        // Stores the edges to split
-        std::vector<Geometry::TopologicalMesh::EdgeHandle> edgesToSplit;
+        // Compute all weights distances for all edges, in parallel.
+        const int numEdges = int( topoMesh.n_edges() );
+        std::vector<Scalar> weightDistances( numEdges );
+        parallelFor( 0, numEdges, [&]( int e ) {
+            const Geometry::TopologicalMesh::EdgeHandle edge( e );
+            int v0 = topoMesh.to_vertex_handle( topoMesh.halfedge_handle( edge, 0 ) ).idx();
+            int v1 = topoMesh.to_vertex_handle( topoMesh.halfedge_handle( edge, 1 ) ).idx();
 
-        // Compute all weights distances for all edges.
-        for ( auto e_it = topoMesh.edges_begin(); e_it != topoMesh.edges_end(); ++e_it ) {
-            const auto& he0 = topoMesh.halfedge_handle( *e_it, 0 );
-            const auto& he1 = topoMesh.halfedge_handle( *e_it, 1 );
-            int v0          = topoMesh.to_vertex_handle( he0 ).idx();
-            int v1          = topoMesh.to_vertex_handle( he1 ).idx();
+            weightDistances[e] = ( subdivW.row( v0 ) - subdivW.row( v1 ) ).squaredNorm();
+        } );
 
-            Scalar weightDistance = ( subdivW.row( v0 ) - subdivW.row( v1 ) ).squaredNorm();
-
-            maxWeightDistance = std::max( maxWeightDistance, weightDistance );
-            if ( weightDistance > wEps2 ) { edgesToSplit.push_back( *e_it ); }
+        // Stores the edges to split
+        std::vector<Geometry::TopologicalMesh::EdgeHandle> edgesToSplit;
+        for ( int e = 0; e < numEdges; ++e ) {
+            maxWeightDistance = std::max( maxWeightDistance, weightDistances[e] );
+            if ( weightDistances[e] > wEps2 ) { edgesToSplit.emplace_back( e ); }
         }
         LOG( logDEBUG ) << "Max weight distance is " << sqrt( maxWeightDistance );
 
         // sort edges to split according to growing weightDistance to avoid
         // creating edges larger than weightDistance
-        std::sort(
-            edgesToSplit.begin(),
-            edgesToSplit.end(),
-            [&topoMesh, &subdivW]( const auto& a, const auto& b ) {
-                const auto& a0 = topoMesh.to_vertex_handle( topoMesh.halfedge_handle( a, 0 ) );
-                const auto& a1 = topoMesh.to_vertex_handle( topoMesh.halfedge_handle( a, 1 ) );
-                Scalar la = ( subdivW.row( a0.idx() ) - subdivW.row( a1.idx() ) ).squaredNorm();
-                const auto& b0 = topoMesh.to_vertex_handle( topoMesh.halfedge_handle( b, 0 ) );
-                const auto& b1 = topoMesh.to_vertex_handle( topoMesh.halfedge_handle( b, 1 ) );
-                Scalar lb = ( subdivW.row( b0.idx() ) - subdivW.row( b1.idx() ) ).squaredNorm();
-                return ( la > lb );
-            } );
+        std::sort( edgesToSplit.begin(),
+                   edgesToSplit.end(),
+                   [&weightDistances]( const auto& a, const auto& b ) {
+                       return weightDistances[a.idx()] > weightDistances[b.idx()];
+                   } );
 
         // We found some edges over the limit, so we split them.
         if ( !edgesToSplit.empty() ) {
             LOG( logDEBUG ) << "Splitting " << edgesToSplit.size() << " edges";
             int startIndex = subdivW.rows();
 
-            Eigen::SparseMatrix<Scalar, Eigen::RowMajor> newWeights(
-                startIndex + edgesToSplit.size(), numCols );
+            RowMajorWeights newWeights( startIndex + edgesToSplit.size(), numCols );
 
             newWeights.topRows( startIndex ) = subdivW;
             subdivW                          = newWeights;
 
             int i = 0;
-            // Split ALL the edges !
+            // Split ALL the edges ! Splits change the topology, hence are done serially.
             for ( const auto& edge : edgesToSplit ) {
                 int v0 = topoMesh.to_vertex_handle( topoMesh.halfedge_handle( edge, 0 ) ).idx();
                 int v1 = topoMesh.to_vertex_handle( topoMesh.halfedge_handle( edge, 1 ) ).idx();
@@ -151,21 +219,14 @@ void computeCoR( SkinningRefData& dataInOut, Scalar sigma, Scalar weightEpsilon
 
     CORE_ASSERT( topoMesh.n_vertices() == size_t( subdivW.rows() ),
                  "Weights and vertices don't match" );
+}
 
-    //
-    // Second step : evaluate the integrals over all triangles for all vertices.
-    //
-
-    // naive implementation : iterate over all the triangles (of the subdivided mesh)
-    // for all vertices (of the original mesh).
-    const uint nVerts = V.size();
-    dataInOut.m_CoR.clear();
-    dataInOut.m_CoR.resize( nVerts, Vector3::Zero() );
-
-    // first precompute triangle data
-    std::map<Geometry::TopologicalMesh::FaceHandle,
-             std::tuple<Vector3, Scalar, Eigen::SparseVector<Scalar>>>
-        triangleData;
+/// Calls \p f( area, centroid, weights ) for each triangle of \p topoMesh, whose vertices
+/// weights are \p subdivW.
+template <typename Functor>
+void forEachTriangle( const Geometry::TopologicalMesh& topoMesh,
+                      const RowMajorWeights& subdivW,
+                      Functor f ) {
     for ( auto f_it = topoMesh.faces_begin(); f_it != topoMesh.faces_end(); ++f_it ) {
         // get needed data
         const auto& he0        = topoMesh.halfedge_handle( *f_it );
@@ -177,37 +238,174 @@ void computeCoR( SkinningRefData& dataInOut, Scalar sigma, Scalar weightEpsilon
         const auto& p0         = topoMesh.point( v0 );
         const auto& p1         = topoMesh.point( v1 );
         const auto& p2         = topoMesh.point( v2 );
-        const Vector3 centroid = ( p0 + p1 + p2 ) / 3.f;
         const Scalar area      = ( ( ( p1 - p0 ).cross( p2 - p0 ) ).norm() * 0.5 );
+        const Vector3 centroid = ( p0 + p1 + p2 ) / 3.f;
         const Eigen::SparseVector<Scalar> triWeight =
             ( 1 / 3.f ) *
             ( subdivW.row( v0.idx() ) + subdivW.row( v1.idx() ) + subdivW.row( v2.idx() ) );
-        triangleData[*f_it] = std::make_tuple( centroid, area, triWeight );
+        f( area, centroid, triWeight );
     }
+}
+} // namespace
 
-#pragma omp parallel for
-    for ( int i = 0; i < int( nVerts ); ++i ) {
+Scalar weightSimilarity( const Eigen::SparseVector<Scalar>& v1w,
+                         const Eigen::SparseVector<Scalar>& v2w,
+                         Scalar sigma ) {
+    const Scalar sigmaSq = sigma * sigma;
+
+    Scalar result = 0;
+    // Iterating over non zero coefficients
+    for ( Eigen::SparseVector<Scalar>::InnerIterator it1( v1w ); it1; ++it1 ) {
+        const uint j      = it1.index();
+        const Scalar& W1j = it1.value();              // This one is necessarily non zero
+        const Scalar& W2j = v2w.coeff( it1.index() ); // This one may be 0.
+
+        if ( W2j > 0 ) {
+            for ( Eigen::SparseVector<Scalar>::InnerIterator it2( v2w ); it2; ++it2 ) {
+                const uint k      = it2.index();
+                const Scalar& W1k = v1w.coeff( it2.index() );
+                const Scalar& W2k = it2.value();
+                if ( j != k && W1k > 0 ) {
+                    const Scalar diff =
+                        std::exp( -Math::ipow<2>( ( W1j * W2k ) - ( W1k * W2j ) ) / ( sigmaSq ) );
+                    result += W1j * W1k * W2j * W2k * diff;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+void computeCoR( SkinningRefData& dataInOut, Scalar sigma, Scalar weightEpsilon ) {
+    LOG( logDEBUG ) << "Precomputing CoRs";
+
+    //
+    // First step : subdivide the original mesh until weights are sufficiently close enough.
+    //
+
+    // convert the mesh to TopologicalMesh for easy processing.
+    Geometry::TriangleMesh triMesh;
+    triMesh.copy( dataInOut.m_referenceMesh );
+    Geometry::TopologicalMesh topoMesh( triMesh );
+    RowMajorWeights subdivW;
+    std::vector<int> vertexIndex;
+    subdivideMesh( dataInOut, weightEpsilon, topoMesh, subdivW, vertexIndex );
+
+    //
+    // Second step : evaluate the integrals over all triangles for all vertices.
+    //
+
+    // The similarity between two weight vectors being zero unless they share at least 2 non-zero
+    // weights, only such triangles are considered. Triangles (resp. vertices) with the same
+    // weights, up to the quantum, are clustered so that the integrals are evaluated once per
+    // cluster pair.
+    const Scalar quantum = sigma * s_weightQuantumRatio;
+    struct TriangleCluster {
+        Eigen::SparseVector<Scalar> m_weights;
+        Scalar m_area { 0_ra };
+        Vector3 m_centroid { Vector3::Zero() }; // weighted by the area
+    };
+    std::vector<TriangleCluster> triangleClusters;
+    std::unordered_map<WeightKey, size_t, hash_weights> triangleClusterIndex;
+    forEachTriangle( topoMesh,
+                     subdivW,
+                     [&]( Scalar area,
+                          const Vector3& centroid,
+                          const Eigen::SparseVector<Scalar>& triWeight ) {
+                         if ( triWeight.nonZeros() < 2 ) { return; }
+                         const auto it = triangleClusterIndex.emplace(
+                             getWeightKey( triWeight, quantum ), triangleClusters.size() );
+                         if ( it.second ) { triangleClusters.push_back( { triWeight } ); }
+                         auto& cluster = triangleClusters[it.first->second];
+                         cluster.m_area += area;
+                         cluster.m_centroid += area * centroid;
+                     } );
+
+    const uint nVerts = vertexIndex.size();
+    std::vector<int> vertexCluster( nVerts, -1 );
+    std::vector<Eigen::SparseVector<Scalar>> vertexClusterWeights;
+    std::unordered_map<WeightKey, size_t, hash_weights> vertexClusterIndex;
+    for ( uint i = 0; i < nVerts; ++i ) {
+        const Eigen::SparseVector<Scalar> Wi = subdivW.row( vertexIndex[i] );
+        if ( Wi.nonZeros() < 2 ) { continue; }
+        const auto it =
+            vertexClusterIndex.emplace( getWeightKey( Wi, quantum ), vertexClusterWeights.size() );
+        if ( it.second ) { vertexClusterWeights.push_back( Wi ); }
+        vertexCluster[i] = int( it.first->second );
+    }
+    LOG( logDEBUG ) << "CoR: " << vertexClusterWeights.size() << " vertex clusters, "
+                    << triangleClusters.size() << " triangle clusters";
+
+    Vector3Array clusterCoR( vertexClusterWeights.size(), Vector3::Zero() );
+    parallelFor( 0, int( clusterCoR.size() ), [&]( int c ) {
         Vector3 cor( 0, 0, 0 );
-        Scalar sumweight                     = 0;
-        const Eigen::SparseVector<Scalar> Wi = subdivW.row( mapV2I[V[i]] );
+        Scalar sumweight = 0;
 
         // Sum the cor and weights over all triangles of the subdivided mesh.
-        for ( auto f_it = topoMesh.faces_begin(); f_it != topoMesh.faces_end(); ++f_it ) {
-            const auto& triData     = triangleData[*f_it];
-            const Vector3& centroid = std::get<0>( triData );
-            Scalar area             = std::get<1>( triData );
-            const auto& triWeight   = std::get<2>( triData );
-            const Scalar s          = weightSimilarity( Wi, triWeight, sigma );
-            cor += s * area * centroid;
-            sumweight += s * area;
+        for ( const auto& cluster : triangleClusters ) {
+            const Scalar s = weightSimilarity( vertexClusterWeights[c], cluster.m_weights, sigma );
+            cor += s * cluster.m_centroid;
+            sumweight += s * cluster.m_area;
         }
 
+        // Avoid division by 0
+        if ( sumweight > 0 ) { clusterCoR[c] = cor / sumweight; }
+    } );
+
+    dataInOut.m_CoR.clear();
+    dataInOut.m_CoR.resize( nVerts, Vector3::Zero() );
+    for ( uint i = 0; i < nVerts; ++i ) {
+        if ( vertexCluster[i] != -1 ) { dataInOut.m_CoR[i] = clusterCoR[vertexCluster[i]]; }
+    }
+}
+
+void computeCoR_naive( SkinningRefData& dataInOut, Scalar sigma, Scalar weightEpsilon ) {
+    Geometry::TriangleMesh triMesh;
+    triMesh.copy( dataInOut.m_referenceMesh );
+    Geometry::TopologicalMesh topoMesh( triMesh );
+    RowMajorWeights subdivW;
+    std::vector<int> vertexIndex;
+    subdivideMesh( dataInOut, weightEpsilon, topoMesh, subdivW, vertexIndex );
+
+    const uint nVerts = vertexIndex.size();
+    dataInOut.m_CoR.clear();
+    dataInOut.m_CoR.resize( nVerts, Vector3::Zero() );
+    for ( uint i = 0; i < nVerts; ++i ) {
+        const Eigen::SparseVector<Scalar> Wi = subdivW.row( vertexIndex[i] );
+        Vector3 cor( 0, 0, 0 );
+        Scalar sumweight = 0;
+
+        // Sum the cor and weights over all triangles of the subdivided mesh.
+        forEachTriangle( topoMesh,
+                         subdivW,
+                         [&]( Scalar area,
+                              const Vector3& centroid,
+                              const Eigen::SparseVector<Scalar>& triWeight ) {
+                             const Scalar s = weightSimilarity( Wi, triWeight, sigma );
+                             cor += s * area * centroid;
+                             sumweight += s * area;
+                         } );
+
         // Avoid division by 0
         if ( sumweight > 0 ) { dataInOut.m_CoR[i] = cor / sumweight; }
+    }
+}
 
-#if defined CORE_DEBUG
-        if ( i % 100 == 0 ) { LOG( logDEBUG ) << "CoR: " << i << " / " << nVerts; }
-#endif // CORE_DEBUG
+void computeCoR( SkinningRefData& dataInOut,
+                 const std::string& cacheDirectory,
+                 Scalar sigma,
+                 Scalar weightEpsilon ) {
+    const auto header = getCoRCacheHeader( dataInOut, sigma, weightEpsilon );
+    std::ostringstream filename;
+    filename << cacheDirectory << "/cor_" << std::hex << std::setw( 16 ) << std::setfill( '0' )
+             << header[1] << ".bin";
+    if ( loadCoR( filename.str(), header, dataInOut.m_CoR ) ) {
+        LOG( logDEBUG ) << "CoRs loaded from " << filename.str();
+        return;
+    }
+    computeCoR( dataInOut, sigma, weightEpsilon );
+    if ( !saveCoR( filename.str(), header, dataInOut.m_CoR ) ) {
+        LOG( logWARNING ) << "Unable to save CoRs in " << filename.str();
     }
 }
 
@@ -215,49 +413,46 @@ void centerOfRotationSkinning( const SkinningRefData& refData,
                                const Vector3Array& tangents,
                                const Vector3Array& bitangents,
                                SkinningFrameData& frameData ) {
+    centerOfRotationSkinning(
+        refData, packWeights( refData.m_weights ), tangents, bitangents, frameData );
+}
+
+void centerOfRotationSkinning( const SkinningRefData& refData,
+                               const PackedWeights& weights,
+                               const Vector3Array& tangents,
+                               const Vector3Array& bitangents,
+                               SkinningFrameData& frameData ) {
     CORE_ASSERT( refData.m_CoR.size() == frameData.m_currentPosition.size(),
                  "Invalid center of rotations" );
+    CORE_ASSERT( weights.size() == frameData.m_currentPosition.size(),
+                 "Weights are incompatible with mesh." );
 
-    const auto& W        = refData.m_weights;
     const auto& vertices = refData.m_referenceMesh.vertices();
     const auto& normals  = refData.m_referenceMesh.normals();
     const auto& CoR      = refData.m_CoR;
     auto pose            = frameData.m_skeleton.getPose( HandleArray::SpaceType::MODEL );
 
     // prepare the pose w.r.t. the bind matrices
-#pragma omp parallel for
-    for ( int i = 0; i < int( frameData.m_skeleton.size() ); ++i ) {
+    parallelFor( 0, int( frameData.m_skeleton.size() ), [&]( int i ) {
         pose[i] = refData.m_meshTransformInverse * pose[i] * refData.m_bindMatrices[i];
-    }
+    } );
     // Compute the dual quaternions
-    const auto DQ = computeDQ( pose, W );
-
-    // Do LBS on the COR with weights of their associated vertices
-#pragma omp parallel for
-    for ( int i = 0; i < int( frameData.m_currentPosition.size() ); ++i ) {
-        frameData.m_currentPosition[i] = Vector3::Zero();
-    }
-    for ( int k = 0; k < W.outerSize(); ++k ) {
-        const int nonZero = W.col( k ).nonZeros();
-        WeightMatrix::InnerIterator it0( W, k );
-#pragma omp parallel for
-        for ( int nz = 0; nz < nonZero; ++nz ) {
-            WeightMatrix::InnerIterator it = it0 + Eigen::Index( nz );
-            const uint i                   = it.row();
-            const uint j                   = it.col();
-            const Scalar w                 = it.value();
-            frameData.m_currentPosition[i] += w * ( pose[j] * CoR[i] );
+    const auto DQ = computeDQ( pose, weights );
+
+    // Do LBS on the COR with weights of their associated vertices, then compute the final
+    // transformation
+    const uint K = weights.m_influenceCount;
+    parallelFor( 0, int( frameData.m_currentPosition.size() ), [&]( int i ) {
+        const SingleWeight* influences = weights.m_influences.data() + size_t( i ) * K;
+        Vector3 cor                    = Vector3::Zero();
+        for ( uint k = 0; k < K; ++k ) {
+            cor += influences[k].second * ( pose[influences[k].first] * CoR[i] );
         }
-    }
-
-    // Compute final transformation
-#pragma omp parallel for
-    for ( int i = 0; i < int( frameData.m_currentPosition.size() ); ++i ) {
-        frameData.m_currentPosition[i] += DQ[i].rotate( vertices[i] - CoR[i] );
+        frameData.m_currentPosition[i]  = cor + DQ[i].rotate( vertices[i] - CoR[i] );
         frameData.m_currentNormal[i]    = DQ[i].rotate( normals[i] );
         frameData.m_currentTangent[i]   = DQ[i].rotate( tangents[i] );
         frameData.m_currentBitangent[i] = DQ[i].rotate( bitangents[i] );
-    }
+    } );
 }
 
 } // namespace Animation
@@ -2,8 +2,11 @@
 
 #include <Core/RaCore.hpp>
 
+#include <Core/Animation/HandleWeight.hpp>
 #include <Core/Containers/VectorArray.hpp>
 
+#include <string>
+
 namespace Ra {
 namespace Core {
 namespace Animation {
@@ -31,13 +34,40 @@ struct SkinningFrameData;
  * and \f$\mathbf{v}_t = \frac{1}{3}(\mathbf{p}_{t_0}+\mathbf{p}_{t_1}+\mathbf{p}_{t_2})\f$
  * , \f$t_j\f$ being the \f$j\f$-th vertex of triangle \f$t\f$ and \f$\mathcal{A}_t\f$ its area.
  *
- * \note Parallelized loop inside (using openmp).
+ * Vertices, resp. triangles, with the same weights, up to a step proportional to \p sigma, are
+ * clustered so that the integrals are evaluated once per pair of clusters.
+ *
+ * \note Parallelized loops inside (using parallelFor(), see Core/Tasks/Parallel.hpp), but for
+ * the edge splits of the mesh subdivision.
  */
 // clang-format on
 void RA_CORE_API computeCoR( SkinningRefData& dataInOut,
                              Scalar sigma         = 0.1_ra,
                              Scalar weightEpsilon = 0.1_ra );
 
+/**
+ * \brief Default non-optimized, non-parallel implementation of computeCoR, evaluating the
+ * integrals over all triangles for each vertex.
+ */
+void RA_CORE_API computeCoR_naive( SkinningRefData& dataInOut,
+                                   Scalar sigma         = 0.1_ra,
+                                   Scalar weightEpsilon = 0.1_ra );
+
+/**
+ * \brief Computes the per-vertex optimal center of rotations as computeCoR(), reusing the ones
+ * stored in \p cacheDirectory for the same mesh, weights and parameters.
+ *
+ * The centers of rotation are stored in a file "cor_<key>.bin", the key being a hash of the
+ * reference mesh, the weights and the parameters. The file starts with seven 64 bits unsigned
+ * integers: the file version, the key, the number of vertices, sizeof( Scalar ), the number of
+ * triangles, the number of handles and the number of non-zero weights, followed by the centers
+ * of rotation. A file whose header does not match is ignored and overwritten.
+ */
+void RA_CORE_API computeCoR( SkinningRefData& dataInOut,
+                             const std::string& cacheDirectory,
+                             Scalar sigma         = 0.1_ra,
+                             Scalar weightEpsilon = 0.1_ra );
+
 // clang-format off
 /**
  * \brief Applies Center-of-Rotation skinning to the current frame.
@@ -63,13 +93,25 @@ void RA_CORE_API computeCoR( SkinningRefData& dataInOut,
  *
  *
  * \note Considers frameData is well sized.
- * \note Parallelized loop inside (using openmp).
+ * \note Parallelized loop inside (using parallelFor(), see Core/Tasks/Parallel.hpp).
+ * \note Packs refData.m_weights at each call, prefer the overload taking packed weights when
+ * skinning several frames.
  */
 // clang-format on
 void RA_CORE_API centerOfRotationSkinning( const SkinningRefData& refData,
                                            const Vector3Array& tangents,
                                            const Vector3Array& bitangents,
                                            SkinningFrameData& frameData );
+
+/**
+ * \brief Applies Center-of-Rotation skinning to the current frame, with the weights of
+ * refData.m_weights packed per vertex (see packWeights()).
+ */
+void RA_CORE_API centerOfRotationSkinning( const SkinningRefData& refData,
+                                           const PackedWeights& weights,
+                                           const Vector3Array& tangents,
+                                           const Vector3Array& bitangents,
+                                           SkinningFrameData& frameData );
 /// \}
 
 } // namespace Animation
@@ -2,12 +2,17 @@
 #include <Core/Math/LinearAlgebra.hpp> // Math::clamp
 
 #include <algorithm>
-#include <stack>
+#include <atomic>
 
 namespace Ra {
 namespace Core {
 namespace Animation {
 
+namespace {
+/// The last version given to a skeleton pose.
+std::atomic<uint64_t> s_lastPoseVersion { 0 };
+} // namespace
+
 /// CONSTRUCTOR
 Skeleton::Skeleton() : HandleArray(), m_graph(), m_modelSpace() {}
 
@@ -17,11 +22,19 @@ void Skeleton::clear() {
     m_pose.clear();
     m_graph.clear();
     m_modelSpace.clear();
+    m_updateOrder.clear();
+    m_updateParents.clear();
+    m_updateRank.clear();
+    m_dirty.clear();
+    m_firstDirty = 0;
+    updatePoseVersion();
 }
 
 const Pose& Skeleton::getPose( const SpaceType MODE ) const {
     static_assert( std::is_same<bool, typename std::underlying_type<SpaceType>::type>::value,
                    "SpaceType is not a boolean" );
+    CORE_ASSERT( MODE == SpaceType::LOCAL || !isModelSpaceOutdated(),
+                 "Model-space pose is outdated, call updateModelSpace()" );
     if ( MODE == SpaceType::LOCAL ) return m_pose;
     return m_modelSpace;
 }
@@ -31,31 +44,54 @@ void Skeleton::setPose( const Pose& pose, const SpaceType MODE ) {
     static_assert( std::is_same<bool, typename std::underlying_type<SpaceType>::type>::value,
                    "SpaceType is not a boolean" );
     if ( MODE == SpaceType::LOCAL ) {
-        m_pose = pose;
-        m_modelSpace.resize( m_pose.size() );
-        for ( uint i = 0; i < m_graph.size(); ++i ) {
-            if ( m_graph.isRoot( i ) ) { m_modelSpace[i] = m_pose[i]; }
-            for ( const auto& child : m_graph.children()[i] ) {
-                m_modelSpace[child] = m_modelSpace[i] * m_pose[child];
+        // only the bones whose transform changed, and their descendants, are updated
+        bool changed = false;
+        for ( uint i = 0; i < size(); ++i ) {
+            if ( m_pose[i].matrix() != pose[i].matrix() ) {
+                m_pose[i] = pose[i];
+                setDirty( i );
+                changed = true;
             }
         }
+        updateModelSpace();
+        if ( changed ) { updatePoseVersion(); }
     }
     else {
         m_modelSpace = pose;
-        m_pose.resize( m_modelSpace.size() );
-        for ( uint i = 0; i < m_graph.size(); ++i ) {
-            if ( m_graph.isRoot( i ) ) { m_pose[i] = m_modelSpace[i]; }
-            for ( const auto& child : m_graph.children()[i] ) {
-                m_pose[child] = m_modelSpace[i].inverse() * m_modelSpace[child];
+
+        const auto& parents = m_graph.parents();
+        for ( uint i = 0; i < size(); ++i ) {
+            const int parent = parents[i];
+            if ( parent == -1 ) { m_pose[i] = m_modelSpace[i]; }
+            else {
+                m_pose[i] = m_modelSpace[parent].inverse() * m_modelSpace[i];
             }
         }
+        std::fill( m_dirty.begin(), m_dirty.end(), 0 );
+        m_firstDirty = m_dirty.size();
+        updatePoseVersion();
     }
 }
 
+void Skeleton::setPose( const QTPose& pose ) {
+    CORE_ASSERT( ( size() == pose.size() ), "Size mismatching" );
+    PackedPose local;
+    PackedPose model;
+    pose.getPackedPose( local );
+    localToModel( local, m_graph.parents(), model );
+    toPose( local, m_pose );
+    toPose( model, m_modelSpace );
+    std::fill( m_dirty.begin(), m_dirty.end(), 0 );
+    m_firstDirty = m_dirty.size();
+    updatePoseVersion();
+}
+
 const Transform& Skeleton::getTransform( const uint i, const SpaceType MODE ) const {
     CORE_ASSERT( ( i < size() ), "Index i out of bounds" );
     static_assert( std::is_same<bool, typename std::underlying_type<SpaceType>::type>::value,
                    "SpaceType is not a boolean" );
+    CORE_ASSERT( MODE == SpaceType::LOCAL || !isModelSpaceOutdated(),
+                 "Model-space pose is outdated, call updateModelSpace()" );
     if ( MODE == SpaceType::LOCAL ) return m_pose[i];
     return m_modelSpace[i];
 }
@@ -64,6 +100,7 @@ void Skeleton::setTransform( const uint i, const Transform& T, const SpaceType M
     CORE_ASSERT( ( i < size() ), "Index i out of bounds" );
     static_assert( std::is_same<bool, typename std::underlying_type<SpaceType>::type>::value,
                    "SpaceType is not a boolean" );
+    updateModelSpace();
 
     switch ( m_manipulation ) {
     case FORWARD: {
@@ -99,24 +136,8 @@ void Skeleton::setTransform( const uint i, const Transform& T, const SpaceType M
 }
 
 void Skeleton::setLocalTransform( const uint i, const Transform& T ) {
-    m_pose[i] = T;
-    // Compute the model space pose
-    if ( m_graph.isRoot( i ) ) { m_modelSpace[i] = m_pose[i]; }
-    else {
-        m_modelSpace[i] = m_modelSpace[m_graph.parents()[i]] * T;
-    }
-    if ( !m_graph.isLeaf( i ) ) {
-        std::stack<uint> stack;
-        stack.push( i );
-        while ( !stack.empty() ) {
-            uint parent = stack.top();
-            stack.pop();
-            for ( const auto& child : m_graph.children()[parent] ) {
-                m_modelSpace[child] = m_modelSpace[parent] * m_pose[child];
-                stack.push( child );
-            }
-        }
-    }
+    setLocalTransformDeferred( i, T );
+    updateModelSpace();
 }
 
 void Skeleton::setModelTransform( const uint i, const Transform& T ) {
@@ -126,24 +147,88 @@ void Skeleton::setModelTransform( const uint i, const Transform& T ) {
     else {
         m_pose[i] = m_modelSpace[m_graph.parents()[i]].inverse() * T;
     }
+    // The Model-space transforms of the descendants being kept, only the children's Local-space
+    // transforms change.
     if ( !m_graph.isLeaf( i ) ) {
-        std::stack<uint> stack;
-        stack.push( i );
-        while ( !stack.empty() ) {
-            uint parent = stack.top();
-            stack.pop();
-            for ( const auto& child : m_graph.children()[parent] ) {
-                m_pose[child] = m_modelSpace[parent].inverse() * m_modelSpace[child];
-                stack.push( child );
+        const Transform invT = T.inverse();
+        for ( const auto& child : m_graph.children()[i] ) {
+            m_pose[child] = invT * m_modelSpace[child];
+        }
+    }
+    updatePoseVersion();
+}
+
+void Skeleton::setLocalTransformDeferred( const uint i, const Transform& T ) {
+    CORE_ASSERT( ( i < size() ), "Index i out of bounds" );
+    m_pose[i] = T;
+    setDirty( i );
+    updatePoseVersion();
+}
+
+void Skeleton::updateModelSpace() {
+    if ( !isModelSpaceOutdated() ) { return; }
+    // the dirty flags are propagated from parents to children along the breadth-first order
+    const size_t n = m_updateOrder.size();
+    for ( size_t k = m_firstDirty; k < n; ++k ) {
+        const int parent = m_updateParents[k];
+        if ( parent != -1 && m_dirty[parent] ) { m_dirty[k] = 1; }
+        if ( m_dirty[k] ) {
+            const uint bone = m_updateOrder[k];
+            if ( parent == -1 ) { m_modelSpace[bone] = m_pose[bone]; }
+            else {
+                m_modelSpace[bone] = m_modelSpace[m_updateOrder[parent]] * m_pose[bone];
             }
         }
     }
+    std::fill( m_dirty.begin() + m_firstDirty, m_dirty.end(), 0 );
+    m_firstDirty = n;
+}
+
+void Skeleton::setDirty( const uint i ) {
+    updateHierarchyOrder();
+    const size_t k = m_updateRank[i];
+    m_dirty[k]     = 1;
+    m_firstDirty   = std::min( m_firstDirty, k );
+}
+
+void Skeleton::updateHierarchyOrder() {
+    const uint n = size();
+    if ( m_updateOrder.size() == n ) { return; }
+    m_updateOrder.clear();
+    m_updateOrder.reserve( n );
+    for ( uint i = 0; i < n; ++i ) {
+        if ( m_graph.isRoot( i ) ) { m_updateOrder.push_back( i ); }
+    }
+    for ( size_t k = 0; k < m_updateOrder.size(); ++k ) {
+        for ( const auto& child : m_graph.children()[m_updateOrder[k]] ) {
+            m_updateOrder.push_back( child );
+        }
+    }
+    CORE_ASSERT( m_updateOrder.size() == n, "Invalid hierarchy" );
+    m_updateRank.resize( n );
+    for ( uint k = 0; k < n; ++k ) {
+        m_updateRank[m_updateOrder[k]] = k;
+    }
+    m_updateParents.resize( n );
+    for ( uint k = 0; k < n; ++k ) {
+        const int parent   = m_graph.parents()[m_updateOrder[k]];
+        m_updateParents[k] = ( parent == -1 ) ? -1 : int( m_updateRank[parent] );
+    }
+    // the whole Model-space pose is recomputed once for the new hierarchy
+    m_dirty.assign( n, 1 );
+    m_firstDirty = 0;
+}
+
+void Skeleton::updatePoseVersion() {
+    m_poseVersion = ++s_lastPoseVersion;
 }
 
 uint Skeleton::addRoot( const Transform& T, const Label label ) {
+    updateModelSpace();
     m_pose.push_back( T );
     m_modelSpace.push_back( T );
     m_label.push_back( label );
+    updatePoseVersion();
     return m_graph.addRoot();
 }
 
@@ -153,15 +238,17 @@ uint Skeleton::addBone( const uint parent,
                         const Label label ) {
     static_assert( std::is_same<bool, typename std::underlying_type<SpaceType>::type>::value,
                    "SpaceType is not a boolean" );
+    updateModelSpace();
     if ( MODE == SpaceType::LOCAL ) {
         m_pose.push_back( T );
-        m_modelSpace.push_back( T * m_modelSpace[parent] );
+        m_modelSpace.push_back( m_modelSpace[parent] * T );
     }
     else {
         m_modelSpace.push_back( T );
         m_pose.push_back( m_modelSpace[parent].inverse() * T );
     }
     m_label.push_back( label );
+    updatePoseVersion();
     return m_graph.addNode( parent );
 }
 
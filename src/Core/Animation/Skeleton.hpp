@@ -1,8 +1,11 @@
 #pragma once
 
+#include <Core/Animation/CompactPose.hpp>
 #include <Core/Animation/HandleArray.hpp>
 #include <Core/Containers/AdjacencyList.hpp>
 
+#include <vector>
+
 namespace Ra {
 namespace Core {
 namespace Animation {
@@ -41,6 +44,12 @@ class RA_CORE_API Skeleton : public HandleArray
     void clear() override;
     const Pose& getPose( const SpaceType MODE ) const override;
     void setPose( const Pose& pose, const SpaceType MODE ) override;
+
+    /**
+     * Sets the Local-space pose from its compact representation.
+     * \note The Model-space pose is propagated on packed 3x4 transforms, see localToModel().
+     */
+    void setPose( const QTPose& pose );
     const Transform& getTransform( const uint i, const SpaceType MODE ) const override;
 
     /**
@@ -49,6 +58,22 @@ class RA_CORE_API Skeleton : public HandleArray
      */
     void setTransform( const uint i, const Transform& T, const SpaceType MODE ) override;
 
+    /**
+     * Sets the \p i-th Local-space transform to \p T without updating the Model-space pose.
+     * The bone is flagged dirty until the next call to updateModelSpace(), so that several bones
+     * can be edited before a single traversal of the hierarchy.
+     */
+    void setLocalTransformDeferred( const uint i, const Transform& T );
+
+    /**
+     * Recomputes the Model-space transforms of the dirty bones and of their descendants only,
+     * going through the bones in breadth-first order.
+     */
+    void updateModelSpace();
+
+    /// Returns true if some Model-space transforms wait for updateModelSpace().
+    inline bool isModelSpaceOutdated() const { return m_firstDirty < m_dirty.size(); }
+
     /**
      * Add a new root transform to the skeleton.
      * @param T      the joint transform associated to the new bone
@@ -83,6 +108,14 @@ class RA_CORE_API Skeleton : public HandleArray
     /// Projects point \p pos, given in Model Space, onto the bone with index \p boneIdx.
     Vector3 projectOnBone( uint boneIdx, const Vector3& pos ) const;
 
+    /**
+     * Return the version of the pose, which changes each time the pose or the hierarchy are
+     * modified through the Skeleton methods.
+     * Versions are unique among all the skeletons, and copies of a skeleton share its version
+     * until they are modified, so that comparing versions tells whether two poses may differ.
+     */
+    inline uint64_t getPoseVersion() const { return m_poseVersion; }
+
     /// Stream insertion operator.
     friend std::ostream& operator<<( std::ostream& os, const Skeleton& skeleton );
 
@@ -101,6 +134,15 @@ class RA_CORE_API Skeleton : public HandleArray
      */
     void setModelTransform( uint i, const Transform& T );
 
+    /// Give a new version to the pose.
+    void updatePoseVersion();
+
+    /// Flags the \p i-th bone as dirty, see setLocalTransformDeferred().
+    void setDirty( uint i );
+
+    /// Builds the breadth-first update order of the bones if the hierarchy changed.
+    void updateHierarchyOrder();
+
   public:
     /// The Joint hierarchy.
     AdjacencyList m_graph;
@@ -111,6 +153,24 @@ class RA_CORE_API Skeleton : public HandleArray
   protected:
     /// Skeleton pose in MODEL space.
     ModelPose m_modelSpace;
+
+    /// The version of the pose.
+    uint64_t m_poseVersion { 0 };
+
+    /// The bones in breadth-first order, each bone coming after its parent.
+    std::vector<uint> m_updateOrder;
+
+    /// The position in m_updateOrder of the parent of each bone of m_updateOrder (-1 for roots).
+    std::vector<int> m_updateParents;
+
+    /// The position of each bone in m_updateOrder.
+    std::vector<uint> m_updateRank;
+
+    /// Whether the Model-space transform of each bone of m_updateOrder is outdated.
+    std::vector<char> m_dirty;
+
+    /// The first dirty position in m_updateOrder, m_dirty.size() if none.
+    size_t m_firstDirty { 0 };
 };
 
 } // namespace Animation
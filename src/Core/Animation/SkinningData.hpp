@@ -34,7 +34,14 @@ struct SkinningRefData {
     WeightMatrix m_weightSTBS;
 };
 
-/// \brief Pose data for one frame.
+/**
+ * \brief Pose data for one frame.
+ *
+ * The skinning functions write the skinned vertex data in the m_current* arrays.
+ * \note The SkinningComponent swaps these arrays with the ones of the skinned mesh once the
+ * skinning is done, so that they then hold the data of the previous frame, to be overwritten by
+ * the next skinning.
+ */
 struct SkinningFrameData {
     /// The animation skeleton in the current pose.
     Skeleton m_skeleton;
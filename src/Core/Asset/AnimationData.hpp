@@ -80,12 +80,17 @@ class RA_CORE_API AnimationData : public AssetData
     /**
      * \returns the list of HandleAnimations, i.e. the whole animation frames.
      */
-    inline std::vector<HandleAnimation> getHandleData() const;
+    inline const std::vector<HandleAnimation>& getHandleData() const;
 
     /**
      * Sets the animation frames.
      */
     inline void setHandleData( const std::vector<HandleAnimation>& frameList );
+
+    /**
+     * Sets the animation frames, without copying them.
+     */
+    inline void setHandleData( std::vector<HandleAnimation>&& frameList );
     /// \}
 
     /**
@@ -33,7 +33,7 @@ inline uint AnimationData::getFramesSize() const {
     return m_keyFrame.size();
 }
 
-inline std::vector<HandleAnimation> AnimationData::getHandleData() const {
+inline const std::vector<HandleAnimation>& AnimationData::getHandleData() const {
     return m_keyFrame;
 }
 
@@ -46,6 +46,10 @@ inline void AnimationData::setHandleData( const std::vector<HandleAnimation>& fr
     }
 }
 
+inline void AnimationData::setHandleData( std::vector<HandleAnimation>&& frameList ) {
+    m_keyFrame = std::move( frameList );
+}
+
 inline void AnimationData::displayInfo() const {
     using namespace Core::Utils; // log
     LOG( logDEBUG ) << "======== ANIMATION INFO ========";
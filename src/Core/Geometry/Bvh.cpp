@@ -0,0 +1,325 @@
+#include <Core/Geometry/Bvh.hpp>
+#include <Core/Tasks/Parallel.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/// Recursive binned SAH builder, see "On fast Construction of SAH-based Bounding Volume
+/// Hierarchies", Wald 2007.
+class Bvh::Builder
+{
+  public:
+    /// Bounds of the primitives of a node, and of their centroids.
+    struct Bounds {
+        Aabb aabb;
+        Aabb centroids;
+    };
+
+    explicit Builder( const std::vector<Aabb>& boxes ) : m_primitives( boxes.size() ) {
+        parallelFor( size_t( 0 ), boxes.size(), [this, &boxes]( size_t i ) {
+            m_primitives[i] = { boxes[i], boxes[i].center(), uint( i ) };
+        } );
+    }
+
+    /// Primitive indices, in the order of the leaves once built.
+    void getPrimitiveIndices( std::vector<uint>& primitiveIndices ) const {
+        primitiveIndices.resize( m_primitives.size() );
+        parallelFor( size_t( 0 ), m_primitives.size(), [this, &primitiveIndices]( size_t i ) {
+            primitiveIndices[i] = m_primitives[i].index;
+        } );
+    }
+
+    Bounds computeBounds( uint begin, uint end ) const;
+
+    /// Appends to \p nodes the subtree over the primitives [begin, end) of m_primitives,
+    /// in depth first order. The indices of the second children are relative to the start of
+    /// \p nodes.
+    void buildSubtree( std::vector<Node>& nodes,
+                       uint begin,
+                       uint end,
+                       const Bounds& bounds,
+                       uint depth );
+
+  private:
+    static constexpr int s_numBins = 16;
+    /// Cost of traversing a node, relatively to the cost of intersecting a primitive.
+    static constexpr Scalar s_traversalCost = 1_ra;
+    /// Ranges bigger than this are processed in parallel.
+    static constexpr uint s_parallelSize = 16384;
+    /// Nodes deeper than this are split at their median.
+    static constexpr uint s_maxSahDepth = 64;
+
+    struct Bin {
+        Aabb aabb;
+        uint count { 0 };
+    };
+    using Bins = std::array<std::array<Bin, s_numBins>, 3>;
+
+    /// Maps the centroids to the bins of each axis, the axes without extent being ignored.
+    /// Small nodes use less bins, which are cheaper to sweep.
+    struct Binning {
+        Binning( const Aabb& centroids, uint count ) :
+            origin( centroids.min() ), numBins( int( std::min( uint( s_numBins ), count ) ) ) {
+            const Vector3 extents = centroids.sizes();
+            for ( int axis = 0; axis < 3; ++axis ) {
+                scale[axis] = extents[axis] > 0_ra ? Scalar( numBins ) / extents[axis] : 0_ra;
+            }
+        }
+        bool isValid( int axis ) const { return scale[axis] > 0_ra; }
+        int index( const Vector3& centroid, int axis ) const {
+            return std::min( numBins - 1, int( ( centroid[axis] - origin[axis] ) * scale[axis] ) );
+        }
+
+        Vector3 origin;
+        Vector3 scale;
+        int numBins;
+    };
+
+    struct Split {
+        int axis { -1 };
+        int bin { 0 };
+        Scalar cost { std::numeric_limits<Scalar>::max() };
+        Aabb left;
+        Aabb right;
+    };
+
+    static Scalar surfaceArea( const Aabb& aabb ) {
+        if ( aabb.isEmpty() ) { return 0_ra; }
+        const Vector3 d = aabb.sizes();
+        return 2_ra * ( d.x() * d.y() + d.y() * d.z() + d.z() * d.x() );
+    }
+
+    Split findSplit( uint begin, uint end, const Bounds& bounds, const Binning& binning ) const;
+
+    void makeLeaf( Node& node, uint begin, uint end ) const {
+        node.index = begin;
+        node.count = end - begin;
+    }
+
+    /// The primitive data is reordered with the indices, so that nodes access contiguous memory.
+    struct Primitive {
+        Aabb aabb;
+        Vector3 centroid;
+        uint index;
+    };
+    std::vector<Primitive> m_primitives;
+};
+
+Bvh::Builder::Bounds Bvh::Builder::computeBounds( uint begin, uint end ) const {
+    const auto accumulate = [this]( uint b, uint e, Bounds bounds ) {
+        for ( uint i = b; i < e; ++i ) {
+            bounds.aabb.extend( m_primitives[i].aabb );
+            bounds.centroids.extend( m_primitives[i].centroid );
+        }
+        return bounds;
+    };
+    if ( end - begin < s_parallelSize ) { return accumulate( begin, end, Bounds() ); }
+    return parallelReduce( begin, end, Bounds(), accumulate, []( Bounds a, const Bounds& b ) {
+        a.aabb.extend( b.aabb );
+        a.centroids.extend( b.centroids );
+        return a;
+    } );
+}
+
+Bvh::Builder::Split Bvh::Builder::findSplit( uint begin,
+                                             uint end,
+                                             const Bounds& bounds,
+                                             const Binning& binning ) const {
+    const auto accumulate = [this, &binning]( uint b, uint e, Bins& bins ) {
+        for ( uint i = b; i < e; ++i ) {
+            const Primitive& p = m_primitives[i];
+            for ( int axis = 0; axis < 3; ++axis ) {
+                if ( !binning.isValid( axis ) ) { continue; }
+                Bin& bin = bins[axis][binning.index( p.centroid, axis )];
+                bin.aabb.extend( p.aabb );
+                ++bin.count;
+            }
+        }
+    };
+    Bins bins;
+    if ( end - begin < s_parallelSize ) { accumulate( begin, end, bins ); }
+    else {
+        bins = parallelReduce(
+            begin,
+            end,
+            Bins(),
+            [&accumulate]( uint b, uint e, Bins chunkBins ) {
+                accumulate( b, e, chunkBins );
+                return chunkBins;
+            },
+            [&binning]( Bins a, const Bins& b ) {
+                for ( int axis = 0; axis < 3; ++axis ) {
+                    for ( int i = 0; i < binning.numBins; ++i ) {
+                        a[axis][i].aabb.extend( b[axis][i].aabb );
+                        a[axis][i].count += b[axis][i].count;
+                    }
+                }
+                return a;
+            } );
+    }
+
+    // Sweep the bins of each axis, the cost of splitting after bin i being
+    // traversalCost + ( area(left) * count(left) + area(right) * count(right) ) / area(node).
+    Split split;
+    const Scalar invArea =
+        1_ra / std::max( surfaceArea( bounds.aabb ), std::numeric_limits<Scalar>::min() );
+    for ( int axis = 0; axis < 3; ++axis ) {
+        if ( !binning.isValid( axis ) ) { continue; }
+        std::array<Scalar, s_numBins - 1> rightCosts;
+        Aabb rightBox;
+        uint rightCount = 0;
+        for ( int i = binning.numBins - 1; i > 0; --i ) {
+            rightBox.extend( bins[axis][i].aabb );
+            rightCount += bins[axis][i].count;
+            rightCosts[i - 1] = surfaceArea( rightBox ) * Scalar( rightCount );
+        }
+        Aabb leftBox;
+        uint leftCount = 0;
+        for ( int i = 0; i < binning.numBins - 1; ++i ) {
+            leftBox.extend( bins[axis][i].aabb );
+            leftCount += bins[axis][i].count;
+            const Scalar cost =
+                s_traversalCost +
+                ( surfaceArea( leftBox ) * Scalar( leftCount ) + rightCosts[i] ) * invArea;
+            if ( cost < split.cost ) {
+                split.axis = axis;
+                split.bin  = i;
+                split.cost = cost;
+            }
+        }
+    }
+
+    // The children bounds are the union of their bins.
+    for ( int i = 0; i < binning.numBins; ++i ) {
+        ( i <= split.bin ? split.left : split.right ).extend( bins[split.axis][i].aabb );
+    }
+    return split;
+}
+
+void Bvh::Builder::buildSubtree( std::vector<Node>& nodes,
+                                 uint begin,
+                                 uint end,
+                                 const Bounds& bounds,
+                                 uint depth ) {
+    const size_t nodeIdx = nodes.size();
+    nodes.emplace_back();
+    nodes[nodeIdx].aabb = bounds.aabb;
+
+    const uint count = end - begin;
+    const Binning binning( bounds.centroids, count );
+    const bool canBin = binning.isValid( 0 ) || binning.isValid( 1 ) || binning.isValid( 2 );
+
+    uint mid = begin;
+    Bounds left, right;
+    if ( depth < s_maxSahDepth && canBin ) {
+        const Split split = findSplit( begin, end, bounds, binning );
+        // Make a leaf when splitting does not pay off, the cost of a leaf being its size.
+        if ( count <= s_maxLeafSize && split.cost >= Scalar( count ) ) {
+            makeLeaf( nodes[nodeIdx], begin, end );
+            return;
+        }
+        // Partition the primitives, computing the bounds of the children centroids.
+        left.aabb  = split.left;
+        right.aabb = split.right;
+        uint last  = end;
+        while ( mid < last ) {
+            const Vector3& centroid = m_primitives[mid].centroid;
+            if ( binning.index( centroid, split.axis ) <= split.bin ) {
+                left.centroids.extend( centroid );
+                ++mid;
+            }
+            else {
+                right.centroids.extend( centroid );
+                std::swap( m_primitives[mid], m_primitives[--last] );
+            }
+        }
+    }
+    else if ( count <= s_maxLeafSize ) {
+        makeLeaf( nodes[nodeIdx], begin, end );
+        return;
+    }
+
+    // Fall back to a median split for too deep nodes, or when the centroids cannot be separated.
+    if ( mid == begin || mid == end ) {
+        mid = begin + count / 2;
+        int axis;
+        bounds.centroids.sizes().maxCoeff( &axis );
+        std::nth_element( m_primitives.begin() + begin,
+                          m_primitives.begin() + mid,
+                          m_primitives.begin() + end,
+                          [axis]( const Primitive& a, const Primitive& b ) {
+                              return a.centroid[axis] < b.centroid[axis];
+                          } );
+        left  = computeBounds( begin, mid );
+        right = computeBounds( mid, end );
+    }
+
+    if ( count < s_parallelSize ) {
+        buildSubtree( nodes, begin, mid, left, depth + 1 );
+        nodes[nodeIdx].index = uint( nodes.size() );
+        buildSubtree( nodes, mid, end, right, depth + 1 );
+        return;
+    }
+
+    // Build both children in parallel, the second one in a separate array which is then
+    // appended, offsetting its second child indices.
+    std::vector<Node> secondChild;
+    parallelFor(
+        0,
+        2,
+        [&]( int child ) {
+            if ( child == 0 ) { buildSubtree( nodes, begin, mid, left, depth + 1 ); }
+            else { buildSubtree( secondChild, mid, end, right, depth + 1 ); }
+        },
+        1 );
+    const uint offset    = uint( nodes.size() );
+    nodes[nodeIdx].index = offset;
+    for ( auto& node : secondChild ) {
+        if ( !node.isLeaf() ) { node.index += offset; }
+    }
+    nodes.insert( nodes.end(), secondChild.begin(), secondChild.end() );
+}
+
+void Bvh::build( const std::vector<Aabb>& boxes ) {
+    clear();
+    if ( boxes.empty() ) { return; }
+    CORE_ASSERT( boxes.size() <= std::numeric_limits<uint>::max(), "Too many primitives" );
+
+    // A binary tree with leaves of at least one primitive.
+    m_nodes.reserve( 2 * boxes.size() - 1 );
+
+    Builder builder( boxes );
+    const uint size = uint( boxes.size() );
+    builder.buildSubtree( m_nodes, 0, size, builder.computeBounds( 0, size ), 0 );
+    builder.getPrimitiveIndices( m_primitiveIndices );
+    m_nodes.shrink_to_fit();
+}
+
+void Bvh::build( const VectorArray<Vector3>& vertices, const VectorArray<Vector3ui>& triangles ) {
+    std::vector<Aabb> boxes( triangles.size() );
+    parallelFor( size_t( 0 ), triangles.size(), [&vertices, &triangles, &boxes]( size_t i ) {
+        const Vector3ui& t = triangles[i];
+        Aabb& box          = boxes[i];
+        box.extend( vertices[t[0]] ).extend( vertices[t[1]] ).extend( vertices[t[2]] );
+        // Pad the box by the rounding error of the triangle intersection, so that hits on the
+        // triangle borders are found even when the ray grazes the box.
+        const Scalar pad = 4_ra * std::numeric_limits<Scalar>::epsilon() *
+                           box.min().cwiseAbs().cwiseMax( box.max().cwiseAbs() ).maxCoeff();
+        box.min().array() -= pad;
+        box.max().array() += pad;
+    } );
+    build( boxes );
+}
+
+void Bvh::clear() {
+    m_nodes.clear();
+    m_primitiveIndices.clear();
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <Core/Containers/VectorArray.hpp>
+#include <Core/Geometry/RayPacket.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/// \brief Bounding volume hierarchy over a set of primitives known by their bounding boxes.
+///
+/// The tree is built with the binned surface area heuristic (SAH), the biggest nodes being built
+/// in parallel with parallelFor() and parallelReduce(). Nodes are stored in a flat array, in depth
+/// first order : the first child of an interior node follows it, and the node stores the index of
+/// its second child. Leaves reference a range of primitiveIndices().
+///
+/// The Bvh does not store the primitives : queries call a functor with the primitive indices.
+/// \see TriangleMesh::getBvh(), RayCastTriangleMesh() and pointToMeshSq() for triangle meshes.
+class RA_CORE_API Bvh
+{
+  public:
+    struct Node {
+        Aabb aabb;
+        /// Leaf : first entry of the leaf in primitiveIndices().
+        /// Interior node : index of the second child, the first one being the next node.
+        uint index { 0 };
+        /// Number of primitives of a leaf, 0 for an interior node.
+        uint count { 0 };
+
+        inline bool isLeaf() const { return count > 0; }
+    };
+
+    /// Maximum number of primitives in a leaf, unless they cannot be separated.
+    static constexpr uint s_maxLeafSize = 4;
+
+    /// Maximum depth of the tree. Nodes deeper than 64 are split at their median, which bounds
+    /// the remaining depth by log2 of the number of primitives.
+    static constexpr uint s_maxDepth = 96;
+
+    /// Builds the hierarchy over the primitives, primitive i being bounded by \p boxes[i].
+    void build( const std::vector<Aabb>& boxes );
+
+    /// Builds the hierarchy over \p triangles, primitive i being \p triangles[i].
+    void build( const VectorArray<Vector3>& vertices, const VectorArray<Vector3ui>& triangles );
+
+    /// Removes all nodes.
+    void clear();
+
+    inline bool isEmpty() const { return m_nodes.empty(); }
+
+    /// Number of primitives the hierarchy has been built on.
+    inline size_t getNumPrimitives() const { return m_primitiveIndices.size(); }
+
+    inline const std::vector<Node>& getNodes() const { return m_nodes; }
+
+    /// Primitive indices, ordered such that each leaf covers a contiguous range.
+    inline const std::vector<uint>& getPrimitiveIndices() const { return m_primitiveIndices; }
+
+    /// Bounding box of all the primitives.
+    inline Aabb getAabb() const { return m_nodes.empty() ? Aabb() : m_nodes.front().aabb; }
+
+    /// Visits the leaves hit by the ray \p r for t in [0, tMax], nearest child first, and calls
+    /// \p f( primitiveIndex, tMax ) for each primitive of these leaves.
+    /// \p f gets tMax by reference and may reduce it (e.g. to the closest hit found so far), so
+    /// that the farther nodes are skipped.
+    template <typename Functor>
+    void traverse( const Ray& r, Scalar tMax, Functor&& f ) const;
+
+    /// Packet version of traverse(), visiting the leaves hit by at least one active ray of
+    /// \p rays. \p f( primitiveIndex, tMax ) gets the tMax of all the rays by reference, and
+    /// may reduce them.
+    template <int N, typename Functor>
+    void traverse( const RayPacket<N>& rays,
+                   typename RayPacket<N>::Lanes tMax,
+                   Functor&& f ) const;
+
+    /// Visits the leaves whose box is within sqrt( \p maxDistanceSquared ) of \p p, nearest
+    /// first, and calls \p f( primitiveIndex, maxDistanceSquared ) for each primitive of these
+    /// leaves. As for ray traversal, \p f may reduce maxDistanceSquared (e.g. to the distance of
+    /// the closest primitive found so far), so that the farther nodes are skipped.
+    template <typename Functor>
+    void traverse( const Vector3& p, Scalar maxDistanceSquared, Functor&& f ) const;
+
+  private:
+    class Builder;
+
+    std::vector<Node> m_nodes;
+    std::vector<uint> m_primitiveIndices;
+};
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#include <Core/Geometry/Bvh.inl>
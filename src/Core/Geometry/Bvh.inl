@@ -0,0 +1,233 @@
+#pragma once
+#include "Bvh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+namespace BvhDetail {
+/// Ray/box slab test, on [0, tMax]. \p tNearOut is the entry parameter of the ray in the box.
+/// The exit parameter is slightly enlarged so that rounding errors do not miss primitives lying
+/// on the box faces (see Ize, Robust BVH Ray Traversal, JCGT 2013).
+inline bool rayHitsAabb( const Aabb& box,
+                         const Vector3& origin,
+                         const Vector3& invDir,
+                         Scalar tMax,
+                         Scalar& tNearOut ) {
+    constexpr Scalar eps   = std::numeric_limits<Scalar>::epsilon();
+    constexpr Scalar scale = 1 + 2 * ( 3 * eps ) / ( 1 - 3 * eps );
+
+    Scalar tNear = 0;
+    Scalar tFar  = tMax;
+    for ( int i = 0; i < 3; ++i ) {
+        Scalar t0 = ( box.min()[i] - origin[i] ) * invDir[i];
+        Scalar t1 = ( box.max()[i] - origin[i] ) * invDir[i];
+        if ( t0 > t1 ) { std::swap( t0, t1 ); }
+        tNear = std::max( tNear, t0 );
+        tFar  = std::min( tFar, t1 * scale );
+        if ( tNear > tFar ) { return false; }
+    }
+    tNearOut = tNear;
+    return true;
+}
+} // namespace BvhDetail
+
+template <typename Functor>
+void Bvh::traverse( const Ray& r, Scalar tMax, Functor&& f ) const {
+    if ( m_nodes.empty() ) { return; }
+
+    // Null direction components are replaced by a tiny value, to get infinite slabs without
+    // producing NaNs when the origin lies on a box face.
+    constexpr Scalar tiny = std::numeric_limits<Scalar>::min();
+    Vector3 invDir;
+    for ( int i = 0; i < 3; ++i ) {
+        const Scalar d = r.direction()[i];
+        invDir[i]      = 1_ra / ( std::abs( d ) > tiny ? d : std::copysign( tiny, d ) );
+    }
+    const Vector3& origin = r.origin();
+
+    // The build bounds the depth of the tree, each level pushing at most one node.
+    struct StackEntry {
+        uint node;
+        Scalar tNear;
+    };
+    StackEntry stack[s_maxDepth];
+    int stackSize = 0;
+
+    Scalar tNear;
+    if ( !BvhDetail::rayHitsAabb( m_nodes[0].aabb, origin, invDir, tMax, tNear ) ) { return; }
+    stack[stackSize++] = { 0, tNear };
+
+    while ( stackSize > 0 ) {
+        const StackEntry entry = stack[--stackSize];
+        // tMax may have been reduced since the node has been pushed.
+        if ( entry.tNear > tMax ) { continue; }
+
+        uint nodeIdx = entry.node;
+        while ( true ) {
+            const Node& node = m_nodes[nodeIdx];
+            if ( node.isLeaf() ) {
+                for ( uint i = node.index; i < node.index + node.count; ++i ) {
+                    f( m_primitiveIndices[i], tMax );
+                }
+                break;
+            }
+
+            uint first  = nodeIdx + 1;
+            uint second = node.index;
+            Scalar tFirst, tSecond;
+            const bool hitFirst =
+                BvhDetail::rayHitsAabb( m_nodes[first].aabb, origin, invDir, tMax, tFirst );
+            const bool hitSecond =
+                BvhDetail::rayHitsAabb( m_nodes[second].aabb, origin, invDir, tMax, tSecond );
+
+            if ( hitFirst && hitSecond ) {
+                // Visit the nearest child first, the other one is pushed.
+                if ( tSecond < tFirst ) {
+                    std::swap( first, second );
+                    std::swap( tFirst, tSecond );
+                }
+                CORE_ASSERT( stackSize < int( s_maxDepth ), "Bvh traversal stack overflow" );
+                stack[stackSize++] = { second, tSecond };
+                nodeIdx            = first;
+            }
+            else if ( hitFirst ) { nodeIdx = first; }
+            else if ( hitSecond ) { nodeIdx = second; }
+            else { break; }
+        }
+    }
+}
+
+template <int N, typename Functor>
+void Bvh::traverse( const RayPacket<N>& rays,
+                    typename RayPacket<N>::Lanes tMax,
+                    Functor&& f ) const {
+    using Lanes = typename RayPacket<N>::Lanes;
+    using Mask  = typename RayPacket<N>::Mask;
+    if ( m_nodes.empty() ) { return; }
+
+    // Nodes are ordered by the nearest entry of the rays hitting them, and skipped when it is
+    // beyond the tMax of all the active rays.
+    const auto nearest = []( const Mask& hit, const Lanes& tNear ) -> Scalar {
+        const Lanes farthest = Lanes::Constant( std::numeric_limits<Scalar>::infinity() );
+        return hit.select( tNear, farthest ).minCoeff();
+    };
+    const auto activeTMax = [&rays]( const Lanes& tMax ) -> Scalar {
+        const Lanes lowest = Lanes::Constant( -std::numeric_limits<Scalar>::infinity() );
+        return rays.active.select( tMax, lowest ).maxCoeff();
+    };
+
+    struct StackEntry {
+        uint node;
+        Scalar tNear;
+    };
+    StackEntry stack[s_maxDepth];
+    int stackSize = 0;
+
+    Lanes tNear;
+    const Mask hit = RayCastAabb( rays, m_nodes[0].aabb, tMax, tNear );
+    if ( !hit.any() ) { return; }
+    stack[stackSize++] = { 0, nearest( hit, tNear ) };
+
+    while ( stackSize > 0 ) {
+        const StackEntry entry = stack[--stackSize];
+        // The tMax of the rays may have been reduced since the node has been pushed.
+        if ( entry.tNear > activeTMax( tMax ) ) { continue; }
+
+        uint nodeIdx = entry.node;
+        while ( true ) {
+            const Node& node = m_nodes[nodeIdx];
+            if ( node.isLeaf() ) {
+                for ( uint i = node.index; i < node.index + node.count; ++i ) {
+                    f( m_primitiveIndices[i], tMax );
+                }
+                break;
+            }
+
+            uint first  = nodeIdx + 1;
+            uint second = node.index;
+            Lanes tFirstLanes, tSecondLanes;
+            const Mask hitFirst = RayCastAabb( rays, m_nodes[first].aabb, tMax, tFirstLanes );
+            const Mask hitSecond =
+                RayCastAabb( rays, m_nodes[second].aabb, tMax, tSecondLanes );
+            const bool anyFirst  = hitFirst.any();
+            const bool anySecond = hitSecond.any();
+
+            if ( anyFirst && anySecond ) {
+                Scalar tFirst  = nearest( hitFirst, tFirstLanes );
+                Scalar tSecond = nearest( hitSecond, tSecondLanes );
+                if ( tSecond < tFirst ) {
+                    std::swap( first, second );
+                    std::swap( tFirst, tSecond );
+                }
+                CORE_ASSERT( stackSize < int( s_maxDepth ), "Bvh traversal stack overflow" );
+                stack[stackSize++] = { second, tSecond };
+                nodeIdx            = first;
+            }
+            else if ( anyFirst ) { nodeIdx = first; }
+            else if ( anySecond ) { nodeIdx = second; }
+            else { break; }
+        }
+    }
+}
+
+template <typename Functor>
+void Bvh::traverse( const Vector3& p, Scalar maxDistanceSquared, Functor&& f ) const {
+    if ( m_nodes.empty() ) { return; }
+
+    struct StackEntry {
+        uint node;
+        Scalar distanceSquared;
+    };
+    StackEntry stack[s_maxDepth];
+    int stackSize = 0;
+
+    const Scalar rootDistance = m_nodes[0].aabb.squaredExteriorDistance( p );
+    if ( rootDistance > maxDistanceSquared ) { return; }
+    stack[stackSize++] = { 0, rootDistance };
+
+    while ( stackSize > 0 ) {
+        const StackEntry entry = stack[--stackSize];
+        // maxDistanceSquared may have been reduced since the node has been pushed.
+        if ( entry.distanceSquared > maxDistanceSquared ) { continue; }
+
+        uint nodeIdx = entry.node;
+        while ( true ) {
+            const Node& node = m_nodes[nodeIdx];
+            if ( node.isLeaf() ) {
+                for ( uint i = node.index; i < node.index + node.count; ++i ) {
+                    f( m_primitiveIndices[i], maxDistanceSquared );
+                }
+                break;
+            }
+
+            uint first           = nodeIdx + 1;
+            uint second          = node.index;
+            Scalar dFirst        = m_nodes[first].aabb.squaredExteriorDistance( p );
+            Scalar dSecond       = m_nodes[second].aabb.squaredExteriorDistance( p );
+            const bool hitFirst  = dFirst <= maxDistanceSquared;
+            const bool hitSecond = dSecond <= maxDistanceSquared;
+
+            if ( hitFirst && hitSecond ) {
+                if ( dSecond < dFirst ) {
+                    std::swap( first, second );
+                    std::swap( dFirst, dSecond );
+                }
+                CORE_ASSERT( stackSize < int( s_maxDepth ), "Bvh traversal stack overflow" );
+                stack[stackSize++] = { second, dSecond };
+                nodeIdx            = first;
+            }
+            else if ( hitFirst ) { nodeIdx = first; }
+            else if ( hitSecond ) { nodeIdx = second; }
+            else { break; }
+        }
+    }
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,118 @@
+#include <Core/Geometry/DistanceQueries.hpp>
+#include <Core/Tasks/Parallel.hpp>
+
+#include <algorithm>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+namespace {
+/// Order of the query results : by distance, then by triangle index.
+bool isCloser( const PointToMeshOutput& a, const PointToMeshOutput& b ) {
+    return a.distanceSquared < b.distanceSquared ||
+           ( a.distanceSquared == b.distanceSquared && a.triangleIndex < b.triangleIndex );
+}
+
+PointToMeshOutput pointToMeshTriangleSq( const Vector3& q, const TriangleMesh& mesh, uint i ) {
+    const auto& t        = mesh.getIndices()[i];
+    const auto& vertices = mesh.vertices();
+    PointToMeshOutput output;
+    static_cast<PointToTriangleOutput&>( output ) =
+        pointToTriSq( q, vertices[t[0]], vertices[t[1]], vertices[t[2]] );
+    output.triangleIndex = i;
+    return output;
+}
+} // namespace
+
+PointToMeshOutput
+pointToMeshSq( const Vector3& q, const TriangleMesh& mesh, Scalar maxDistanceSquared ) {
+    PointToMeshOutput closest;
+    closest.distanceSquared = maxDistanceSquared;
+    mesh.getBvh().traverse( q, maxDistanceSquared, [&]( uint i, Scalar& maxDistance ) {
+        const PointToMeshOutput output = pointToMeshTriangleSq( q, mesh, i );
+        if ( output.distanceSquared <= maxDistance &&
+             ( !closest.isValid() || isCloser( output, closest ) ) ) {
+            closest     = output;
+            maxDistance = output.distanceSquared;
+        }
+    } );
+    return closest;
+}
+
+void pointToMeshSq( const Vector3Array& queries,
+                    const TriangleMesh& mesh,
+                    std::vector<PointToMeshOutput>& output,
+                    Scalar maxDistanceSquared ) {
+    // Build the Bvh once, before the parallel queries.
+    mesh.getBvh();
+    output.resize( queries.size() );
+    parallelFor( size_t( 0 ), queries.size(), [&]( size_t i ) {
+        output[i] = pointToMeshSq( queries[i], mesh, maxDistanceSquared );
+    } );
+}
+
+void kNearestTriangles( const Vector3& q,
+                        const TriangleMesh& mesh,
+                        size_t k,
+                        std::vector<PointToMeshOutput>& output ) {
+    output.clear();
+    if ( k == 0 ) { return; }
+    output.reserve( std::min( k, mesh.getIndices().size() ) );
+
+    // output is a max heap of the k nearest triangles found so far.
+    mesh.getBvh().traverse(
+        q, std::numeric_limits<Scalar>::max(), [&]( uint i, Scalar& maxDistance ) {
+            const PointToMeshOutput triangle = pointToMeshTriangleSq( q, mesh, i );
+            if ( output.size() < k ) {
+                output.push_back( triangle );
+                std::push_heap( output.begin(), output.end(), isCloser );
+            }
+            else if ( isCloser( triangle, output.front() ) ) {
+                std::pop_heap( output.begin(), output.end(), isCloser );
+                output.back() = triangle;
+                std::push_heap( output.begin(), output.end(), isCloser );
+            }
+            if ( output.size() == k ) { maxDistance = output.front().distanceSquared; }
+        } );
+    std::sort_heap( output.begin(), output.end(), isCloser );
+}
+
+void kNearestTriangles( const Vector3Array& queries,
+                        const TriangleMesh& mesh,
+                        size_t k,
+                        std::vector<std::vector<PointToMeshOutput>>& output ) {
+    mesh.getBvh();
+    output.resize( queries.size() );
+    parallelFor( size_t( 0 ), queries.size(), [&]( size_t i ) {
+        kNearestTriangles( queries[i], mesh, k, output[i] );
+    } );
+}
+
+void trianglesWithinRadius( const Vector3& q,
+                            const TriangleMesh& mesh,
+                            Scalar radius,
+                            std::vector<PointToMeshOutput>& output ) {
+    output.clear();
+    const Scalar radiusSquared = radius * radius;
+    mesh.getBvh().traverse( q, radiusSquared, [&]( uint i, Scalar& /*maxDistance*/ ) {
+        const PointToMeshOutput triangle = pointToMeshTriangleSq( q, mesh, i );
+        if ( triangle.distanceSquared <= radiusSquared ) { output.push_back( triangle ); }
+    } );
+    std::sort( output.begin(), output.end(), isCloser );
+}
+
+void trianglesWithinRadius( const Vector3Array& queries,
+                            const TriangleMesh& mesh,
+                            Scalar radius,
+                            std::vector<std::vector<PointToMeshOutput>>& output ) {
+    mesh.getBvh();
+    output.resize( queries.size() );
+    parallelFor( size_t( 0 ), queries.size(), [&]( size_t i ) {
+        trianglesWithinRadius( queries[i], mesh, radius, output[i] );
+    } );
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
@@ -4,6 +4,7 @@
 #include <Core/RaCore.hpp>
 #include <Core/Types.hpp>
 #include <limits>
+#include <vector>
 
 /// Functions in this file are utilities to compute the distance between various geometric sets.
 /// They always return the squared distance.
@@ -130,6 +131,63 @@ struct TriangleToTriangleOutput {
 inline RA_CORE_API TriangleToTriangleOutput triangleToTriSq( const Vector3 v1[3],
                                                              const Vector3 v2[3] );
 
+//
+// Point-to-mesh distance
+//
+// These queries use the mesh Bvh (see TriangleMesh::getBvh()), which is built on first use.
+// The batched versions process the query points in parallel (see parallelFor()).
+
+/// Structure holding the result of a point-to-mesh distance query.
+struct PointToMeshOutput : public PointToTriangleOutput {
+    /// Index of the hit triangle in TriangleMesh::getIndices(), or s_invalidTriangle.
+    uint triangleIndex { s_invalidTriangle };
+
+    static constexpr uint s_invalidTriangle = std::numeric_limits<uint>::max();
+
+    /// Return if a triangle has been found.
+    inline bool isValid() const { return triangleIndex != s_invalidTriangle; }
+};
+
+/// Computes the closest point of the mesh to a query point Q.
+/// Only the triangles within sqrt( maxDistanceSquared ) of Q are considered, the output being
+/// invalid if there is none. Ties are resolved by the lowest triangle index.
+RA_CORE_API PointToMeshOutput
+pointToMeshSq( const Vector3& q,
+               const TriangleMesh& mesh,
+               Scalar maxDistanceSquared = std::numeric_limits<Scalar>::max() );
+
+/// Batched version of pointToMeshSq(), \p output[i] being the closest point to \p queries[i].
+RA_CORE_API void pointToMeshSq( const Vector3Array& queries,
+                                const TriangleMesh& mesh,
+                                std::vector<PointToMeshOutput>& output,
+                                Scalar maxDistanceSquared = std::numeric_limits<Scalar>::max() );
+
+/// Computes the k triangles of the mesh nearest to a query point Q, in output, ordered by
+/// distance then by triangle index. Output has less than k entries when the mesh is smaller.
+RA_CORE_API void kNearestTriangles( const Vector3& q,
+                                    const TriangleMesh& mesh,
+                                    size_t k,
+                                    std::vector<PointToMeshOutput>& output );
+
+/// Batched version of kNearestTriangles(), \p output[i] being the result of \p queries[i].
+RA_CORE_API void kNearestTriangles( const Vector3Array& queries,
+                                    const TriangleMesh& mesh,
+                                    size_t k,
+                                    std::vector<std::vector<PointToMeshOutput>>& output );
+
+/// Computes the triangles of the mesh within \p radius of a query point Q, in output, ordered
+/// by distance then by triangle index.
+RA_CORE_API void trianglesWithinRadius( const Vector3& q,
+                                        const TriangleMesh& mesh,
+                                        Scalar radius,
+                                        std::vector<PointToMeshOutput>& output );
+
+/// Batched version of trianglesWithinRadius(), \p output[i] being the result of \p queries[i].
+RA_CORE_API void trianglesWithinRadius( const Vector3Array& queries,
+                                        const TriangleMesh& mesh,
+                                        Scalar radius,
+                                        std::vector<std::vector<PointToMeshOutput>>& output );
+
 } // namespace Geometry
 } // namespace Core
 } // namespace Ra
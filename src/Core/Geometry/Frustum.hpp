@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/// A view frustum, given by the 6 clipping planes of a view-projection matrix.
+class Frustum
+{
+  public:
+    /// Builds the frustum of the view-projection matrix \p viewProj, i.e. the set of points p such
+    /// that viewProj * p lies in the OpenGL clip volume.
+    inline explicit Frustum( const Matrix4& viewProj ) {
+        // Gribb-Hartmann extraction: w +/- x, w +/- y and w +/- z must be positive.
+        for ( int i = 0; i < 3; ++i ) {
+            m_planes.row( 2 * i )     = viewProj.row( 3 ) + viewProj.row( i );
+            m_planes.row( 2 * i + 1 ) = viewProj.row( 3 ) - viewProj.row( i );
+        }
+    }
+
+    /**
+     * Returns false if the box \p aabb is outside the frustum.
+     * The test is conservative: boxes crossing the extension of two planes near a corner of the
+     * frustum may be reported as intersecting, while being outside.
+     * \note Empty boxes are reported as intersecting, since their geometry is unknown.
+     */
+    inline bool intersects( const Aabb& aabb ) const {
+        if ( aabb.isEmpty() ) { return true; }
+        const Vector3 center = aabb.center();
+        const Vector3 extent = aabb.max() - center;
+        for ( int i = 0; i < 6; ++i ) {
+            const Vector3 n = m_planes.row( i ).head<3>();
+            // signed distance of the box vertex the farthest along the plane normal
+            if ( n.dot( center ) + n.cwiseAbs().dot( extent ) + m_planes( i, 3 ) < 0_ra ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Returns the planes ( a, b, c, d ) of the frustum, the points inside being such that
+    /// a x + b y + c z + d >= 0, in order left, right, bottom, top, near, far.
+    inline const Eigen::Matrix<Scalar, 6, 4>& planes() const { return m_planes; }
+
+  private:
+    Eigen::Matrix<Scalar, 6, 4> m_planes;
+};
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
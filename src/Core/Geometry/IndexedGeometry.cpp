@@ -1,5 +1,9 @@
 #include <Core/Geometry/IndexedGeometry.hpp>
+#include <Core/Geometry/StandardAttribNames.hpp>
+
+#include <atomic>
 #include <iterator>
+#include <mutex>
 
 namespace Ra {
 namespace Core {
@@ -259,6 +263,80 @@ std::size_t MultiIndexedGeometry::KeyHash::operator()( const LayerKeyType& k ) c
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
 
+/// The cache is shared with the observers, which only keep a weak reference as they may
+/// outlive the mesh (e.g. the vertex attribs are moved to another geometry).
+struct TriangleMesh::BvhCache {
+    std::mutex mutex;
+    Bvh bvh;
+    std::atomic<bool> valid { false };
+    /// Observed position attrib, and a token owned by its observer, which expires with the
+    /// attrib (e.g. when the attribs are copied from another geometry).
+    const Utils::AttribBase* positions { nullptr };
+    std::weak_ptr<void> positionsToken;
+
+    static Utils::ObservableVoid::Observer invalidate( const std::shared_ptr<BvhCache>& cache,
+                                                       std::shared_ptr<void> token = nullptr ) {
+        return [weakCache = std::weak_ptr<BvhCache>( cache ), token]() {
+            if ( auto c = weakCache.lock() ) { c->valid = false; }
+        };
+    }
+};
+
+TriangleMesh::TriangleMesh() : m_bvhCache( std::make_shared<BvhCache>() ) {
+    attachBvhObserver();
+}
+
+TriangleMesh::TriangleMesh( const TriangleMesh& other ) :
+    IndexedGeometry<Vector3ui>( other ), m_bvhCache( std::make_shared<BvhCache>() ) {
+    attachBvhObserver();
+}
+
+TriangleMesh::TriangleMesh( TriangleMesh&& other ) :
+    IndexedGeometry<Vector3ui>( std::move( other ) ),
+    m_bvhCache( std::make_shared<BvhCache>() ) {
+    attachBvhObserver();
+}
+
+// Assignments notify the observers, which invalidate the Bvh.
+TriangleMesh& TriangleMesh::operator=( const TriangleMesh& other ) {
+    IndexedGeometry<Vector3ui>::operator=( other );
+    return *this;
+}
+
+TriangleMesh& TriangleMesh::operator=( TriangleMesh&& other ) {
+    IndexedGeometry<Vector3ui>::operator=( std::move( other ) );
+    return *this;
+}
+
+void TriangleMesh::attachBvhObserver() {
+    attach( BvhCache::invalidate( m_bvhCache ) );
+}
+
+const Bvh& TriangleMesh::getBvh() const {
+    auto& cache = *m_bvhCache;
+    std::lock_guard<std::mutex> lock( cache.mutex );
+
+    // The position attrib changes when the attribs are replaced, observe the new one.
+    const auto* positions = getAttribBase( getAttribName( MeshAttrib::VERTEX_POSITION ) );
+    CORE_ASSERT( positions != nullptr, "TriangleMesh without vertex positions" );
+    if ( positions != cache.positions || cache.positionsToken.expired() ) {
+        auto token = std::make_shared<char>();
+        // Observers are not part of the attrib data, hence the const_cast.
+        const_cast<Utils::AttribBase*>( positions )
+            ->attach( BvhCache::invalidate( m_bvhCache, token ) );
+        cache.positions      = positions;
+        cache.positionsToken = token;
+        cache.valid          = false;
+    }
+
+    // Validate before building, so that a notification during the build is not lost.
+    if ( !cache.valid.exchange( true ) ) { cache.bvh.build( vertices(), getIndices() ); }
+    return cache.bvh;
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////
+
 void PointCloudIndexLayer::linearIndices( const AttribArrayGeometry& attr ) {
     auto nbVert = attr.vertices().size();
     collection().resize( nbVert );
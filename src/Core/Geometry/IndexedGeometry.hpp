@@ -2,12 +2,14 @@
 
 #include <Core/Containers/VectorArray.hpp>
 
+#include <Core/Geometry/Bvh.hpp>
 #include <Core/Geometry/TriangleMesh.hpp>
 
 #include <Core/Utils/ContainerIntrospectionInterface.hpp>
 #include <Core/Utils/ObjectWithSemantic.hpp>
 #include <Core/Utils/StdMapIterators.hpp>
 
+#include <memory>
 #include <unordered_map>
 
 namespace Ra {
@@ -547,8 +549,30 @@ class IndexedGeometry : public MultiIndexedGeometry
 class RA_CORE_API IndexedPointCloud : public IndexedGeometry<Vector1ui>
 {};
 
+/// \brief Triangle mesh, caching a Bvh over its triangles for ray casts.
 class RA_CORE_API TriangleMesh : public IndexedGeometry<Vector3ui>
-{};
+{
+  public:
+    TriangleMesh();
+    /// \note The Bvh is not copied, it is rebuilt on demand.
+    TriangleMesh( const TriangleMesh& other );
+    TriangleMesh( TriangleMesh&& other );
+    TriangleMesh& operator=( const TriangleMesh& other );
+    TriangleMesh& operator=( TriangleMesh&& other );
+
+    /// \brief Bvh over the triangles, primitive i being getIndices()[i].
+    ///
+    /// The Bvh is built on first call, and cached until it is invalidated by the observers of
+    /// the vertex position attrib or of the mesh (i.e. when vertices or indices change).
+    /// Can be called concurrently, as long as the mesh is not modified at the same time.
+    const Bvh& getBvh() const;
+
+  private:
+    struct BvhCache;
+    void attachBvhObserver();
+
+    std::shared_ptr<BvhCache> m_bvhCache;
+};
 
 class RA_CORE_API QuadMesh : public IndexedGeometry<Vector4ui>
 {};
@@ -16,6 +16,21 @@ void PolyLine::update() {
         len += m_ptsDiff.back().norm();
         m_lengths.push_back( len );
     }
+
+    m_bvh.clear();
+    if ( m_ptsDiff.size() >= s_minBvhSegments ) {
+        std::vector<Aabb> boxes( m_ptsDiff.size() );
+        for ( uint i = 0; i < m_ptsDiff.size(); ++i ) {
+            Aabb& box = boxes[i];
+            box.extend( m_pts[i] ).extend( m_pts[i + 1] );
+            // Pad the box by the rounding error of the projection on the segment.
+            const Scalar pad = 4_ra * std::numeric_limits<Scalar>::epsilon() *
+                               box.min().cwiseAbs().cwiseMax( box.max().cwiseAbs() ).maxCoeff();
+            box.min().array() -= pad;
+            box.max().array() += pad;
+        }
+        m_bvh.build( boxes );
+    }
 }
 
 PolyLine::PolyLine( const Vector3Array& pts ) : m_pts( pts ) {
@@ -28,11 +43,8 @@ void PolyLine::setPoints( const Vector3Array& pts ) {
 }
 
 Scalar PolyLine::squaredDistance( const Vector3& p ) const {
-    CORE_ASSERT( m_pts.size() > 1, "Line must have at least two points" );
-    Scalar sqDist = std::numeric_limits<Scalar>::max();
-    for ( uint i = 0; i < m_ptsDiff.size(); ++i ) {
-        sqDist = std::min( Geometry::pointToSegmentSq( p, m_pts[i], m_ptsDiff[i] ), sqDist );
-    }
+    Scalar sqDist;
+    getNearestSegment( p, sqDist );
     return sqDist;
 }
 
@@ -47,32 +59,27 @@ Scalar PolyLine::projectOnSegment( const Vector3& p, uint segment ) const {
 }
 
 Scalar PolyLine::project( const Vector3& p ) const {
-    CORE_ASSERT( m_pts.size() > 1, "Line must have at least two points" );
-    Scalar sqDist = std::numeric_limits<Scalar>::max();
-    uint segment  = 0;
-    std::vector<Scalar> ts;
-    std::vector<Scalar> ds;
-    ts.reserve( m_ptsDiff.size() );
-    ds.reserve( m_ptsDiff.size() );
-
-    for ( uint i = 0; i < m_ptsDiff.size(); ++i ) {
-        Scalar proj = Geometry::projectOnSegment( p, m_pts[i], m_ptsDiff[i] );
-        Scalar d    = ( p - ( m_pts[i] + proj * ( m_ptsDiff[i] ) ) ).squaredNorm();
-        ds.push_back( d );
-        ts.push_back( proj );
-        if ( d < sqDist ) {
-            sqDist  = d;
-            segment = i;
-        }
-    }
-
-    CORE_ASSERT( segment < m_ptsDiff.size(), "Invalid index" );
-    Scalar t = ts[segment];
+    const uint segment     = getNearestSegment( p );
+    const auto projectOnto = [this, &p]( uint i ) {
+        return Geometry::projectOnSegment( p, m_pts[i], m_ptsDiff[i] );
+    };
+    const auto squaredDistanceTo = [this, &p]( uint i, Scalar proj ) {
+        return ( p - ( m_pts[i] + proj * ( m_ptsDiff[i] ) ) ).squaredNorm();
+    };
+
+    const Scalar t = projectOnto( segment );
     if ( t > 0 && t < 1 ) {
-        bool prev = segment > 0 && ts[segment - 1] > 0 && ts[segment - 1] < 1;
-        bool next = segment < m_ptsDiff.size() - 1 && ts[segment + 1] > 0 && ts[segment + 1] < 1;
+        const bool hasPrev = segment > 0;
+        const bool hasNext = segment < m_ptsDiff.size() - 1;
+        const Scalar tPrev = hasPrev ? projectOnto( segment - 1 ) : 0_ra;
+        const Scalar tNext = hasNext ? projectOnto( segment + 1 ) : 0_ra;
+        bool prev          = hasPrev && tPrev > 0 && tPrev < 1;
+        bool next          = hasNext && tNext > 0 && tNext < 1;
         if ( prev || next ) {
-            if ( prev && next ) { prev = ds[segment - 1] < ds[segment + 1]; }
+            if ( prev && next ) {
+                prev = squaredDistanceTo( segment - 1, tPrev ) <
+                       squaredDistanceTo( segment + 1, tNext );
+            }
             uint i     = prev ? segment - 1 : segment;
             Vector3 ba = -m_ptsDiff[i];
             Vector3 bc = m_ptsDiff[i + 1];
@@ -80,8 +87,8 @@ Scalar PolyLine::project( const Vector3& p ) const {
             Scalar c1  = Math::cotan( ba, bp );
             Scalar c2  = Math::cotan( bp, bc );
 
-            Scalar t1 = getLineParameter( i, ts[i] );
-            Scalar t2 = getLineParameter( i + 1, ts[i + 1] );
+            Scalar t1 = getLineParameter( i, prev ? tPrev : t );
+            Scalar t2 = getLineParameter( i + 1, prev ? t : tNext );
             return ( c1 * t1 + c2 * t2 ) / ( c1 + c2 );
         }
     }
@@ -107,19 +114,38 @@ Vector3 PolyLine::f( Scalar t ) const {
 }
 
 uint PolyLine::getNearestSegment( const Vector3& p ) const {
+    Scalar sqDist;
+    return getNearestSegment( p, sqDist );
+}
+
+uint PolyLine::getNearestSegment( const Vector3& p, Scalar& sqDistOut ) const {
     CORE_ASSERT( m_pts.size() > 1, "Line must have at least two points" );
     Scalar sqDist = std::numeric_limits<Scalar>::max();
     uint segment  = 0;
-    for ( uint i = 0; i < m_ptsDiff.size(); ++i ) {
+
+    const auto testSegment = [this, &p, &sqDist, &segment]( uint i ) {
         Scalar proj = Geometry::projectOnSegment( p, m_pts[i], m_ptsDiff[i] );
         Scalar d    = ( p - ( m_pts[i] + proj * ( m_ptsDiff[i] ) ) ).squaredNorm();
-        if ( d < sqDist ) {
+        if ( d < sqDist || ( d == sqDist && i < segment ) ) {
             sqDist  = d;
             segment = i;
         }
+        return sqDist;
+    };
+
+    if ( m_bvh.isEmpty() ) {
+        for ( uint i = 0; i < m_ptsDiff.size(); ++i ) {
+            testSegment( i );
+        }
+    }
+    else {
+        m_bvh.traverse( p, sqDist, [&testSegment]( uint i, Scalar& maxDistanceSquared ) {
+            maxDistanceSquared = testSegment( i );
+        } );
     }
 
     CORE_ASSERT( segment < m_ptsDiff.size(), "Invalid index" );
+    sqDistOut = sqDist;
     return segment;
 }
 
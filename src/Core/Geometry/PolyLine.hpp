@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Core/Containers/VectorArray.hpp>
+#include <Core/Geometry/Bvh.hpp>
 #include <Core/Geometry/DistanceQueries.hpp>
 #include <Core/RaCore.hpp>
 #include <Core/Types.hpp>
@@ -10,10 +11,14 @@ namespace Core {
 namespace Geometry {
 /// A parametrized polyline, i.e. a continuous polygonal chain of segments.
 /// Points go from P0 to Pn. The ith segments joins Pi and Pi+1.
+/// Distance queries on long polylines use a Bvh over the segments.
 class RA_CORE_API PolyLine
 {
 
   public:
+    /// Polylines with at least this number of segments get a Bvh.
+    static constexpr uint s_minBvhSegments = 16;
+
     /// Create a polyline from a given set of points.
     explicit PolyLine( const Vector3Array& pt );
 
@@ -68,6 +73,10 @@ class RA_CORE_API PolyLine
     /// in the whole line parametrization.
     inline Scalar getLineParameter( uint segment, Scalar tSegment ) const;
 
+    /// Returns the index of the nearest segment, and its squared distance in \p sqDistOut.
+    /// Ties are resolved by the lowest segment index.
+    uint getNearestSegment( const Vector3& p, Scalar& sqDistOut ) const;
+
   private:
     // Stores the points Pi
     Vector3Array m_pts;
@@ -75,6 +84,8 @@ class RA_CORE_API PolyLine
     Vector3Array m_ptsDiff;
     // Length from origin to point Pi+1.
     std::vector<Scalar> m_lengths;
+    // Hierarchy over the segments, empty for short lines.
+    Bvh m_bvh;
 };
 
 } // namespace Geometry
@@ -1,6 +1,12 @@
 #include <Core/Geometry/RayCast.hpp>
+#include <Core/Geometry/RayPacket.hpp>
 #include <Core/Geometry/TriangleMesh.hpp>
 #include <Core/Math/LinearAlgebra.hpp> // Math::sign
+#include <Core/Tasks/Parallel.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
 
 namespace Ra {
 namespace Core {
@@ -276,6 +282,17 @@ bool RayCastTriangle( const Ray& ray,
                       const Vector3& b,
                       const Vector3& c,
                       std::vector<Scalar>& hitsOut ) {
+    Scalar t;
+    const bool hit = RayCastTriangle( ray, a, b, c, t );
+    if ( hit ) { hitsOut.push_back( t ); }
+    return hit;
+}
+
+bool RayCastTriangle( const Ray& ray,
+                      const Vector3& a,
+                      const Vector3& b,
+                      const Vector3& c,
+                      Scalar& hitOut ) {
     const Vector3 ab = b - a;
     const Vector3 ac = c - a;
 
@@ -314,7 +331,7 @@ bool RayCastTriangle( const Ray& ray,
 
     // If we're here we really intersect the triangle so let's compute T.
     const Scalar t = ac.dot( qvec ) * inv_det;
-    if ( t >= 0 ) { hitsOut.push_back( t ); }
+    if ( t >= 0 ) { hitOut = t; }
     return ( t >= 0 );
 }
 
@@ -322,12 +339,117 @@ bool RayCastTriangleMesh( const Ray& r,
                           const TriangleMesh& mesh,
                           std::vector<Scalar>& hitsOut,
                           std::vector<Vector3ui>& trianglesIdxOut ) {
+    const auto& triangles = mesh.getIndices();
+    const auto& vertices  = mesh.vertices();
+
+    std::vector<std::pair<uint, Scalar>> hits;
+    mesh.getBvh().traverse(
+        r, std::numeric_limits<Scalar>::infinity(), [&]( uint i, Scalar& /*tMax*/ ) {
+            const auto& t = triangles[i];
+            Scalar hit;
+            if ( RayCastTriangle( r, vertices[t[0]], vertices[t[1]], vertices[t[2]], hit ) ) {
+                hits.emplace_back( i, hit );
+            }
+        } );
+
+    // Report the hits in triangle order, as the brute force version.
+    std::sort( hits.begin(), hits.end(), []( const auto& a, const auto& b ) {
+        return a.first < b.first;
+    } );
+    for ( const auto& hit : hits ) {
+        hitsOut.push_back( hit.second );
+        trianglesIdxOut.push_back( triangles[hit.first] );
+    }
+    return !hits.empty();
+}
+
+bool RayCastTriangleMesh( const Ray& r,
+                          const TriangleMesh& mesh,
+                          Scalar& hitOut,
+                          Vector3ui& triangleIdxOut ) {
+    const auto& triangles = mesh.getIndices();
+    const auto& vertices  = mesh.vertices();
+
+    // Closest hit, ties being resolved by the lowest triangle index.
+    uint closest = std::numeric_limits<uint>::max();
+    Scalar tMin  = std::numeric_limits<Scalar>::infinity();
+    mesh.getBvh().traverse( r, tMin, [&]( uint i, Scalar& tMax ) {
+        const auto& t = triangles[i];
+        Scalar hit;
+        if ( RayCastTriangle( r, vertices[t[0]], vertices[t[1]], vertices[t[2]], hit ) &&
+             ( hit < tMin || ( hit == tMin && i < closest ) ) ) {
+            tMin    = hit;
+            closest = i;
+            tMax    = hit;
+        }
+    } );
+
+    if ( closest == std::numeric_limits<uint>::max() ) { return false; }
+    hitOut         = tMin;
+    triangleIdxOut = triangles[closest];
+    return true;
+}
+
+size_t RayCastTriangleMesh( const std::vector<Ray>& rays,
+                            const TriangleMesh& mesh,
+                            Eigen::Ref<VectorN> hitsOut,
+                            Eigen::Ref<VectorNi> trianglesIdxOut ) {
+    CORE_ASSERT( size_t( hitsOut.size() ) == rays.size(), "Wrong hits buffer size" );
+    CORE_ASSERT( size_t( trianglesIdxOut.size() ) == rays.size(), "Wrong triangles buffer size" );
+    using Packet = RayPacket<8>;
+    using Lanes  = Packet::Lanes;
+    using Mask   = Packet::Mask;
+    using Ints   = Eigen::Array<int, Packet::Size, 1>;
+
+    const auto& triangles = mesh.getIndices();
+    const auto& vertices  = mesh.vertices();
+    const Bvh& bvh        = mesh.getBvh();
+
+    const size_t numPackets = ( rays.size() + Packet::Size - 1 ) / Packet::Size;
+    const auto tracePackets = [&]( size_t begin, size_t end, size_t numHits ) {
+        for ( size_t p = begin; p < end; ++p ) {
+            const size_t first = p * Packet::Size;
+            const int count    = int( std::min( size_t( Packet::Size ), rays.size() - first ) );
+            const Packet packet( rays.data() + first, count );
+
+            // Closest hits, ties being resolved by the lowest triangle index.
+            Lanes tMin   = Lanes::Constant( std::numeric_limits<Scalar>::infinity() );
+            Ints closest = Ints::Constant( -1 );
+            bvh.traverse( packet, tMin, [&]( uint i, Lanes& tMax ) {
+                const auto& t = triangles[i];
+                Lanes hit     = tMin;
+                const Mask isHit =
+                    RayCastTriangle( packet, vertices[t[0]], vertices[t[1]], vertices[t[2]], hit );
+                if ( !isHit.any() ) { return; }
+                const Mask closer =
+                    isHit && ( hit < tMin || ( hit == tMin && closest > int( i ) ) );
+                tMin    = closer.select( hit, tMin );
+                closest = closer.select( Ints::Constant( int( i ) ), closest );
+                tMax    = tMin;
+            } );
+
+            hitsOut.segment( first, count )         = tMin.head( count ).matrix();
+            trianglesIdxOut.segment( first, count ) = closest.head( count ).matrix();
+            numHits += size_t( ( closest.head( count ) >= 0 ).count() );
+        }
+        return numHits;
+    };
+    return parallelReduce(
+        size_t( 0 ), numPackets, size_t( 0 ), tracePackets, std::plus<size_t>() );
+}
+
+bool RayCastTriangleMeshBruteForce( const Ray& r,
+                                    const TriangleMesh& mesh,
+                                    std::vector<Scalar>& hitsOut,
+                                    std::vector<Vector3ui>& trianglesIdxOut ) {
+    const auto& triangles = mesh.getIndices();
+    const auto& vertices  = mesh.vertices();
+
     bool hit = false;
-    for ( size_t i = 0; i < mesh.getIndices().size(); ++i ) {
-        const auto& t    = mesh.getIndices()[i];
-        const Vector3& a = mesh.vertices()[t[0]];
-        const Vector3& b = mesh.vertices()[t[1]];
-        const Vector3& c = mesh.vertices()[t[2]];
+    for ( const auto& t : triangles ) {
+        const Vector3& a = vertices[t[0]];
+        const Vector3& b = vertices[t[1]];
+        const Vector3& c = vertices[t[2]];
         if ( RayCastTriangle( r, a, b, c, hitsOut ) ) {
             trianglesIdxOut.push_back( t );
             hit = true;
@@ -48,10 +48,45 @@ bool RA_CORE_API RayCastTriangle( const Ray& r,
                                   const Core::Vector3& c,
                                   std::vector<Scalar>& hitsOut );
 
+/// Intersect a ray with a triangle abc, the hit is written in \p hitOut.
+bool RA_CORE_API RayCastTriangle( const Ray& r,
+                                  const Core::Vector3& a,
+                                  const Core::Vector3& b,
+                                  const Core::Vector3& c,
+                                  Scalar& hitOut );
+
+/// Intersect a ray with all the triangles of a mesh, using the mesh Bvh (see
+/// TriangleMesh::getBvh()). The hits and the hit triangles are appended in triangle order.
 bool RA_CORE_API RayCastTriangleMesh( const Ray& r,
                                       const TriangleMesh& mesh,
                                       std::vector<Scalar>& hitsOut,
                                       std::vector<Vector3ui>& trianglesIdxOut );
+
+/// Intersect a ray with a mesh, keeping only the closest hit and its triangle.
+/// Uses the mesh Bvh (see TriangleMesh::getBvh()).
+bool RA_CORE_API RayCastTriangleMesh( const Ray& r,
+                                      const TriangleMesh& mesh,
+                                      Scalar& hitOut,
+                                      Vector3ui& triangleIdxOut );
+
+/// Intersect a batch of rays with a mesh, keeping the closest hit of each ray as the single ray
+/// version does. The rays are traced by packets of 8 through the mesh Bvh (see RayPacket), the
+/// packets being processed in parallel. Packets pay off for coherent rays, such as camera or
+/// picking brush rays : incoherent rays are better traced one by one.
+/// \p hitsOut[i] receives the closest hit of \p rays[i], and \p trianglesIdxOut[i] the index of
+/// the hit triangle in mesh.getIndices(), or infinity and -1 when the ray misses the mesh.
+/// Both buffers must have the size of \p rays.
+/// \return the number of rays hitting the mesh.
+size_t RA_CORE_API RayCastTriangleMesh( const std::vector<Ray>& rays,
+                                        const TriangleMesh& mesh,
+                                        Eigen::Ref<VectorN> hitsOut,
+                                        Eigen::Ref<VectorNi> trianglesIdxOut );
+
+/// Same as RayCastTriangleMesh, testing every triangle of the mesh without the Bvh.
+bool RA_CORE_API RayCastTriangleMeshBruteForce( const Ray& r,
+                                                const TriangleMesh& mesh,
+                                                std::vector<Scalar>& hitsOut,
+                                                std::vector<Vector3ui>& trianglesIdxOut );
 } // namespace Geometry
 } // namespace Core
 } // namespace Ra
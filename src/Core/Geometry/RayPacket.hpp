@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/// \brief A packet of N rays, stored as a structure of arrays.
+///
+/// Each component of the origins and directions is an Eigen array of N lanes, so that the packet
+/// kernels (RayCastAabb(), RayCastTriangle()) process the N rays at once. Eigen maps the lane
+/// operations to SSE, AVX or NEON instructions when they are enabled at compile time, and to
+/// scalar code otherwise. Packets of 4 or 8 rays fit the usual SIMD register widths.
+///
+/// A packet may be partially filled : the unused lanes are inactive and never report hits.
+template <int N>
+struct RayPacket {
+    static_assert( N > 0, "Empty ray packet" );
+
+    static constexpr int Size = N;
+    /// One value per ray.
+    using Lanes = Eigen::Array<Scalar, N, 1>;
+    /// One flag per ray.
+    using Mask = Eigen::Array<bool, N, 1>;
+    /// One vector per ray, column i holding the i-th components.
+    using Vectors = Eigen::Array<Scalar, N, 3>;
+
+    /// Loads the \p count first rays of \p rays, with \p count <= N.
+    RayPacket( const Ray* rays, int count );
+
+    Vectors origins;
+    Vectors directions;
+    /// Inverse of the directions, null components being replaced by a tiny value.
+    Vectors invDirections;
+    /// Lanes holding a ray.
+    Mask active;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+/// Intersects the rays of \p rays with \p aabb for t in [0, tMax]. The entry parameters of the
+/// rays hitting the box are written in \p tNearOut.
+/// Conservative slab test, meant for hierarchy traversal (see Bvh::traverse()).
+/// \return the lanes hitting the box.
+template <int N>
+typename RayPacket<N>::Mask RayCastAabb( const RayPacket<N>& rays,
+                                         const Core::Aabb& aabb,
+                                         const typename RayPacket<N>::Lanes& tMax,
+                                         typename RayPacket<N>::Lanes& tNearOut );
+
+/// Intersects the rays of \p rays with the triangle abc, the hits of the lanes hitting the
+/// triangle being written in \p hitsOut.
+/// Finds the same hits as RayCastTriangle( const Ray&, ... ) for each ray.
+/// \return the lanes hitting the triangle.
+template <int N>
+typename RayPacket<N>::Mask RayCastTriangle( const RayPacket<N>& rays,
+                                             const Core::Vector3& a,
+                                             const Core::Vector3& b,
+                                             const Core::Vector3& c,
+                                             typename RayPacket<N>::Lanes& hitsOut );
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#include <Core/Geometry/RayPacket.inl>
@@ -0,0 +1,103 @@
+#pragma once
+#include "RayPacket.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+template <int N>
+RayPacket<N>::RayPacket( const Ray* rays, int count ) {
+    CORE_ASSERT( count >= 0 && count <= N, "Too many rays for the packet" );
+    // Unused lanes get a valid ray, so that they do not produce NaNs.
+    origins.setZero();
+    directions.setConstant( 1_ra );
+    active.setConstant( false );
+    for ( int i = 0; i < count; ++i ) {
+        origins.row( i )    = rays[i].origin().transpose().array();
+        directions.row( i ) = rays[i].direction().transpose().array();
+        active[i]           = true;
+    }
+    // Null direction components are replaced by a tiny value, to get infinite slabs without
+    // producing NaNs when an origin lies on a box face (see Bvh::traverse()).
+    constexpr Scalar tiny = std::numeric_limits<Scalar>::min();
+    invDirections         = directions.unaryExpr( []( Scalar d ) {
+        return 1_ra / ( std::abs( d ) > tiny ? d : std::copysign( tiny, d ) );
+    } );
+}
+
+template <int N>
+typename RayPacket<N>::Mask RayCastAabb( const RayPacket<N>& rays,
+                                         const Core::Aabb& aabb,
+                                         const typename RayPacket<N>::Lanes& tMax,
+                                         typename RayPacket<N>::Lanes& tNearOut ) {
+    using Lanes = typename RayPacket<N>::Lanes;
+    // Same robust slab test as the scalar Bvh traversal, see BvhDetail::rayHitsAabb().
+    constexpr Scalar eps   = std::numeric_limits<Scalar>::epsilon();
+    constexpr Scalar scale = 1 + 2 * ( 3 * eps ) / ( 1 - 3 * eps );
+
+    Lanes tNear = Lanes::Zero();
+    Lanes tFar  = tMax;
+    for ( int i = 0; i < 3; ++i ) {
+        const Lanes t0 = ( aabb.min()[i] - rays.origins.col( i ) ) * rays.invDirections.col( i );
+        const Lanes t1 = ( aabb.max()[i] - rays.origins.col( i ) ) * rays.invDirections.col( i );
+        tNear          = tNear.max( t0.min( t1 ) );
+        tFar           = tFar.min( t0.max( t1 ) * scale );
+    }
+    tNearOut = tNear;
+    return rays.active && ( tNear <= tFar );
+}
+
+template <int N>
+typename RayPacket<N>::Mask RayCastTriangle( const RayPacket<N>& rays,
+                                             const Core::Vector3& a,
+                                             const Core::Vector3& b,
+                                             const Core::Vector3& c,
+                                             typename RayPacket<N>::Lanes& hitsOut ) {
+    using Lanes = typename RayPacket<N>::Lanes;
+    using Mask  = typename RayPacket<N>::Mask;
+    // Lane-wise version of the scalar Moller-Trumbore test, with the same tests, so that both
+    // versions find the same hits (up to the rounding of the dot products).
+    const Vector3 ab = b - a;
+    const Vector3 ac = c - a;
+
+    const auto dx = rays.directions.col( 0 );
+    const auto dy = rays.directions.col( 1 );
+    const auto dz = rays.directions.col( 2 );
+
+    // pvec = direction x ac
+    const Lanes px  = dy * ac.z() - dz * ac.y();
+    const Lanes py  = dz * ac.x() - dx * ac.z();
+    const Lanes pz  = dx * ac.y() - dy * ac.x();
+    const Lanes det = ab.x() * px + ab.y() * py + ab.z() * pz;
+
+    // tvec = origin - a
+    const Lanes tx = rays.origins.col( 0 ) - a.x();
+    const Lanes ty = rays.origins.col( 1 ) - a.y();
+    const Lanes tz = rays.origins.col( 2 ) - a.z();
+
+    // qvec = tvec x ab
+    const Lanes qx = ty * ab.z() - tz * ab.y();
+    const Lanes qy = tz * ab.x() - tx * ab.z();
+    const Lanes qz = tx * ab.y() - ty * ab.x();
+
+    const Lanes u  = tx * px + ty * py + tz * pz;
+    const Lanes v  = dx * qx + dy * qy + dz * qz;
+    const Lanes uv = u + v;
+
+    const Mask inFront = ( det > 0_ra ) && ( u >= 0_ra ) && ( u <= det ) && ( v >= 0_ra ) &&
+                         ( uv <= det );
+    const Mask inBack = ( det < 0_ra ) && ( u <= 0_ra ) && ( u >= det ) && ( v <= 0_ra ) &&
+                        ( uv >= det );
+
+    const Lanes t  = ( ac.x() * qx + ac.y() * qy + ac.z() * qz ) * det.inverse();
+    const Mask hit = rays.active && ( inFront || inBack ) && ( t >= 0_ra );
+    hitsOut        = hit.select( t, hitsOut );
+    return hit;
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,132 @@
+#include <Core/Geometry/SplitNormals.hpp>
+
+#include <Core/Geometry/TriangleMesh.hpp>
+#include <Core/Math/LinearAlgebra.hpp>
+#include <Core/Tasks/Parallel.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+namespace {
+/// Lexicographic order on the coefficients of two vectors.
+inline bool lexicographicLess( const Vector3& a, const Vector3& b ) {
+    return std::lexicographical_compare( a.data(), a.data() + 3, b.data(), b.data() + 3 );
+}
+} // namespace
+
+void SplitNormals::build( const TriangleMesh& mesh ) {
+    const auto& vertices  = mesh.vertices();
+    const auto& normals   = mesh.normals();
+    const bool hasNormals = normals.size() == vertices.size();
+
+    m_numVertices = vertices.size();
+    m_triangles   = mesh.getIndices();
+
+    // Group the vertices sharing position and reference normal.
+    m_groupVertices.resize( m_numVertices );
+    std::iota( m_groupVertices.begin(), m_groupVertices.end(), 0u );
+    auto less = [&]( uint a, uint b ) {
+        if ( lexicographicLess( vertices[a], vertices[b] ) ) return true;
+        if ( lexicographicLess( vertices[b], vertices[a] ) ) return false;
+        return hasNormals && lexicographicLess( normals[a], normals[b] );
+    };
+    std::sort( m_groupVertices.begin(), m_groupVertices.end(), less );
+
+    std::vector<uint> vertexGroup( m_numVertices );
+    m_vertexOffsets.clear();
+    for ( size_t i = 0; i < m_numVertices; ++i ) {
+        if ( i == 0 || less( m_groupVertices[i - 1], m_groupVertices[i] ) ) {
+            m_vertexOffsets.push_back( uint( i ) );
+        }
+        vertexGroup[m_groupVertices[i]] = uint( m_vertexOffsets.size() - 1 );
+    }
+    m_vertexOffsets.push_back( uint( m_numVertices ) );
+    const size_t numGroups = getNumGroups();
+
+    // Count then fill the faces of each group, a face being referenced once per corner.
+    m_faceOffsets.assign( numGroups + 1, 0 );
+    for ( const auto& t : m_triangles ) {
+        for ( int k = 0; k < 3; ++k ) {
+            ++m_faceOffsets[vertexGroup[t( k )] + 1];
+        }
+    }
+    std::partial_sum( m_faceOffsets.begin(), m_faceOffsets.end(), m_faceOffsets.begin() );
+    m_groupFaces.resize( m_faceOffsets.back() );
+    std::vector<uint> cursors( m_faceOffsets.begin(), m_faceOffsets.end() - 1 );
+    for ( size_t f = 0; f < m_triangles.size(); ++f ) {
+        for ( int k = 0; k < 3; ++k ) {
+            m_groupFaces[cursors[vertexGroup[m_triangles[f]( k )]]++] = uint( f );
+        }
+    }
+    m_faceNormals.resize( m_triangles.size() );
+}
+
+void SplitNormals::clear() {
+    m_triangles.clear();
+    m_numVertices = 0;
+    m_faceOffsets.clear();
+    m_groupFaces.clear();
+    m_vertexOffsets.clear();
+    m_groupVertices.clear();
+    m_faceNormals.clear();
+}
+
+void SplitNormals::computeFaceNormals( const Vector3Array& vertices ) {
+    CORE_ASSERT( vertices.size() == m_numVertices, "Vertices do not match the adjacency." );
+    m_faceNormals.resize( m_triangles.size() );
+    // Not normalized : the norm of the cross product is twice the area of the face.
+    parallelFor( size_t( 0 ), m_triangles.size(), [this, &vertices]( size_t f ) {
+        const auto& t    = m_triangles[f];
+        const Vector3& p = vertices[t( 0 )];
+        m_faceNormals[f] = ( vertices[t( 1 )] - p ).cross( vertices[t( 2 )] - p );
+    } );
+}
+
+Vector3 SplitNormals::groupNormal( size_t group ) const {
+    Vector3 n = Vector3::Zero();
+    for ( uint i = m_faceOffsets[group]; i < m_faceOffsets[group + 1]; ++i ) {
+        n += m_faceNormals[m_groupFaces[i]];
+    }
+    return n.normalized();
+}
+
+void SplitNormals::computeNormals( const Vector3Array& vertices, Vector3Array& normals ) {
+    computeFaceNormals( vertices );
+    normals.resize( m_numVertices );
+    parallelFor( size_t( 0 ), getNumGroups(), [this, &normals]( size_t g ) {
+        const Vector3 n = groupNormal( g );
+        for ( uint i = m_vertexOffsets[g]; i < m_vertexOffsets[g + 1]; ++i ) {
+            normals[m_groupVertices[i]] = n;
+        }
+    } );
+}
+
+void SplitNormals::computeNormals( const Vector3Array& vertices,
+                                   Vector3Array& normals,
+                                   Vector3Array& tangents,
+                                   Vector3Array& bitangents ) {
+    computeFaceNormals( vertices );
+    normals.resize( m_numVertices );
+    tangents.resize( m_numVertices );
+    bitangents.resize( m_numVertices );
+    auto setGroup = [this, &normals, &tangents, &bitangents]( size_t g ) {
+        const Vector3 n = groupNormal( g );
+        Vector3 t, b;
+        Math::getOrthogonalVectors( n, t, b );
+        for ( uint i = m_vertexOffsets[g]; i < m_vertexOffsets[g + 1]; ++i ) {
+            const uint v  = m_groupVertices[i];
+            normals[v]    = n;
+            tangents[v]   = t;
+            bitangents[v] = b;
+        }
+    };
+    parallelFor( size_t( 0 ), getNumGroups(), setGroup );
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
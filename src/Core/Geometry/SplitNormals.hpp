@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Core/Containers/VectorArray.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+class TriangleMesh;
+
+/**
+ * Flat vertex to face adjacency of a TriangleMesh, to recompute the normals of the mesh when its
+ * vertices move, without building a TopologicalMesh.
+ *
+ * The vertices of the mesh are grouped by position and reference normal, so that split normals
+ * (e.g. on sharp edges) are preserved : the normal of a vertex is the area weighted sum of the
+ * normals of the faces around its position whose corner at this position has the same reference
+ * normal. The groups and their faces are stored in compressed rows, built once by build().
+ */
+class RA_CORE_API SplitNormals
+{
+  public:
+    /// Build the adjacency of the mesh, from its positions, normals and triangles.
+    void build( const TriangleMesh& mesh );
+
+    /// Erase the adjacency.
+    void clear();
+
+    /// Number of vertices of the mesh the adjacency has been built from.
+    inline size_t getNumVertices() const { return m_numVertices; }
+
+    /// Number of groups of vertices sharing position and reference normal.
+    inline size_t getNumGroups() const {
+        return m_vertexOffsets.empty() ? 0 : m_vertexOffsets.size() - 1;
+    }
+
+    /// Compute the normals of the mesh for the vertex positions \p vertices.
+    /// \note Parallelized loops inside.
+    /// \note Uses an internal face normals buffer, so concurrent calls on the same object are
+    /// not allowed.
+    void computeNormals( const Vector3Array& vertices, Vector3Array& normals );
+
+    /// Compute the normals of the mesh for the vertex positions \p vertices, and orthonormal
+    /// tangents and bitangents (see Math::getOrthogonalVectors()) in the same pass.
+    /// \note Parallelized loops inside.
+    /// \note Uses an internal face normals buffer, as the overload above.
+    void computeNormals( const Vector3Array& vertices,
+                         Vector3Array& normals,
+                         Vector3Array& tangents,
+                         Vector3Array& bitangents );
+
+  private:
+    /// Area weighted face normals of the mesh for the vertex positions \p vertices.
+    void computeFaceNormals( const Vector3Array& vertices );
+
+    /// Normal of a group, from the face normals.
+    Vector3 groupNormal( size_t group ) const;
+
+    VectorArray<Vector3ui> m_triangles;
+    size_t m_numVertices { 0 };
+    /// Faces of group g are m_groupFaces[m_faceOffsets[g] .. m_faceOffsets[g + 1]).
+    std::vector<uint> m_faceOffsets;
+    std::vector<uint> m_groupFaces;
+    /// Vertices of group g are m_groupVertices[m_vertexOffsets[g] .. m_vertexOffsets[g + 1]).
+    std::vector<uint> m_vertexOffsets;
+    std::vector<uint> m_groupVertices;
+    /// Face normals buffer, reused by each computation.
+    Vector3Array m_faceNormals;
+};
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
@@ -197,7 +197,8 @@ class RA_CORE_API AttribArrayGeometry : public AbstractGeometry
     /// \warning need to call verticesUnlock when job done.
     inline PointAttribHandle::Container& verticesWithLock();
 
-    /// Release lock on vertices positions
+    /// Release lock on vertices positions, and invalidate the bounding box since they may have
+    /// been modified.
     inline void verticesUnlock();
 
     /// Read/write access the vertices normals.
@@ -201,7 +201,8 @@ inline AttribArrayGeometry::PointAttribHandle::Container& AttribArrayGeometry::v
 }
 
 inline void AttribArrayGeometry::verticesUnlock() {
-    return m_vertexAttribs.getAttrib( m_verticesHandle ).unlock();
+    m_vertexAttribs.getAttrib( m_verticesHandle ).unlock();
+    invalidateAabb();
 }
 
 inline AttribArrayGeometry::NormalAttribHandle::Container& AttribArrayGeometry::normalsWithLock() {
@@ -1,7 +1,11 @@
 #include <Core/Geometry/Volume.hpp>
 
+#include <Core/Tasks/Parallel.hpp>
 #include <Core/Utils/Log.hpp>
 
+#include <algorithm>
+#include <limits>
+
 namespace Ra {
 namespace Core {
 namespace Geometry {
@@ -72,8 +76,7 @@ void VolumeGrid::computeGradients() {
     m_gradient.resize( m_data.size() );
     auto s = size();
 
-#pragma omp parallel for firstprivate( s )
-    for ( int k = 0; k < s.z(); ++k ) {
+    parallelFor( 0, int( s.z() ), [this, s]( int k ) {
         for ( int j = 0; j < s.y(); ++j ) {
             for ( int i = 0; i < s.x(); ++i ) {
                 Eigen::Matrix<ValueType, 3, 1> s1;
@@ -90,6 +93,405 @@ void VolumeGrid::computeGradients() {
                     gradient[0], gradient[1], gradient[2], sample( { i, j, k } ) };
             }
         }
+    } );
+}
+
+namespace {
+/// Calls \p f( brick ) for each brick of \p volume, in parallel.
+template <typename F>
+void forEachBrick( const VolumeBricked& volume, F&& f ) {
+    const Vector3i count = volume.brickCount();
+    parallelFor( 0, count.prod(), [&count, &f]( int b ) {
+        f( Vector3i { b % count.x(), ( b / count.x() ) % count.y(), b / count.head<2>().prod() } );
+    } );
+}
+} // namespace
+
+VolumeBricked::ValueType VolumeBricked::getBrickValue( const Brick& brick, size_t idx ) {
+    switch ( brick.storage ) {
+    case RAW:
+        return brick.values[idx];
+    case COMPRESSED:
+        return std::upper_bound( brick.runs.begin(),
+                                 brick.runs.end(),
+                                 uint32_t( idx ),
+                                 []( uint32_t i, const Brick::Run& run ) { return i < run.end; } )
+            ->value;
+    default:
+        return brick.min;
+    }
+}
+
+Utils::optional<VolumeBricked::ValueType>
+VolumeBricked::getBinValue( typename IndexType::Scalar idx ) const {
+    const IndexType bin { idx % size().x(),
+                          ( idx / size().x() ) % size().y(),
+                          idx / ( size().x() * size().y() ) };
+    return sample( bin );
+}
+
+VolumeBricked::ValueType VolumeBricked::sample( const IndexType& i ) const {
+    const IndexType bin {
+        std::clamp( i.x(), 0, size().x() - 1 ),
+        std::clamp( i.y(), 0, size().y() - 1 ),
+        std::clamp( i.z(), 0, size().z() - 1 ),
+    };
+    const IndexType brick     = bin / s_brickSize;
+    const IndexType local     = bin - getBrickOrigin( brick );
+    const IndexType brickSize = getBrickSize( brick );
+    return getBrickValue( m_bricks[brickIndex( brick )],
+                          size_t( local.x() +
+                                  brickSize.x() * ( local.y() + brickSize.y() * local.z() ) ) );
+}
+
+void VolumeBricked::addToBin( const ValueType& value, typename IndexType::Scalar idx ) {
+    const IndexType bin { idx % size().x(),
+                          ( idx / size().x() ) % size().y(),
+                          idx / ( size().x() * size().y() ) };
+    const IndexType brickIdx  = bin / s_brickSize;
+    const IndexType local     = bin - getBrickOrigin( brickIdx );
+    const IndexType brickSize = getBrickSize( brickIdx );
+    const size_t i =
+        size_t( local.x() + brickSize.x() * ( local.y() + brickSize.y() * local.z() ) );
+
+    decompressBrick( brickIdx );
+    Brick& brick = m_bricks[brickIndex( brickIdx )];
+    if ( brick.storage == UNIFORM ) {
+        brick.values.assign( size_t( brickSize.prod() ), brick.min );
+        brick.storage = RAW;
+    }
+    const ValueType old = brick.values[i];
+    brick.values[i] += value;
+    // The range only shrinks when one of its bounds is modified.
+    if ( old == brick.min || old == brick.max ) {
+        const auto range = std::minmax_element( brick.values.begin(), brick.values.end() );
+        brick.min        = *range.first;
+        brick.max        = *range.second;
+    }
+    else {
+        brick.min = std::min( brick.min, brick.values[i] );
+        brick.max = std::max( brick.max, brick.values[i] );
+    }
+    m_modifiedBricks[brickIndex( brickIdx )] = true;
+}
+
+void VolumeBricked::updateStorage() {
+    m_brickCount = ( size().array() + s_brickSize - 1 ) / s_brickSize;
+    Brick brick;
+    brick.min = brick.max = m_defaultValue;
+    m_bricks.assign( size_t( m_brickCount.prod() ), brick );
+    m_modifiedBricks.assign( m_bricks.size(), true );
+    m_mipLevels.clear();
+}
+
+void VolumeBricked::setBrickValues( const IndexType& brickIdx, Container& values ) {
+    Brick& brick     = m_bricks[brickIndex( brickIdx )];
+    const auto range = std::minmax_element( values.begin(), values.end() );
+    brick.min        = *range.first;
+    brick.max        = *range.second;
+    brick.runs.clear();
+    if ( brick.min == brick.max ) {
+        brick.storage = UNIFORM;
+        brick.values.clear();
+    }
+    else {
+        brick.storage = RAW;
+        brick.values.swap( values );
+    }
+}
+
+void VolumeBricked::getBrickValues( const IndexType& brickIdx, Container& values ) const {
+    const Brick& brick = getBrick( brickIdx );
+    const size_t count = size_t( getBrickSize( brickIdx ).prod() );
+    switch ( brick.storage ) {
+    case RAW:
+        values = brick.values;
+        break;
+    case COMPRESSED: {
+        values.resize( count );
+        auto first = values.begin();
+        for ( const auto& run : brick.runs ) {
+            const auto last = values.begin() + run.end;
+            std::fill( first, last, run.value );
+            first = last;
+        }
+        break;
+    }
+    default:
+        values.assign( count, brick.min );
+    }
+}
+
+void VolumeBricked::compress() {
+    forEachBrick( *this, [this]( const IndexType& brickIdx ) {
+        Brick& brick = m_bricks[brickIndex( brickIdx )];
+        if ( brick.storage != RAW ) { return; }
+        std::vector<Brick::Run> runs;
+        for ( size_t i = 0; i < brick.values.size(); ++i ) {
+            if ( runs.empty() || runs.back().value != brick.values[i] ) {
+                runs.push_back( { brick.values[i], 0 } );
+            }
+            runs.back().end = uint32_t( i + 1 );
+        }
+        if ( runs.size() == 1 ) {
+            brick.storage = UNIFORM;
+            brick.values  = Container();
+        }
+        else if ( runs.size() * sizeof( Brick::Run ) < brick.values.size() * sizeof( ValueType ) ) {
+            brick.storage = COMPRESSED;
+            brick.runs    = std::move( runs );
+            brick.values  = Container();
+        }
+    } );
+    for ( auto& level : m_mipLevels ) {
+        level.compress();
+    }
+}
+
+void VolumeBricked::decompress() {
+    forEachBrick( *this, [this]( const IndexType& brickIdx ) { decompressBrick( brickIdx ); } );
+}
+
+void VolumeBricked::decompressBrick( const IndexType& brickIdx ) {
+    Brick& brick = m_bricks[brickIndex( brickIdx )];
+    if ( brick.storage != COMPRESSED ) { return; }
+    getBrickValues( brickIdx, brick.values );
+    brick.storage = RAW;
+    brick.runs    = std::vector<Brick::Run>();
+}
+
+size_t VolumeBricked::getMemorySize() const {
+    size_t memory = m_bricks.size() * sizeof( Brick );
+    for ( const auto& brick : m_bricks ) {
+        memory += brick.values.size() * sizeof( ValueType ) +
+                  brick.runs.size() * sizeof( Brick::Run );
+    }
+    return memory;
+}
+
+void VolumeBricked::fromGrid( const VolumeGrid& grid ) {
+    setSize( grid.size() );
+    setBinSize( grid.binSize() );
+    const auto& data = grid.data();
+    forEachBrick( *this, [this, &data]( const IndexType& brickIdx ) {
+        const IndexType origin    = getBrickOrigin( brickIdx );
+        const IndexType brickSize = getBrickSize( brickIdx );
+        Container values;
+        values.reserve( size_t( brickSize.prod() ) );
+        for ( int k = 0; k < brickSize.z(); ++k ) {
+            for ( int j = 0; j < brickSize.y(); ++j ) {
+                const auto first =
+                    data.begin() + *linearIndex( origin + IndexType { 0, j, k } );
+                values.insert( values.end(), first, first + brickSize.x() );
+            }
+        }
+        setBrickValues( brickIdx, values );
+    } );
+}
+
+void VolumeBricked::toGrid( VolumeGrid& grid ) const {
+    grid.setSize( size() );
+    grid.setBinSize( binSize() );
+    auto& data = grid.data();
+    forEachBrick( *this, [this, &data]( const IndexType& brickIdx ) {
+        const IndexType origin    = getBrickOrigin( brickIdx );
+        const IndexType brickSize = getBrickSize( brickIdx );
+        Container values;
+        getBrickValues( brickIdx, values );
+        auto first = values.begin();
+        for ( int k = 0; k < brickSize.z(); ++k ) {
+            for ( int j = 0; j < brickSize.y(); ++j ) {
+                std::copy( first,
+                           first + brickSize.x(),
+                           data.begin() + *linearIndex( origin + IndexType { 0, j, k } ) );
+                first += brickSize.x();
+            }
+        }
+    } );
+}
+
+VolumeBricked::GradientType VolumeBricked::getGradient( const IndexType& bin ) const {
+    // Same finite differences as VolumeGrid::computeGradients().
+    const int i = bin.x(), j = bin.y(), k = bin.z();
+    Eigen::Matrix<ValueType, 3, 1> s1;
+    Eigen::Matrix<ValueType, 3, 1> s2;
+    s1( 0 ) = sample( { i - 1, j, k } );
+    s2( 0 ) = sample( { i + 1, j, k } );
+    s1( 1 ) = sample( { i, j - 1, k } );
+    s2( 1 ) = sample( { i, j + 1, k } );
+    s1( 2 ) = sample( { i, j, k - 1 } );
+    s2( 2 ) = sample( { i, j, k + 1 } );
+    Eigen::Matrix<ValueType, 3, 1> gradient = s2 - s1;
+    return { gradient[0], gradient[1], gradient[2], sample( bin ) };
+}
+
+void VolumeBricked::computeBrickGradients( const IndexType& brickIdx,
+                                           GradientContainer& gradients ) const {
+    const IndexType origin    = getBrickOrigin( brickIdx );
+    const IndexType brickSize = getBrickSize( brickIdx );
+    gradients.resize( size_t( brickSize.prod() ) );
+    size_t idx = 0;
+    for ( int k = 0; k < brickSize.z(); ++k ) {
+        for ( int j = 0; j < brickSize.y(); ++j ) {
+            for ( int i = 0; i < brickSize.x(); ++i ) {
+                gradients[idx++] = getGradient( origin + IndexType { i, j, k } );
+            }
+        }
+    }
+}
+
+void VolumeBricked::computeMipmaps() {
+    m_mipLevels.clear();
+    const VolumeBricked* level = this;
+    while ( ( level->size().array() > 1 ).any() ) {
+        VolumeBricked next( m_defaultValue );
+        next.setSize( ( level->size().array() + 1 ) / 2 );
+        next.setBinSize( 2_ra * level->binSize() );
+        // Average of the children of a bin which are within the previous level.
+        const auto average = [level]( const IndexType& bin ) {
+            const IndexType first = 2 * bin;
+            const IndexType last  = ( first.array() + 1 ).min( level->size().array() - 1 );
+            ValueType sum         = 0;
+            for ( int z = first.z(); z <= last.z(); ++z ) {
+                for ( int y = first.y(); y <= last.y(); ++y ) {
+                    for ( int x = first.x(); x <= last.x(); ++x ) {
+                        sum += level->sample( { x, y, z } );
+                    }
+                }
+            }
+            return sum / ValueType( ( last - first + IndexType::Ones() ).prod() );
+        };
+        forEachBrick( next, [&next, &average]( const IndexType& brickIdx ) {
+            const IndexType origin    = next.getBrickOrigin( brickIdx );
+            const IndexType brickSize = next.getBrickSize( brickIdx );
+            Container values;
+            values.reserve( size_t( brickSize.prod() ) );
+            for ( int k = 0; k < brickSize.z(); ++k ) {
+                for ( int j = 0; j < brickSize.y(); ++j ) {
+                    for ( int i = 0; i < brickSize.x(); ++i ) {
+                        values.push_back( average( origin + IndexType { i, j, k } ) );
+                    }
+                }
+            }
+            next.setBrickValues( brickIdx, values );
+        } );
+        m_mipLevels.push_back( std::move( next ) );
+        level = &m_mipLevels.back();
+    }
+}
+
+void VolumeBricked::resetModifiedBricks() {
+    std::fill( m_modifiedBricks.begin(), m_modifiedBricks.end(), false );
+}
+
+void VolumeSparse::addToBin( const ValueType& value, typename IndexType::Scalar idx ) {
+    const int sample = findSample( idx );
+    if ( sample >= 0 ) {
+        m_data[size_t( sample )].value += value;
+        return;
+    }
+    // Keep the load factor below 1/2.
+    if ( 2 * ( m_data.size() + 1 ) > m_slots.size() ) { rehash( 2 * ( m_data.size() + 1 ) ); }
+    const size_t mask = m_slots.size() - 1;
+    size_t s          = firstSlot( idx );
+    while ( m_slots[s].sample >= 0 ) {
+        s = ( s + 1 ) & mask;
+    }
+    m_slots[s] = { idx, int( m_data.size() ) };
+    m_data.emplace_back( idx, value );
+}
+
+void VolumeSparse::rehash( size_t capacity ) {
+    CORE_ASSERT( m_data.size() < size_t( std::numeric_limits<int>::max() ), "Too many samples" );
+    int bits = 4;
+    while ( ( size_t( 1 ) << bits ) < capacity ) {
+        ++bits;
+    }
+    m_hashShift = 64 - bits;
+    m_slots.assign( size_t( 1 ) << bits, Slot() );
+    const size_t mask = m_slots.size() - 1;
+    for ( size_t i = 0; i < m_data.size(); ++i ) {
+        size_t s = firstSlot( m_data[i].index );
+        while ( m_slots[s].sample >= 0 ) {
+            s = ( s + 1 ) & mask;
+        }
+        m_slots[s] = { m_data[i].index, int( i ) };
+    }
+}
+
+void VolumeSparse::reserve( size_t count ) {
+    m_data.reserve( count );
+    if ( 2 * count > m_slots.size() ) { rehash( 2 * count ); }
+}
+
+bool VolumeSparse::addToBins( const std::vector<IndexType>& bins,
+                              const std::vector<ValueType>& values ) {
+    CORE_ASSERT( bins.size() == values.size(), "Each bin needs a value" );
+    reserve( m_data.size() + bins.size() );
+    bool inBounds = true;
+    for ( size_t i = 0; i < bins.size(); ++i ) {
+        if ( auto res = linearIndex( bins[i] ) ) { addToBin( values[i], *res ); }
+        else { inBounds = false; }
+    }
+    invalidateAabb();
+    return inBounds;
+}
+
+namespace {
+/// Spreads the 21 lower bits of \p x, two zero bits being inserted after each bit.
+uint64_t spreadBits( uint64_t x ) {
+    x &= 0x1fffff;
+    x = ( x | x << 32 ) & 0x1f00000000ffffull;
+    x = ( x | x << 16 ) & 0x1f0000ff0000ffull;
+    x = ( x | x << 8 ) & 0x100f00f00f00f00full;
+    x = ( x | x << 4 ) & 0x10c30c30c30c30c3ull;
+    x = ( x | x << 2 ) & 0x1249249249249249ull;
+    return x;
+}
+} // namespace
+
+void VolumeSparse::sortSamples() {
+    // Morton code of the bins, computed from their linear index.
+    const uint64_t sx = uint64_t( size().x() );
+    const uint64_t sy = uint64_t( size().y() );
+    std::vector<std::pair<uint64_t, SampleType>> keys;
+    keys.reserve( m_data.size() );
+    for ( const auto& sample : m_data ) {
+        const uint64_t idx = uint64_t( sample.index );
+        const uint64_t x   = idx % sx, y = ( idx / sx ) % sy, z = idx / ( sx * sy );
+        keys.emplace_back( spreadBits( x ) | spreadBits( y ) << 1 | spreadBits( z ) << 2, sample );
+    }
+    std::sort( keys.begin(), keys.end(), []( const auto& a, const auto& b ) {
+        return a.first < b.first;
+    } );
+    for ( size_t i = 0; i < keys.size(); ++i ) {
+        m_data[i] = keys[i].second;
+    }
+    rehash( m_slots.size() );
+}
+
+void VolumeSparse::fromGrid( const VolumeGrid& grid, const ValueType& background ) {
+    setSize( grid.size() );
+    setBinSize( grid.binSize() );
+    const auto& values = grid.data();
+    size_t count       = 0;
+    for ( const auto& v : values ) {
+        count += ( v != background );
+    }
+    reserve( count );
+    for ( size_t i = 0; i < values.size(); ++i ) {
+        if ( values[i] != background ) { addToBin( values[i], int( i ) ); }
+    }
+}
+
+void VolumeSparse::toGrid( VolumeGrid& grid ) const {
+    // Resize from an empty grid, so that all the bins get the default value.
+    grid.setSize( Vector3i::Zero() );
+    grid.setSize( size() );
+    grid.setBinSize( binSize() );
+    auto& values = grid.data();
+    for ( const auto& sample : m_data ) {
+        values[size_t( sample.index )] = sample.value;
     }
 }
 
@@ -8,7 +8,9 @@
 #include <Core/Utils/StdOptional.hpp> // trigger an error if optional is not found
 #undef RA_REQUIRE_OPTIONAL
 
-#include <algorithm> // find_if
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 
 namespace Ra {
 namespace Core {
@@ -250,10 +252,177 @@ class RA_CORE_API VolumeGrid : public AbstractDiscreteVolume
     GradientContainer m_gradient;
 }; // class VolumeGrid
 
+/** Discrete volume data storing values in a regular grid split into bricks.
+ *
+ * The grid is split into bricks of s_brickSize^3 bins, the bricks on the upper borders of the
+ * volume being smaller. Uniform bricks only store their value, and the other bricks can be
+ * compressed with a lossless run length encoding (see compress()), being decompressed on demand.
+ * Each brick knows the range of its values, which allows to skip empty space, and the volume can
+ * compute a mip pyramid of itself.
+ *
+ * Gradients are not stored as in VolumeGrid, but computed on demand, per bin or per brick.
+ * Bricks modified since the last resetModifiedBricks() are tracked, so that a GPU copy of the
+ * volume only has to upload them again (see Engine::Data::VolumeObject).
+ */
+class RA_CORE_API VolumeBricked : public AbstractDiscreteVolume
+{
+  public:
+    using ValueType         = AbstractDiscreteVolume::ValueType;
+    using IndexType         = AbstractDiscreteVolume::IndexType;
+    using GradientType      = VolumeGrid::GradientType;
+    using Container         = std::vector<ValueType>;
+    using GradientContainer = VolumeGrid::GradientContainer;
+
+    /// Number of bins of a brick per dimension.
+    static constexpr int s_brickSize = 16;
+
+    /// Storage of the values of a brick.
+    enum BrickStorage {
+        UNIFORM,   /// <\brief all the bins have the value Brick::min
+        RAW,       /// <\brief the values are stored in Brick::values
+        COMPRESSED /// <\brief the values are run length encoded in Brick::runs
+    };
+
+    /// Values of a brick, its bins being ordered along x, then y, then z as in VolumeGrid.
+    struct Brick {
+        /// A run of equal values of a compressed brick, ending before the bin \p end of the brick.
+        struct Run {
+            ValueType value;
+            uint32_t end;
+        };
+
+        BrickStorage storage { UNIFORM };
+        /// Range of the values of the brick.
+        ValueType min { 0 };
+        ValueType max { 0 };
+        /// Values of a RAW brick.
+        Container values;
+        /// Runs of a COMPRESSED brick.
+        std::vector<Run> runs;
+    };
+
+  public:
+    inline VolumeBricked( const ValueType& defaultValue = ValueType( 0. ) ) :
+        AbstractDiscreteVolume( DISCRETE_DENSE ), m_defaultValue( defaultValue ) {}
+    VolumeBricked( const VolumeBricked& data ) = default;
+    VolumeBricked& operator=( const VolumeBricked& ) = default;
+    ~VolumeBricked() override                        = default;
+
+    using AbstractDiscreteVolume::addToBin;
+    using AbstractDiscreteVolume::getBinValue;
+
+    /// \name Bricks
+    ///@{
+    /// Number of bricks per dimension.
+    inline const IndexType& brickCount() const { return m_brickCount; }
+    /// First bin of a brick.
+    inline IndexType getBrickOrigin( const IndexType& brick ) const { return brick * s_brickSize; }
+    /// Number of bins of a brick per dimension.
+    inline IndexType getBrickSize( const IndexType& brick ) const {
+        return ( size() - getBrickOrigin( brick ) ).cwiseMin( s_brickSize );
+    }
+    /// Get a brick. \warning no bounds checking on the parameter brick
+    inline const Brick& getBrick( const IndexType& brick ) const {
+        return m_bricks[brickIndex( brick )];
+    }
+    /// Decompress the values of a brick in \p values, whatever its storage.
+    void getBrickValues( const IndexType& brick, Container& values ) const;
+    ///@}
+
+    /// \name Compression
+    ///@{
+    /// Compress the bricks whose run length encoding is smaller than their values, and the bricks
+    /// of the mip levels.
+    void compress();
+    /// Decompress all the bricks, uniform bricks excepted.
+    void decompress();
+    /// Decompress a brick, so that its values can be accessed directly.
+    void decompressBrick( const IndexType& brick );
+    /// Memory used by the values of the bricks, in bytes.
+    size_t getMemorySize() const;
+    ///@}
+
+    /// \name Conversions
+    ///@{
+    /// Set the size, bin size and values from a dense volume.
+    void fromGrid( const VolumeGrid& grid );
+    /// Set the size, bin size and values of a dense volume.
+    void toGrid( VolumeGrid& grid ) const;
+    ///@}
+
+    /// \name Gradients
+    ///@{
+    /// Gradient of bin \p bin, with the same layout and "clamp to border" behavior as
+    /// VolumeGrid::gradient() : the 3 partial derivatives, and the value as fourth component.
+    /// \warning no bounds checking on the parameter bin
+    GradientType getGradient( const IndexType& bin ) const;
+    /// Gradients of all the bins of a brick, ordered as the brick values.
+    void computeBrickGradients( const IndexType& brick, GradientContainer& gradients ) const;
+    ///@}
+
+    /// \name Mip pyramid
+    ///@{
+    /// Compute the mip levels, each level averaging the 2x2x2 bins of the previous one, down to a
+    /// single bin. The mip levels are not updated when the volume is modified afterwards.
+    void computeMipmaps();
+    /// Number of levels of the mip pyramid, level 0 being the volume itself.
+    inline size_t getNumMipLevels() const { return m_mipLevels.size() + 1; }
+    /// Get a level of the mip pyramid, level 0 being the volume itself.
+    inline const VolumeBricked& getMipLevel( size_t level ) const {
+        CORE_ASSERT( level < getNumMipLevels(), "Invalid mip level" );
+        return level == 0 ? *this : m_mipLevels[level - 1];
+    }
+    ///@}
+
+    /// \name Modified bricks
+    ///@{
+    /// Return true if the brick has been modified since the last call to resetModifiedBricks().
+    /// All the bricks are modified when the volume is resized.
+    inline bool isBrickModified( const IndexType& brick ) const {
+        return m_modifiedBricks[brickIndex( brick )];
+    }
+    /// Mark all the bricks as not modified.
+    void resetModifiedBricks();
+    ///@}
+
+  protected:
+    /// Get the function value a given position p
+    /// \warning no bounds checking on the parameter p
+    Utils::optional<ValueType> getBinValue( typename IndexType::Scalar idx ) const override;
+
+    /// Add a value to the given bin, decompressing its brick if needed.
+    /// \warning no bounds checking on the parameter idx
+    void addToBin( const ValueType& value, typename IndexType::Scalar idx ) override;
+
+    /// Reset all the bricks to the default value.
+    void updateStorage() override;
+
+  private:
+    inline size_t brickIndex( const IndexType& brick ) const {
+        return size_t( brick.x() +
+                       m_brickCount.x() * ( brick.y() + m_brickCount.y() * brick.z() ) );
+    }
+    /// Get the value of a bin, clamping it to the volume.
+    ValueType sample( const IndexType& bin ) const;
+    /// Get the value of the bin \p idx of a brick.
+    static ValueType getBrickValue( const Brick& brick, size_t idx );
+    /// Set the values of a brick, uniform values being stored as a single value.
+    /// The brick is not marked as modified.
+    void setBrickValues( const IndexType& brick, Container& values );
+
+    ValueType m_defaultValue;
+    IndexType m_brickCount { IndexType::Zero() };
+    std::vector<Brick> m_bricks;
+    std::vector<bool> m_modifiedBricks;
+    std::vector<VolumeBricked> m_mipLevels;
+}; // class VolumeBricked
+
 /** Discrete volume data with sparse storage
  *
  * Samples are stored as SparseVolumeData::sample, which stores the bin linear
- * index, and the function value
+ * index, and the function value.
+ * Bins are found through an open addressing hash map from the bin linear index to the sample,
+ * so that getBinValue() and addToBin() run in constant expected time.
  */
 class RA_CORE_API VolumeSparse : public AbstractDiscreteVolume
 {
@@ -277,17 +446,41 @@ class RA_CORE_API VolumeSparse : public AbstractDiscreteVolume
     using AbstractDiscreteVolume::addToBin;
     using AbstractDiscreteVolume::getBinValue;
 
+    /// Direct access to the samples, in insertion order unless sortSamples() has been called.
+    inline const Container& data() const { return m_data; }
+
+    /// Reserve memory for \p count samples, avoiding rehashing during insertions.
+    void reserve( size_t count );
+
+    /**
+     * Increment the bins \p bins[i] by \p values[i], creating the missing bins.
+     * \note : bins out of bounds are ignored.
+     * \return false if some bins are out of bounds.
+     */
+    bool addToBins( const std::vector<IndexType>& bins, const std::vector<ValueType>& values );
+
+    /// Sort the samples in Morton (Z-curve) order of their bins, so that iterating over data()
+    /// visits neighbouring bins together.
+    void sortSamples();
+
+    /// Set the size, bin size and samples from a dense volume, keeping only the bins whose
+    /// value is not \p background. The samples are in the order of the grid bins.
+    void fromGrid( const VolumeGrid& grid, const ValueType& background = ValueType( 0. ) );
+
+    /// Set the size, bin size and values of a dense volume, the bins without sample keeping
+    /// the default value of \p grid.
+    void toGrid( VolumeGrid& grid ) const;
+
   protected:
     /** Get the function value at a given position p (if the bin exists)
      *
      * Returns an invalid value when no sample is registered in the targeted bin.
      *
-     * \complexity At most last - first applications of the predicate
-     * (http://en.cppreference.com/w/cpp/algorithm/find)
+     * \complexity Constant on average.
      */
     inline Utils::optional<ValueType> getBinValue( typename IndexType::Scalar idx ) const override {
-        auto res = findBin( idx );
-        if ( res != std::end( m_data ) ) return res->value;
+        const int sample = findSample( idx );
+        if ( sample >= 0 ) return m_data[size_t( sample )].value;
         return {};
     }
 
@@ -295,32 +488,45 @@ class RA_CORE_API VolumeSparse : public AbstractDiscreteVolume
     ///
     /// Create the bin if not already existing
     ///
-    /// \complexity At most last - first applications of the predicate
-    /// (http://en.cppreference.com/w/cpp/algorithm/find)
-    inline void addToBin( const ValueType& value, typename IndexType::Scalar idx ) override {
-        auto res = findBin( idx );
-        if ( res != std::end( m_data ) )
-            res->value += value;
-        else
-            m_data.emplace_back( idx, value );
-    }
+    /// \complexity Constant on average.
+    void addToBin( const ValueType& value, typename IndexType::Scalar idx ) override;
 
-    inline void updateStorage() override { m_data.clear(); }
+    inline void updateStorage() override {
+        m_data.clear();
+        m_slots.clear();
+    }
 
   private:
-    inline Container::iterator findBin( typename IndexType::Scalar idx ) {
-        return std::find_if( std::begin( m_data ),
-                             std::end( m_data ),
-                             [&idx]( const SampleType& s ) { return s.index == idx; } );
+    /// Entry of the hash map, storing the bin index and the position of its sample in m_data.
+    struct Slot {
+        int index { 0 };
+        int sample { -1 };
+    };
+
+    /// Position of the first slot to probe for the bin \p idx (Fibonacci hashing).
+    inline size_t firstSlot( int idx ) const {
+        return size_t( ( uint64_t( uint32_t( idx ) ) * 0x9E3779B97F4A7C15ull ) >> m_hashShift );
     }
-    inline Container::const_iterator findBin( typename IndexType::Scalar idx ) const {
-        return std::find_if( std::begin( m_data ),
-                             std::end( m_data ),
-                             [&idx]( const SampleType& s ) { return s.index == idx; } );
+
+    /// Position of the sample of bin \p idx in m_data, or -1 if the bin is empty.
+    inline int findSample( int idx ) const {
+        if ( m_slots.empty() ) return -1;
+        const size_t mask = m_slots.size() - 1;
+        for ( size_t s = firstSlot( idx );; s = ( s + 1 ) & mask ) {
+            const Slot& slot = m_slots[s];
+            if ( slot.sample < 0 || slot.index == idx ) return slot.sample;
+        }
     }
 
+    /// Rebuild the hash map with at least \p capacity slots.
+    void rehash( size_t capacity );
+
   private:
     Container m_data;
+    /// Hash map from the bin indices to m_data, with linear probing. Its size is a power of 2
+    /// and at least twice the number of samples.
+    std::vector<Slot> m_slots;
+    int m_hashShift { 64 };
 
 }; // class VolumeSparse
 
@@ -0,0 +1,43 @@
+#include <Core/Tasks/Parallel.hpp>
+#include <Core/Tasks/TaskQueue.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace Ra {
+namespace Core {
+
+namespace {
+std::atomic<TaskQueue*> s_parallelTaskQueue { nullptr };
+
+TaskQueue* getDefaultTaskQueue() {
+    // Created at first use, joined at exit.
+    static std::unique_ptr<TaskQueue> defaultQueue(
+        new TaskQueue( std::max( std::thread::hardware_concurrency(), 1u ) - 1 ) );
+    return defaultQueue.get();
+}
+} // namespace
+
+void setParallelTaskQueue( TaskQueue* taskQueue ) {
+    s_parallelTaskQueue.store( taskQueue, std::memory_order_release );
+}
+
+TaskQueue* getParallelTaskQueue() {
+    TaskQueue* taskQueue = s_parallelTaskQueue.load( std::memory_order_acquire );
+    return taskQueue != nullptr ? taskQueue : getDefaultTaskQueue();
+}
+
+void parallelChunks( size_t numChunks, const std::function<void( size_t )>& chunk ) {
+    getParallelTaskQueue()->runParallelChunks( numChunks, chunk );
+}
+
+size_t defaultGrainSize( size_t size ) {
+    // A few chunks per thread, for load balancing.
+    const size_t numChunks = 4 * ( size_t( getParallelTaskQueue()->getNumThreads() ) + 1 );
+    return std::max<size_t>( ( size + numChunks - 1 ) / numChunks, 1 );
+}
+
+} // namespace Core
+} // namespace Ra
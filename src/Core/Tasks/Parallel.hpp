@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Core/RaCore.hpp>
+
+#include <cstddef>
+#include <functional>
+
+namespace Ra {
+namespace Core {
+class TaskQueue;
+
+/** Data parallel loops, executed on the worker threads of a TaskQueue.
+ * The range [begin, end) is split in chunks of grainSize consecutive indices (the last one may
+ * be smaller), processed concurrently by the calling thread and the idle workers of the
+ * parallel task queue (see setParallelTaskQueue()). A grain size of 0 selects a default value,
+ * giving a few chunks per thread. Calls can be nested, and can be made from a running task.
+ */
+
+/// Sets the task queue whose workers run parallelFor() and parallelReduce(), typically the
+/// task queue of the application, so that tasks and loops share the same threads.
+/// Set to nullptr before destroying the queue : loops then use a default task queue, created
+/// at first use with one worker less than the number of hardware threads.
+RA_CORE_API void setParallelTaskQueue( TaskQueue* taskQueue );
+
+/// Returns the task queue used by parallelFor() and parallelReduce().
+RA_CORE_API TaskQueue* getParallelTaskQueue();
+
+/// Splits [0, numChunks) over the parallel task queue, and calls chunk(i) for each i.
+/// This is the non template part of the loops below.
+RA_CORE_API void parallelChunks( size_t numChunks, const std::function<void( size_t )>& chunk );
+
+/// Default grain size for a range of \p size elements.
+RA_CORE_API size_t defaultGrainSize( size_t size );
+
+/// Calls f(i) for each i in [begin, end), in parallel.
+template <typename Integer, typename Function>
+void parallelFor( Integer begin, Integer end, Function&& f, Integer grainSize = 0 );
+
+/// Calls f(chunkBegin, chunkEnd) on each chunk of [begin, end), in parallel.
+/// Useful when some setup can be shared by the iterations of a chunk.
+template <typename Integer, typename Function>
+void parallelForChunks( Integer begin, Integer end, Function&& f, Integer grainSize = 0 );
+
+/// Parallel reduction over [begin, end).
+/// \param identity the neutral element of \p reduce, used to initialize each chunk.
+/// \param f computes the value of a chunk : T f( Integer chunkBegin, Integer chunkEnd, T init ).
+/// \param reduce combines two values : T reduce( const T& a, const T& b ).
+/// The chunk values are combined in chunk order on the calling thread, so the result is
+/// deterministic for a given grain size, even for non associative floating point operations.
+template <typename T, typename Integer, typename Function, typename Reduction>
+T parallelReduce( Integer begin,
+                  Integer end,
+                  const T& identity,
+                  Function&& f,
+                  Reduction&& reduce,
+                  Integer grainSize = 0 );
+
+} // namespace Core
+} // namespace Ra
+
+#include <Core/Tasks/Parallel.inl>
@@ -0,0 +1,63 @@
+#pragma once
+#include "Parallel.hpp"
+
+#include <vector>
+
+namespace Ra {
+namespace Core {
+
+template <typename Integer, typename Function>
+void parallelForChunks( Integer begin, Integer end, Function&& f, Integer grainSize ) {
+    if ( end <= begin ) { return; }
+    const size_t size      = size_t( end - begin );
+    const size_t grain     = grainSize > 0 ? size_t( grainSize ) : defaultGrainSize( size );
+    const size_t numChunks = ( size + grain - 1 ) / grain;
+    parallelChunks( numChunks, [begin, end, grain, &f]( size_t chunk ) {
+        const Integer b = begin + Integer( chunk * grain );
+        const Integer e = ( end - b ) > Integer( grain ) ? b + Integer( grain ) : end;
+        f( b, e );
+    } );
+}
+
+template <typename Integer, typename Function>
+void parallelFor( Integer begin, Integer end, Function&& f, Integer grainSize ) {
+    parallelForChunks(
+        begin,
+        end,
+        [&f]( Integer b, Integer e ) {
+            for ( Integer i = b; i < e; ++i ) {
+                f( i );
+            }
+        },
+        grainSize );
+}
+
+template <typename T, typename Integer, typename Function, typename Reduction>
+T parallelReduce( Integer begin,
+                  Integer end,
+                  const T& identity,
+                  Function&& f,
+                  Reduction&& reduce,
+                  Integer grainSize ) {
+    if ( end <= begin ) { return identity; }
+    const size_t size      = size_t( end - begin );
+    const size_t grain     = grainSize > 0 ? size_t( grainSize ) : defaultGrainSize( size );
+    const size_t numChunks = ( size + grain - 1 ) / grain;
+
+    // One value per chunk, combined in order once all the chunks are done.
+    std::vector<T> values( numChunks, identity );
+    parallelChunks( numChunks, [begin, end, grain, &f, &values]( size_t chunk ) {
+        const Integer b = begin + Integer( chunk * grain );
+        const Integer e = ( end - b ) > Integer( grain ) ? b + Integer( grain ) : end;
+        values[chunk]   = f( b, e, values[chunk] );
+    } );
+
+    T result = values[0];
+    for ( size_t i = 1; i < numChunks; ++i ) {
+        result = reduce( result, values[i] );
+    }
+    return result;
+}
+
+} // namespace Core
+} // namespace Ra
@@ -3,14 +3,50 @@
 #include <Core/Utils/Log.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <mutex>
-#include <stack>
+#include <thread>
+#include <unordered_map>
 
 namespace Ra {
 namespace Core {
 
-TaskQueue::TaskQueue( uint numThreads ) : m_processingTasks( 0 ), m_shuttingDown( false ) {
+namespace {
+/// Number of idle rounds of a work-stealing worker only yielding before it starts sleeping.
+constexpr uint s_idleYieldRounds = 16;
+/// Maximal sleep of an idle work-stealing worker, as a power of two of microseconds.
+constexpr uint s_maxIdleSleepShift = 8;
+
+/// Waits before the next attempt of a work-stealing worker idle for \p round rounds: yields for
+/// the first rounds, then sleeps for exponentially increasing durations, up to 256 us.
+void idleBackoff( uint round ) {
+    if ( round < s_idleYieldRounds ) {
+        std::this_thread::yield();
+        return;
+    }
+    const uint shift = std::min( round - s_idleYieldRounds, s_maxIdleSleepShift );
+    std::this_thread::sleep_for( std::chrono::microseconds( 1u << shift ) );
+}
+} // namespace
+
+struct TaskQueue::ParallelJob {
+    /// Function processing one chunk.
+    const std::function<void( size_t )>* chunk;
+    /// Number of chunks of the loop.
+    size_t numChunks;
+    /// Index of the next chunk to process.
+    std::atomic<size_t> nextChunk { 0 };
+    /// Number of workers currently helping on this loop.
+    std::atomic<uint> helpers { 0 };
+};
+
+TaskQueue::TaskQueue( uint numThreads, ExecutionMode mode ) :
+    m_processingTasks( 0 ), m_shuttingDown( false ), m_executionMode( mode ) {
+    m_localQueues.reserve( numThreads );
+    for ( uint i = 0; i < numThreads; ++i ) {
+        m_localQueues.emplace_back( new WorkStealingDeque<TaskId::IntegerType>() );
+    }
     m_workerThreads.reserve( numThreads );
     for ( uint i = 0; i < numThreads; ++i ) {
         m_workerThreads.emplace_back( &TaskQueue::runThread, this, i );
@@ -19,7 +55,10 @@ TaskQueue::TaskQueue( uint numThreads ) : m_processingTasks( 0 ), m_shuttingDown
 
 TaskQueue::~TaskQueue() {
     flushTaskQueue();
-    m_shuttingDown = true;
+    {
+        std::lock_guard<std::mutex> lock( m_taskQueueMutex );
+        m_shuttingDown = true;
+    }
     m_threadNotifier.notify_all();
     for ( auto& t : m_workerThreads ) {
         t.join();
@@ -39,10 +78,11 @@ TaskQueue::TaskId TaskQueue::registerTask( std::unique_ptr<Task> task ) {
 
     m_tasks.push_back( std::move( task ) );
     m_dependencies.push_back( std::vector<TaskId>() );
-    m_remainingDependencies.push_back( 0 );
+    m_predecessorCount.push_back( 0 );
+    m_graphCompiled = false;
 
     CORE_ASSERT( m_tasks.size() == m_dependencies.size(), "Inconsistent task list" );
-    CORE_ASSERT( m_tasks.size() == m_remainingDependencies.size(), "Inconsistent task list" );
+    CORE_ASSERT( m_tasks.size() == m_predecessorCount.size(), "Inconsistent task list" );
     CORE_ASSERT( m_tasks.size() == m_timerData.size(), "Inconsistent task list" );
     return TaskId { m_tasks.size() - 1 };
 }
@@ -61,7 +101,8 @@ void TaskQueue::addDependency( TaskQueue::TaskId predecessor, TaskQueue::TaskId
                  "Cannot add a dependency twice" );
 
     m_dependencies[predecessor].push_back( successor );
-    ++m_remainingDependencies[successor];
+    ++m_predecessorCount[successor];
+    m_graphCompiled = false;
 }
 
 bool TaskQueue::addDependency( const std::string& predecessors, TaskQueue::TaskId successor ) {
@@ -90,25 +131,46 @@ void TaskQueue::addPendingDependency( const std::string& predecessors,
                                       TaskQueue::TaskId successor ) {
     std::lock_guard<std::mutex> lock( m_taskMutex );
     m_pendingDepsSucc.emplace_back( predecessors, successor );
+    m_graphCompiled = false;
 }
 
 void TaskQueue::addPendingDependency( TaskId predecessor, const std::string& successors ) {
     std::lock_guard<std::mutex> lock( m_taskMutex );
     m_pendingDepsPre.emplace_back( predecessor, successors );
+    m_graphCompiled = false;
 }
 
 void TaskQueue::resolveDependencies() {
+    if ( m_pendingDepsPre.empty() && m_pendingDepsSucc.empty() ) { return; }
+
+    // Index the tasks by name once, instead of scanning all the tasks for each dependency.
+    std::unordered_map<std::string, std::vector<TaskId>> tasksByName;
+    tasksByName.reserve( m_tasks.size() );
+    for ( uint i = 0; i < m_tasks.size(); ++i ) {
+        tasksByName[m_tasks[i]->getName()].push_back( TaskId { i } );
+    }
+
     for ( const auto& pre : m_pendingDepsPre ) {
-        ON_ASSERT( bool result = ) addDependency( pre.first, pre.second );
-        CORE_WARN_IF( !result,
+        auto it = tasksByName.find( pre.second );
+        CORE_WARN_IF( it == tasksByName.end(),
                       "Pending dependency unresolved : " << m_tasks[pre.first]->getName() << " -> ("
                                                          << pre.second << ")" );
+        if ( it != tasksByName.end() ) {
+            for ( const auto& succ : it->second ) {
+                addDependency( pre.first, succ );
+            }
+        }
     }
     for ( const auto& pre : m_pendingDepsSucc ) {
-        ON_ASSERT( bool result = ) addDependency( pre.first, pre.second );
-        CORE_WARN_IF( !result,
+        auto it = tasksByName.find( pre.first );
+        CORE_WARN_IF( it == tasksByName.end(),
                       "Pending dependency unresolved : (" << pre.first << ") -> "
                                                           << m_tasks[pre.second]->getName() );
+        if ( it != tasksByName.end() ) {
+            for ( const auto& pred : it->second ) {
+                addDependency( pred, pre.second );
+            }
+        }
     }
     std::lock_guard<std::mutex> lock( m_taskMutex );
     m_pendingDepsPre.clear();
@@ -123,33 +185,34 @@ void TaskQueue::queueTask( TaskQueue::TaskId task ) {
     m_taskQueue.push_front( task );
 }
 
-void TaskQueue::detectCycles() {
-#if defined( CORE_DEBUG )
-    // Do a depth-first search of the nodes.
-    std::vector<bool> visited( m_tasks.size(), false );
-    std::stack<TaskId> pending;
-
-    for ( uint id = 0; id < m_tasks.size(); ++id ) {
-        if ( m_dependencies[id].size() == 0 ) { pending.push( TaskId( id ) ); }
-    }
-
-    // If you hit this assert, there are tasks in the list but
-    // all tasks have dependencies so no task can start.
-    CORE_ASSERT( m_tasks.empty() || !pending.empty(), "No free tasks." );
-
-    while ( !pending.empty() ) {
-        TaskId id = pending.top();
-        pending.pop();
+void TaskQueue::compileGraph() {
+    if ( m_graphCompiled ) { return; }
 
-        // The task has already been visited. It means there is a cycle in the task graph.
-        CORE_ASSERT( !( visited[id] ), "Cycle detected in tasks !" );
+    // Add pending dependencies.
+    resolveDependencies();
 
-        visited[id] = true;
-        for ( const auto& dep : m_dependencies[id] ) {
-            pending.push( dep );
+    // Sort the tasks in topological order (Kahn's algorithm). The tasks without predecessors
+    // are the roots of the graph, started first at each run.
+    const uint numTasks         = uint( m_tasks.size() );
+    std::vector<uint> remaining = m_predecessorCount;
+    m_rootTasks.clear();
+    m_topologicalOrder.clear();
+    m_topologicalOrder.reserve( numTasks );
+    for ( uint t = 0; t < numTasks; ++t ) {
+        if ( remaining[t] == 0 ) {
+            m_rootTasks.push_back( TaskId { t } );
+            m_topologicalOrder.push_back( TaskId { t } );
+        }
+    }
+    for ( uint i = 0; i < m_topologicalOrder.size(); ++i ) {
+        for ( const auto& succ : m_dependencies[m_topologicalOrder[i]] ) {
+            if ( --remaining[succ] == 0 ) { m_topologicalOrder.push_back( succ ); }
         }
     }
-#endif
+    // If you hit this assert, some tasks can never start : there is a cycle in the task graph.
+    CORE_ASSERT( m_topologicalOrder.size() == numTasks, "Cycle detected in tasks !" );
+
+    m_graphCompiled = true;
 }
 
 void TaskQueue::startTasks() {
@@ -160,15 +223,46 @@ void TaskQueue::startTasks() {
         return;
     }
 
-    // Add pending dependencies.
-    resolveDependencies();
+    // Resolve and sort the task graph, only if it changed since the last run.
+    compileGraph();
 
-    // Do a debug check
-    detectCycles();
+    if ( m_executionMode == ExecutionMode::WorkStealing ) {
+        if ( m_tasks.empty() ) { return; }
+        // Workers are all sleeping at this point (waitForTasks waits for them), so their deques
+        // can be safely filled from this thread.
+        const uint numTasks = uint( m_tasks.size() );
+        if ( m_atomicDependencies.size() != numTasks ) {
+            m_atomicDependencies = std::vector<std::atomic<uint>>( numTasks );
+        }
+        for ( uint t = 0; t < numTasks; ++t ) {
+            m_atomicDependencies[t].store( m_predecessorCount[t], std::memory_order_relaxed );
+        }
+        for ( auto& q : m_localQueues ) {
+            q->reset( numTasks );
+        }
+        // Distribute all tasks with no dependencies over the workers.
+        uint worker = 0;
+        for ( const auto& t : m_rootTasks ) {
+            m_localQueues[worker]->push( t.getValue() );
+            worker = ( worker + 1 ) % m_localQueues.size();
+        }
+        m_unfinishedTasks.store( numTasks, std::memory_order_relaxed );
+        m_activeWorkers.store( uint( m_workerThreads.size() ), std::memory_order_relaxed );
+        {
+            std::lock_guard<std::mutex> lock( m_taskQueueMutex );
+            ++m_runGeneration;
+        }
+        m_threadNotifier.notify_all();
+        return;
+    }
 
-    // Enqueue all tasks with no dependencies.
-    for ( uint t = 0; t < m_tasks.size(); ++t ) {
-        if ( m_remainingDependencies[t] == 0 ) { queueTask( TaskId { t } ); }
+    // Reset the dependency counters and enqueue all tasks with no dependencies.
+    {
+        std::lock_guard<std::mutex> lock( m_taskQueueMutex );
+        m_remainingDependencies = m_predecessorCount;
+        for ( const auto& t : m_rootTasks ) {
+            queueTask( t );
+        }
     }
 
     // Wake up all threads.
@@ -177,35 +271,19 @@ void TaskQueue::startTasks() {
 
 void TaskQueue::runTasksInThisThread() {
 
-    // lock task queue so no other worker can start working while this thread do the job.
-    std::lock_guard<std::mutex> lock( m_taskQueueMutex );
-
-    // Add pending dependencies.
-    resolveDependencies();
-
-    // Do a debug check
-    detectCycles();
+    // Tasks are never put in m_taskQueue here, so workers cannot pick them and m_taskQueueMutex
+    // does not need to be held while they run. Keeping it unlocked lets a task call
+    // runParallelChunks(), which locks it to share its chunks with the workers.
 
-    // Enqueue all tasks with no dependencies.
-    for ( uint t = 0; t < m_tasks.size(); ++t ) {
-        if ( m_remainingDependencies[t] == 0 ) { queueTask( TaskId { t } ); }
-    }
-    while ( !m_taskQueue.empty() ) {
-        TaskId task { m_taskQueue.back() };
-        m_taskQueue.pop_back();
+    // Resolve and sort the task graph, only if it changed since the last run.
+    compileGraph();
 
-        // Run task
+    // The topological order satisfies all the dependencies.
+    for ( const auto& task : m_topologicalOrder ) {
         m_timerData[task].start    = Utils::Clock::now();
         m_timerData[task].threadId = 0;
         m_tasks[task]->process();
         m_timerData[task].end = Utils::Clock::now();
-
-        for ( auto t : m_dependencies[task] ) {
-            uint& nDepends = m_remainingDependencies[t];
-            CORE_ASSERT( nDepends > 0, "Inconsistency in dependencies" );
-            --nDepends;
-            if ( nDepends == 0 ) { queueTask( t ); }
-        }
     }
     flushTaskQueue();
 }
@@ -216,13 +294,14 @@ void TaskQueue::waitForTasks() {
         // TODO : use a notifier for task queue empty.
         {
             std::lock_guard<std::mutex> lock( m_taskQueueMutex );
-            isFinished = ( m_taskQueue.empty() && m_processingTasks == 0 );
+            isFinished = ( m_taskQueue.empty() && m_processingTasks == 0 &&
+                           m_activeWorkers.load( std::memory_order_acquire ) == 0 );
         }
         if ( !isFinished ) { std::this_thread::yield(); }
     }
 }
 
-const std::vector<TaskQueue::TimerData>& TaskQueue::getTimerData() {
+const std::vector<TaskQueue::TimerData>& TaskQueue::getTimerData() const {
     return m_timerData;
 }
 
@@ -232,13 +311,27 @@ void TaskQueue::flushTaskQueue() {
     CORE_ASSERT( m_processingTasks == 0, "You have tasks still in process" );
     CORE_ASSERT( m_taskQueue.empty(), " You have unprocessed tasks " );
 
+    CORE_ASSERT( m_activeWorkers == 0, "You have workers still running" );
+
     m_tasks.clear();
     m_dependencies.clear();
     m_timerData.clear();
+    m_predecessorCount.clear();
     m_remainingDependencies.clear();
+    m_atomicDependencies.clear();
+    m_rootTasks.clear();
+    m_topologicalOrder.clear();
+    m_graphCompiled = false;
+}
+
+void TaskQueue::setExecutionMode( ExecutionMode mode ) {
+    CORE_ASSERT( m_activeWorkers == 0 && m_processingTasks == 0,
+                 "Cannot change execution mode while tasks are running" );
+    m_executionMode = mode;
 }
 
 void TaskQueue::runThread( uint id ) {
+    uint generation = 0;
     while ( true ) {
         TaskId task;
 
@@ -246,12 +339,31 @@ void TaskQueue::runThread( uint id ) {
         {
             std::unique_lock<std::mutex> lock( m_taskQueueMutex );
 
-            // Wait for a new task
-            m_threadNotifier.wait( lock,
-                                   [this]() { return m_shuttingDown || !m_taskQueue.empty(); } );
+            // Wait for a new task, a new work-stealing run, or a parallel loop to help
+            ParallelJob* job = nullptr;
+            m_threadNotifier.wait( lock, [this, generation, &job]() {
+                return m_shuttingDown || !m_taskQueue.empty() || m_runGeneration != generation ||
+                       ( job = acquireParallelJob() ) != nullptr;
+            } );
             // If the task queue is shutting down we quit, releasing
             // the lock.
-            if ( m_shuttingDown ) { return; }
+            if ( m_shuttingDown ) {
+                if ( job != nullptr ) { job->helpers.fetch_sub( 1, std::memory_order_release ); }
+                return;
+            }
+
+            if ( job != nullptr ) {
+                lock.unlock();
+                processParallelJob( job );
+                continue;
+            }
+
+            if ( m_runGeneration != generation ) {
+                generation = m_runGeneration;
+                lock.unlock();
+                runWorkStealing( id );
+                continue;
+            }
 
             // If we are here it means we got a task
             task = m_taskQueue.back();
@@ -288,6 +400,126 @@ void TaskQueue::runThread( uint id ) {
     } // End of while(true)
 }
 
+void TaskQueue::runWorkStealing( uint id ) {
+    const uint numQueues = uint( m_localQueues.size() );
+    auto& localQueue     = *m_localQueues[id];
+    TaskId task;
+    TaskId::IntegerType value;
+    uint idleRounds = 0;
+
+    while ( m_unfinishedTasks.load( std::memory_order_acquire ) > 0 ) {
+        if ( task.isInvalid() && localQueue.pop( value ) ) { task = TaskId { value }; }
+        // Local deque is empty, try to steal from the other workers, starting with the next one.
+        for ( uint i = 1; task.isInvalid() && i < numQueues; ++i ) {
+            auto& victim = *m_localQueues[( id + i ) % numQueues];
+            if ( victim.steal( value ) ) { task = TaskId { value }; }
+        }
+        if ( task.isInvalid() ) {
+            // No task available, help a parallel loop started by a running task.
+            if ( m_numParallelJobs.load( std::memory_order_relaxed ) > 0 ) {
+                ParallelJob* job = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock( m_taskQueueMutex );
+                    job = acquireParallelJob();
+                }
+                if ( job != nullptr ) {
+                    processParallelJob( job );
+                    idleRounds = 0;
+                    continue;
+                }
+            }
+            idleBackoff( idleRounds++ );
+            continue;
+        }
+        idleRounds = 0;
+        task       = processStealingTask( task, id );
+    }
+    // Release so that waitForTasks sees all the writes done by the tasks.
+    m_activeWorkers.fetch_sub( 1, std::memory_order_release );
+}
+
+TaskQueue::TaskId TaskQueue::processStealingTask( TaskId task, uint id ) {
+    CORE_ASSERT( task.isValid() && task < m_tasks.size(), "Invalid task" );
+
+    // Run task
+    m_timerData[task].start    = Utils::Clock::now();
+    m_timerData[task].threadId = id;
+    m_tasks[task]->process();
+    m_timerData[task].end = Utils::Clock::now();
+
+    // Mark successors, keep the first ready one to run it immediately on this thread.
+    TaskId next;
+    for ( auto t : m_dependencies[task] ) {
+        const uint nDepends = m_atomicDependencies[t].fetch_sub( 1, std::memory_order_acq_rel );
+        CORE_ASSERT( nDepends > 0, "Inconsistency in dependencies" );
+        if ( nDepends == 1 ) {
+            if ( next.isInvalid() ) { next = t; }
+            else { m_localQueues[id]->push( t.getValue() ); }
+        }
+    }
+    m_unfinishedTasks.fetch_sub( 1, std::memory_order_acq_rel );
+    return next;
+}
+
+void TaskQueue::runParallelChunks( size_t numChunks,
+                                   const std::function<void( size_t )>& chunk ) {
+    // Nothing to share with the workers.
+    if ( numChunks < 2 || m_workerThreads.empty() ) {
+        for ( size_t i = 0; i < numChunks; ++i ) {
+            chunk( i );
+        }
+        return;
+    }
+
+    ParallelJob job;
+    job.chunk     = &chunk;
+    job.numChunks = numChunks;
+    {
+        std::lock_guard<std::mutex> lock( m_taskQueueMutex );
+        m_parallelJobs.push_back( &job );
+        m_numParallelJobs.store( uint( m_parallelJobs.size() ), std::memory_order_relaxed );
+    }
+    m_threadNotifier.notify_all();
+
+    // The calling thread processes chunks too, so that the loop completes even if all the
+    // workers are busy (e.g. when called from a task).
+    size_t i;
+    while ( ( i = job.nextChunk.fetch_add( 1, std::memory_order_relaxed ) ) < numChunks ) {
+        chunk( i );
+    }
+
+    // No worker can start helping once the job is unregistered, wait for the ones that
+    // are still processing their last chunk.
+    {
+        std::lock_guard<std::mutex> lock( m_taskQueueMutex );
+        m_parallelJobs.erase( std::find( m_parallelJobs.begin(), m_parallelJobs.end(), &job ) );
+        m_numParallelJobs.store( uint( m_parallelJobs.size() ), std::memory_order_relaxed );
+    }
+    while ( job.helpers.load( std::memory_order_acquire ) > 0 ) {
+        std::this_thread::yield();
+    }
+}
+
+// acquireParallelJob is always called with m_taskQueueMutex locked
+TaskQueue::ParallelJob* TaskQueue::acquireParallelJob() {
+    for ( auto job : m_parallelJobs ) {
+        if ( job->nextChunk.load( std::memory_order_relaxed ) < job->numChunks ) {
+            job->helpers.fetch_add( 1, std::memory_order_relaxed );
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void TaskQueue::processParallelJob( ParallelJob* job ) {
+    size_t i;
+    while ( ( i = job->nextChunk.fetch_add( 1, std::memory_order_relaxed ) ) < job->numChunks ) {
+        ( *job->chunk )( i );
+    }
+    // Release so that the thread which started the loop sees all the writes of the chunks.
+    job->helpers.fetch_sub( 1, std::memory_order_release );
+}
+
 void TaskQueue::printTaskGraph( std::ostream& output ) const {
     output << "digraph tasks {" << std::endl;
 
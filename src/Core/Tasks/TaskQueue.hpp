@@ -1,14 +1,17 @@
 #pragma once
 
 #include <Core/RaCore.hpp>
+#include <atomic>
 #include <condition_variable>
 #include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include <Core/Tasks/WorkStealingDeque.hpp>
 #include <Core/Utils/Index.hpp>
 #include <Core/Utils/Timer.hpp> // Ra::Core::TimePoint
 
@@ -27,6 +30,22 @@ namespace Core {
  * are satisfied, i.e. all dependant tasks are finished.
  * Note that most functions are not thread safe and must not be called when the task queue is
  * running.
+ *
+ * Two execution modes are available (see ExecutionMode) :
+ *  - GlobalQueue : all ready tasks are stored in a single queue protected by a mutex.
+ *  - WorkStealing : each worker owns a lock-free deque. Successors made ready by a finished task
+ *    are pushed on the local deque of the worker (and the first one is run immediately), idle
+ *    workers steal tasks from the other deques. This mode avoids contention on the global mutex
+ *    when many small tasks are run each frame.
+ * Both modes share the same task registration and dependency API.
+ *
+ * The task graph is persistent : once started, tasks are kept until flushTaskQueue() is called.
+ * The graph (named dependencies resolution and topological sort) is compiled at the first run
+ * following a modification, and calling startTasks() again after waitForTasks() replays it,
+ * only resetting the dependency counters.
+ *
+ * The worker threads are also used for data parallel loops (see runParallelChunks() and
+ * Core/Tasks/Parallel.hpp) : idle workers help the thread that started the loop.
  */
 class RA_CORE_API TaskQueue
 {
@@ -42,10 +61,16 @@ class RA_CORE_API TaskQueue
         std::string taskName;
     };
 
+    /// Scheduling strategy used by the worker threads.
+    enum class ExecutionMode {
+        GlobalQueue, ///< One shared queue, protected by a mutex.
+        WorkStealing ///< Per-worker lock-free deques with task stealing.
+    };
+
   public:
     /// Constructor. Initializes the thread worker pools with numThreads threads.
     /// if numThreads == 0, its a runTasksInThisThread only task queue
-    explicit TaskQueue( uint numThreads );
+    explicit TaskQueue( uint numThreads, ExecutionMode mode = ExecutionMode::GlobalQueue );
 
     /// Destructor. Waits for all the threads and safely deletes them.
     ~TaskQueue();
@@ -80,6 +105,7 @@ class RA_CORE_API TaskQueue
 
     /// Launches the execution of all the threads in the task queue.
     /// No more tasks should be added at this point.
+    /// Once waitForTasks() returned, it can be called again to replay the same tasks.
     void startTasks();
 
     /// Launches the execution of all task in the thread of the caller.
@@ -92,25 +118,67 @@ class RA_CORE_API TaskQueue
     void waitForTasks();
 
     /// Access the data from the last frame execution after processTaskQueue();
-    const std::vector<TimerData>& getTimerData();
+    const std::vector<TimerData>& getTimerData() const;
+
+    /// Tasks depending on \p task, i.e. started only once \p task is finished.
+    /// Named dependencies are only included once resolved by a run of the tasks.
+    const std::vector<TaskId>& getSuccessors( TaskId task ) const { return m_dependencies[task]; }
 
     /// Erases all tasks. Will assert if tasks are unprocessed.
     void flushTaskQueue();
 
+    /// Number of registered tasks.
+    size_t getNumTasks() const { return m_tasks.size(); }
+
     /// Prints the current task graph in dot format
     void printTaskGraph( std::ostream& output ) const;
 
+    /// Change the scheduling strategy. Must not be called while tasks are running.
+    void setExecutionMode( ExecutionMode mode );
+    ExecutionMode getExecutionMode() const { return m_executionMode; }
+
+    /// Number of worker threads.
+    uint getNumThreads() const { return uint( m_workerThreads.size() ); }
+
+    //
+    // Data parallel loops
+    //
+
+    /// Calls \p chunk(i) for each i in [0, numChunks), on the calling thread and on the idle
+    /// workers, and returns when all the chunks are processed.
+    /// The calling thread always participates, so this can be called from any thread, including
+    /// from a task running on this queue, and nested loops are allowed.
+    void runParallelChunks( size_t numChunks, const std::function<void( size_t )>& chunk );
+
   private:
+    /// A data parallel loop started by runParallelChunks(), defined in TaskQueue.cpp.
+    struct ParallelJob;
+
+    /// Returns a parallel loop with unprocessed chunks, or nullptr if there is none, and
+    /// registers the caller as one of its helpers. Must be called with m_taskQueueMutex locked.
+    ParallelJob* acquireParallelJob();
+
+    /// Processes the chunks of \p job until there is none left.
+    static void processParallelJob( ParallelJob* job );
+
     /// Function called by a new thread.
     void runThread( uint id );
 
+    /// Work-stealing loop of worker \p id, returns when all the tasks of the run are done.
+    void runWorkStealing( uint id );
+
+    /// Runs \p task on worker \p id in work-stealing mode, pushes its ready successors on the
+    /// worker local deque and returns one of them (or an invalid id) to be run next.
+    TaskId processStealingTask( TaskId task, uint id );
+
     /// Puts the task on the queue to be executed. A task can only be queued if it has
     /// no dependencies.
     void queueTask( TaskId task );
 
-    /// Detect if there are any cycles in the task graph, and asserts if it is the case.
-    /// (this function is compiled to nothing in release).
-    void detectCycles();
+    /// Resolves pending dependencies, sorts the tasks in topological order and finds the root
+    /// tasks. Asserts if there are any cycles in the task graph. Does nothing if the graph did not
+    /// change since the last call.
+    void compileGraph();
 
     /// Resolves the pending named dependencies. Will assert if dependencies don't resolve.
     void resolveDependencies();
@@ -123,10 +191,19 @@ class RA_CORE_API TaskQueue
     /// For each task, stores which tasks depend on it.
     std::vector<std::vector<TaskId>> m_dependencies;
 
+    /// For each task, number of tasks it depends on (reset value of m_remainingDependencies).
+    std::vector<uint> m_predecessorCount;
+
     /// List of pending dependencies
     std::vector<std::pair<TaskId, std::string>> m_pendingDepsPre;
     std::vector<std::pair<std::string, TaskId>> m_pendingDepsSucc;
 
+    /// Compiled graph : tasks without dependencies, and all the tasks in topological order.
+    std::vector<TaskId> m_rootTasks;
+    std::vector<TaskId> m_topologicalOrder;
+    /// False when the graph has been modified since its last compilation.
+    bool m_graphCompiled { false };
+
     /// Stores the timings of each frame after execution.
     std::vector<TimerData> m_timerData;
 
@@ -150,6 +227,32 @@ class RA_CORE_API TaskQueue
     /// Mutex for task registration (m_tasks, m_dependencies, m_timerData ...), if tasks are
     /// registered from multiple threads
     std::mutex m_taskMutex;
+
+    //
+    // work-stealing mode variables.
+    //
+
+    /// Scheduling strategy of the worker threads.
+    ExecutionMode m_executionMode;
+    /// One deque of ready tasks per worker.
+    std::vector<std::unique_ptr<WorkStealingDeque<TaskId::IntegerType>>> m_localQueues;
+    /// Number of tasks each task is waiting on, decremented concurrently by workers.
+    std::vector<std::atomic<uint>> m_atomicDependencies;
+    /// Number of tasks of the current run not yet finished.
+    std::atomic<uint> m_unfinishedTasks { 0 };
+    /// Number of workers that did not leave the current run yet.
+    std::atomic<uint> m_activeWorkers { 0 };
+    /// Incremented at each work-stealing run start, protected by m_taskQueueMutex.
+    uint m_runGeneration { 0 };
+
+    //
+    // data parallel loops variables.
+    //
+
+    /// Running parallel loops, protected by m_taskQueueMutex.
+    std::vector<ParallelJob*> m_parallelJobs;
+    /// Size of m_parallelJobs, readable without locking.
+    std::atomic<uint> m_numParallelJobs { 0 };
 };
 
 } // namespace Core
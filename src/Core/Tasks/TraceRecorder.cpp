@@ -0,0 +1,147 @@
+#include <Core/Tasks/TaskQueue.hpp>
+#include <Core/Tasks/TraceRecorder.hpp>
+#include <Core/Utils/Log.hpp>
+
+#include <algorithm>
+#include <iomanip>
+
+namespace Ra {
+namespace Core {
+
+namespace {
+// Writes s as a JSON string.
+void writeString( std::ostream& out, const std::string& s ) {
+    out << '"';
+    for ( char c : s ) {
+        switch ( c ) {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        case '\t':
+            out << "\\t";
+            break;
+        default:
+            // other control characters are not expected in names.
+            if ( static_cast<unsigned char>( c ) >= 0x20 ) { out << c; }
+        }
+    }
+    out << '"';
+}
+} // namespace
+
+TraceRecorder::~TraceRecorder() {
+    stop();
+}
+
+bool TraceRecorder::start( const std::string& filename, uint numFrames ) {
+    using namespace Ra::Core::Utils; // log
+    stop();
+    m_file.open( filename, std::ios::out | std::ios::trunc );
+    if ( !m_file.is_open() ) {
+        LOG( logERROR ) << "TraceRecorder : could not open " << filename;
+        return false;
+    }
+    m_origin            = Utils::Clock::now();
+    m_numFrames         = numFrames;
+    m_numRecordedFrames = 0;
+    m_nextFlowId        = 0;
+    m_hasEvents         = false;
+    m_namedTracks.clear();
+
+    m_file << std::fixed << std::setprecision( 3 );
+    m_file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    beginEvent( "process_name", "", 'M', 0 );
+    m_file << ",\"args\":{\"name\":\"Radium\"}}";
+    LOG( logINFO ) << "TraceRecorder : recording " << numFrames << " frames to " << filename;
+    return true;
+}
+
+void TraceRecorder::stop() {
+    if ( !m_file.is_open() ) { return; }
+    m_file << "\n]}\n";
+    m_file.close();
+}
+
+void TraceRecorder::addSpan( const std::string& name,
+                             const std::string& category,
+                             const Utils::TimePoint& start,
+                             const Utils::TimePoint& end,
+                             uint track ) {
+    if ( !isRecording() ) { return; }
+    nameTrack( track );
+    beginEvent( name, category, 'X', track );
+    const double ts = timestamp( start );
+    m_file << ",\"ts\":" << ts << ",\"dur\":" << std::max( timestamp( end ) - ts, 0. ) << "}";
+}
+
+void TraceRecorder::addTasks( const TaskQueue& taskQueue ) {
+    if ( !isRecording() ) { return; }
+    const auto& timerData = taskQueue.getTimerData();
+    for ( const auto& t : timerData ) {
+        addSpan( t.taskName, "task", t.start, t.end, t.threadId + 1 );
+    }
+    // A flow arrow per dependency, from the start of the predecessor span to the start of the
+    // successor span (flow events are bound to the span enclosing their timestamp).
+    for ( uint i = 0; i < timerData.size(); ++i ) {
+        const auto& pred = timerData[i];
+        for ( const auto& s : taskQueue.getSuccessors( TaskQueue::TaskId { i } ) ) {
+            const auto& succ = timerData[s];
+            const uint id    = m_nextFlowId++;
+            beginEvent( "dependency", "task", 's', pred.threadId + 1 );
+            m_file << ",\"id\":" << id << ",\"ts\":" << timestamp( pred.start ) << "}";
+            beginEvent( "dependency", "task", 'f', succ.threadId + 1 );
+            m_file << ",\"id\":" << id << ",\"bp\":\"e\",\"ts\":" << timestamp( succ.start )
+                   << "}";
+        }
+    }
+}
+
+void TraceRecorder::endFrame() {
+    if ( !isRecording() ) { return; }
+    ++m_numRecordedFrames;
+    // Make sure the events are on disk if the application does not exit properly.
+    m_file.flush();
+    if ( m_numFrames > 0 && m_numRecordedFrames >= m_numFrames ) {
+        using namespace Ra::Core::Utils; // log
+        LOG( logINFO ) << "TraceRecorder : " << m_numRecordedFrames << " frames recorded";
+        stop();
+    }
+}
+
+void TraceRecorder::beginEvent( const std::string& name,
+                                const std::string& category,
+                                char phase,
+                                uint track ) {
+    m_file << ( m_hasEvents ? ",\n" : "\n" ) << "{\"name\":";
+    writeString( m_file, name );
+    if ( !category.empty() ) {
+        m_file << ",\"cat\":";
+        writeString( m_file, category );
+    }
+    m_file << ",\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << track;
+    m_hasEvents = true;
+}
+
+void TraceRecorder::nameTrack( uint track ) {
+    if ( !m_namedTracks.insert( track ).second ) { return; }
+    beginEvent( "thread_name", "", 'M', track );
+    m_file << ",\"args\":{\"name\":";
+    writeString( m_file, track == 0 ? "Main thread" : "Worker " + std::to_string( track - 1 ) );
+    m_file << "}}";
+    // Keep the main thread above the workers.
+    beginEvent( "thread_sort_index", "", 'M', track );
+    m_file << ",\"args\":{\"sort_index\":" << track << "}}";
+}
+
+double TraceRecorder::timestamp( const Utils::TimePoint& t ) const {
+    return std::chrono::duration<double, std::micro>( t - m_origin ).count();
+}
+
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Core/RaCore.hpp>
+#include <Core/Utils/Timer.hpp> // Ra::Core::TimePoint
+
+#include <fstream>
+#include <set>
+#include <string>
+
+namespace Ra {
+namespace Core {
+class TaskQueue;
+
+/** Records frame timelines to a Chrome trace-event JSON file, that can be opened with
+ * Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+ * Events are streamed to the file as frames are recorded, and the recording stops by itself
+ * once the requested number of frames has been recorded.
+ * Spans are displayed on tracks : track 0 is the main thread, track i + 1 is the worker i of
+ * the task queue. Task dependencies are displayed as flow arrows between task spans.
+ *
+ * Typical use, once per frame :
+ * \code{.cpp}
+ * recorder.addSpan( "Frame", "frame", frameStart, frameEnd );
+ * recorder.addTasks( taskQueue );
+ * recorder.endFrame();
+ * \endcode
+ */
+class RA_CORE_API TraceRecorder
+{
+  public:
+    TraceRecorder() = default;
+    TraceRecorder( const TraceRecorder& ) = delete;
+    TraceRecorder& operator=( const TraceRecorder& ) = delete;
+
+    /// Closes the file if still recording.
+    ~TraceRecorder();
+
+    /// Starts recording \p numFrames frames (0 for no limit) to \p filename.
+    /// Timestamps are relative to the time of this call.
+    /// \return false if the file could not be opened.
+    bool start( const std::string& filename, uint numFrames );
+
+    /// Ends the recording and closes the file.
+    void stop();
+
+    /// True between start() and stop() (or the end of the last requested frame).
+    bool isRecording() const { return m_file.is_open(); }
+
+    /// Number of frames recorded since start().
+    uint getNumRecordedFrames() const { return m_numRecordedFrames; }
+
+    /// Adds a span named \p name, from \p start to \p end on the track \p track.
+    /// Spans of the same track must be either disjoint or nested.
+    void addSpan( const std::string& name,
+                  const std::string& category,
+                  const Utils::TimePoint& start,
+                  const Utils::TimePoint& end,
+                  uint track = 0 );
+
+    /// Adds the spans of the last run of \p taskQueue on the tracks of its workers, and the
+    /// dependencies between tasks.
+    void addTasks( const TaskQueue& taskQueue );
+
+    /// Notifies the end of a frame, and stops the recording after the requested number of frames.
+    void endFrame();
+
+  private:
+    /// Writes the separator and the beginning of a new event, common to all events.
+    void beginEvent( const std::string& name, const std::string& category, char phase, uint track );
+    /// Names \p track in the trace at its first use.
+    void nameTrack( uint track );
+    /// Timestamp of \p t in microseconds, from the recording start.
+    double timestamp( const Utils::TimePoint& t ) const;
+
+  private:
+    std::ofstream m_file;
+    /// Time origin of the trace.
+    Utils::TimePoint m_origin;
+    /// Number of frames to record, 0 for unlimited.
+    uint m_numFrames { 0 };
+    uint m_numRecordedFrames { 0 };
+    /// Identifier of the next flow (dependency) event.
+    uint m_nextFlowId { 0 };
+    /// False until the first event is written (no separator needed).
+    bool m_hasEvents { false };
+    /// Tracks already named in the trace.
+    std::set<uint> m_namedTracks;
+};
+
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <Core/RaCore.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace Ra {
+namespace Core {
+
+/** Lock-free, fixed capacity, single-owner / multiple-thieves deque (Chase-Lev).
+ * The owner thread pushes and pops at the bottom end, while any other thread may steal from
+ * the top end. Memory orderings follow "Correct and Efficient Work-Stealing for Weak Memory
+ * Models" (Lê et al., PPoPP 2013).
+ * The capacity is not grown while the deque is in use: call reset() with an upper bound of the
+ * number of elements that will be pushed, when no thread is accessing the deque.
+ * \tparam T must be trivially copyable (e.g. an integer index).
+ */
+template <typename T>
+class WorkStealingDeque
+{
+    static_assert( std::is_trivially_copyable<T>::value,
+                   "WorkStealingDeque elements must be trivially copyable" );
+
+  public:
+    WorkStealingDeque() = default;
+    WorkStealingDeque( const WorkStealingDeque& ) = delete;
+    WorkStealingDeque& operator=( const WorkStealingDeque& ) = delete;
+
+    /// Empties the deque and makes sure it can hold at least \p capacity elements.
+    /// Not thread safe.
+    void reset( size_t capacity ) {
+        size_t cap = 1;
+        while ( cap < capacity ) {
+            cap <<= 1;
+        }
+        if ( cap > m_capacity ) {
+            m_buffer.reset( new std::atomic<T>[cap] );
+            m_capacity = cap;
+        }
+        m_top.store( 0, std::memory_order_relaxed );
+        m_bottom.store( 0, std::memory_order_relaxed );
+    }
+
+    /// Pushes an element at the bottom of the deque. Owner thread only.
+    void push( T value ) {
+        const int64_t b = m_bottom.load( std::memory_order_relaxed );
+        CORE_ASSERT( b - m_top.load( std::memory_order_relaxed ) < int64_t( m_capacity ),
+                     "WorkStealingDeque overflow" );
+        m_buffer[size_t( b ) & ( m_capacity - 1 )].store( value, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+        m_bottom.store( b + 1, std::memory_order_relaxed );
+    }
+
+    /// Pops the most recently pushed element. Owner thread only.
+    /// \return false if the deque was empty (or its last element has been stolen).
+    bool pop( T& value ) {
+        const int64_t b = m_bottom.load( std::memory_order_relaxed ) - 1;
+        m_bottom.store( b, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        int64_t t = m_top.load( std::memory_order_relaxed );
+        if ( t > b ) {
+            // empty deque
+            m_bottom.store( b + 1, std::memory_order_relaxed );
+            return false;
+        }
+        value = m_buffer[size_t( b ) & ( m_capacity - 1 )].load( std::memory_order_relaxed );
+        if ( t == b ) {
+            // last element, race against thieves
+            const bool won = m_top.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed );
+            m_bottom.store( b + 1, std::memory_order_relaxed );
+            return won;
+        }
+        return true;
+    }
+
+    /// Steals the least recently pushed element. Can be called from any thread.
+    /// \return false if the deque was empty or if another thread won the race.
+    bool steal( T& value ) {
+        int64_t t = m_top.load( std::memory_order_acquire );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        const int64_t b = m_bottom.load( std::memory_order_acquire );
+        if ( t >= b ) { return false; }
+        value = m_buffer[size_t( t ) & ( m_capacity - 1 )].load( std::memory_order_relaxed );
+        return m_top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed );
+    }
+
+    /// Approximate emptiness test, exact only when no other thread accesses the deque.
+    bool empty() const {
+        return m_bottom.load( std::memory_order_relaxed ) <=
+               m_top.load( std::memory_order_relaxed );
+    }
+
+  private:
+    /// Ring buffer storage, size is m_capacity (a power of two).
+    std::unique_ptr<std::atomic<T>[]> m_buffer { nullptr };
+    size_t m_capacity { 0 };
+    /// Index of the next element to steal.
+    alignas( 64 ) std::atomic<int64_t> m_top { 0 };
+    /// Index of the next free slot for the owner.
+    alignas( 64 ) std::atomic<int64_t> m_bottom { 0 };
+};
+
+} // namespace Core
+} // namespace Ra
@@ -5,7 +5,10 @@
 # ----------------------------------------------------
 
 set(core_sources
+    Animation/AnimationCache.cpp
     Animation/Cage.cpp
+    Animation/CompactPose.cpp
+    Animation/CompressedAnimation.cpp
     Animation/DualQuaternionSkinning.cpp
     Animation/HandleArray.cpp
     Animation/HandleWeightOperation.cpp
@@ -24,18 +27,23 @@ set(core_sources
     Asset/LightData.cpp
     Asset/MaterialData.cpp
     Containers/AdjacencyList.cpp
+    Geometry/Bvh.cpp
     Geometry/CatmullClarkSubdivider.cpp
+    Geometry/DistanceQueries.cpp
     Geometry/IndexedGeometry.cpp
     Geometry/LoopSubdivider.cpp
     Geometry/MeshPrimitives.cpp
     Geometry/PolyLine.cpp
     Geometry/RayCast.cpp
+    Geometry/SplitNormals.cpp
     Geometry/TopologicalMesh.cpp
     Geometry/TriangleMesh.cpp
     Geometry/Volume.cpp
     Geometry/deprecated/TopologicalMesh.cpp
     Resources/Resources.cpp
+    Tasks/Parallel.cpp
     Tasks/TaskQueue.cpp
+    Tasks/TraceRecorder.cpp
     Utils/Attribs.cpp
     Utils/CircularIndex.cpp
     Utils/Color.cpp
@@ -44,7 +52,11 @@ set(core_sources
 )
 
 set(core_headers
+    Animation/AnimationCache.hpp
+    Animation/AnimationClip.hpp
     Animation/Cage.hpp
+    Animation/CompactPose.hpp
+    Animation/CompressedAnimation.hpp
     Animation/DualQuaternionSkinning.hpp
     Animation/HandleArray.hpp
     Animation/HandleWeight.hpp
@@ -83,9 +95,11 @@ set(core_headers
     Containers/VectorArray.hpp
     CoreMacros.hpp
     Geometry/AbstractGeometry.hpp
+    Geometry/Bvh.hpp
     Geometry/CatmullClarkSubdivider.hpp
     Geometry/Curve2D.hpp
     Geometry/DistanceQueries.hpp
+    Geometry/Frustum.hpp
     Geometry/IndexedGeometry.hpp
     Geometry/LoopSubdivider.hpp
     Geometry/MeshPrimitives.hpp
@@ -93,7 +107,9 @@ set(core_headers
     Geometry/OpenMesh.hpp
     Geometry/PolyLine.hpp
     Geometry/RayCast.hpp
+    Geometry/RayPacket.hpp
     Geometry/Spline.hpp
+    Geometry/SplitNormals.hpp
     Geometry/StandardAttribNames.hpp
     Geometry/TopologicalMesh.hpp
     Geometry/TriangleMesh.hpp
@@ -106,8 +122,11 @@ set(core_headers
     Math/Quadric.hpp
     RaCore.hpp
     Resources/Resources.hpp
+    Tasks/Parallel.hpp
     Tasks/Task.hpp
     Tasks/TaskQueue.hpp
+    Tasks/TraceRecorder.hpp
+    Tasks/WorkStealingDeque.hpp
     Types.hpp
     Utils/Attribs.hpp
     Utils/BijectiveAssociation.hpp
@@ -134,6 +153,8 @@ set(core_headers
 )
 
 set(core_inlines
+    Animation/AnimationCache.inl
+    Animation/AnimationClip.inl
     Animation/HandleArray.inl
     Animation/Sequence.inl
     Asset/AnimationData.inl
@@ -147,11 +168,13 @@ set(core_inlines
     Containers/AdjacencyList.inl
     Containers/Grid.inl
     Containers/Tex.inl
+    Geometry/Bvh.inl
     Geometry/Curve2D.inl
     Geometry/DistanceQueries.inl
     Geometry/IndexedGeometry.inl
     Geometry/MeshPrimitives.inl
     Geometry/PolyLine.inl
+    Geometry/RayPacket.inl
     Geometry/Spline.inl
     Geometry/TopologicalMesh.inl
     Geometry/TriangleMesh.inl
@@ -160,6 +183,7 @@ set(core_inlines
     Math/LinearAlgebra.inl
     Math/Math.inl
     Math/Quadric.inl
+    Tasks/Parallel.inl
     Utils/Attribs.inl
     Utils/BijectiveAssociation.inl
     Utils/CircularIndex.inl
@@ -14,6 +14,7 @@
 #include <Core/Geometry/MeshPrimitives.hpp>
 #include <Core/Math/Math.hpp>
 #include <Core/Resources/Resources.hpp>
+#include <Core/Tasks/Parallel.hpp>
 
 #include <Engine/Data/Mesh.hpp>
 #include <Engine/Data/ShaderProgram.hpp>
@@ -33,8 +34,7 @@ using namespace gl;
 // Flip horizontally an image of w x h pixels with c commponents
 template <typename T>
 void flip_horizontally( T* img, size_t w, size_t h, size_t c ) {
-#pragma omp parallel for firstprivate( img )
-    for ( int r = 0; r < int( h ); ++r ) {
+    Core::parallelFor( 0, int( h ), [&]( int r ) {
         auto limg = img + r * ( w * c );
         for ( int l = 0; l < int( w ) / 2; ++l ) {
             T* from = limg + ( l * c );
@@ -43,7 +43,7 @@ void flip_horizontally( T* img, size_t w, size_t h, size_t c ) {
                 std::swap( *( from + e ), *( to + e ) );
             }
         }
-    }
+    } );
 }
 
 // -------------------------------------------------------------------
@@ -206,8 +206,7 @@ void EnvironmentTexture::setupTexturesFromPfm() {
         m_skyData[imgIdx] = new float[m_width * m_height * 4];
     }
 
-#pragma omp parallel for
-    for ( int imgIdx = 0; imgIdx < 6; ++imgIdx ) {
+    Core::parallelFor( 0, 6, [&]( int imgIdx ) {
         int xOffset = 0;
         int yOffset = 0;
         switch ( imgIdx ) {
@@ -290,7 +289,7 @@ void EnvironmentTexture::setupTexturesFromPfm() {
                 }
             }
         }
-    }
+    } );
 
     for ( int imgIdx = 0; imgIdx < 6; ++imgIdx ) {
         flip_horizontally( m_skyData[imgIdx], m_width, m_height, 4 );
@@ -416,8 +415,7 @@ void EnvironmentTexture::setupTexturesFromSphericalEquiRectangular() {
 
     Scalar duv = 2_ra / textureSize;
 
-#pragma omp parallel for firstprivate( duv )
-    for ( int imgIdx = 0; imgIdx < 6; ++imgIdx ) {
+    Core::parallelFor( 0, 6, [&]( int imgIdx ) {
         // Fill in pixels
         for ( int i = 0; i < textureSize; i++ ) {
             Scalar u = -1 + i * duv;
@@ -442,7 +440,7 @@ void EnvironmentTexture::setupTexturesFromSphericalEquiRectangular() {
                 m_skyData[imgIdx][4 * ( cv * textureSize + cu ) + 3] = 1;
             }
         }
-    }
+    } );
 
     for ( int imgIdx = 0; imgIdx < 6; ++imgIdx ) {
         flip_horizontally( m_skyData[imgIdx], textureSize, textureSize, 4 );
@@ -569,8 +567,7 @@ Ra::Engine::Data::Texture* EnvironmentTexture::getSHImage() {
 
     size_t ambientWidth = 1024;
     auto thepixels      = new unsigned char[4 * ambientWidth * ambientWidth];
-#pragma omp parallel for
-    for ( int i = 0; i < int( ambientWidth ); i++ ) {
+    Core::parallelFor( 0, int( ambientWidth ), [&]( int i ) {
         for ( int j = 0; j < int( ambientWidth ); j++ ) {
 
             /* We now find the cartesian components for the point (i,j) */
@@ -616,7 +613,7 @@ Ra::Engine::Data::Texture* EnvironmentTexture::getSHImage() {
                 static_cast<unsigned char>( color[2] * 255 );
             thepixels[4 * ( j * ambientWidth + i ) + 3] = 255;
         }
-    }
+    } );
     Ra::Engine::Data::TextureParameters params { "shImage",
                                                  GL_TEXTURE_2D,
                                                  ambientWidth,
@@ -2,30 +2,145 @@
 
 #include <Engine/Data/RenderParameters.hpp>
 #include <Engine/Data/ShaderProgram.hpp>
+#include <Engine/OpenGL.hpp>
 #include <Engine/RadiumEngine.hpp>
 
+#include <globjects/Program.h>
+
+#include <algorithm>
 #include <fstream>
 namespace Ra {
 namespace Engine {
 namespace Data {
 void RenderParameters::bind( const Data::ShaderProgram* shader ) const {
-    m_boolParamsVector.bind( shader );
-    m_intParamsVector.bind( shader );
-    m_uintParamsVector.bind( shader );
-    m_scalarParamsVector.bind( shader );
-    m_intsParamsVector.bind( shader );
-    m_uintsParamsVector.bind( shader );
-    m_scalarsParamsVector.bind( shader );
-    m_vec2ParamsVector.bind( shader );
-    m_vec3ParamsVector.bind( shader );
-    m_vec4ParamsVector.bind( shader );
-    m_colorParamsVector.bind( shader );
-    m_mat2ParamsVector.bind( shader );
-    m_mat3ParamsVector.bind( shader );
-    m_mat4ParamsVector.bind( shader );
+    getUniformBlock( shader ).upload( shader );
+    // texture units are shared by all the programs, textures are bound each time
     m_texParamsVector.bind( shader );
 }
 
+const RenderParameters::UniformBlock&
+RenderParameters::getUniformBlock( const Data::ShaderProgram* shader ) const {
+    // one block per program, replaced when the program is relinked or the parameters change.
+    auto sameProgram = [shader]( const UniformBlock& b ) { return b.m_program == shader; };
+    auto it          = std::find_if( m_uniformBlocks.begin(), m_uniformBlocks.end(), sameProgram );
+    if ( it == m_uniformBlocks.end() ) {
+        m_uniformBlocks.emplace_back( *this, shader );
+        return m_uniformBlocks.back();
+    }
+    if ( it->m_linkId != shader->getLinkId() || it->m_version != m_version ) {
+        *it = UniformBlock( *this, shader );
+    }
+    return *it;
+}
+
+namespace {
+/// Appends the GL representation of the parameter values to the packed arrays.
+void pack( bool v, std::vector<int>& ints, std::vector<float>& ) {
+    ints.push_back( v ? 1 : 0 );
+}
+void pack( int v, std::vector<int>& ints, std::vector<float>& ) {
+    ints.push_back( v );
+}
+void pack( uint v, std::vector<int>& ints, std::vector<float>& ) {
+    ints.push_back( int( v ) );
+}
+void pack( Scalar v, std::vector<int>&, std::vector<float>& floats ) {
+    floats.push_back( float( v ) );
+}
+template <typename Derived>
+void pack( const Eigen::MatrixBase<Derived>& v, std::vector<int>&, std::vector<float>& floats ) {
+    // Eigen matrices are column major, as expected by OpenGL
+    const auto values = v.template cast<float>().eval();
+    floats.insert( floats.end(), values.data(), values.data() + values.size() );
+}
+template <typename T>
+void pack( const std::vector<T>& v, std::vector<int>& ints, std::vector<float>& floats ) {
+    for ( const auto& e : v ) {
+        pack( e, ints, floats );
+    }
+}
+
+template <typename T>
+int elementCount( const T& ) {
+    return 1;
+}
+template <typename T>
+int elementCount( const std::vector<T>& v ) {
+    return int( v.size() );
+}
+} // namespace
+
+template <typename T>
+void RenderParameters::UniformBlock::addValues( const UniformBindableSet<T>& set,
+                                                const Data::ShaderProgram* shader,
+                                                ValueType type ) {
+    const bool isInt = type == ValueType::Int || type == ValueType::UInt;
+    for ( const auto& param : set ) {
+        const int location = shader->getUniformLocation( param.first );
+        const int count    = elementCount( param.second.m_value );
+        if ( location < 0 || count == 0 ) { continue; }
+        m_values.push_back( { location, type, count, isInt ? m_ints.size() : m_floats.size() } );
+        pack( param.second.m_value, m_ints, m_floats );
+    }
+}
+
+RenderParameters::UniformBlock::UniformBlock( const RenderParameters& params,
+                                              const Data::ShaderProgram* shader ) :
+    m_program { shader }, m_linkId { shader->getLinkId() }, m_version { params.m_version } {
+    addValues( params.m_boolParamsVector, shader, ValueType::Int );
+    addValues( params.m_intParamsVector, shader, ValueType::Int );
+    addValues( params.m_uintParamsVector, shader, ValueType::UInt );
+    addValues( params.m_scalarParamsVector, shader, ValueType::Float );
+    addValues( params.m_intsParamsVector, shader, ValueType::Int );
+    addValues( params.m_uintsParamsVector, shader, ValueType::UInt );
+    addValues( params.m_scalarsParamsVector, shader, ValueType::Float );
+    addValues( params.m_vec2ParamsVector, shader, ValueType::Vec2 );
+    addValues( params.m_vec3ParamsVector, shader, ValueType::Vec3 );
+    addValues( params.m_vec4ParamsVector, shader, ValueType::Vec4 );
+    addValues( params.m_colorParamsVector, shader, ValueType::Vec4 );
+    addValues( params.m_mat2ParamsVector, shader, ValueType::Mat2 );
+    addValues( params.m_mat3ParamsVector, shader, ValueType::Mat3 );
+    addValues( params.m_mat4ParamsVector, shader, ValueType::Mat4 );
+}
+
+void RenderParameters::UniformBlock::upload( const Data::ShaderProgram* shader ) const {
+    const auto program = shader->getProgramObject()->id();
+    for ( const auto& v : m_values ) {
+        const int* ints     = m_ints.data() + v.m_offset;
+        const float* floats = m_floats.data() + v.m_offset;
+        switch ( v.m_type ) {
+        case ValueType::Int:
+            glProgramUniform1iv( program, v.m_location, v.m_count, ints );
+            break;
+        case ValueType::UInt:
+            glProgramUniform1uiv(
+                program, v.m_location, v.m_count, reinterpret_cast<const GLuint*>( ints ) );
+            break;
+        case ValueType::Float:
+            glProgramUniform1fv( program, v.m_location, v.m_count, floats );
+            break;
+        case ValueType::Vec2:
+            glProgramUniform2fv( program, v.m_location, v.m_count, floats );
+            break;
+        case ValueType::Vec3:
+            glProgramUniform3fv( program, v.m_location, v.m_count, floats );
+            break;
+        case ValueType::Vec4:
+            glProgramUniform4fv( program, v.m_location, v.m_count, floats );
+            break;
+        case ValueType::Mat2:
+            glProgramUniformMatrix2fv( program, v.m_location, v.m_count, GL_FALSE, floats );
+            break;
+        case ValueType::Mat3:
+            glProgramUniformMatrix3fv( program, v.m_location, v.m_count, GL_FALSE, floats );
+            break;
+        case ValueType::Mat4:
+            glProgramUniformMatrix4fv( program, v.m_location, v.m_count, GL_FALSE, floats );
+            break;
+        }
+    }
+}
+
 void RenderParameters::addEnumConverter( const std::string& name,
                                          std::shared_ptr<AbstractEnumConverter> converter ) {
     m_enumConverters[name] = converter;
@@ -49,67 +164,73 @@ std::string RenderParameters::getEnumString( const std::string& name, int value
 }
 
 void RenderParameters::addParameter( const std::string& name, bool value ) {
-    m_boolParamsVector[name] = BoolParameter( name, value );
+    setParameter( m_boolParamsVector, name, value );
 }
 
 void RenderParameters::addParameter( const std::string& name, int value ) {
-    m_intParamsVector[name] = IntParameter( name, value );
+    setParameter( m_intParamsVector, name, value );
 }
 
 void RenderParameters::addParameter( const std::string& name, uint value ) {
-    m_uintParamsVector[name] = UIntParameter( name, value );
+    setParameter( m_uintParamsVector, name, value );
 }
 
 void RenderParameters::addParameter( const std::string& name, Scalar value ) {
-    m_scalarParamsVector[name] = ScalarParameter( name, value );
+    setParameter( m_scalarParamsVector, name, value );
 }
 
 ///!! array version
 
 void RenderParameters::addParameter( const std::string& name, const std::vector<int>& value ) {
-    m_intsParamsVector[name] = IntsParameter( name, value );
+    setParameter( m_intsParamsVector, name, value );
 }
 
 void RenderParameters::addParameter( const std::string& name, const std::vector<uint>& value ) {
-    m_uintsParamsVector[name] = UIntsParameter( name, value );
+    setParameter( m_uintsParamsVector, name, value );
 }
 
 void RenderParameters::addParameter( const std::string& name, const std::vector<Scalar>& value ) {
-    m_scalarsParamsVector[name] = ScalarsParameter( name, value );
+    setParameter( m_scalarsParamsVector, name, value );
 }
 
 ///!!
 
 void RenderParameters::addParameter( const std::string& name, const Core::Vector2& value ) {
-    m_vec2ParamsVector[name] = Vec2Parameter( name, value );
+    setParameter( m_vec2ParamsVector, name, value );
 }
 
 void RenderParameters::addParameter( const std::string& name, const Core::Vector3& value ) {
-    m_vec3ParamsVector[name] = Vec3Parameter( name, value );
+    setParameter( m_vec3ParamsVector, name, value );
 }
 
 void RenderParameters::addParameter( const std::string& name, const Core::Vector4& value ) {
-    m_vec4ParamsVector[name] = Vec4Parameter( name, value );
+    setParameter( m_vec4ParamsVector, name, value );
 }
 
 void RenderParameters::addParameter( const std::string& name, const Core::Utils::Color& value ) {
-    m_colorParamsVector[name] = ColorParameter( name, value );
+    setParameter( m_colorParamsVector, name, value );
 }
 
 void RenderParameters::addParameter( const std::string& name, const Core::Matrix2& value ) {
-    m_mat2ParamsVector[name] = Mat2Parameter( name, value );
+    setParameter( m_mat2ParamsVector, name, value );
 }
 
 void RenderParameters::addParameter( const std::string& name, const Core::Matrix3& value ) {
-    m_mat3ParamsVector[name] = Mat3Parameter( name, value );
+    setParameter( m_mat3ParamsVector, name, value );
 }
 
 void RenderParameters::addParameter( const std::string& name, const Core::Matrix4& value ) {
-    m_mat4ParamsVector[name] = Mat4Parameter( name, value );
+    setParameter( m_mat4ParamsVector, name, value );
 }
 
 void RenderParameters::addParameter( const std::string& name, Data::Texture* tex, int texUnit ) {
+    auto it = m_texParamsVector.find( name );
+    if ( it != m_texParamsVector.end() && it->second.m_texture == tex &&
+         it->second.m_texUnit == texUnit ) {
+        return;
+    }
     m_texParamsVector[name] = TextureParameter( name, tex, texUnit );
+    ++m_version;
 }
 
 void RenderParameters::addParameter( const std::string& name, const std::string& value ) {
@@ -152,6 +273,7 @@ void RenderParameters::addParameter( const std::string& name, const char* value
 
 void RenderParameters::mergeKeepParameters( const RenderParameters& params ) {
     PARAM_FUNC_HELPER
+    ++m_version;
 }
 #undef P_FUNC
 
@@ -163,6 +285,7 @@ void RenderParameters::mergeKeepParameters( const RenderParameters& params ) {
 
 void RenderParameters::mergeReplaceParameters( const RenderParameters& params ) {
     PARAM_FUNC_HELPER
+    ++m_version;
 }
 #undef P_FUNC
 #undef PARAM_FUNC_HELPER
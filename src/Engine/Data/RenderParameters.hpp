@@ -137,6 +137,53 @@ class RA_ENGINE_API RenderParameters final
     /// Parameter of type Matrix3
     using Mat4Parameter = TParameter<Core::Matrix4>;
 
+    /**
+     * Values of the (non texture) parameters, packed for a linked shader program.
+     * The layout of the block, i.e. the location, type and offset of each value, is generated
+     * from the parameter set and the uniforms of the program, so that uploading the block does
+     * not involve any name lookup nor any conversion, and skips the parameters not used by the
+     * program.
+     */
+    class UniformBlock
+    {
+      public:
+        /// Packs the values of \p params for \p shader.
+        UniformBlock( const RenderParameters& params, const Data::ShaderProgram* shader );
+
+        /// Uploads the values to the uniforms of \p shader, which must be the program the block
+        /// was packed for.
+        void upload( const Data::ShaderProgram* shader ) const;
+
+        /// The program the block was packed for.
+        const Data::ShaderProgram* m_program;
+        /// The link id of the program when the block was packed.
+        size_t m_linkId;
+        /// The version of the parameters when the block was packed.
+        size_t m_version;
+
+      private:
+        enum class ValueType { Int, UInt, Float, Vec2, Vec3, Vec4, Mat2, Mat3, Mat4 };
+        struct Value {
+            int m_location;
+            ValueType m_type;
+            /// Number of elements (1 but for arrays)
+            int m_count;
+            /// Offset in m_ints or m_floats
+            size_t m_offset;
+        };
+
+        template <typename T>
+        void addValues( const UniformBindableSet<T>& set,
+                        const Data::ShaderProgram* shader,
+                        ValueType type );
+
+        std::vector<Value> m_values;
+        /// Packed integer values, unsigned ones having the same representation.
+        std::vector<int> m_ints;
+        /// Packed floating point values, matrices being column major.
+        std::vector<float> m_floats;
+    };
+
   public:
     /**
      * \brief Management of parameter of enum type.
@@ -306,11 +353,19 @@ class RA_ENGINE_API RenderParameters final
     void mergeReplaceParameters( const RenderParameters& params );
 
     /** Bind the parameter uniform on the shader program
+     * The parameter values are packed in a UniformBlock for each program they are bound to, which
+     * is packed again only when a parameter value changes.
      *
      * \param shader The shader to bind to.
      */
     void bind( const Data::ShaderProgram* shader ) const;
 
+    /**
+     * Get the version of the parameters, incremented each time a parameter is added or its value
+     * changes. Adding a parameter with its current value does not change the version.
+     */
+    inline size_t getVersion() const { return m_version; }
+
     /**
      * Get a typed parameter set
      * \tparam T the type of the parameter set to get
@@ -339,6 +394,14 @@ class RA_ENGINE_API RenderParameters final
     const T& getParameter( const std::string& name ) const;
 
   private:
+    /// Sets the parameter \p name of \p set to \p value, and increments the version if the value
+    /// changes.
+    template <typename P, typename T>
+    void setParameter( UniformBindableSet<P>& set, const std::string& name, const T& value );
+
+    /// Returns the block of the parameters for \p shader, packing it if needed.
+    const UniformBlock& getUniformBlock( const Data::ShaderProgram* shader ) const;
+
     /**
      * Storage of the parameters
      * \todo : find a way to simplify this (à la Ra::Core::Geometry::AttribArrayGeometry
@@ -364,6 +427,10 @@ class RA_ENGINE_API RenderParameters final
 
     UniformBindableSet<TextureParameter> m_texParamsVector;
     /**\}*/
+
+    size_t m_version { 0 };
+    /// Packed values, one block per program they are bound to
+    mutable std::vector<UniformBlock> m_uniformBlocks;
 };
 
 /**
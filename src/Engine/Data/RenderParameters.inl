@@ -25,6 +25,16 @@ inline void RenderParameters::TParameter<Ra::Core::Utils::Color>::bind(
     shader->setUniform( m_name.c_str(), Ra::Core::Utils::Color::VectorType( m_value ) );
 }
 
+template <typename P, typename T>
+inline void RenderParameters::setParameter( UniformBindableSet<P>& set,
+                                            const std::string& name,
+                                            const T& value ) {
+    auto it = set.find( name );
+    if ( it != set.end() && it->second.m_value == value ) { return; }
+    set[name] = P( name, value );
+    ++m_version;
+}
+
 inline void RenderParameters::TextureParameter::bind( const Data::ShaderProgram* shader ) const {
     if ( m_texUnit == -1 ) { shader->setUniformTexture( m_name.c_str(), m_texture ); }
     else {
@@ -22,6 +22,11 @@ namespace Data {
 
 using namespace Core::Utils; // log
 
+namespace {
+/// Number of links of all the programs, giving their link ids.
+size_t linkCount = 0;
+} // namespace
+
 // The two following methods are independent of any ShaderProgram object.
 // Fixed : made them local function to remove dependency on openGL.h for the class header
 GLenum getTypeAsGLEnum( ShaderType type ) {
@@ -224,13 +229,29 @@ void ShaderProgram::link() {
 
     m_program->link();
     GL_CHECK_ERROR;
+    m_linkId    = ++linkCount;
     int texUnit = 0;
     auto total  = GLuint( m_program->get( GL_ACTIVE_UNIFORMS ) );
     textureUnits.clear();
+    m_uniformLocations.clear();
 
     for ( GLuint i = 0; i < total; ++i ) {
-        auto name = m_program->getActiveUniformName( i );
-        auto type = m_program->getActiveUniform( i, GL_UNIFORM_TYPE );
+        auto name                = m_program->getActiveUniformName( i );
+        auto type                = m_program->getActiveUniform( i, GL_UNIFORM_TYPE );
+        auto location            = m_program->getUniformLocation( name );
+        m_uniformLocations[name] = location;
+        // arrays are reported by their first element, but are also set by their name and by
+        // each of their elements.
+        if ( name.size() > 3 && name.compare( name.size() - 3, 3, "[0]" ) == 0 ) {
+            const auto arrayName          = name.substr( 0, name.size() - 3 );
+            m_uniformLocations[arrayName] = location;
+
+            const auto size = GLuint( m_program->getActiveUniform( i, GL_UNIFORM_SIZE ) );
+            for ( GLuint k = 1; k < size; ++k ) {
+                const auto element          = arrayName + "[" + std::to_string( k ) + "]";
+                m_uniformLocations[element] = m_program->getUniformLocation( element );
+            }
+        }
 
         //!\todo add other sampler type (or manage all type of sampler automatically)
         if ( type == GL_SAMPLER_1D || type == GL_SAMPLER_2D || type == GL_SAMPLER_3D ||
@@ -255,12 +276,21 @@ void ShaderProgram::link() {
              type == GL_SAMPLER_2D_MULTISAMPLE_ARRAY ||
              type == GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY ||
              type == GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY ) {
-            auto location      = m_program->getUniformLocation( name );
             textureUnits[name] = TextureBinding( texUnit++, location );
         }
     }
 }
 
+int ShaderProgram::getUniformLocation( const std::string& name ) const {
+    auto it = m_uniformLocations.find( name );
+    return it != m_uniformLocations.end() ? it->second : -1;
+}
+
+void ShaderProgram::setUniform( int location, const Core::Matrix4f& value ) const {
+    if ( location < 0 ) { return; }
+    glProgramUniformMatrix4fv( m_program->id(), location, 1, GL_FALSE, value.data() );
+}
+
 void ShaderProgram::bind() const {
     m_program->use();
 }
@@ -9,6 +9,7 @@
 #include <array>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace globjects {
 class Shader;
@@ -55,6 +56,19 @@ class RA_ENGINE_API ShaderProgram final
     //! @warning, call a std::map::find (in O(log(active tex unit in the shader)))
     void setUniformTexture( const char* name, Texture* tex ) const;
 
+    /// Returns the location of the uniform \p name, or -1 if the program has no such uniform.
+    /// The locations of all the active uniforms, including each array element, are queried by
+    /// link(), so that this method does not modify the program and may be called concurrently.
+    int getUniformLocation( const std::string& name ) const;
+
+    /// Returns an identifier of the last link of this program, unique among all the programs.
+    /// Data depending on the uniform locations may be cached with this identifier.
+    inline size_t getLinkId() const { return m_linkId; }
+
+    /// Sets the uniform at \p location, as returned by getUniformLocation(), without any name
+    /// lookup. Does nothing if \p location is -1.
+    void setUniform( int location, const Core::Matrix4f& value ) const;
+
     globjects::Program* getProgramObject() const;
 
     ///\todo go private, and update ShaderConfiguration to add from source !
@@ -74,6 +88,8 @@ class RA_ENGINE_API ShaderProgram final
     };
     using TextureUnits = std::map<std::string, TextureBinding>;
     TextureUnits textureUnits;
+    std::unordered_map<std::string, int> m_uniformLocations;
+    size_t m_linkId { 0 };
 
     void loadShader( Data::ShaderType type,
                      const std::string& name,
@@ -1,3 +1,4 @@
+#include <Core/Tasks/Parallel.hpp>
 #include <Core/Tasks/Task.hpp>
 #include <Core/Tasks/TaskQueue.hpp>
 #include <Core/Utils/Log.hpp>
@@ -297,16 +298,15 @@ void Texture::sRGBToLinearRGB( uint8_t* texels, uint numComponent, bool hasAlpha
             }
             return uint8_t( c * 255 );
         };
-        uint numValues = hasAlphaChannel ? numComponent - 1 : numComponent;
-#pragma omp parallel for
-        for ( int i = 0; i < int( m_textureParameters.width * m_textureParameters.height *
-                                  m_textureParameters.depth );
-              ++i ) {
+        uint numValues      = hasAlphaChannel ? numComponent - 1 : numComponent;
+        const int numPixels = int( m_textureParameters.width * m_textureParameters.height *
+                                   m_textureParameters.depth );
+        Core::parallelFor( 0, numPixels, [&]( int i ) {
             // Convert each R or RGB value while keeping alpha unchanged
             for ( uint p = i * numComponent; p < i * numComponent + numValues; ++p ) {
                 texels[p] = linearize( texels[p] );
             }
-        }
+        } );
     }
 }
 
@@ -7,6 +7,8 @@
 #include <Engine/Data/ShaderProgram.hpp>
 #include <Engine/OpenGL.hpp>
 
+#include <globjects/Texture.h>
+
 namespace Ra {
 namespace Engine {
 namespace Data {
@@ -48,10 +50,16 @@ void VolumeObject::loadGeometry( Core::Geometry::AbstractVolume* volume, const C
         m_mesh.addAttrib( Ra::Core::Geometry::getAttribName( Ra::Core::Geometry::VERTEX_TEXCOORD ),
                           tex_coords );
 
-        Core::Geometry::VolumeGrid* grid = static_cast<Core::Geometry::VolumeGrid*>( volume );
-        m_volume = std::unique_ptr<Core::Geometry::AbstractVolume>( volume );
+        auto discrete = static_cast<Core::Geometry::AbstractDiscreteVolume*>( volume );
+        m_volume      = std::unique_ptr<Core::Geometry::AbstractVolume>( volume );
+
+        // Bricked volumes are uploaded brick by brick once the texture is allocated.
+        void* texels = nullptr;
+        if ( !dynamic_cast<Core::Geometry::VolumeBricked*>( volume ) ) {
+            texels = static_cast<Core::Geometry::VolumeGrid*>( volume )->data().data();
+        }
 
-        auto dim = grid->size();
+        auto dim = discrete->size();
         TextureParameters texparam { getName(),
                                      GL_TEXTURE_3D,
                                      size_t( dim( 0 ) ),
@@ -65,7 +73,7 @@ void VolumeObject::loadGeometry( Core::Geometry::AbstractVolume* volume, const C
                                      GL_CLAMP_TO_BORDER,
                                      GL_LINEAR,
                                      GL_LINEAR,
-                                     grid->data().data() };
+                                     texels };
         m_tex.setParameters( texparam );
 
         m_isDirty = true;
@@ -82,8 +90,41 @@ void VolumeObject::updateGL() {
         GL_CHECK_ERROR;
         m_tex.initializeGL();
         GL_CHECK_ERROR;
+        uploadBricks( true );
         m_isDirty = false;
     }
+    else { uploadBricks( false ); }
+}
+
+void VolumeObject::uploadBricks( bool all ) {
+    auto bricked = dynamic_cast<Core::Geometry::VolumeBricked*>( m_volume.get() );
+    if ( bricked == nullptr || m_tex.texture() == nullptr ) { return; }
+
+    const Core::Vector3i& count = bricked->brickCount();
+    Core::Geometry::VolumeBricked::Container values;
+    for ( int k = 0; k < count.z(); ++k ) {
+        for ( int j = 0; j < count.y(); ++j ) {
+            for ( int i = 0; i < count.x(); ++i ) {
+                const Core::Vector3i brick { i, j, k };
+                if ( !all && !bricked->isBrickModified( brick ) ) { continue; }
+                const Core::Vector3i origin = bricked->getBrickOrigin( brick );
+                const Core::Vector3i size   = bricked->getBrickSize( brick );
+                bricked->getBrickValues( brick, values );
+                m_tex.texture()->subImage3D( 0,
+                                             origin.x(),
+                                             origin.y(),
+                                             origin.z(),
+                                             size.x(),
+                                             size.y(),
+                                             size.z(),
+                                             GL_RED,
+                                             GL_SCALAR,
+                                             values.data() );
+            }
+        }
+    }
+    GL_CHECK_ERROR;
+    bricked->resetModifiedBricks();
 }
 
 void VolumeObject::render( const ShaderProgram* prog ) {
@@ -41,6 +41,8 @@ class RA_ENGINE_API VolumeObject : public Displayable
     inline Core::Geometry::AbstractVolume& getVolume();
 
     /// Use the given volume for display. \warning Takes the pointer ownership
+    /// The volume must be dense. The bricks of a Core::Geometry::VolumeBricked are uploaded one by
+    /// one, without dense copy, and only the modified ones are uploaded again (see updateGL()).
     void loadGeometry( Core::Geometry::AbstractVolume* volume );
 
     /// Use the given volume for display and build the proxy from the given aabb. \warning Takes the
@@ -56,6 +58,8 @@ class RA_ENGINE_API VolumeObject : public Displayable
     /**
      * This function is called at the start of the rendering. It will update the
      * necessary openGL buffers.
+     * The modified bricks of a Core::Geometry::VolumeBricked are uploaded even if the object is
+     * not dirty.
      */
     void updateGL() override;
 
@@ -68,6 +72,9 @@ class RA_ENGINE_API VolumeObject : public Displayable
     inline size_t getNumVertices() const override { return 8; }
 
   private:
+    /// Upload the bricks of a bricked volume to the texture, all of them or only the modified ones.
+    void uploadBricks( bool all );
+
     std::unique_ptr<Core::Geometry::AbstractVolume> m_volume;
     Texture m_tex;
     /// Mesh used to display the bounding box of the grid for the ray marching
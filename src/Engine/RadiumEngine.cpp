@@ -165,7 +165,7 @@ void RadiumEngine::endFrameSync() {
     m_signalManager->fireFrameEnded();
 }
 
-void RadiumEngine::getTasks( Core::TaskQueue* taskQueue, Scalar dt ) {
+void RadiumEngine::updateFrameInfo( Scalar dt ) {
     static uint frameCounter = 0;
 
     if ( m_timeData.m_play || m_timeData.m_singleStep ) {
@@ -173,11 +173,37 @@ void RadiumEngine::getTasks( Core::TaskQueue* taskQueue, Scalar dt ) {
         m_timeData.m_singleStep = false;
     }
 
-    FrameInfo frameInfo {
+    m_frameInfo = FrameInfo {
         m_timeData.m_time, m_timeData.m_realTime ? dt : m_timeData.m_dt, frameCounter++ };
+}
+
+void RadiumEngine::getTasks( Core::TaskQueue* taskQueue, Scalar dt ) {
+    updateFrameInfo( dt );
+    for ( auto& syst : m_systems ) {
+        syst.second->generateTasks( taskQueue, m_frameInfo );
+    }
+    // the caller flushes the queue, a persistent graph must be recorded again.
+    m_taskGraphOutdated = true;
+}
+
+bool RadiumEngine::updateTaskGraph( Core::TaskQueue* taskQueue, Scalar dt ) {
+    updateFrameInfo( dt );
+
+    bool outdated = m_taskGraphOutdated || taskQueue != m_taskGraphQueue;
+    for ( const auto& syst : m_systems ) {
+        outdated = outdated || !syst.second->hasPersistentTasks() ||
+                   syst.second->areTasksOutdated();
+    }
+    if ( !outdated ) { return false; }
+
+    taskQueue->flushTaskQueue();
     for ( auto& syst : m_systems ) {
-        syst.second->generateTasks( taskQueue, frameInfo );
+        syst.second->generateTasks( taskQueue, m_frameInfo );
+        syst.second->setTasksOutdated( false );
     }
+    m_taskGraphQueue    = taskQueue;
+    m_taskGraphOutdated = false;
+    return true;
 }
 
 bool RadiumEngine::registerSystem( const std::string& name, Scene::System* system, int priority ) {
@@ -188,6 +214,7 @@ bool RadiumEngine::registerSystem( const std::string& name, Scene::System* syste
     }
 
     m_systems[std::make_pair( priority, name )] = std::shared_ptr<Scene::System>( system );
+    m_taskGraphOutdated                         = true;
     LOG( logINFO ) << "Loaded : " << name;
     return true;
 }
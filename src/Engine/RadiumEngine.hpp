@@ -2,6 +2,7 @@
 #include <Engine/RaEngine.hpp>
 
 #include <Core/Tasks/TaskQueue.hpp>
+#include <Engine/FrameInfo.hpp>
 #include <Core/Types.hpp>
 #include <Core/Utils/Singleton.hpp>
 
@@ -88,6 +89,26 @@ class RA_ENGINE_API RadiumEngine
      */
     void getTasks( Core::TaskQueue* taskQueue, Scalar dt );
 
+    /**
+     * Persistent alternative to getTasks : updates the frame information and records the tasks of
+     * the systems in \p taskQueue only when needed, so that the same task graph is replayed at
+     * each frame (startTasks/waitForTasks, without flushTaskQueue).
+     * The tasks are recorded again (after flushing the task queue) when a system is registered,
+     * when a component is added to or removed from a system, after a call to
+     * invalidateTaskGraph(), or at each frame if a system does not support persistent tasks.
+     * @see Scene::System::hasPersistentTasks
+     * @param taskQueue the task queue that will be executed for the current frame
+     * @param dt        the time elapsed since the last frame in seconds.
+     * @return true if the tasks have been recorded again.
+     */
+    bool updateTaskGraph( Core::TaskQueue* taskQueue, Scalar dt );
+
+    /// Forces the task graph to be recorded again at next call to updateTaskGraph.
+    void invalidateTaskGraph() { m_taskGraphOutdated = true; }
+
+    /// Information about the current frame, updated by getTasks and updateTaskGraph.
+    const FrameInfo& getFrameInfo() const { return m_frameInfo; }
+
     /**
      * System with high priority will always be used first. Systems with the same
      * priority are ranked randomly.
@@ -403,6 +424,16 @@ class RA_ENGINE_API RadiumEngine
 
     TimeData m_timeData;
 
+    /// Advances the time and updates m_frameInfo for a new frame.
+    void updateFrameInfo( Scalar dt );
+
+    /// Current frame information, given by reference to the systems when generating tasks.
+    FrameInfo m_frameInfo;
+    /// Task queue holding the persistent task graph (@see updateTaskGraph).
+    Core::TaskQueue* m_taskGraphQueue { nullptr };
+    /// True if the persistent task graph must be recorded again.
+    bool m_taskGraphOutdated { true };
+
     /// OpenGL State, usefull to set state of the rendering pipeline. Initialized during
     /// initializedGL()
     std::unique_ptr<globjects::State> m_openglState { nullptr };
@@ -0,0 +1,155 @@
+#include <Engine/Rendering/DrawList.hpp>
+
+#include <Engine/Data/DisplayableObject.hpp>
+#include <Engine/Data/RenderParameters.hpp>
+#include <Engine/Data/ShaderProgram.hpp>
+#include <Engine/Data/ViewingParameters.hpp>
+#include <Engine/OpenGL.hpp>
+#include <Engine/Rendering/RenderObject.hpp>
+#include <Engine/Rendering/RenderTechnique.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace Ra {
+namespace Engine {
+namespace Rendering {
+
+namespace {
+/// Returns 24 bits ordered as the view depth \p depth, negative depths being clamped to 0.
+uint64_t depthBits( Scalar depth ) {
+    const float d = std::max( float( depth ), 0.f );
+    uint32_t bits;
+    std::memcpy( &bits, &d, sizeof( bits ) );
+    // the bits of a positive float are ordered as the float, the sign bit being 0
+    return bits >> 7;
+}
+
+/// Gives consecutive ids to pointers, in order of appearance.
+class PointerIds
+{
+  public:
+    uint64_t operator()( const void* ptr ) {
+        return m_ids.emplace( ptr, uint64_t( m_ids.size() ) ).first->second;
+    }
+
+  private:
+    std::unordered_map<const void*, uint64_t> m_ids;
+};
+} // namespace
+
+void DrawList::clear() {
+    m_draws.clear();
+    m_transforms.clear();
+}
+
+void DrawList::add( const std::vector<RenderObject*>& renderQueue, Core::Utils::Index passId ) {
+    m_draws.reserve( m_draws.size() + renderQueue.size() );
+    for ( const auto& ro : renderQueue ) {
+        if ( !ro->isVisible() || !ro->getRenderTechnique() ) { continue; }
+        const auto& technique = ro->getRenderTechnique();
+        auto shader           = technique->getShader( passId );
+        if ( !shader ) { continue; }
+        auto provider = technique->getParametersProvider( passId );
+        m_draws.push_back( { 0, ro, shader, provider ? &provider->getParameters() : nullptr } );
+    }
+}
+
+void DrawList::sort( const Data::ViewingParameters& viewParams, Order order ) {
+    PointerIds shaderIds;
+    PointerIds parameterIds;
+    for ( auto& draw : m_draws ) {
+        // view depth of the center of the object
+        Core::Vector3 center = Core::Vector3::Zero();
+        const auto& mesh     = draw.m_ro->getMesh();
+        if ( mesh ) {
+            const auto& aabb = mesh->getAbstractGeometry().computeAabb();
+            if ( !aabb.isEmpty() ) { center = aabb.center(); }
+        }
+        const Core::Vector4 position = ( draw.m_ro->getTransform() * center ).homogeneous();
+        const Scalar depth           = -viewParams.viewMatrix.row( 2 ).transpose().dot( position );
+
+        draw.m_key = makeSortKey(
+            shaderIds( draw.m_shader ), parameterIds( draw.m_parameters ), depth, order );
+    }
+    std::stable_sort( m_draws.begin(), m_draws.end(), []( const Draw& a, const Draw& b ) {
+        return a.m_key < b.m_key;
+    } );
+
+    // each object is drawn once per light: its normal matrix is inverted here, once per frame
+    m_transforms.resize( m_draws.size() );
+    for ( size_t i = 0; i < m_draws.size(); ++i ) {
+        const Core::Matrix4 model     = m_draws[i].m_ro->getTransformAsMatrix();
+        m_transforms[i].m_model       = model.cast<float>();
+        m_transforms[i].m_worldNormal = model.inverse().transpose().cast<float>();
+    }
+}
+
+uint64_t
+DrawList::makeSortKey( uint64_t shaderId, uint64_t parameterId, Scalar depth, Order order ) {
+    // 16 bits of shader, 24 bits of material, 24 bits of depth
+    const uint64_t state = ( shaderId & 0xffff ) << 24 | ( parameterId & 0xffffff );
+    if ( order == Order::StateFrontToBack ) { return state << 24 | depthBits( depth ); }
+    return ( ~depthBits( depth ) & 0xffffff ) << 40 | state;
+}
+
+bool DrawList::BindFilter::bindShader( const Data::ShaderProgram* shader ) {
+    if ( shader == m_shader ) { return false; }
+    m_shader = shader;
+    // texture units are shared by all the programs, material parameters are bound again
+    m_parameters = nullptr;
+    ++m_statistics.m_shaderBinds;
+    return true;
+}
+
+bool DrawList::BindFilter::bindParameters( const Data::RenderParameters* parameters ) {
+    if ( !parameters || parameters == m_parameters ) { return false; }
+    m_parameters = parameters;
+    ++m_statistics.m_parameterBinds;
+    return true;
+}
+
+void DrawList::render( const Data::RenderParameters& lightParams,
+                       const Data::ViewingParameters& viewParams,
+                       DrawStatistics& statistics ) const {
+    if ( m_draws.empty() ) { return; }
+    // FIXME : find another solution for FrontFacing polygons (depends on the camera matrix)
+    // See RenderObject::render()
+    if ( viewParams.viewMatrix.determinant() < 0 ) { glFrontFace( GL_CW ); }
+    else {
+        glFrontFace( GL_CCW );
+    }
+
+    CORE_ASSERT( m_transforms.size() == m_draws.size(), "DrawList must be sorted before render" );
+    const Core::Matrix4f proj = viewParams.projMatrix.cast<float>();
+    const Core::Matrix4f view = viewParams.viewMatrix.cast<float>();
+
+    BindFilter filter( statistics );
+    const Data::ShaderProgram* boundShader = nullptr;
+    int modelLocation                      = -1;
+    int worldNormalLocation                = -1;
+    for ( size_t i = 0; i < m_draws.size(); ++i ) {
+        const auto& draw = m_draws[i];
+        if ( filter.bindShader( draw.m_shader ) ) {
+            boundShader = draw.m_shader;
+            boundShader->bind();
+            boundShader->setUniform( boundShader->getUniformLocation( "transform.proj" ), proj );
+            boundShader->setUniform( boundShader->getUniformLocation( "transform.view" ), view );
+            modelLocation       = boundShader->getUniformLocation( "transform.model" );
+            worldNormalLocation = boundShader->getUniformLocation( "transform.worldNormal" );
+            lightParams.bind( boundShader );
+        }
+        if ( filter.bindParameters( draw.m_parameters ) ) {
+            draw.m_parameters->bind( boundShader );
+        }
+        boundShader->setUniform( modelLocation, m_transforms[i].m_model );
+        boundShader->setUniform( worldNormalLocation, m_transforms[i].m_worldNormal );
+        draw.m_ro->getMesh()->render( boundShader );
+        ++statistics.m_draws;
+    }
+}
+
+} // namespace Rendering
+} // namespace Engine
+} // namespace Ra
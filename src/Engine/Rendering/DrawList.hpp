@@ -0,0 +1,141 @@
+#pragma once
+
+#include <Engine/RaEngine.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <Core/Containers/AlignedStdVector.hpp>
+#include <Core/Types.hpp>
+#include <Core/Utils/Index.hpp>
+
+namespace Ra {
+namespace Engine {
+
+namespace Data {
+class RenderParameters;
+class ShaderProgram;
+struct ViewingParameters;
+} // namespace Data
+
+namespace Rendering {
+class RenderObject;
+
+/**
+ * Counters of the state changes issued by DrawList::render().
+ */
+struct DrawStatistics {
+    /// Number of objects drawn.
+    size_t m_draws { 0 };
+    /// Number of shader program binds, each one also setting the view and light parameters.
+    size_t m_shaderBinds { 0 };
+    /// Number of material parameters (uniforms and textures) binds.
+    size_t m_parameterBinds { 0 };
+};
+
+/**
+ * List of the draws of one render pass, sorted to minimize the OpenGL state changes.
+ *
+ * Each draw is given a sort key made of its shader program, its material parameters (including
+ * its textures) and its view depth. When rendered, consecutive draws sharing a shader program or
+ * material parameters do not bind them again.
+ * The model and normal matrices of the draws are computed once, when sorting, so that rendering
+ * the list for several lights only uploads them, by uniform location.
+ *
+ * Typical usage, once per frame and per pass:
+ * \code{.cpp}
+ * drawList.clear();
+ * drawList.add( opaqueObjects, passId );
+ * drawList.sort( viewParams, DrawList::Order::StateFrontToBack );
+ * drawList.render( lightParams, viewParams, statistics );
+ * \endcode
+ */
+class RA_ENGINE_API DrawList
+{
+  public:
+    enum class Order {
+        /// Sort by shader program, material then depth front-to-back, e.g. for opaque objects.
+        StateFrontToBack,
+        /// Sort by depth back-to-front, then state, e.g. for blended transparent objects.
+        BackToFront
+    };
+
+    /// Removes all the draws.
+    void clear();
+
+    /// Adds the draws of the pass \p passId of the visible objects of \p renderQueue having a
+    /// shader for this pass.
+    void add( const std::vector<RenderObject*>& renderQueue, Core::Utils::Index passId );
+
+    /// Computes the sort keys of the draws for the viewpoint \p viewParams, and sorts them.
+    /// Also computes the model and normal matrices of the draws, used by render().
+    void sort( const Data::ViewingParameters& viewParams, Order order );
+
+    /**
+     * Renders the draws in order, with the light parameters \p lightParams.
+     * Shader programs and material parameters are bound only when they differ from the ones of
+     * the previous draw, \p statistics being incremented accordingly.
+     */
+    void render( const Data::RenderParameters& lightParams,
+                 const Data::ViewingParameters& viewParams,
+                 DrawStatistics& statistics ) const;
+
+    /// Returns the number of draws.
+    inline size_t size() const { return m_draws.size(); }
+
+    /// Returns true if there are no draws.
+    inline bool empty() const { return m_draws.empty(); }
+
+    /**
+     * Returns the sort key of a draw, made of the 16 low bits of \p shaderId, the 24 low bits of
+     * \p parameterId and 24 bits of the view depth \p depth, negative depths being clamped to 0.
+     * With Order::StateFrontToBack, the keys are ordered by shader, parameters then increasing
+     * depth. With Order::BackToFront, they are ordered by decreasing depth, shader then parameters.
+     */
+    static uint64_t
+    makeSortKey( uint64_t shaderId, uint64_t parameterId, Scalar depth, Order order );
+
+    /**
+     * Skips the binds of the shader program and material parameters already bound by the
+     * previous draws, counting the binds in the statistics.
+     */
+    class RA_ENGINE_API BindFilter
+    {
+      public:
+        explicit BindFilter( DrawStatistics& statistics ) : m_statistics( statistics ) {}
+
+        /// Returns whether \p shader must be bound, the material parameters having then to be
+        /// bound again.
+        bool bindShader( const Data::ShaderProgram* shader );
+
+        /// Returns whether \p parameters, which may be null, must be bound.
+        bool bindParameters( const Data::RenderParameters* parameters );
+
+      private:
+        DrawStatistics& m_statistics;
+        const Data::ShaderProgram* m_shader { nullptr };
+        const Data::RenderParameters* m_parameters { nullptr };
+    };
+
+  private:
+    struct Draw {
+        uint64_t m_key;
+        RenderObject* m_ro;
+        const Data::ShaderProgram* m_shader;
+        const Data::RenderParameters* m_parameters;
+    };
+
+    /// Matrices of a draw, in the OpenGL uniform format.
+    struct DrawTransform {
+        Core::Matrix4f m_model;
+        Core::Matrix4f m_worldNormal;
+    };
+
+    std::vector<Draw> m_draws;
+    /// Transforms of the sorted draws, indexed as m_draws.
+    Core::AlignedStdVector<DrawTransform> m_transforms;
+};
+
+} // namespace Rendering
+} // namespace Engine
+} // namespace Ra
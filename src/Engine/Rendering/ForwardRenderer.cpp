@@ -147,35 +147,59 @@ void ForwardRenderer::initBuffers() {
 }
 
 void ForwardRenderer::updateStepInternal( const Data::ViewingParameters& renderData ) {
-    CORE_UNUSED( renderData );
     // TODO : Improve the way RO are distributed in fancy (opaque), transparent and volume
     // to simplify rendering loop and code maintenance
     // i.e. Volume should considered as transparent but stored in the volumetric list and
     // transparent-but-not-volume object should be kept in the fancy list, ...
     m_transparentRenderObjects.clear();
     m_volumetricRenderObjects.clear();
-    for ( auto it = m_fancyRenderObjects.begin(); it != m_fancyRenderObjects.end(); ) {
-        if ( ( *it )->isTransparent() ) {
-            m_transparentRenderObjects.push_back( *it );
-            it = m_fancyRenderObjects.erase( it );
+    // move the transparent and volumetric objects out of the fancy list, in a single pass
+    size_t fancyCount = 0;
+    for ( auto ro : m_fancyRenderObjects ) {
+        auto material = ro->getMaterial();
+        if ( ro->isTransparent() ) { m_transparentRenderObjects.push_back( ro ); }
+        else if ( material &&
+                  material->getMaterialAspect() == Data::Material::MaterialAspect::MAT_DENSITY ) {
+            m_volumetricRenderObjects.push_back( ro );
         }
         else {
-            auto material = ( *it )->getMaterial();
-            if ( material &&
-                 material->getMaterialAspect() == Data::Material::MaterialAspect::MAT_DENSITY ) {
-                m_volumetricRenderObjects.push_back( *it );
-                it = m_fancyRenderObjects.erase( it );
-            }
-            else {
-                ++it;
-            }
+            m_fancyRenderObjects[fancyCount++] = ro;
         }
     }
+    m_fancyRenderObjects.resize( fancyCount );
     m_fancyTransparentCount = m_transparentRenderObjects.size();
     m_fancyVolumetricCount  = m_volumetricRenderObjects.size();
 
-    // simple hack to clean wireframes ...
-    if ( m_fancyRenderObjects.size() < m_wireframes.size() ) { m_wireframes.clear(); }
+    // Sort the draws of each pass by shader, material and depth. Transparent objects are blended
+    // order independently, hence sorted as opaque ones to minimize state changes.
+    m_zprepassDrawList.clear();
+    m_zprepassDrawList.add( m_fancyRenderObjects, DefaultRenderingPasses::Z_PREPASS );
+    m_zprepassDrawList.add( m_transparentRenderObjects, DefaultRenderingPasses::Z_PREPASS );
+    m_zprepassDrawList.sort( renderData, DrawList::Order::StateFrontToBack );
+
+    m_opaqueDrawList.clear();
+    m_opaqueDrawList.add( m_fancyRenderObjects, DefaultRenderingPasses::LIGHTING_OPAQUE );
+    m_opaqueDrawList.add( m_transparentRenderObjects, DefaultRenderingPasses::LIGHTING_OPAQUE );
+    m_opaqueDrawList.sort( renderData, DrawList::Order::StateFrontToBack );
+
+    m_transparentDrawList.clear();
+    m_transparentDrawList.add( m_transparentRenderObjects,
+                               DefaultRenderingPasses::LIGHTING_TRANSPARENT );
+    m_transparentDrawList.sort( renderData, DrawList::Order::StateFrontToBack );
+
+    m_volumetricDrawList.clear();
+    m_volumetricDrawList.add( m_volumetricRenderObjects,
+                              DefaultRenderingPasses::LIGHTING_VOLUMETRIC );
+    m_volumetricDrawList.sort( renderData, DrawList::Order::BackToFront );
+
+    m_debugDrawList.clear();
+    m_debugDrawList.add( m_debugRenderObjects, DefaultRenderingPasses::DEFAULT_PASS );
+    m_debugDrawList.sort( renderData, DrawList::Order::StateFrontToBack );
+
+    // drop the wireframes of the removed objects, whose address may be reused
+    for ( auto ro : m_removedRenderObjects ) {
+        m_wireframes.erase( ro );
+    }
 }
 
 template <typename IndexContainerType>
@@ -298,16 +322,11 @@ void ForwardRenderer::renderInternal( const Data::ViewingParameters& renderData
     // Set in RenderParam the configuration about ambiant lighting (instead of hard constant
     // direclty in shaders)
     Data::RenderParameters zprepassParams;
-    for ( const auto& ro : m_fancyRenderObjects ) {
-        ro->render( zprepassParams, renderData, DefaultRenderingPasses::Z_PREPASS );
-    }
     // Transparent objects are rendered in the Z-prepass, but only their fully opaque fragments
     // (if any) might influence the z-buffer.
     // Rendering transparent objects assuming that they
     // discard all their non-opaque fragments
-    for ( const auto& ro : m_transparentRenderObjects ) {
-        ro->render( zprepassParams, renderData, DefaultRenderingPasses::Z_PREPASS );
-    }
+    m_zprepassDrawList.render( zprepassParams, renderData, m_drawStatistics );
     // Volumetric objects are not rendered in the Z-prepass
 
     // Opaque Lighting pass
@@ -329,16 +348,9 @@ void ForwardRenderer::renderInternal( const Data::ViewingParameters& renderData
             Data::RenderParameters lightingpassParams;
             l->getRenderParameters( lightingpassParams );
 
-            for ( const auto& ro : m_fancyRenderObjects ) {
-                ro->render(
-                    lightingpassParams, renderData, DefaultRenderingPasses::LIGHTING_OPAQUE );
-            }
             // Rendering transparent objects assuming that they discard all their non-opaque
             // fragments
-            for ( const auto& ro : m_transparentRenderObjects ) {
-                ro->render(
-                    lightingpassParams, renderData, DefaultRenderingPasses::LIGHTING_OPAQUE );
-            }
+            m_opaqueDrawList.render( lightingpassParams, renderData, m_drawStatistics );
         }
     }
     else {
@@ -369,11 +381,7 @@ void ForwardRenderer::renderInternal( const Data::ViewingParameters& renderData
                 Data::RenderParameters trasparencypassParams;
                 l->getRenderParameters( trasparencypassParams );
 
-                for ( const auto& ro : m_transparentRenderObjects ) {
-                    ro->render( trasparencypassParams,
-                                renderData,
-                                DefaultRenderingPasses::LIGHTING_TRANSPARENT );
-                }
+                m_transparentDrawList.render( trasparencypassParams, renderData, m_drawStatistics );
             }
         }
         else {
@@ -415,9 +423,7 @@ void ForwardRenderer::renderInternal( const Data::ViewingParameters& renderData
             passParams.addParameter( "imageColor", m_textures[RendererTextures_HDR].get() );
             passParams.addParameter( "imageDepth", m_textures[RendererTextures_Depth].get() );
 
-            for ( const auto& ro : m_volumetricRenderObjects ) {
-                ro->render( passParams, renderData, DefaultRenderingPasses::LIGHTING_VOLUMETRIC );
-            }
+            m_volumetricDrawList.render( passParams, renderData, m_drawStatistics );
         }
         m_volumeFbo->unbind();
 
@@ -449,7 +455,7 @@ void ForwardRenderer::renderInternal( const Data::ViewingParameters& renderData
         auto drawWireframe = [this, &renderData]( const auto& ro ) {
             std::shared_ptr<Data::Displayable> wro;
 
-            WireMap::iterator it = m_wireframes.find( ro.get() );
+            WireMap::iterator it = m_wireframes.find( ro );
             if ( it == m_wireframes.end() ) {
                 std::shared_ptr<Data::LineMesh> disp;
 
@@ -472,8 +478,8 @@ void ForwardRenderer::renderInternal( const Data::ViewingParameters& renderData
                 if ( tp ) { processLineMesh( tp, disp ); }
                 if ( tq ) { processLineMesh( tq, disp ); }
 
-                m_wireframes[ro.get()] = disp;
-                wro                    = disp;
+                m_wireframes[ro] = disp;
+                wro              = disp;
             }
             else {
                 wro = it->second;
@@ -524,9 +530,7 @@ void ForwardRenderer::debugInternal( const Data::ViewingParameters& renderData )
 
         glDrawBuffers( 1, buffers );
 
-        for ( const auto& ro : m_debugRenderObjects ) {
-            ro->render( Data::RenderParameters {}, renderData );
-        }
+        m_debugDrawList.render( Data::RenderParameters {}, renderData, m_drawStatistics );
 
         DebugRender::getInstance()->render( renderData.viewMatrix, renderData.projMatrix );
 
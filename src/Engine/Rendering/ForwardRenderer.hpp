@@ -71,12 +71,19 @@ class RA_ENGINE_API ForwardRenderer : public Renderer
     std::unique_ptr<globjects::Framebuffer> m_uiXrayFbo;
     std::unique_ptr<globjects::Framebuffer> m_volumeFbo;
 
-    std::vector<RenderObjectPtr> m_transparentRenderObjects;
+    RenderQueue m_transparentRenderObjects;
     size_t m_fancyTransparentCount { 0 };
 
-    std::vector<RenderObjectPtr> m_volumetricRenderObjects;
+    RenderQueue m_volumetricRenderObjects;
     size_t m_fancyVolumetricCount { 0 };
 
+    /// Draw lists of the render passes, built at each frame by updateStepInternal().
+    DrawList m_zprepassDrawList;
+    DrawList m_opaqueDrawList;
+    DrawList m_transparentDrawList;
+    DrawList m_volumetricDrawList;
+    DrawList m_debugDrawList;
+
     size_t m_pingPongSize { 0 };
 
     std::array<std::unique_ptr<Data::Texture>, RendererTexture_Count> m_textures;
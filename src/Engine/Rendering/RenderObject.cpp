@@ -70,7 +70,9 @@ const RenderObjectType& RenderObject::getType() const {
 }
 
 void RenderObject::setType( const RenderObjectType& t ) {
+    if ( t == m_type ) { return; }
     m_type = t;
+    notifyChanged();
 }
 
 const std::string& RenderObject::getName() const {
@@ -102,11 +104,14 @@ bool RenderObject::isPickable() const {
 }
 
 void RenderObject::setXRay( bool xray ) {
+    if ( xray == m_xray ) { return; }
     m_xray = xray;
+    notifyChanged();
 }
 
 void RenderObject::toggleXRay() {
     m_xray = !m_xray;
+    notifyChanged();
 }
 
 bool RenderObject::isXRay() const {
@@ -259,6 +264,12 @@ void RenderObject::hasExpired() {
     m_component->notifyRenderObjectExpired( m_idx );
 }
 
+void RenderObject::notifyChanged() {
+    auto engine = RadiumEngine::getInstance();
+    auto roMgr  = engine ? engine->getRenderObjectManager() : nullptr;
+    if ( roMgr && roMgr->exists( m_idx ) ) { roMgr->renderObjectChanged( m_idx ); }
+}
+
 void RenderObject::setLifetime( int t ) {
     m_lifetime    = t;
     m_hasLifetime = true;
@@ -269,15 +280,10 @@ void RenderObject::render( const Data::RenderParameters& lightParams,
                            const Data::ShaderProgram* shader,
                            const Data::RenderParameters& shaderParams ) {
     if ( !m_visible || !shader ) { return; }
-    // Radium V2 : avoid this temporary
-    Core::Matrix4 modelMatrix  = getTransformAsMatrix();
-    Core::Matrix4 normalMatrix = modelMatrix.inverse().transpose();
     // bind data
     shader->bind();
     shader->setUniform( "transform.proj", viewParams.projMatrix );
     shader->setUniform( "transform.view", viewParams.viewMatrix );
-    shader->setUniform( "transform.model", modelMatrix );
-    shader->setUniform( "transform.worldNormal", normalMatrix );
     lightParams.bind( shader );
     shaderParams.bind( shader );
     // FIXME : find another solution for FrontFacing polygons (depends on the camera matrix)
@@ -287,6 +293,15 @@ void RenderObject::render( const Data::RenderParameters& lightParams,
     else {
         glFrontFace( GL_CCW );
     }
+    draw( shader );
+}
+
+void RenderObject::draw( const Data::ShaderProgram* shader ) {
+    // Radium V2 : avoid this temporary
+    Core::Matrix4 modelMatrix  = getTransformAsMatrix();
+    Core::Matrix4 normalMatrix = modelMatrix.inverse().transpose();
+    shader->setUniform( "transform.model", modelMatrix );
+    shader->setUniform( "transform.worldNormal", normalMatrix );
     m_mesh->render( shader );
 }
 
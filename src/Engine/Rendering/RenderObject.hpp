@@ -185,9 +185,19 @@ class RA_ENGINE_API RenderObject final : public Core::Utils::IndexedObject
                  const Data::ViewingParameters& viewParams,
                  Core::Utils::Index passId = DefaultRenderingPasses::LIGHTING_OPAQUE );
 
+    /**
+     * Sets the transformation of the object and draws it with \p shader, which must be bound with
+     * its other parameters already set, e.g. by DrawList::render().
+     * @param shader shader to use for this rendering
+     */
+    void draw( const Data::ShaderProgram* shader );
+
     void invalidateAabb();
 
   private:
+    /// Notifies the RenderObjectManager that the type or xray state changed, if registered.
+    void notifyChanged();
+
     Core::Transform m_localTransform { Core::Transform::Identity() };
 
     Scene::Component* m_component { nullptr };
@@ -36,6 +36,7 @@ Core::Utils::Index RenderObjectManager::addRenderObject( Rendering::RenderObject
     auto type = renderObject->getType();
 
     m_renderObjectByType[(int)type].insert( index );
+    m_roAddedCallbacks.notify( renderObject );
 
     Engine::RadiumEngine::getInstance()->getSignalManager()->fireRenderObjectAdded(
         Scene::ItemEntry(
@@ -55,6 +56,7 @@ void RenderObjectManager::removeRenderObject( const Core::Utils::Index& index )
 
     // Lock after signal has been fired (as this signal can cause another RO to be deleted)
     std::lock_guard<std::mutex> lock( m_doubleBufferMutex );
+    m_roRemovedCallbacks.notify( renderObject.get() );
     m_renderObjects.remove( index );
 
     auto type = renderObject->getType();
@@ -95,6 +97,7 @@ void RenderObjectManager::renderObjectExpired( const Core::Utils::Index& idx ) {
     std::lock_guard<std::mutex> lock( m_doubleBufferMutex );
 
     auto ro = m_renderObjects.at( idx );
+    m_roRemovedCallbacks.notify( ro.get() );
     m_renderObjects.remove( idx );
 
     auto type = ro->getType();
@@ -106,6 +109,18 @@ void RenderObjectManager::renderObjectExpired( const Core::Utils::Index& idx ) {
     ro.reset();
 }
 
+void RenderObjectManager::renderObjectChanged( const Core::Utils::Index& idx ) {
+    std::lock_guard<std::mutex> lock( m_doubleBufferMutex );
+
+    const auto& ro = m_renderObjects.at( idx );
+    for ( auto& indices : m_renderObjectByType ) {
+        indices.erase( idx );
+    }
+    m_renderObjectByType[size_t( ro->getType() )].insert( idx );
+
+    m_roChangedCallbacks.notify( ro.get() );
+}
+
 size_t RenderObjectManager::getNumFaces() const {
     // todo : use reduce instead of accumulate to improve performances (since C++17)
     size_t result = std::accumulate(
@@ -10,6 +10,7 @@
 
 #include <Core/Utils/Index.hpp>
 #include <Core/Utils/IndexMap.hpp>
+#include <Core/Utils/Observable.hpp>
 
 #include <Core/Types.hpp>
 #include <Engine/Rendering/RenderObjectTypes.hpp>
@@ -23,6 +24,10 @@ class RenderObject;
 class RA_ENGINE_API RenderObjectManager final
 {
   public:
+    /// Type of the observables notifying render object events.
+    /// Observers are called with the manager locked, and thus must not call back the manager.
+    using RenderObjectObservable = Core::Utils::Observable<RenderObject*>;
+
     RenderObjectManager();
     ~RenderObjectManager();
 
@@ -61,6 +66,25 @@ class RA_ENGINE_API RenderObjectManager final
      */
     void renderObjectExpired( const Ra::Core::Utils::Index& idx );
 
+    /**
+     * Notifies the observers that the type or the xray state of the render object at the given
+     * index changed, see getRenderObjectChangedNotifier().
+     * Called by RenderObject::setType(), RenderObject::setXRay() and RenderObject::toggleXRay().
+     * @param idx
+     */
+    void renderObjectChanged( const Ra::Core::Utils::Index& idx );
+
+    /// Access to the observables, allowing e.g. renderers to maintain their render queues
+    /// incrementally instead of querying the render objects each frame.
+    ///@{
+    /// Notified just after a render object has been added.
+    RenderObjectObservable& getRenderObjectAddedNotifier() { return m_roAddedCallbacks; }
+    /// Notified just before a render object is removed (or has expired) and destroyed.
+    RenderObjectObservable& getRenderObjectRemovedNotifier() { return m_roRemovedCallbacks; }
+    /// Notified when the type or the xray state of a render object changed.
+    RenderObjectObservable& getRenderObjectChangedNotifier() { return m_roChangedCallbacks; }
+    ///@}
+
     /** Return the total number of faces drawn
      *
      * @return
@@ -80,6 +104,10 @@ class RA_ENGINE_API RenderObjectManager final
         m_renderObjectByType;
 
     mutable std::mutex m_doubleBufferMutex;
+
+    RenderObjectObservable m_roAddedCallbacks;
+    RenderObjectObservable m_roRemovedCallbacks;
+    RenderObjectObservable m_roChangedCallbacks;
 };
 
 } // namespace Rendering
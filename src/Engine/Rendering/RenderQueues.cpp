@@ -0,0 +1,53 @@
+#include <Engine/Rendering/RenderQueues.hpp>
+
+#include <Engine/Rendering/RenderObject.hpp>
+
+namespace Ra {
+namespace Engine {
+namespace Rendering {
+
+RenderQueues::Type RenderQueues::getType( const RenderObject* ro ) {
+    if ( ro->isXRay() ) { return XRay; }
+    switch ( ro->getType() ) {
+    case RenderObjectType::Geometry:
+        return Fancy;
+    case RenderObjectType::Debug:
+        return Debug;
+    default:
+        return Ui;
+    }
+}
+
+void RenderQueues::add( RenderObject* ro ) {
+    if ( contains( ro ) ) { return; }
+    const auto type = getType( ro );
+    m_positions[ro] = { type, m_queues[type].size() };
+    m_queues[type].push_back( ro );
+}
+
+void RenderQueues::remove( RenderObject* ro ) {
+    if ( erase( ro ) ) { m_removed.push_back( ro ); }
+}
+
+void RenderQueues::update( RenderObject* ro ) {
+    if ( erase( ro ) ) { add( ro ); }
+}
+
+bool RenderQueues::erase( RenderObject* ro ) {
+    auto it = m_positions.find( ro );
+    if ( it == m_positions.end() ) { return false; }
+
+    auto& queue      = m_queues[it->second.first];
+    const size_t pos = it->second.second;
+
+    // move the last object of the queue in place of the removed one
+    queue[pos]                     = queue.back();
+    m_positions[queue[pos]].second = pos;
+    queue.pop_back();
+    m_positions.erase( ro );
+    return true;
+}
+
+} // namespace Rendering
+} // namespace Engine
+} // namespace Ra
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Engine/RaEngine.hpp>
+
+#include <array>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Ra {
+namespace Engine {
+namespace Rendering {
+class RenderObject;
+
+/**
+ * Persistent render queues, sorting the render objects by kind of rendering.
+ *
+ * Objects are added, removed or moved to another queue as they are notified by the
+ * RenderObjectManager, each operation running in constant time. The order of the objects in a
+ * queue is unspecified.
+ * The objects removed since the last call to takeRemoved() are recorded, so that renderers may
+ * drop the data they keep per object.
+ *
+ * This class is not thread safe, its user is responsible for the locking.
+ */
+class RA_ENGINE_API RenderQueues
+{
+  public:
+    using Queue = std::vector<RenderObject*>;
+
+    enum Type : size_t { Fancy = 0, Debug, XRay, Ui, Count };
+
+    /// Returns the queue of \p ro, given by its type and xray state.
+    static Type getType( const RenderObject* ro );
+
+    /// Adds \p ro to its queue, if not already in a queue.
+    void add( RenderObject* ro );
+
+    /// Removes \p ro from its queue, if in a queue, and records it as removed.
+    void remove( RenderObject* ro );
+
+    /// Moves \p ro to the queue matching its current type and xray state, if in a queue.
+    void update( RenderObject* ro );
+
+    /// Returns whether \p ro is in a queue.
+    bool contains( const RenderObject* ro ) const { return m_positions.count( ro ) != 0; }
+
+    const Queue& getQueue( Type type ) const { return m_queues[type]; }
+
+    /// Returns the objects removed since the last call, in order of removal.
+    /// These pointers may dangle and must only be used as keys.
+    Queue takeRemoved() { return std::exchange( m_removed, {} ); }
+
+  private:
+    /// Removes \p ro from its queue, moving the last object of the queue in its place.
+    bool erase( RenderObject* ro );
+
+    std::array<Queue, Count> m_queues;
+    /// Queue and position in this queue of each render object.
+    std::unordered_map<const RenderObject*, std::pair<Type, size_t>> m_positions;
+    Queue m_removed;
+};
+
+} // namespace Rendering
+} // namespace Engine
+} // namespace Ra
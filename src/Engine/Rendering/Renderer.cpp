@@ -1,7 +1,10 @@
 #include <Engine/Rendering/Renderer.hpp>
 
 #include <Core/Asset/FileData.hpp>
+#include <Core/Geometry/Frustum.hpp>
 #include <Core/Geometry/MeshPrimitives.hpp>
+#include <Core/Tasks/Parallel.hpp>
+#include <Core/Tasks/TraceRecorder.hpp>
 #include <Core/Utils/Log.hpp>
 #include <Engine/Data/Material.hpp>
 #include <Engine/Data/Mesh.hpp>
@@ -51,7 +54,9 @@ Renderer::Renderer() :
     m_pickingFbo { nullptr },
     m_pickingTexture { nullptr } {}
 
-Renderer::~Renderer() = default;
+Renderer::~Renderer() {
+    detachRenderQueues();
+}
 
 void Renderer::initialize( uint width, uint height ) {
     /// For internal resources management in a filesystem
@@ -64,6 +69,7 @@ void Renderer::initialize( uint width, uint height ) {
     // https://isocpp.github.io/CppCoreGuidelines/CppCoreGuidelines#Rr-ptr
     m_renderObjectManager  = RadiumEngine::getInstance()->getRenderObjectManager();
     m_shaderProgramManager = RadiumEngine::getInstance()->getShaderProgramManager();
+    attachRenderQueues();
 
     m_width  = width;
     m_height = height;
@@ -208,6 +214,7 @@ Renderer::PickingResult Renderer::doPickingNow( const PickingQuery& query,
 
     // 1. Gather render objects if needed
     feedRenderQueuesInternal( renderData );
+    cullRenderQueuesInternal( renderData );
     updateRenderObjectsInternal( renderData );
     // 3. Do picking if needed
 
@@ -321,16 +328,17 @@ void Renderer::render( const Data::ViewingParameters& data ) {
     CORE_UNUSED( renderLock );
 
     m_timerData.renderStart = Core::Utils::Clock::now();
+    m_drawStatistics        = {};
 
     // 0. Save eventual already bound FBO (e.g. QtOpenGLWidget) and viewport
     saveExternalFBOInternal();
 
-    // 1. Gather render objects if needed
-    // TODO : make this only once and only update modified objects at each frame
-    //  Actually, this correspond to 3 loops over all ROs. Could be done without loops, just by
-    //  using observers
+    // 1. Gather render objects from the persistent render queues
     feedRenderQueuesInternal( data );
 
+    // 1.1 Remove the render objects outside the view frustum
+    cullRenderQueuesInternal( data );
+
     m_timerData.feedRenderQueuesEnd = Core::Utils::Clock::now();
 
     // 2. Update them (from an opengl point of view)
@@ -348,6 +356,7 @@ void Renderer::render( const Data::ViewingParameters& data ) {
     m_pickingQueries.clear();
 
     updateStepInternal( data );
+    m_removedRenderObjects.clear();
 
     // 4. Do the rendering.
     renderInternal( data );
@@ -374,6 +383,16 @@ void Renderer::render( const Data::ViewingParameters& data ) {
     notifyRenderObjectsRenderingInternal();
 }
 
+void Renderer::addTimerDataToTrace( const TimerData& data, Core::TraceRecorder& recorder ) {
+    // Same order as in render()
+    recorder.addSpan( "Render", "render", data.renderStart, data.renderEnd );
+    recorder.addSpan( "Feed render queues", "render", data.renderStart, data.feedRenderQueuesEnd );
+    recorder.addSpan( "Update render objects", "render", data.feedRenderQueuesEnd, data.updateEnd );
+    recorder.addSpan( "Picking and main render", "render", data.updateEnd, data.mainRenderEnd );
+    recorder.addSpan( "Post process", "render", data.mainRenderEnd, data.postProcessEnd );
+    recorder.addSpan( "Debug, UI and display", "render", data.postProcessEnd, data.renderEnd );
+}
+
 void Renderer::saveExternalFBOInternal() {
     RadiumEngine::getInstance()->pushFboAndViewport();
     // Set the internal rendering viewport
@@ -397,50 +416,122 @@ void Renderer::updateRenderObjectsInternal( const Data::ViewingParameters& /*ren
 }
 
 void Renderer::feedRenderQueuesInternal( const Data::ViewingParameters& /*renderData*/ ) {
-    m_fancyRenderObjects.clear();
-    m_debugRenderObjects.clear();
-    m_uiRenderObjects.clear();
-    m_xrayRenderObjects.clear();
-
-    m_renderObjectManager->getRenderObjectsByType( m_fancyRenderObjects,
-                                                   RenderObjectType::Geometry );
-    m_renderObjectManager->getRenderObjectsByType( m_debugRenderObjects, RenderObjectType::Debug );
-    m_renderObjectManager->getRenderObjectsByType( m_uiRenderObjects, RenderObjectType::UI );
-
-    for ( auto it = m_fancyRenderObjects.begin(); it != m_fancyRenderObjects.end(); ) {
-        if ( ( *it )->isXRay() ) {
-            m_xrayRenderObjects.push_back( *it );
-            it = m_fancyRenderObjects.erase( it );
-        }
-        else {
-            ++it;
-        }
+    std::lock_guard<std::mutex> lock( m_renderQueuesMutex );
+    m_fancyRenderObjects   = m_renderQueues.getQueue( RenderQueues::Fancy );
+    m_debugRenderObjects   = m_renderQueues.getQueue( RenderQueues::Debug );
+    m_xrayRenderObjects    = m_renderQueues.getQueue( RenderQueues::XRay );
+    m_uiRenderObjects      = m_renderQueues.getQueue( RenderQueues::Ui );
+    // picking also feeds the queues, the removed objects are kept until the next update step
+    const auto removed = m_renderQueues.takeRemoved();
+    m_removedRenderObjects.insert( m_removedRenderObjects.end(), removed.begin(), removed.end() );
+}
+
+void Renderer::attachRenderQueues() {
+    if ( m_roAddedObserverId != -1 ) { return; }
+    m_roAddedObserverId = m_renderObjectManager->getRenderObjectAddedNotifier().attachMember(
+        this, &Renderer::addToRenderQueues );
+
+    m_roRemovedObserverId = m_renderObjectManager->getRenderObjectRemovedNotifier().attachMember(
+        this, &Renderer::removeFromRenderQueues );
+
+    m_roChangedObserverId = m_renderObjectManager->getRenderObjectChangedNotifier().attachMember(
+        this, &Renderer::updateRenderQueues );
+
+    // render objects created before the renderer
+    for ( const auto& ro : m_renderObjectManager->getRenderObjects() ) {
+        addToRenderQueues( ro.get() );
     }
+}
 
-    for ( auto it = m_debugRenderObjects.begin(); it != m_debugRenderObjects.end(); ) {
-        if ( ( *it )->isXRay() ) {
-            m_xrayRenderObjects.push_back( *it );
-            it = m_debugRenderObjects.erase( it );
-        }
-        else {
-            ++it;
+void Renderer::detachRenderQueues() {
+    if ( m_roAddedObserverId == -1 ) { return; }
+    // The engine may have been cleaned up before the renderer is destroyed.
+    if ( auto engine = RadiumEngine::getInstance() ) {
+        if ( auto roMgr = engine->getRenderObjectManager() ) {
+            roMgr->getRenderObjectAddedNotifier().detach( m_roAddedObserverId );
+            roMgr->getRenderObjectRemovedNotifier().detach( m_roRemovedObserverId );
+            roMgr->getRenderObjectChangedNotifier().detach( m_roChangedObserverId );
         }
     }
+    m_roAddedObserverId   = -1;
+    m_roRemovedObserverId = -1;
+    m_roChangedObserverId = -1;
+}
 
-    for ( auto it = m_uiRenderObjects.begin(); it != m_uiRenderObjects.end(); ) {
-        if ( ( *it )->isXRay() ) {
-            m_xrayRenderObjects.push_back( *it );
-            it = m_uiRenderObjects.erase( it );
+void Renderer::addToRenderQueues( RenderObject* ro ) {
+    std::lock_guard<std::mutex> lock( m_renderQueuesMutex );
+    m_renderQueues.add( ro );
+}
+
+void Renderer::removeFromRenderQueues( RenderObject* ro ) {
+    std::lock_guard<std::mutex> lock( m_renderQueuesMutex );
+    m_renderQueues.remove( ro );
+}
+
+void Renderer::updateRenderQueues( RenderObject* ro ) {
+    std::lock_guard<std::mutex> lock( m_renderQueuesMutex );
+    m_renderQueues.update( ro );
+}
+
+void Renderer::cullRenderQueuesInternal( const Data::ViewingParameters& renderData ) {
+    m_cullingStatistics = {};
+    m_culledRenderObjects.clear();
+    if ( !m_frustumCulling ) { return; }
+
+    const Core::Geometry::Frustum frustum( renderData.projMatrix * renderData.viewMatrix );
+    const auto cull = [this, &frustum]( RenderQueue& renderQueue ) {
+        m_cullingStatistics.m_submitted += renderQueue.size();
+        m_cullingStatistics.m_culled +=
+            cullRenderQueue( frustum, renderQueue, m_culledRenderObjects );
+    };
+    if ( m_cullFancyRenderObjects ) { cull( m_fancyRenderObjects ); }
+    if ( m_cullDebugRenderObjects ) { cull( m_debugRenderObjects ); }
+    if ( m_cullXRayRenderObjects ) { cull( m_xrayRenderObjects ); }
+    if ( m_cullUiRenderObjects ) { cull( m_uiRenderObjects ); }
+}
+
+size_t Renderer::cullRenderQueue( const Core::Geometry::Frustum& frustum,
+                                  std::vector<RenderObject*>& renderQueue,
+                                  std::vector<RenderObject*>& culled ) {
+    const size_t n = renderQueue.size();
+
+    // Gather the model-space boxes first, since geometries compute and store them at first call.
+    std::vector<Core::Aabb> boxes( n );
+    for ( size_t i = 0; i < n; ++i ) {
+        const auto& mesh = renderQueue[i]->getMesh();
+        if ( mesh ) { boxes[i] = mesh->getAbstractGeometry().computeAabb(); }
+    }
+
+    // Test the world-space boxes, the entity transform being applied at each frame.
+    std::vector<char> inside( n );
+    Core::parallelFor( size_t( 0 ), n, [&]( size_t i ) {
+        const auto& box = boxes[i];
+        if ( box.isEmpty() ) {
+            inside[i] = true;
+            return;
         }
+        const Core::Transform T    = renderQueue[i]->getTransform();
+        const Core::Vector3 extent = T.linear().cwiseAbs() * ( box.max() - box.center() );
+        const Core::Vector3 center = T * box.center();
+
+        inside[i] = frustum.intersects( Core::Aabb( center - extent, center + extent ) );
+    } );
+
+    // Compact the queue, keeping the order of the remaining objects.
+    size_t kept = 0;
+    for ( size_t i = 0; i < n; ++i ) {
+        if ( inside[i] ) { renderQueue[kept++] = renderQueue[i]; }
         else {
-            ++it;
+            culled.push_back( renderQueue[i] );
         }
     }
+    renderQueue.resize( kept );
+    return n - kept;
 }
 
 // subroutine to Renderer::splitRenderQueuesForPicking()
-void Renderer::splitRQ( const std::vector<RenderObjectPtr>& renderQueue,
-                        std::array<std::vector<RenderObjectPtr>, 4>& renderQueuePicking ) {
+void Renderer::splitRQ( const RenderQueue& renderQueue,
+                        std::array<RenderQueue, 4>& renderQueuePicking ) {
     // clean renderQueuePicking
     for ( auto& q : renderQueuePicking ) {
         q.clear();
@@ -462,10 +553,9 @@ void Renderer::splitRenderQueuesForPicking( const Data::ViewingParameters& /*ren
 }
 
 // subroutine to Renderer::doPicking()
-void Renderer::renderForPicking(
-    const Data::ViewingParameters& renderData,
-    const std::array<const Data::ShaderProgram*, 4>& pickingShaders,
-    const std::array<std::vector<RenderObjectPtr>, 4>& renderQueuePicking ) {
+void Renderer::renderForPicking( const Data::ViewingParameters& renderData,
+                                 const std::array<const Data::ShaderProgram*, 4>& pickingShaders,
+                                 const std::array<RenderQueue, 4>& renderQueuePicking ) {
     for ( uint i = 0; i < pickingShaders.size(); ++i ) {
         pickingShaders[i]->bind();
         pickingShaders[i]->setUniform( "transform.proj", renderData.projMatrix );
@@ -672,6 +762,11 @@ void Renderer::notifyRenderObjectsRenderingInternal() {
     for ( auto& ro : m_uiRenderObjects ) {
         ro->hasBeenRenderedOnce();
     }
+
+    // culled objects count as rendered, so that objects with a lifetime expire
+    for ( auto& ro : m_culledRenderObjects ) {
+        ro->hasBeenRenderedOnce();
+    }
 }
 
 void Renderer::resize( uint w, uint h ) {
@@ -12,6 +12,8 @@
 #include <Core/Utils/Color.hpp>
 #include <Core/Utils/Timer.hpp>
 #include <Engine/Data/DisplayableObject.hpp>
+#include <Engine/Rendering/DrawList.hpp>
+#include <Engine/Rendering/RenderQueues.hpp>
 
 namespace globjects {
 class Framebuffer;
@@ -21,6 +23,12 @@ namespace Ra {
 namespace Asset {
 class FileData;
 }
+namespace Core {
+class TraceRecorder;
+namespace Geometry {
+class Frustum;
+}
+} // namespace Core
 
 namespace Engine {
 
@@ -49,6 +57,8 @@ class RA_ENGINE_API Renderer
 {
   protected:
     using RenderObjectPtr = std::shared_ptr<RenderObject>;
+    /// Render queues reference the render objects owned by the RenderObjectManager.
+    using RenderQueue = std::vector<RenderObject*>;
 
   public:
     /**
@@ -63,6 +73,15 @@ class RA_ENGINE_API Renderer
         Core::Utils::TimePoint renderEnd;
     };
 
+    /**
+     * Statistics of the view-frustum culling stage for the last frame, over the render queues
+     * culling applies to.
+     */
+    struct CullingStatistics {
+        size_t m_submitted { 0 }; ///< Render objects fed to the culled render queues.
+        size_t m_culled { 0 };    ///< Render objects removed from them by culling.
+    };
+
     /**
      * Picking mode
      */
@@ -169,6 +188,12 @@ class RA_ENGINE_API Renderer
      */
     inline const TimerData& getTimerData() const;
 
+    /**
+     * Adds the spans of the rendering passes timed in \p data to \p recorder, on the main
+     * thread track.
+     */
+    static void addTimerDataToTrace( const TimerData& data, Core::TraceRecorder& recorder );
+
     /**
      * Get the currently displayed texture
      */
@@ -213,6 +238,36 @@ class RA_ENGINE_API Renderer
      */
     inline void enablePostProcess( bool enabled );
 
+    /**
+     * Set the view-frustum culling mode
+     * @param enabled true if render objects whose bounding box is outside the view frustum must
+     * be removed from the render queues before rendering.
+     */
+    inline void enableFrustumCulling( bool enabled );
+
+    inline bool isFrustumCullingEnabled() const;
+
+    /**
+     * Extract the culling statistics of the last render
+     */
+    inline const CullingStatistics& getCullingStatistics() const;
+
+    /**
+     * Removes from \p renderQueue the render objects whose world space bounding box is outside
+     * \p frustum, keeping the order of the other ones, and appends them to \p culled.
+     * Render objects without mesh or with an empty bounding box are kept.
+     * \return the number of culled render objects.
+     */
+    static size_t cullRenderQueue( const Core::Geometry::Frustum& frustum,
+                                   std::vector<RenderObject*>& renderQueue,
+                                   std::vector<RenderObject*>& culled );
+
+    /**
+     * Extract the draw statistics of the last render, i.e. the state changes of the draw lists
+     * used by the renderer, see DrawList.
+     */
+    inline const DrawStatistics& getDrawStatistics() const;
+
     /**
      * @brief Tell the renderer it needs to render.
      * This method does the following steps :
@@ -410,16 +465,25 @@ class RA_ENGINE_API Renderer
     // 1.
     void feedRenderQueuesInternal( const Data::ViewingParameters& renderData );
 
+    // 1.0 Persistent render queues, maintained on RenderObjectManager notifications
+    void attachRenderQueues();
+    void detachRenderQueues();
+    void addToRenderQueues( RenderObject* ro );
+    void removeFromRenderQueues( RenderObject* ro );
+    void updateRenderQueues( RenderObject* ro );
+
+    // 1.1
+    void cullRenderQueuesInternal( const Data::ViewingParameters& renderData );
+
     // 2.0
     void updateRenderObjectsInternal( const Data::ViewingParameters& renderData );
 
     // 3.
     void splitRenderQueuesForPicking( const Data::ViewingParameters& renderData );
-    void splitRQ( const std::vector<RenderObjectPtr>& renderQueue,
-                  std::array<std::vector<RenderObjectPtr>, 4>& renderQueuePicking );
+    void splitRQ( const RenderQueue& renderQueue, std::array<RenderQueue, 4>& renderQueuePicking );
     void renderForPicking( const Data::ViewingParameters& renderData,
                            const std::array<const Data::ShaderProgram*, 4>& pickingShaders,
-                           const std::array<std::vector<RenderObjectPtr>, 4>& renderQueuePicking );
+                           const std::array<RenderQueue, 4>& renderQueuePicking );
 
     void doPicking( const Data::ViewingParameters& renderData );
 
@@ -460,10 +524,23 @@ class RA_ENGINE_API Renderer
 
     bool m_renderQueuesUpToDate { false };
 
-    std::vector<RenderObjectPtr> m_fancyRenderObjects;
-    std::vector<RenderObjectPtr> m_debugRenderObjects;
-    std::vector<RenderObjectPtr> m_xrayRenderObjects;
-    std::vector<RenderObjectPtr> m_uiRenderObjects;
+    /// Render queues of the current frame, copied from the persistent queues at each frame, that
+    /// derived renderers may split or reorder.
+    RenderQueue m_fancyRenderObjects;
+    RenderQueue m_debugRenderObjects;
+    RenderQueue m_xrayRenderObjects;
+    RenderQueue m_uiRenderObjects;
+
+    /// Render objects removed since the previous update step, for derived renderers to drop the
+    /// data they keep per object. These pointers may dangle and must only be used as keys.
+    RenderQueue m_removedRenderObjects;
+
+    /// Whether view-frustum culling applies to each render queue. Derived renderers may opt in or
+    /// out, e.g. for objects rendered with their own projection.
+    bool m_cullFancyRenderObjects { true };
+    bool m_cullDebugRenderObjects { true };
+    bool m_cullXRayRenderObjects { false };
+    bool m_cullUiRenderObjects { false };
 
     // Simple quad mesh, used to render the final image
     std::unique_ptr<Data::Displayable> m_quadMesh;
@@ -480,10 +557,27 @@ class RA_ENGINE_API Renderer
     /// Textures exposed in the texture section box to be displayed.
     std::map<std::string, Data::Texture*> m_secondaryTextures;
 
+    /// Statistics of the draw lists rendered in the current frame, reset at each frame.
+    DrawStatistics m_drawStatistics;
+
   private:
     // Renderer timings data
     TimerData m_timerData;
 
+    // VIEW-FRUSTUM CULLING
+    bool m_frustumCulling { true };
+    CullingStatistics m_cullingStatistics;
+    /// Render objects culled for the current frame, kept to be notified of the frame rendering.
+    RenderQueue m_culledRenderObjects;
+
+    // PERSISTENT RENDER QUEUES
+    RenderQueues m_renderQueues;
+    /// Persistent queues are updated by the thread adding or removing render objects.
+    std::mutex m_renderQueuesMutex;
+    int m_roAddedObserverId { -1 };
+    int m_roRemovedObserverId { -1 };
+    int m_roChangedObserverId { -1 };
+
     std::mutex m_renderMutex;
 
     // PICKING STUFF
@@ -493,10 +587,10 @@ class RA_ENGINE_API Renderer
     std::unique_ptr<Data::Texture> m_pickingTexture;
 
     static const int NoPickingRenderMode = Data::Displayable::PickingRenderMode::NO_PICKING;
-    std::array<std::vector<RenderObjectPtr>, NoPickingRenderMode> m_fancyRenderObjectsPicking;
-    std::array<std::vector<RenderObjectPtr>, NoPickingRenderMode> m_debugRenderObjectsPicking;
-    std::array<std::vector<RenderObjectPtr>, NoPickingRenderMode> m_xrayRenderObjectsPicking;
-    std::array<std::vector<RenderObjectPtr>, NoPickingRenderMode> m_uiRenderObjectsPicking;
+    std::array<RenderQueue, NoPickingRenderMode> m_fancyRenderObjectsPicking;
+    std::array<RenderQueue, NoPickingRenderMode> m_debugRenderObjectsPicking;
+    std::array<RenderQueue, NoPickingRenderMode> m_xrayRenderObjectsPicking;
+    std::array<RenderQueue, NoPickingRenderMode> m_uiRenderObjectsPicking;
     std::array<const Data::ShaderProgram*, NoPickingRenderMode> m_pickingShaders;
 
     std::vector<PickingQuery> m_pickingQueries;
@@ -88,6 +88,22 @@ inline void Renderer::enablePostProcess( bool enabled ) {
     m_postProcessEnabled = enabled;
 }
 
+inline void Renderer::enableFrustumCulling( bool enabled ) {
+    m_frustumCulling = enabled;
+}
+
+inline bool Renderer::isFrustumCullingEnabled() const {
+    return m_frustumCulling;
+}
+
+inline const Renderer::CullingStatistics& Renderer::getCullingStatistics() const {
+    return m_cullingStatistics;
+}
+
+inline const DrawStatistics& Renderer::getDrawStatistics() const {
+    return m_drawStatistics;
+}
+
 inline void Renderer::addPickingRequest( const PickingQuery& query ) {
     m_pickingQueries.push_back( query );
 }
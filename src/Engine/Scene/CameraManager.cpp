@@ -78,20 +78,18 @@ void CameraManager::generateTasks( Core::TaskQueue* taskQueue,
     class RoUpdater : public Ra::Core::Task
     {
       public:
-        void process() override { m_camera->updateTransform(); }
+        void process() override {
+            // only update visible components.
+            if ( m_camera->getRenderObject()->isVisible() ) { m_camera->updateTransform(); }
+        }
         std::string getName() const override { return "camera updater"; }
         CameraComponent* m_camera;
     };
 
-    // only update visible components.
     for ( size_t i = 0; i < m_data->size(); ++i ) {
-        auto comp = ( *m_data )[i];
-        auto ro   = comp->getRenderObject();
-        if ( ro->isVisible() ) {
-            auto updater      = new RoUpdater();
-            updater->m_camera = comp;
-            taskQueue->registerTask( updater );
-        }
+        auto updater      = new RoUpdater();
+        updater->m_camera = ( *m_data )[i];
+        taskQueue->registerTask( updater );
     }
 }
 
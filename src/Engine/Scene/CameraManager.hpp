@@ -75,6 +75,9 @@ class RA_ENGINE_API CameraManager : public System
     //
     void generateTasks( Core::TaskQueue* taskQueue, const Engine::FrameInfo& frameInfo ) override;
 
+    /// Camera updaters check the camera visibility when processed, so they can be replayed.
+    bool hasPersistentTasks() const override { return true; }
+
     void handleAssetLoading( Entity* entity, const Core::Asset::FileData* data ) override;
 
     /// this static data member handles default camera values.
@@ -15,6 +15,9 @@ class RA_ENGINE_API GeometrySystem : public System
     void handleAssetLoading( Entity* entity, const Ra::Core::Asset::FileData* fileData ) override;
 
     void generateTasks( Ra::Core::TaskQueue* taskQueue, const FrameInfo& frameInfo ) override;
+
+    /// No task is generated, so they can be replayed.
+    bool hasPersistentTasks() const override { return true; }
 };
 
 } // namespace Scene
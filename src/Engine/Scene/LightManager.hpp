@@ -56,6 +56,9 @@ class RA_ENGINE_API LightManager : public System
     /// Do nothing as this system only manage light related asset loading
     void generateTasks( Core::TaskQueue* taskQueue, const Engine::FrameInfo& frameInfo ) override;
 
+    /// No task is generated, so they can be replayed.
+    bool hasPersistentTasks() const override { return true; }
+
     /// Transform loaded file data to usable entities and component in the engine
     void handleAssetLoading( Entity* entity, const Core::Asset::FileData* data ) override;
 
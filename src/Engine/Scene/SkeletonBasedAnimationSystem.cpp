@@ -1,5 +1,6 @@
 #include <Engine/Scene/SkeletonBasedAnimationSystem.hpp>
 
+#include <set>
 #include <string>
 
 #include <Core/Asset/FileData.hpp>
@@ -7,6 +8,7 @@
 #include <Core/Resources/Resources.hpp>
 #include <Core/Tasks/Task.hpp>
 #include <Core/Tasks/TaskQueue.hpp>
+#include <Core/Utils/Timer.hpp>
 
 #include <Engine/Data/Texture.hpp>
 #include <Engine/Data/TextureManager.hpp>
@@ -46,27 +48,46 @@ SkeletonBasedAnimationSystem::~SkeletonBasedAnimationSystem() {
 
 void SkeletonBasedAnimationSystem::generateTasks( Core::TaskQueue* taskQueue,
                                                   const FrameInfo& frameInfo ) {
+    // Tasks read the frame info when processed, so that they can be replayed at each frame.
+    const FrameInfo* info = &frameInfo;
+    std::vector<Core::TaskQueue::TaskId> animTasks;
+
+    // the caches only hold the data of the current frame.
+    Core::TaskQueue::TaskId cacheTaskId;
+    if ( m_poseCaching || m_skinCaching ) {
+        auto cacheFunc = [this]() {
+            m_poseCache.clear();
+            m_skinCache.clear();
+        };
+        cacheTaskId =
+            taskQueue->registerTask( new Core::FunctionTask( cacheFunc, "AnimationCacheTask" ) );
+    }
+
     for ( auto compEntry : m_components ) {
         // deal with AnimationComponents
         if ( auto animComp = dynamic_cast<SkeletonComponent*>( compEntry.second ) ) {
-            if ( !Core::Math::areApproxEqual( m_time, frameInfo.m_animationTime ) ) {
-                // here we update the skeleton w.r.t. the animation
-                auto animFunc =
-                    std::bind( &SkeletonComponent::update, animComp, frameInfo.m_animationTime );
-                auto animTask = new Core::FunctionTask(
-                    animFunc, "AnimatorTask_" + animComp->getSkeleton()->getName() );
-                taskQueue->registerTask( animTask );
-            }
-            else {
-                // here we update the skeleton w.r.t. the manipulation
-                auto animFunc = std::bind( &SkeletonComponent::updateDisplay, animComp );
-                auto animTask = new Core::FunctionTask(
-                    animFunc, "AnimatorTask_" + animComp->getSkeleton()->getName() );
-                taskQueue->registerTask( animTask );
+            animComp->setPoseCache( m_poseCaching ? &m_poseCache : nullptr );
+            auto animFunc = [this, animComp, info]() {
+                if ( !Core::Math::areApproxEqual( m_time, info->m_animationTime ) ) {
+                    // here we update the skeleton w.r.t. the animation
+                    animComp->update( info->m_animationTime );
+                }
+                else {
+                    // here we update the skeleton w.r.t. the manipulation
+                    animComp->updateDisplay();
+                }
+            };
+            auto animTask = new Core::FunctionTask(
+                animFunc, "AnimatorTask_" + animComp->getSkeleton()->getName() );
+            animTasks.push_back( taskQueue->registerTask( animTask ) );
+            if ( cacheTaskId.isValid() ) {
+                taskQueue->addDependency( cacheTaskId, animTasks.back() );
             }
         }
-        // deal with SkinningComponents
+        // deal with SkinningComponents, batched ones being dealt with afterwards
+        else if ( m_batchedSkinning ) { continue; }
         else if ( auto skinComp = dynamic_cast<SkinningComponent*>( compEntry.second ) ) {
+            skinComp->setSkinCache( m_skinCaching ? &m_skinCache : nullptr );
             auto skinFunc = std::bind( &SkinningComponent::skin, skinComp );
             auto skinTask =
                 new Core::FunctionTask( skinFunc, "SkinnerTask_" + skinComp->getMeshName() );
@@ -81,8 +102,68 @@ void SkeletonBasedAnimationSystem::generateTasks( Core::TaskQueue* taskQueue,
             taskQueue->addDependency( skinTaskId, endTaskId );
         }
     }
+    if ( m_batchedSkinning ) { generateSkinningPackets( taskQueue ); }
 
-    m_time = frameInfo.m_animationTime;
+    // the current time is updated once all the animators compared it to the frame time.
+    auto timeFunc = [this, info]() { m_time = info->m_animationTime; };
+    auto timeTaskId =
+        taskQueue->registerTask( new Core::FunctionTask( timeFunc, "AnimationTimeTask" ) );
+    for ( const auto& animTaskId : animTasks ) {
+        taskQueue->addDependency( animTaskId, timeTaskId );
+    }
+}
+
+void SkeletonBasedAnimationSystem::generateSkinningPackets( Core::TaskQueue* taskQueue ) {
+    // Fill the packets with consecutive components up to s_packetVertexCount vertices.
+    std::vector<std::vector<SkinningComponent*>> packets;
+    size_t packetVertices = s_packetVertexCount;
+    for ( auto compEntry : m_components ) {
+        auto skinComp = dynamic_cast<SkinningComponent*>( compEntry.second );
+        if ( skinComp == nullptr ) { continue; }
+        skinComp->setSkinCache( m_skinCaching ? &m_skinCache : nullptr );
+        if ( packetVertices >= s_packetVertexCount ) {
+            packets.emplace_back();
+            packetVertices = 0;
+        }
+        packets.back().push_back( skinComp );
+        packetVertices += skinComp->getSkinningRefData()->m_referenceMesh.vertices().size();
+    }
+    m_packetStatistics.assign( packets.size(), PacketStatistics {} );
+
+    for ( size_t p = 0; p < packets.size(); ++p ) {
+        auto packetFunc = [this, p, packet = packets[p]]() {
+            const auto start = Core::Utils::Clock::now();
+            PacketStatistics stats;
+            for ( auto skinComp : packet ) {
+                // the skinning is done once the mesh gets visible again, since the pose
+                // version of the skeleton is not updated meanwhile.
+                if ( !skinComp->isSkinnedMeshVisible() ) {
+                    ++stats.m_skippedMeshes;
+                    continue;
+                }
+                skinComp->skin();
+                const auto frameData = skinComp->getSkinningFrameData();
+                if ( frameData->m_doSkinning ) {
+                    ++stats.m_skinnedMeshes;
+                    stats.m_skinnedVertices += frameData->m_currentPosition.size();
+                }
+                skinComp->endSkinning();
+            }
+            stats.m_time = Core::Utils::getIntervalMicro( start, Core::Utils::Clock::now() );
+
+            m_packetStatistics[p] = stats;
+        };
+        auto packetTaskId = taskQueue->registerTask(
+            new Core::FunctionTask( packetFunc, "SkinnerPacketTask_" + std::to_string( p ) ) );
+
+        std::set<std::string> skeletons;
+        for ( auto skinComp : packets[p] ) {
+            skeletons.insert( skinComp->getSkeletonName() );
+        }
+        for ( const auto& skelName : skeletons ) {
+            taskQueue->addPendingDependency( "AnimatorTask_" + skelName, packetTaskId );
+        }
+    }
 }
 
 void SkeletonBasedAnimationSystem::handleAssetLoading( Entity* entity,
@@ -155,6 +236,49 @@ void SkeletonBasedAnimationSystem::toggleSkeleton( const bool status ) {
     }
 }
 
+// Batched skinning
+
+void SkeletonBasedAnimationSystem::setBatchedSkinning( bool on ) {
+    if ( m_batchedSkinning == on ) { return; }
+    m_batchedSkinning = on;
+    m_packetStatistics.clear();
+    setTasksOutdated();
+}
+
+SkeletonBasedAnimationSystem::SkinningStatistics
+SkeletonBasedAnimationSystem::getSkinningStatistics() const {
+    SkinningStatistics stats;
+    stats.m_packetCount = m_packetStatistics.size();
+    stats.m_packetTimes.reserve( m_packetStatistics.size() );
+    for ( const auto& packet : m_packetStatistics ) {
+        stats.m_skinnedMeshes += packet.m_skinnedMeshes;
+        stats.m_skippedMeshes += packet.m_skippedMeshes;
+        stats.m_skinnedVertices += packet.m_skinnedVertices;
+        stats.m_packetTimes.push_back( packet.m_time );
+    }
+    return stats;
+}
+
+// Animation caches
+
+void SkeletonBasedAnimationSystem::setPoseCaching( bool on, Scalar timeStep ) {
+    m_poseCache.setTimeStep( timeStep );
+    if ( m_poseCaching == on ) { return; }
+    m_poseCaching = on;
+    setTasksOutdated();
+}
+
+void SkeletonBasedAnimationSystem::setSkinCaching( bool on ) {
+    if ( m_skinCaching == on ) { return; }
+    m_skinCaching = on;
+    setTasksOutdated();
+}
+
+void SkeletonBasedAnimationSystem::resetCacheCounters() {
+    m_poseCache.resetCounters();
+    m_skinCache.resetCounters();
+}
+
 } // namespace Scene
 } // namespace Engine
 } // namespace Ra
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <Core/Animation/AnimationCache.hpp>
+
 #include <Engine/Scene/ItemEntry.hpp>
 #include <Engine/Scene/System.hpp>
 
+#include <vector>
+
 namespace Ra {
 namespace Engine {
 namespace Scene {
@@ -14,6 +18,19 @@ namespace Scene {
 class RA_ENGINE_API SkeletonBasedAnimationSystem : public System
 {
   public:
+    /// Statistics of the batched skinning, for the last processed frame.
+    struct SkinningStatistics {
+        size_t m_packetCount { 0 };     ///< The number of skinning work packets.
+        size_t m_skinnedMeshes { 0 };   ///< The number of meshes skinned.
+        size_t m_skippedMeshes { 0 };   ///< The number of invisible meshes not skinned.
+        size_t m_skinnedVertices { 0 }; ///< The number of vertices skinned.
+        std::vector<long> m_packetTimes; ///< The time spent in each packet, in microseconds.
+    };
+
+    /// The number of vertices a skinning work packet is filled up to in batched mode, so that
+    /// the reference and skinned data of a packet roughly fit in the L2 cache.
+    static constexpr size_t s_packetVertexCount = 8192;
+
     /// Create a new animation system
     SkeletonBasedAnimationSystem();
 
@@ -28,6 +45,9 @@ class RA_ENGINE_API SkeletonBasedAnimationSystem : public System
     /// Creates a task for each AnimationComponent to update skeleton display.
     void generateTasks( Core::TaskQueue* taskQueue, const FrameInfo& frameInfo ) override;
 
+    /// Tasks read the animation time when processed, so they can be replayed.
+    bool hasPersistentTasks() const override { return true; }
+
     /// Loads Skeletons and Animations from a file data into the givn Entity.
     void handleAssetLoading( Entity* entity, const Core::Asset::FileData* fileData ) override;
     /// \}
@@ -48,12 +68,87 @@ class RA_ENGINE_API SkeletonBasedAnimationSystem : public System
     /// Enforce Skeleton update at the next frame.
     inline void enforceUpdate() { m_time = -1; }
 
+    /// \name Batched skinning
+    /// \{
+
+    /// Toggles the batched skinning.
+    /// When on, the SkinningComponents are skinned by work packets of about
+    /// s_packetVertexCount vertices instead of two tasks per component, and the meshes which
+    /// are not visible are not skinned.
+    void setBatchedSkinning( bool on );
+
+    /// Returns true if the batched skinning is on, false otherwise.
+    inline bool isBatchedSkinning() const { return m_batchedSkinning; }
+
+    /// Returns the statistics of the batched skinning for the last processed frame.
+    /// \note Must not be called while the tasks are processed.
+    SkinningStatistics getSkinningStatistics() const;
+    /// \}
+
+    /// \name Animation caches
+    /// \{
+
+    /// Toggles the sharing of the poses between the SkeletonComponents with the same skeleton
+    /// and animations playing the same animation at the same time, the animation time being
+    /// quantized by \p timeStep (0 for exact times).
+    void setPoseCaching( bool on, Scalar timeStep = 0_ra );
+
+    /// Returns true if the poses are shared, false otherwise.
+    inline bool isPoseCaching() const { return m_poseCaching; }
+
+    /// Toggles the sharing of the skinned vertices between the SkinningComponents with the same
+    /// mesh, weights and skinning methods, whose skeletons share the same pose.
+    /// \note Requires the pose caching.
+    void setSkinCaching( bool on );
+
+    /// Returns true if the skinned vertices are shared, false otherwise.
+    inline bool isSkinCaching() const { return m_skinCaching; }
+
+    /// Returns the pose cache, for its hit and miss counters.
+    inline const Core::Animation::PoseCache& getPoseCache() const { return m_poseCache; }
+
+    /// Returns the skinned vertices cache, for its hit and miss counters.
+    inline const Core::Animation::SkinCache& getSkinCache() const { return m_skinCache; }
+
+    /// Resets the hit and miss counters of the caches.
+    void resetCacheCounters();
+    /// \}
+
   private:
+    /// Statistics of a skinning work packet.
+    struct PacketStatistics {
+        size_t m_skinnedMeshes { 0 };
+        size_t m_skippedMeshes { 0 };
+        size_t m_skinnedVertices { 0 };
+        long m_time { 0 };
+    };
+
+    /// Registers the batched skinning tasks for the SkinningComponents.
+    void generateSkinningPackets( Core::TaskQueue* taskQueue );
+
     /// True if we want to show xray-bones.
     bool m_xrayOn { false };
 
     /// The current animation time.
     Scalar m_time { 0_ra };
+
+    /// True if the SkinningComponents are skinned by work packets.
+    bool m_batchedSkinning { false };
+
+    /// The statistics of each skinning work packet, written by the packet tasks.
+    std::vector<PacketStatistics> m_packetStatistics;
+
+    /// True if the poses are shared between the SkeletonComponents.
+    bool m_poseCaching { false };
+
+    /// True if the skinned vertices are shared between the SkinningComponents.
+    bool m_skinCaching { false };
+
+    /// The poses of the current frame.
+    Core::Animation::PoseCache m_poseCache;
+
+    /// The skinned vertices of the current frame.
+    Core::Animation::SkinCache m_skinCache;
 };
 
 } // namespace Scene
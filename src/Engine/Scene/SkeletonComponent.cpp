@@ -11,6 +11,7 @@
 #include <Core/Containers/MakeShared.hpp>
 #include <Core/Geometry/TriangleMesh.hpp>
 #include <Core/Math/Math.hpp> // areApproxEqual
+#include <Core/Utils/StdUtils.hpp>
 
 #include <Engine/Data/BlinnPhongMaterial.hpp>
 #include <Engine/Data/Mesh.hpp>
@@ -63,6 +64,8 @@ void SkeletonComponent::setTransform( const Index& roIdx, const Core::Transform&
     const Core::Transform& TBoneLocal = m_skel.getTransform( boneIdx, SpaceType::LOCAL );
     auto diff                         = TBoneModel.inverse() * transform;
     m_skel.setTransform( boneIdx, TBoneLocal * diff, SpaceType::LOCAL );
+    // the pose is not the one played from the animation anymore.
+    m_poseKey = Core::Animation::PoseKey {};
 }
 
 // Build from fileData
@@ -74,7 +77,8 @@ void SkeletonComponent::handleSkeletonLoading( const Core::Asset::HandleData* da
 
     Core::Asset::createSkeleton( *data, m_skel );
 
-    m_refPose = m_skel.getPose( SpaceType::LOCAL );
+    m_refPose          = m_skel.getPose( SpaceType::LOCAL );
+    m_assetKeyOutdated = true;
 
     setupSkeletonDisplay();
     setupIO();
@@ -90,7 +94,7 @@ void SkeletonComponent::handleAnimationLoading(
     for ( uint n = 0; n < data.size(); ++n ) {
         m_animations.emplace_back();
         m_animations.back().reserve( m_skel.size() );
-        auto handleAnim = data[n]->getHandleData();
+        const auto& handleAnim = data[n]->getHandleData();
         for ( uint i = 0; i < m_skel.size(); ++i ) {
             auto it =
                 std::find_if( handleAnim.cbegin(), handleAnim.cend(), [this, i]( const auto& ha ) {
@@ -110,15 +114,19 @@ void SkeletonComponent::handleAnimationLoading(
             m_animations[0].push_back( KeyFramedValue( 0_ra, pose[i] ) );
         }
     }
-    m_animationID   = 0;
-    m_animationTime = 0_ra;
+    m_animationID      = 0;
+    m_animationTime    = 0_ra;
+    m_assetKeyOutdated = true;
+    m_clip.setTracks( nullptr );
 }
 
 // Skeleton-based animation data
 
 void SkeletonComponent::setSkeleton( const Skeleton& skel ) {
-    m_skel    = skel;
-    m_refPose = skel.getPose( SpaceType::LOCAL );
+    m_skel             = skel;
+    m_refPose          = skel.getPose( SpaceType::LOCAL );
+    m_assetKeyOutdated = true;
+    m_poseKey          = Core::Animation::PoseKey {};
     setupSkeletonDisplay();
 }
 
@@ -127,13 +135,17 @@ SkeletonComponent::Animation& SkeletonComponent::addNewAnimation() {
     for ( uint i = 0; i < m_skel.size(); ++i ) {
         m_animations.back().push_back( KeyFramedValue( 0_ra, m_refPose[i] ) );
     }
+    m_assetKeyOutdated = true;
+    m_clip.setTracks( nullptr );
     return m_animations.back();
 }
 
 void SkeletonComponent::removeAnimation( const size_t i ) {
     CORE_ASSERT( i < m_animations.size(), "Out of bound index." );
     m_animations.erase( m_animations.begin() + i );
-    m_animationID = i > 1 ? i - 1 : 0;
+    m_animationID      = i > 1 ? i - 1 : 0;
+    m_assetKeyOutdated = true;
+    m_clip.setTracks( nullptr );
 }
 
 void SkeletonComponent::useAnimation( const size_t i ) {
@@ -150,6 +162,7 @@ void SkeletonComponent::update( Scalar t ) {
     m_wasReset = Core::Math::areApproxEqual( t, 0_ra );
     if ( m_wasReset ) {
         m_animationTime = t;
+        m_poseKey       = Core::Animation::PoseKey {};
         m_skel.setPose( m_refPose, SpaceType::LOCAL );
 
         updateDisplay();
@@ -157,10 +170,8 @@ void SkeletonComponent::update( Scalar t ) {
     }
 
     m_animationTime = m_speed * t;
-    Scalar lastTime = 0;
-    for ( auto boneAnim : m_animations[m_animationID] ) {
-        lastTime = std::max( lastTime, *boneAnim.getTimes().rbegin() );
-    }
+    m_clip.setTracks( m_animations.empty() ? nullptr : &m_animations[m_animationID] );
+    const Scalar lastTime = std::max( 0_ra, m_clip.getEndTime() );
     if ( m_autoRepeat ) {
         if ( !m_pingPong ) { m_animationTime = std::fmod( m_animationTime, lastTime ); }
         else {
@@ -175,19 +186,36 @@ void SkeletonComponent::update( Scalar t ) {
         }
     }
 
-    // get the current pose from the animation
-    Core::Animation::Pose pose = m_skel.getPose( SpaceType::LOCAL );
+    // get the current pose from the animation, or from the identical skeletons playing the
+    // same animation at the same time.
+    // The pose buffer is kept across frames, so that sampling the clip does not allocate.
+    if ( m_localPose.size() != m_skel.size() ) {
+        m_localPose = m_skel.getPose( SpaceType::LOCAL );
+    }
+    m_poseKey = Core::Animation::PoseKey {};
     if ( !m_animations.empty() ) {
-#pragma omp parallel for
-        for ( int i = 0; i < int( m_animations[m_animationID].size() ); ++i ) {
-            pose[uint( i )] = m_animations[m_animationID][uint( i )].at(
-                m_animationTime, Core::Animation::linearInterpolate<Core::Transform> );
+        Scalar time = m_animationTime;
+        Core::Animation::PoseCache::ValuePtr cachedPose;
+        if ( m_poseCache != nullptr ) {
+            const size_t version = getAnimationsVersion();
+            if ( m_assetKeyOutdated || version != m_assetVersion ||
+                 m_assetCache != m_poseCache ) {
+                updateAssetKey();
+                m_assetVersion = version;
+            }
+            m_poseKey  = m_poseCache->getKey( *m_assetKey, m_animationID, time );
+            cachedPose = m_poseCache->find( m_poseKey );
+        }
+        if ( cachedPose ) { m_localPose = *cachedPose; }
+        else {
+            m_clip.sample( time, m_localPose );
+            if ( m_poseCache != nullptr ) { m_poseCache->insert( m_poseKey, m_localPose ); }
         }
     }
     else {
-        pose = m_refPose;
+        m_localPose = m_refPose;
     }
-    m_skel.setPose( pose, SpaceType::LOCAL );
+    m_skel.setPose( m_localPose, SpaceType::LOCAL );
 
     updateDisplay();
 }
@@ -200,10 +228,9 @@ std::pair<Scalar, Scalar> SkeletonComponent::getAnimationTimeInterval() const {
     if ( m_animations.empty() ) { return { 0_ra, 0_ra }; }
     Scalar startTime = std::numeric_limits<Scalar>::max();
     Scalar endTime   = 0;
-    for ( auto boneAnim : m_animations[m_animationID] ) {
-        const auto& times = boneAnim.getTimes();
-        startTime         = std::min( startTime, *times.begin() );
-        endTime           = std::max( endTime, *times.rbegin() );
+    for ( const auto& boneAnim : m_animations[m_animationID] ) {
+        startTime = std::min( startTime, boneAnim.getKeyFrames().front().first );
+        endTime   = std::max( endTime, boneAnim.getKeyFrames().back().first );
     }
     return { startTime, endTime };
 }
@@ -232,6 +259,50 @@ bool SkeletonComponent::isPingPong() const {
     return m_pingPong;
 }
 
+size_t SkeletonComponent::getAnimationsVersion() const {
+    size_t version = m_animations.size();
+    for ( const auto& animation : m_animations ) {
+        for ( const auto& boneAnim : animation ) {
+            version += boneAnim.getVersion();
+        }
+    }
+    return version;
+}
+
+void SkeletonComponent::updateAssetKey() {
+    using Core::Animation::appendBytes;
+    const auto appendTransform = []( std::string& bytes, const Core::Transform& transform ) {
+        appendBytes( bytes, transform.matrix().data(), size_t( transform.matrix().size() ) );
+    };
+    std::string content;
+    const size_t numBones = m_skel.size();
+    appendBytes( content, &numBones, 1 );
+    for ( uint i = 0; i < m_skel.size(); ++i ) {
+        const auto label       = m_skel.getLabel( i );
+        const size_t labelSize = label.size();
+        appendBytes( content, &labelSize, 1 );
+        content += label;
+        appendBytes( content, &m_skel.m_graph.parents()[i], 1 );
+        appendTransform( content, m_refPose[i] );
+    }
+    for ( const auto& animation : m_animations ) {
+        const size_t numTracks = animation.size();
+        appendBytes( content, &numTracks, 1 );
+        for ( const auto& boneAnim : animation ) {
+            const size_t numKeyFrames = boneAnim.size();
+            appendBytes( content, &numKeyFrames, 1 );
+            for ( size_t k = 0; k < boneAnim.size(); ++k ) {
+                appendBytes( content, &boneAnim[k].first, 1 );
+                appendTransform( content, boneAnim[k].second );
+            }
+        }
+    }
+    // the key is given by the pose cache, which compares the contents of the assets.
+    m_assetKey         = m_poseCache->getContentKey( std::move( content ) );
+    m_assetCache       = m_poseCache;
+    m_assetKeyOutdated = false;
+}
+
 // Skeleton display
 
 void SkeletonComponent::setXray( bool on ) const {
@@ -407,6 +478,11 @@ void SkeletonComponent::setupIO() {
         std::bind( &SkeletonComponent::getWasReset, this );
     ComponentMessenger::getInstance()->registerOutput<bool>(
         getEntity(), this, m_skelName, resetOut );
+
+    ComponentMessenger::CallbackTypes<Core::Animation::PoseKey>::Getter poseKeyOut =
+        std::bind( &SkeletonComponent::getPoseKeyOutput, this );
+    ComponentMessenger::getInstance()->registerOutput<Core::Animation::PoseKey>(
+        getEntity(), this, m_skelName, poseKeyOut );
 }
 
 const std::map<Index, uint>* SkeletonComponent::getBoneRO2idx() const {
@@ -430,6 +506,10 @@ const bool* SkeletonComponent::getWasReset() const {
     return &m_wasReset;
 }
 
+const Core::Animation::PoseKey* SkeletonComponent::getPoseKeyOutput() const {
+    return &m_poseKey;
+}
+
 } // namespace Scene
 } // namespace Engine
 } // namespace Ra
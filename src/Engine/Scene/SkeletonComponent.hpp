@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Core/Animation/AnimationCache.hpp>
+#include <Core/Animation/AnimationClip.hpp>
 #include <Core/Animation/HandleWeight.hpp>
 #include <Core/Animation/KeyFramedValue.hpp>
 #include <Core/Animation/Skeleton.hpp>
@@ -136,6 +138,14 @@ class RA_ENGINE_API SkeletonComponent : public Component
 
     /// Return true is animation ping-pong is on, false otherwise.
     bool isPingPong() const;
+
+    /// Sets the cache sharing the poses played from the animations between the
+    /// SkeletonComponents with the same skeleton and animations, nullptr for none.
+    inline void setPoseCache( Core::Animation::PoseCache* cache ) { m_poseCache = cache; }
+
+    /// Returns the key of the current pose, which is invalid unless the pose has been played from
+    /// an animation with a pose cache.
+    inline const Core::Animation::PoseKey& getPoseKey() const { return m_poseKey; }
     /// \}
 
     /// \name Skeleton display and manipulation
@@ -174,6 +184,14 @@ class RA_ENGINE_API SkeletonComponent : public Component
     /// Internal Debug function to display the skeleton hierarchy.
     void printSkeleton( const Core::Animation::Skeleton& skeleton );
 
+    /// Returns the sum of the versions of the animations keyframes, to detect their edits.
+    size_t getAnimationsVersion() const;
+
+    /// Gets the key of the skeleton and animations from the pose cache, which compares their
+    /// content to the ones of the other SkeletonComponents, so that identical ones share their
+    /// poses.
+    void updateAssetKey();
+
     /// \name Component Communication (CC)
     /// \{
 
@@ -191,6 +209,9 @@ class RA_ENGINE_API SkeletonComponent : public Component
 
     /// Reset status getter for CC.
     const bool* getWasReset() const;
+
+    /// Current pose key getter for CC.
+    const Core::Animation::PoseKey* getPoseKeyOutput() const;
     /// \}
 
   private:
@@ -224,6 +245,30 @@ class RA_ENGINE_API SkeletonComponent : public Component
     /// Was the animation reset?
     bool m_wasReset { false };
 
+    /// The cache of the poses played from the animations, if any.
+    Core::Animation::PoseCache* m_poseCache { nullptr };
+
+    /// The key of the skeleton and animations content, given by m_assetCache.
+    Core::Animation::PoseCache::ContentKey m_assetKey;
+
+    /// The pose cache which gave the asset key.
+    const Core::Animation::PoseCache* m_assetCache { nullptr };
+
+    /// Whether the skeleton or animations changed since the asset key has been computed.
+    bool m_assetKeyOutdated { true };
+
+    /// The animations version the asset key has been computed for.
+    size_t m_assetVersion { 0 };
+
+    /// The player of the current animation.
+    Core::Animation::AnimationClip<Core::Transform> m_clip;
+
+    /// The local pose played from the current animation.
+    Core::Animation::Pose m_localPose;
+
+    /// The key of the current pose.
+    Core::Animation::PoseKey m_poseKey;
+
     /// Bones ROs.
     std::vector<Rendering::RenderObject*> m_boneDrawables;
 
@@ -1,14 +1,14 @@
 ﻿#include <Engine/Scene/SkinningComponent.hpp>
 
-#include <Core/Animation/PoseOperation.hpp>
-
 #include <Core/Animation/DualQuaternionSkinning.hpp>
 #include <Core/Animation/HandleWeightOperation.hpp>
 #include <Core/Animation/LinearBlendSkinning.hpp>
 #include <Core/Animation/RotationCenterSkinning.hpp>
 #include <Core/Geometry/DistanceQueries.hpp>
+#include <Core/Tasks/Parallel.hpp>
 #include <Core/Utils/Color.hpp>
 #include <Core/Utils/Log.hpp>
+#include <Core/Utils/StdUtils.hpp>
 
 #include <Engine/Data/BlinnPhongMaterial.hpp>
 #include <Engine/Data/Mesh.hpp>
@@ -35,11 +35,49 @@ namespace Ra {
 namespace Engine {
 namespace Scene {
 
+std::string SkinningComponent::s_corCacheDirectory;
+
 static const std::string tangentName =
     Ra::Core::Geometry::getAttribName( Ra::Core::Geometry::VERTEX_TANGENT );
 static const std::string bitangentName =
     Ra::Core::Geometry::getAttribName( Ra::Core::Geometry::VERTEX_BITANGENT );
 
+/// Content of the reference skinning data, i.e. the asset whose key identifies the skinned mesh.
+static std::string refDataContent( const SkinningRefData& refData, const PackedWeights& weights ) {
+    std::string content;
+    const auto appendVectors = [&content]( const Vector3Array& vectors ) {
+        const size_t size = vectors.size();
+        appendBytes( content, &size, 1 );
+        if ( size > 0 ) { appendBytes( content, vectors.front().data(), 3 * size ); }
+    };
+    const auto appendTransform = [&content]( const Transform& transform ) {
+        appendBytes( content, transform.matrix().data(), 16 );
+    };
+    const auto& mesh = refData.m_referenceMesh;
+    appendVectors( mesh.vertices() );
+    appendVectors( mesh.normals() );
+    appendVectors( mesh.getAttrib( mesh.getAttribHandle<Vector3>( tangentName ) ).data() );
+    appendVectors( mesh.getAttrib( mesh.getAttribHandle<Vector3>( bitangentName ) ).data() );
+    const size_t numTriangles = mesh.getIndices().size();
+    appendBytes( content, &numTriangles, 1 );
+    for ( const auto& t : mesh.getIndices() ) {
+        appendBytes( content, t.data(), 3 );
+    }
+    appendTransform( refData.m_meshTransformInverse );
+    for ( const auto& bind : refData.m_bindMatrices ) {
+        appendTransform( bind );
+    }
+    for ( const auto& transform : refData.m_skeleton.getPose( SpaceType::MODEL ) ) {
+        appendTransform( transform );
+    }
+    appendBytes( content, &weights.m_influenceCount, 1 );
+    for ( const auto& w : weights.m_influences ) {
+        appendBytes( content, &w.first, 1 );
+        appendBytes( content, &w.second, 1 );
+    }
+    return content;
+}
+
 TriangleMesh triangulate( const PolyMesh& polyMesh ) {
     TriangleMesh res;
     res.setVertices( polyMesh.vertices() );
@@ -95,6 +133,9 @@ void SkinningComponent::initialize() {
     if ( hasSkel && hasRefPose && ( hasTriMesh || m_meshIsPoly || m_meshIsQuad ) ) {
         m_renderObjectReader = compMsg->getterCallback<Index>( getEntity(), m_meshName );
         m_skeletonGetter     = compMsg->getterCallback<Skeleton>( getEntity(), m_skelName );
+        if ( compMsg->canGet<PoseKey>( getEntity(), m_skelName ) ) {
+            m_poseKeyGetter = compMsg->getterCallback<PoseKey>( getEntity(), m_skelName );
+        }
         if ( hasTriMesh ) {
             m_triMeshWriter = compMsg->rwCallback<TriangleMesh>( getEntity(), m_meshName );
         }
@@ -119,10 +160,9 @@ void SkinningComponent::initialize() {
             const auto& normals = m_refData.m_referenceMesh.normals();
             Vector3Array tangents( normals.size() );
             Vector3Array bitangents( normals.size() );
-#pragma omp parallel for
-            for ( int i = 0; i < int( normals.size() ); ++i ) {
+            parallelFor( 0, int( normals.size() ), [&]( int i ) {
                 Core::Math::getOrthogonalVectors( normals[i], tangents[i], bitangents[i] );
-            }
+            } );
             m_refData.m_referenceMesh.addAttrib( tangentName, std::move( tangents ) );
             m_refData.m_referenceMesh.addAttrib( bitangentName, std::move( bitangents ) );
         }
@@ -131,10 +171,9 @@ void SkinningComponent::initialize() {
             const auto& bH = m_refData.m_referenceMesh.getAttribHandle<Vector3>( bitangentName );
             const auto& bitangents = m_refData.m_referenceMesh.getAttrib( bH ).data();
             Vector3Array tangents( normals.size() );
-#pragma omp parallel for
-            for ( int i = 0; i < int( normals.size() ); ++i ) {
+            parallelFor( 0, int( normals.size() ), [&]( int i ) {
                 tangents[i] = bitangents[i].cross( normals[i] );
-            }
+            } );
             m_refData.m_referenceMesh.addAttrib( tangentName, std::move( tangents ) );
         }
         else if ( !m_refData.m_referenceMesh.hasAttrib( bitangentName ) ) {
@@ -142,20 +181,20 @@ void SkinningComponent::initialize() {
             const auto& tH      = m_refData.m_referenceMesh.getAttribHandle<Vector3>( tangentName );
             const auto& tangents = m_refData.m_referenceMesh.getAttrib( tH ).data();
             Vector3Array bitangents( normals.size() );
-#pragma omp parallel for
-            for ( int i = 0; i < int( normals.size() ); ++i ) {
+            parallelFor( 0, int( normals.size() ), [&]( int i ) {
                 bitangents[i] = normals[i].cross( tangents[i] );
-            }
+            } );
             m_refData.m_referenceMesh.addAttrib( bitangentName, std::move( bitangents ) );
         }
 
-        m_topoMesh = Ra::Core::Geometry::TopologicalMesh { m_refData.m_referenceMesh };
+        m_splitNormals.build( m_refData.m_referenceMesh );
 
         auto ro = getRoMgr()->getRenderObject( *m_renderObjectReader() );
         // get other data
         m_refData.m_meshTransformInverse = ro->getLocalTransform().inverse();
         m_refData.m_skeleton             = *m_skeletonGetter();
         createWeightMatrix();
+        if ( m_skinningType == COR ) { computeCentersOfRotation(); }
 
         // initialize frame data
         m_frameData.m_skeleton        = m_refData.m_skeleton;
@@ -220,14 +259,35 @@ void SkinningComponent::skin() {
         m_frameData.m_frameCounter = 0;
         m_forceUpdate              = true;
     }
-    const auto prevPose    = m_frameData.m_skeleton.getPose( SpaceType::MODEL );
-    m_frameData.m_skeleton = *skel;
-    auto currentPose       = m_frameData.m_skeleton.getPose( SpaceType::MODEL );
-    if ( !areEqual( currentPose, prevPose ) || m_forceUpdate ) {
+    // The pose versions tell whether the skeleton has changed, without comparing the poses.
+    if ( skel->getPoseVersion() != m_skeletonVersion || m_forceUpdate ) {
+        m_skeletonVersion = skel->getPoseVersion();
+        // Only the pose is needed, the hierarchy being unchanged.
+        if ( m_frameData.m_skeleton.size() == skel->size() ) {
+            m_frameData.m_skeleton.setPose( skel->getPose( SpaceType::MODEL ), SpaceType::MODEL );
+        }
+        else { m_frameData.m_skeleton = *skel; }
         m_forceUpdate            = false;
         m_frameData.m_doSkinning = true;
         m_frameData.m_frameCounter++;
 
+        // reuse the vertices skinned by an identical mesh with the same pose, if any.
+        if ( m_skinCache != nullptr && m_refDataCache != m_skinCache ) {
+            m_refDataKey =
+                m_skinCache->getContentKey( refDataContent( m_refData, m_packedWeights ) );
+            m_refDataCache = m_skinCache;
+        }
+        const SkinKey skinKey = getSkinKey();
+        if ( skinKey.isValid() ) {
+            if ( auto cached = m_skinCache->find( skinKey ) ) {
+                m_frameData.m_currentPosition  = cached->m_position;
+                m_frameData.m_currentNormal    = cached->m_normal;
+                m_frameData.m_currentTangent   = cached->m_tangent;
+                m_frameData.m_currentBitangent = cached->m_bitangent;
+                return;
+            }
+        }
+
         const auto tH = m_refData.m_referenceMesh.getAttribHandle<Vector3>( tangentName );
         const Vector3Array& tangents = m_refData.m_referenceMesh.getAttrib( tH ).data();
         const auto bH = m_refData.m_referenceMesh.getAttribHandle<Vector3>( bitangentName );
@@ -235,34 +295,46 @@ void SkinningComponent::skin() {
 
         switch ( m_skinningType ) {
         case DQS: {
-            dualQuaternionSkinning( m_refData, tangents, bitangents, m_frameData );
+            dualQuaternionSkinning( m_refData, m_packedWeights, tangents, bitangents, m_frameData );
             break;
         }
         case COR: {
-            centerOfRotationSkinning( m_refData, tangents, bitangents, m_frameData );
+            centerOfRotationSkinning(
+                m_refData, m_packedWeights, tangents, bitangents, m_frameData );
             break;
         }
         case LBS:
         default: {
-            linearBlendSkinning( m_refData, tangents, bitangents, m_frameData );
+            linearBlendSkinning( m_refData, m_packedWeights, tangents, bitangents, m_frameData );
             break;
         }
         }
 
         if ( m_normalSkinning == GEOMETRIC ) {
-            m_topoMesh.updatePositions( m_frameData.m_currentPosition );
-            m_topoMesh.updateWedgeNormals();
-            m_topoMesh.updateTriangleMeshNormals( m_frameData.m_currentNormal );
-#pragma omp parallel for
-            for ( int i = 0; i < int( m_frameData.m_currentNormal.size() ); ++i ) {
-                Core::Math::getOrthogonalVectors( m_frameData.m_currentNormal[i],
-                                                  m_frameData.m_currentTangent[i],
-                                                  m_frameData.m_currentBitangent[i] );
-            }
+            m_splitNormals.computeNormals( m_frameData.m_currentPosition,
+                                           m_frameData.m_currentNormal,
+                                           m_frameData.m_currentTangent,
+                                           m_frameData.m_currentBitangent );
+        }
+
+        if ( skinKey.isValid() ) {
+            m_skinCache->insert( skinKey,
+                                 { m_frameData.m_currentPosition,
+                                   m_frameData.m_currentNormal,
+                                   m_frameData.m_currentTangent,
+                                   m_frameData.m_currentBitangent } );
         }
     }
 }
 
+SkinKey SkinningComponent::getSkinKey() const {
+    if ( m_skinCache == nullptr || m_refDataCache != m_skinCache || !m_poseKeyGetter ) {
+        return {};
+    }
+    const int method = 2 * int( m_skinningType ) + int( m_normalSkinning );
+    return { *m_refDataKey, *m_poseKeyGetter(), method };
+}
+
 void SkinningComponent::endSkinning() {
     if ( m_frameData.m_doSkinning ) {
         AttribArrayGeometry* geom;
@@ -276,22 +348,34 @@ void SkinningComponent::endSkinning() {
             geom = const_cast<PolyMesh*>( m_polyMeshWriter() );
         }
 
-        geom->setVertices( m_frameData.m_currentPosition );
-        geom->setNormals( m_frameData.m_currentNormal );
-        auto handle = geom->getAttribHandle<Vector3>( tangentName );
-        if ( handle.idx().isValid() ) {
-            geom->getAttrib( handle ).setData( m_frameData.m_currentTangent );
-        }
-        handle = geom->getAttribHandle<Vector3>( bitangentName );
-        if ( handle.idx().isValid() ) {
-            geom->getAttrib( handle ).setData( m_frameData.m_currentBitangent );
-        }
+        // Swap the skinned data with the ones of the geometry instead of copying them, the
+        // previous data being overwritten by the next skinning.
+        const auto swapData = [geom]( Vector3Array& skinned, const std::string& name ) {
+            auto handle = geom->getAttribHandle<Vector3>( name );
+            if ( !handle.idx().isValid() ) { return; }
+            auto& attrib = geom->getAttrib( handle );
+            std::swap( attrib.getDataWithLock(), skinned );
+            attrib.unlock();
+        };
+        // Unlocking the positions invalidates the geometry bounding box, so that the
+        // RenderObject one follows the skinned pose.
+        std::swap( geom->verticesWithLock(), m_frameData.m_currentPosition );
+        geom->verticesUnlock();
+        swapData( m_frameData.m_currentNormal,
+                  Ra::Core::Geometry::getAttribName( Ra::Core::Geometry::VERTEX_NORMAL ) );
+        swapData( m_frameData.m_currentTangent, tangentName );
+        swapData( m_frameData.m_currentBitangent, bitangentName );
 
         m_frameData.m_doReset    = false;
         m_frameData.m_doSkinning = false;
     }
 }
 
+bool SkinningComponent::isSkinnedMeshVisible() const {
+    if ( !m_isReady ) { return false; }
+    return getRoMgr()->getRenderObject( *m_renderObjectReader() )->isVisible();
+}
+
 void SkinningComponent::handleSkinDataLoading( const Asset::HandleData* data,
                                                const std::string& meshName ) {
     m_skelName = data->getName();
@@ -341,6 +425,12 @@ void SkinningComponent::createWeightMatrix() {
     if ( normalizeWeights( m_refData.m_weights, true ) ) {
         LOG( logINFO ) << "Skinning weights have been normalized";
     }
+    m_packedWeights = packWeights( m_refData.m_weights );
+}
+
+void SkinningComponent::computeCentersOfRotation() {
+    if ( s_corCacheDirectory.empty() ) { computeCoR( m_refData ); }
+    else { computeCoR( m_refData, s_corCacheDirectory ); }
 }
 
 void SkinningComponent::setupIO( const std::string& id ) {
@@ -357,8 +447,7 @@ void SkinningComponent::setSkinningType( SkinningType type ) {
     m_skinningType = type;
     if ( m_isReady ) {
         // compute the per-vertex center of rotation only if required.
-        // FIXME: takes time, would be nice to store them in a file and reload.
-        if ( m_skinningType == COR && m_refData.m_CoR.empty() ) { computeCoR( m_refData ); }
+        if ( m_skinningType == COR && m_refData.m_CoR.empty() ) { computeCentersOfRotation(); }
         m_forceUpdate = true;
     }
 }
@@ -400,10 +489,9 @@ void SkinningComponent::showWeights( bool on ) {
         switch ( m_weightType ) {
         case STANDARD:
         default: {
-#pragma omp parallel for
-            for ( int i = 0; i < int( size ); ++i ) {
+            parallelFor( 0, int( size ), [&]( int i ) {
                 m_weightsUV[i][0] = m_refData.m_weights.coeff( i, m_weightBone );
-            }
+            } );
         } break;
         } // end of switch.
         // change the material
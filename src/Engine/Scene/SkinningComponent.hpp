@@ -1,10 +1,11 @@
 #pragma once
 
+#include <Core/Animation/AnimationCache.hpp>
 #include <Core/Animation/HandleWeight.hpp>
 #include <Core/Animation/Pose.hpp>
 #include <Core/Animation/SkinningData.hpp>
 #include <Core/Asset/HandleData.hpp>
-#include <Core/Geometry/TopologicalMesh.hpp>
+#include <Core/Geometry/SplitNormals.hpp>
 #include <Core/Geometry/TriangleMesh.hpp>
 #include <Core/Math/DualQuaternion.hpp>
 #include <Core/Utils/Index.hpp>
@@ -87,12 +88,31 @@ class RA_ENGINE_API SkinningComponent : public Component
     /// Update internal data and update the skinned mesh.
     void endSkinning();
 
+    /// Returns true if the render object of the skinned mesh is visible.
+    bool isSkinnedMeshVisible() const;
+
+    /// Sets the cache sharing the skinned vertices between the SkinningComponents with the same
+    /// mesh, weights and skinning methods whose skeletons play the same cached pose,
+    /// nullptr for none.
+    inline void setSkinCache( Core::Animation::SkinCache* cache ) { m_skinCache = cache; }
+
     /// Sets the Skinning method to use.
     void setSkinningType( SkinningType type );
 
     /// Returns the current skinning method.
     inline SkinningType getSkinningType() const { return m_skinningType; }
 
+    /// Sets the directory where the COR skinning stores the centers of rotation it computes, to
+    /// reuse them for the same mesh and weights (see Core::Animation::computeCoR()).
+    /// Empty, the default, for no storage.
+    /// \note Must be set before initializing the SkinningComponents.
+    static inline void setCoRCacheDirectory( const std::string& directory ) {
+        s_corCacheDirectory = directory;
+    }
+
+    /// Returns the directory where the centers of rotation are stored, empty if none.
+    static inline const std::string& getCoRCacheDirectory() { return s_corCacheDirectory; }
+
     /// Sets the method to use to skin the normal, tangent and binormal vectors.
     void setNormalSkinning( NormalSkinning normalSkinning );
 
@@ -113,6 +133,8 @@ class RA_ENGINE_API SkinningComponent : public Component
     const Core::Animation::SkinningRefData* getSkinningRefData() const { return &m_refData; }
 
     /// Returns the current Pose data.
+    /// \note The skinned vertex data are only valid between skin() and endSkinning(), which
+    /// swaps them with the ones of the mesh (see Core::Animation::SkinningFrameData).
     const Core::Animation::SkinningFrameData* getSkinningFrameData() const { return &m_frameData; }
     /// \}
 
@@ -139,9 +161,16 @@ class RA_ENGINE_API SkinningComponent : public Component
     /// Setup Component Communication.
     void setupIO( const std::string& id );
 
+    /// Returns the key of the skinned vertices for the current skeleton pose, invalid if they
+    /// cannot be cached.
+    Core::Animation::SkinKey getSkinKey() const;
+
     /// Internal function to create the skinning weights.
     void createWeightMatrix();
 
+    /// Computes the centers of rotation of m_refData, stored in s_corCacheDirectory if any.
+    void computeCentersOfRotation();
+
   private:
     template <typename T>
     using Getter = typename ComponentMessenger::CallbackTypes<T>::Getter;
@@ -158,12 +187,33 @@ class RA_ENGINE_API SkinningComponent : public Component
     /// The refrence Skinning data.
     Core::Animation::SkinningRefData m_refData;
 
+    /// The skinning weights of m_refData packed per vertex, for the LBS and DQS skinnings.
+    Core::Animation::PackedWeights m_packedWeights;
+
     /// The current Pose data.
     Core::Animation::SkinningFrameData m_frameData;
 
     /// Getter for the animation skeletton.
     Getter<Core::Animation::Skeleton> m_skeletonGetter;
 
+    /// The pose version of the animation skeleton at the last skinning.
+    uint64_t m_skeletonVersion { 0 };
+
+    /// Getter for the key of the animation skeleton pose.
+    Getter<Core::Animation::PoseKey> m_poseKeyGetter;
+
+    /// The cache of the skinned vertices, if any.
+    Core::Animation::SkinCache* m_skinCache { nullptr };
+
+    /// The key of the reference skinning data content, given by m_refDataCache.
+    Core::Animation::SkinCache::ContentKey m_refDataKey;
+
+    /// The skinned vertices cache which gave the reference skinning data key.
+    const Core::Animation::SkinCache* m_refDataCache { nullptr };
+
+    /// The directory where the centers of rotation are stored, empty if none.
+    static std::string s_corCacheDirectory;
+
     /// The Skinning Method.
     SkinningType m_skinningType;
 
@@ -194,8 +244,8 @@ class RA_ENGINE_API SkinningComponent : public Component
     /// Getter/Setter to the skinned mesh, in case it is a QuadMesh.
     ReadWrite<Core::Geometry::QuadMesh> m_quadMeshWriter;
 
-    /// The Topological mesh used to geometrically recompute the normals.
-    Core::Geometry::TopologicalMesh m_topoMesh;
+    /// The vertex to face adjacency used to geometrically recompute the normals.
+    Core::Geometry::SplitNormals m_splitNormals;
 
     /// The per-bone skinning weights.
     /// \note These are stored this way because we cannot build the weight matrix
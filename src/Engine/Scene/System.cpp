@@ -21,6 +21,7 @@ void System::registerComponent( const Entity* ent, Component* component ) {
 #endif // DEBUG
     m_components.emplace_back( ent, component );
     component->setSystem( this );
+    m_tasksOutdated = true;
 }
 
 void System::unregisterComponent( const Entity* ent, Component* component ) {
@@ -35,6 +36,7 @@ void System::unregisterComponent( const Entity* ent, Component* component ) {
     CORE_ASSERT( pos->first == ent, "Component belongs to a different entity" );
     component->setSystem( nullptr );
     m_components.erase( pos );
+    m_tasksOutdated = true;
 }
 
 void System::unregisterAllComponents( const Entity* entity ) {
@@ -44,6 +46,7 @@ void System::unregisterAllComponents( const Entity* entity ) {
                       return pair.first == entity;
                   } ) ) != m_components.end() ) {
         m_components.erase( pos );
+        m_tasksOutdated = true;
     }
 }
 
@@ -58,6 +58,23 @@ class RA_ENGINE_API System
     virtual void generateTasks( Core::TaskQueue* taskQueue,
                                 const Engine::FrameInfo& frameInfo ) = 0;
 
+    /**
+     * Tells if the tasks registered by generateTasks can be recorded once and replayed at each
+     * frame, until a component is added to or removed from the system.
+     * Such tasks must not depend on the frame they have been generated for : they read the frame
+     * information when processed, through the FrameInfo reference given to generateTasks, which
+     * stays valid and is updated by the engine before each frame.
+     * @see RadiumEngine::updateTaskGraph
+     * @return false by default, meaning that generateTasks is called at each frame.
+     */
+    virtual bool hasPersistentTasks() const { return false; }
+
+    /// True if the components of the system changed since the tasks have been generated.
+    bool areTasksOutdated() const { return m_tasksOutdated; }
+
+    /// Mark the generated tasks as outdated (or up to date when \p outdated is false).
+    void setTasksOutdated( bool outdated = true ) { m_tasksOutdated = outdated; }
+
     /** Returns the components stored for the given entity.
      *
      * @param entity
@@ -101,6 +118,10 @@ class RA_ENGINE_API System
   protected:
     /// List of active components.
     std::vector<std::pair<const Entity*, Component*>> m_components;
+
+  private:
+    /// Set when a component is registered or unregistered.
+    bool m_tasksOutdated { true };
 };
 
 } // namespace Scene
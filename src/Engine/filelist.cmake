@@ -27,9 +27,11 @@ set(engine_sources
     Data/stb.cpp
     RadiumEngine.cpp
     Rendering/DebugRender.cpp
+    Rendering/DrawList.cpp
     Rendering/ForwardRenderer.cpp
     Rendering/RenderObject.cpp
     Rendering/RenderObjectManager.cpp
+    Rendering/RenderQueues.cpp
     Rendering/RenderTechnique.cpp
     Rendering/Renderer.cpp
     Scene/CameraComponent.cpp
@@ -83,10 +85,12 @@ set(engine_headers
     RaEngine.hpp
     RadiumEngine.hpp
     Rendering/DebugRender.hpp
+    Rendering/DrawList.hpp
     Rendering/ForwardRenderer.hpp
     Rendering/RenderObject.hpp
     Rendering/RenderObjectManager.hpp
     Rendering/RenderObjectTypes.hpp
+    Rendering/RenderQueues.hpp
     Rendering/RenderTechnique.hpp
     Rendering/Renderer.hpp
     Scene/CameraComponent.hpp
@@ -5,6 +5,7 @@
 
 #include <Core/CoreMacros.hpp>
 #include <Core/Resources/Resources.hpp>
+#include <Core/Tasks/Parallel.hpp>
 #include <Core/Tasks/Task.hpp>
 #include <Core/Tasks/TaskQueue.hpp>
 #include <Core/Types.hpp>
@@ -104,6 +105,9 @@ BaseApplication::BaseApplication( int& argc,
         "Control the maximum number of threads. 0 will set to the number of cores available",
         "number",
         "0" );
+    QCommandLineOption workStealingOpt(
+        QStringList { "w", "workstealing", "work-stealing" },
+        "Use per-thread task queues with work stealing to run the frame tasks." );
     QCommandLineOption numFramesOpt(
         QStringList { "n", "numframes" }, "Run for a fixed number of frames.", "number", "0" );
     QCommandLineOption pluginOpt( QStringList { "p", "plugins", "pluginsPath" },
@@ -130,6 +134,14 @@ BaseApplication::BaseApplication( int& argc,
                                "foo.bar" );
     QCommandLineOption recordOpt( QStringList { "s", "recordFrames" },
                                   "Enable snapshot recording." );
+    QCommandLineOption traceOpt(
+        QStringList { "trace" },
+        "Record the tasks and rendering timelines to a Chrome trace-event file (see Perfetto).",
+        "file name" );
+    QCommandLineOption traceFramesOpt( QStringList { "traceframes", "trace-frames" },
+                                       "Number of frames recorded by the --trace option.",
+                                       "number",
+                                       "100" );
 
     QCommandLineOption datapathOpt( QStringList { "d", "data", "export" },
                                     "Set the default data path and store it in the settings.",
@@ -144,8 +156,11 @@ BaseApplication::BaseApplication( int& argc,
                          fileOpt,
                          camOpt,
                          maxThreadsOpt,
+                         workStealingOpt,
                          numFramesOpt,
                          recordOpt,
+                         traceOpt,
+                         traceFramesOpt,
                          datapathOpt } );
 
     if ( !parser.parse( this->arguments() ) ) {
@@ -168,10 +183,15 @@ BaseApplication::BaseApplication( int& argc,
     if ( parser.isSet( pluginOpt ) ) m_pluginPath = parser.value( pluginOpt ).toStdString();
     if ( parser.isSet( numFramesOpt ) ) m_numFrames = parser.value( numFramesOpt ).toUInt();
     if ( parser.isSet( maxThreadsOpt ) ) m_maxThreads = parser.value( maxThreadsOpt ).toUInt();
+    if ( parser.isSet( workStealingOpt ) ) m_workStealing = true;
     if ( parser.isSet( recordOpt ) ) {
         m_recordFrames = true;
         setContinuousUpdate( true );
     }
+    if ( parser.isSet( traceOpt ) ) {
+        startTraceRecording( parser.value( traceOpt ).toStdString(),
+                             parser.value( traceFramesOpt ).toUInt() );
+    }
 
     {
         std::time_t startTime = std::time( nullptr );
@@ -342,7 +362,12 @@ void BaseApplication::initialize( const WindowFactory& factory,
     // unless monothread CPU
     uint numThreads =
         std::max( m_maxThreads == 0 ? RA_MAX_THREAD : std::min( m_maxThreads, RA_MAX_THREAD ), 1u );
-    m_taskQueue = std::make_unique<Core::TaskQueue>( numThreads );
+    m_taskQueue = std::make_unique<Core::TaskQueue>(
+        numThreads,
+        m_workStealing ? Core::TaskQueue::ExecutionMode::WorkStealing
+                       : Core::TaskQueue::ExecutionMode::GlobalQueue );
+    // Data parallel loops (skinning, texture processing ...) also run on the task queue threads.
+    Core::setParallelTaskQueue( m_taskQueue.get() );
 
     setupScene();
     emit starting();
@@ -486,7 +511,9 @@ void BaseApplication::radiumFrame() {
 
     // ----------
     // 2. Run the engine task queue.
-    m_engine->getTasks( m_taskQueue.get(), dt );
+    // The task graph is kept between frames, and recorded again only when systems or components
+    // changed (or if a system does not support persistent tasks).
+    m_engine->updateTaskGraph( m_taskQueue.get(), dt );
 
     if ( m_recordGraph ) { m_taskQueue->printTaskGraph( std::cout ); }
 
@@ -494,7 +521,6 @@ void BaseApplication::radiumFrame() {
     m_taskQueue->startTasks();
     m_taskQueue->waitForTasks();
     timerData.taskData = m_taskQueue->getTimerData();
-    m_taskQueue->flushTaskQueue();
 
     timerData.tasksEnd = Core::Utils::Clock::now();
 
@@ -528,6 +554,17 @@ void BaseApplication::radiumFrame() {
 
     if ( m_recordTimings ) { timerData.print( std::cout ); }
 
+    if ( m_traceRecorder.isRecording() ) {
+        m_traceRecorder.addSpan( "Frame " + std::to_string( m_frameCounter ),
+                                 "frame",
+                                 timerData.frameStart,
+                                 timerData.frameEnd );
+        m_traceRecorder.addSpan( "Tasks", "frame", timerData.tasksStart, timerData.tasksEnd );
+        m_traceRecorder.addTasks( *m_taskQueue );
+        Engine::Rendering::Renderer::addTimerDataToTrace( timerData.renderData, m_traceRecorder );
+        m_traceRecorder.endFrame();
+    }
+
     m_timerData.push_back( timerData );
 
     if ( m_recordFrames ) { recordFrame(); }
@@ -577,6 +614,7 @@ void BaseApplication::recordFrame() {
 
 BaseApplication::~BaseApplication() {
     emit stopping();
+    Core::setParallelTaskQueue( nullptr );
     m_mainWindow->cleanup();
     m_engine->cleanup();
     Ra::Engine::RadiumEngine::destroyInstance();
@@ -754,6 +792,10 @@ void BaseApplication::setRecordGraph( bool on ) {
     m_recordGraph = on;
 }
 
+bool BaseApplication::startTraceRecording( const std::string& filename, uint numFrames ) {
+    return m_traceRecorder.start( filename, numFrames );
+}
+
 void BaseApplication::addPluginDirectory( const std::string& pluginDir ) {
     QSettings settings;
     QStringList pluginPaths = settings.value( "plugins/paths" ).value<QStringList>();
@@ -6,6 +6,7 @@
 
 #include <QApplication>
 
+#include <Core/Tasks/TraceRecorder.hpp>
 #include <Core/Utils/Timer.hpp>
 #include <Gui/TimerData/FrameTimerData.hpp>
 #include <PluginBase/RadiumPluginInterface.hpp>
@@ -190,6 +191,9 @@ class RA_GUI_API BaseApplication : public QApplication
     void setRecordFrames( bool on );
     void setRecordTimings( bool on );
     void setRecordGraph( bool on );
+    /// Record the timelines of the next \p numFrames frames (tasks, dependencies and rendering
+    /// passes) to the Chrome trace-event file \p filename, to be opened with Perfetto.
+    bool startTraceRecording( const std::string& filename, uint numFrames = 100 );
 
     void recordFrame();
 
@@ -254,6 +258,8 @@ class RA_GUI_API BaseApplication : public QApplication
     uint m_frameCountBeforeUpdate;
     uint m_numFrames;
     uint m_maxThreads;
+    /// If true, the frame task queue uses the work-stealing execution mode.
+    bool m_workStealing { false };
     std::vector<FrameTimerData> m_timerData;
     std::string m_pluginPath;
 
@@ -270,6 +276,8 @@ class RA_GUI_API BaseApplication : public QApplication
     bool m_recordTimings;
     /// If true, print the task graph;
     bool m_recordGraph;
+    /// Records the frame timelines to a trace file, when started.
+    Core::TraceRecorder m_traceRecorder;
 
     /// True if the applicatioon is about to quit. prevent to use resources that are being released.
     bool m_isAboutToQuit;
@@ -2,6 +2,7 @@
 
 #include <Core/Asset/Camera.hpp>
 #include <Core/Asset/FileLoaderInterface.hpp>
+#include <Core/Tasks/Parallel.hpp>
 #include <Core/Tasks/TaskQueue.hpp>
 #include <Core/Utils/Log.hpp>
 
@@ -14,6 +15,8 @@
 #include <Engine/Scene/SkeletonBasedAnimationSystem.hpp>
 #include <Engine/Scene/SystemDisplay.hpp>
 
+#include <algorithm>
+
 namespace Ra {
 namespace Headless {
 using namespace Ra::Core::Utils;
@@ -27,9 +30,15 @@ CLIViewer::CLIViewer( const glbinding::Version& glVersion ) :
         ->check( CLI::ExistingFile );
     addOption( "-s,--size", m_parameters.m_size, "Size of the computed image." )->delimiter( 'x' );
     addFlag( "-a,--animation", m_parameters.m_animationEnable, "Enable Radium Animation system." );
+    addOption( "--trace",
+               m_parameters.m_traceFile,
+               "Record the tasks and rendering timelines to a Chrome trace-event file." );
+    addOption( "--traceframes", m_parameters.m_traceFrames, "Number of frames to trace." );
 }
 
 CLIViewer::~CLIViewer() {
+    Ra::Core::setParallelTaskQueue( nullptr );
+    m_taskQueue.reset();
     if ( m_engineInitialized ) {
         m_glContext.makeCurrent();
         m_renderer.reset();
@@ -85,11 +94,16 @@ int CLIViewer::init( int argc, const char* argv[] ) {
     // register listeners on the OpenGL Context
     m_glContext.resizeListener().attach(
         [this]( int width, int height ) { resize( width, height ); } );
+
+    if ( !m_parameters.m_traceFile.empty() ) {
+        startTraceRecording( m_parameters.m_traceFile, m_parameters.m_traceFrames );
+    }
     // Init is OK
     return 0;
 }
 
 int CLIViewer::oneFrame( float timeStep ) {
+    const auto frameStart = Ra::Core::Utils::Clock::now();
     if ( m_parameters.m_animationEnable ) {
         auto animationSystem = dynamic_cast<Ra::Engine::Scene::SkeletonBasedAnimationSystem*>(
             m_engine->getSystem( "SkeletonBasedAnimationSystem" ) );
@@ -98,19 +112,39 @@ int CLIViewer::oneFrame( float timeStep ) {
         m_engine->step();
     }
 
-    Ra::Core::TaskQueue tasks( std::thread::hardware_concurrency() - 1 );
-    m_engine->getTasks( &tasks, Scalar( timeStep ) );
-    tasks.startTasks();
-    tasks.waitForTasks();
-    tasks.flushTaskQueue();
+    if ( !m_taskQueue ) {
+        m_taskQueue = std::make_unique<Ra::Core::TaskQueue>(
+            std::max( std::thread::hardware_concurrency(), 2u ) - 1 );
+        Ra::Core::setParallelTaskQueue( m_taskQueue.get() );
+    }
+    // The task graph is only recorded again when systems or components changed.
+    const auto tasksStart = Ra::Core::Utils::Clock::now();
+    m_engine->updateTaskGraph( m_taskQueue.get(), Scalar( timeStep ) );
+    m_taskQueue->startTasks();
+    m_taskQueue->waitForTasks();
+    const auto tasksEnd = Ra::Core::Utils::Clock::now();
 
     Ra::Engine::Data::ViewingParameters data {
         m_camera->getViewMatrix(), m_camera->getProjMatrix(), timeStep };
     m_renderer->render( data );
 
+    if ( m_traceRecorder.isRecording() ) {
+        const auto frameName = "Frame " + std::to_string( m_traceRecorder.getNumRecordedFrames() );
+        m_traceRecorder.addSpan( frameName, "frame", frameStart, Ra::Core::Utils::Clock::now() );
+        m_traceRecorder.addSpan( "Tasks", "frame", tasksStart, tasksEnd );
+        m_traceRecorder.addTasks( *m_taskQueue );
+        Ra::Engine::Rendering::Renderer::addTimerDataToTrace( m_renderer->getTimerData(),
+                                                              m_traceRecorder );
+        m_traceRecorder.endFrame();
+    }
+
     return 0;
 }
 
+bool CLIViewer::startTraceRecording( const std::string& filename, uint numFrames ) {
+    return m_traceRecorder.start( filename, numFrames );
+}
+
 std::unique_ptr<unsigned char[]> CLIViewer::grabFrame( size_t& w, size_t& h ) const {
     return m_renderer->grabFrame( w, h );
 }
@@ -2,14 +2,17 @@
 #include <Headless/CLIBaseApplication.hpp>
 #include <Headless/OpenGLContext/OpenGLContext.hpp>
 
+#include <Core/Tasks/TraceRecorder.hpp>
 #include <Core/Utils/Index.hpp>
 
 #include <functional>
+#include <memory>
 
 #include <glbinding/Version.h>
 
 namespace Ra {
 namespace Core {
+class TaskQueue;
 namespace Asset {
 class FileLoaderInterface;
 class Camera;
@@ -43,6 +46,10 @@ class HEADLESS_API CLIViewer : public CLIBaseApplication
         std::string m_imgPrefix { "frame" };
         /// The data file to manage
         std::string m_dataFile = { "" };
+        /// Chrome trace-event file where frame timelines are recorded (no recording if empty)
+        std::string m_traceFile { "" };
+        /// Number of frames recorded in m_traceFile
+        uint m_traceFrames { 100 };
     };
 
   public:
@@ -62,6 +69,12 @@ class HEADLESS_API CLIViewer : public CLIBaseApplication
     /// The camera for rendering
     Ra::Core::Asset::Camera* m_camera { nullptr };
 
+    /// Task queue running the engine tasks, its task graph is kept between frames.
+    std::unique_ptr<Ra::Core::TaskQueue> m_taskQueue;
+
+    /// Records the frame timelines to a trace file, when started.
+    Ra::Core::TraceRecorder m_traceRecorder;
+
     /// The application parameters
     ViewerParameters m_parameters;
 
@@ -94,6 +107,8 @@ class HEADLESS_API CLIViewer : public CLIBaseApplication
      *   - --size <width x height> : the size of the rendered picture
      *   - --animation : load the Radium animation system
      *   - --env <env_map> : load and use the given environment map.
+     *   - --trace <file> : record the timelines of the first frames to a Chrome trace-event file.
+     *   - --traceframes <n> : number of frames recorded by --trace (100 by default).
      */
     int init( int argc, const char* argv[] ) override;
 
@@ -106,6 +121,13 @@ class HEADLESS_API CLIViewer : public CLIBaseApplication
      */
     int oneFrame( float timeStep = 1.f / 60.f );
 
+    /**
+     * Record the timelines of the next \p numFrames frames (tasks, dependencies and rendering
+     * passes) to the Chrome trace-event file \p filename, to be opened with Perfetto.
+     * @return false if the file can't be opened.
+     */
+    bool startTraceRecording( const std::string& filename, uint numFrames = 100 );
+
     /**
      * Set the renderer to use to compute an image
      *  The app takes ownership of the give pointer.
@@ -111,7 +111,7 @@ void AssimpAnimationDataLoader::fetchAnimation( const aiAnimation* anim,
         fetchHandleAnimation( anim->mChannels[i], keyFrame[i], data->getTimeStep() );
         time.extends( keyFrame[i].m_animationTime );
     }
-    data->setHandleData( keyFrame );
+    data->setHandleData( std::move( keyFrame ) );
     data->setTime( time );
 }
 
@@ -1,3 +1,7 @@
+#include <Core/Animation/AnimationCache.hpp>
+#include <Core/Animation/AnimationClip.hpp>
+#include <Core/Animation/CompactPose.hpp>
+#include <Core/Animation/CompressedAnimation.hpp>
 #include <Core/Animation/HandleWeightOperation.hpp>
 //! [include keyframed]
 #include <Core/Animation/KeyFramedValue.hpp>
@@ -11,11 +15,21 @@
 #include <Core/Animation/DualQuaternionSkinning.hpp>
 //! [include DualQuaternionSkinning ]
 
+#include <Core/Animation/LinearBlendSkinning.hpp>
 #include <Core/Animation/PoseOperation.hpp>
+#include <Core/Animation/RotationCenterSkinning.hpp>
 #include <Core/Animation/Skeleton.hpp>
+#include <Core/Animation/SkinningData.hpp>
+#include <Core/Geometry/MeshPrimitives.hpp>
+#include <Core/Utils/StdFilesystem.hpp>
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+
 using namespace Ra::Core;
 using namespace Ra::Core::Animation;
 
@@ -463,6 +477,21 @@ TEST_CASE( "Core/Animation/Skeleton", "[Core][Core/Animation][Skeleton]" ) {
         REQUIRE( b.isApprox( 3 * Vector3::UnitX() ) );
     }
 
+    SECTION( "Test pose versions" ) {
+        const auto version = skel.getPoseVersion();
+        Skeleton copy      = skel;
+        REQUIRE( copy.getPoseVersion() == version );
+        // Any modification gives a new version, unique among the skeletons.
+        copy.setTransform( bone2, localT, Space::LOCAL );
+        REQUIRE( copy.getPoseVersion() != version );
+        skel.setPose( skel.getPose( Space::MODEL ), Space::MODEL );
+        REQUIRE( skel.getPoseVersion() != version );
+        REQUIRE( skel.getPoseVersion() != copy.getPoseVersion() );
+        const auto poseVersion = skel.getPoseVersion();
+        skel.addBone( bone3, localT, Space::LOCAL, "bone4" );
+        REQUIRE( skel.getPoseVersion() != poseVersion );
+    }
+
     SECTION( "Test Forward Manipulation" ) {
         /*                                                          > - - v
          * Here we will pose the skeleton from                 to   |     |
@@ -964,6 +993,80 @@ TEST_CASE( "Core/Animation/Skeleton", "[Core][Core/Animation][Skeleton]" ) {
     }
 }
 
+TEST_CASE( "Core/Animation/Skeleton/Dirty propagation", "[Core][Core/Animation][Skeleton]" ) {
+    using Space = HandleArray::SpaceType;
+    // a big random rig, bones being added in depth-first order.
+    const int numBones = 300;
+    std::mt19937 gen( 0 );
+    std::uniform_real_distribution<Scalar> dis( -1_ra, 1_ra );
+    const auto randomTransform = [&]() {
+        Transform T = Transform::Identity();
+        T.translate( Vector3( dis( gen ), dis( gen ), dis( gen ) ) );
+        T.rotate( AngleAxis( dis( gen ), Vector3( dis( gen ), dis( gen ), 1_ra ).normalized() ) );
+        return T;
+    };
+    Skeleton skel;
+    skel.addRoot( randomTransform() );
+    for ( int i = 1; i < numBones; ++i ) {
+        skel.addBone( uint( gen() ) % i, randomTransform() );
+    }
+    // the Model-space pose computed from scratch.
+    const auto modelPose = []( const Skeleton& s ) {
+        const auto& local = s.getPose( Space::LOCAL );
+        Pose model( local.size() );
+        for ( uint i = 0; i < s.size(); ++i ) {
+            const int parent = s.m_graph.parents()[i];
+            model[i]         = ( parent == -1 ) ? local[i] : Transform( model[parent] * local[i] );
+        }
+        return model;
+    };
+    REQUIRE( areEqual( skel.getPose( Space::MODEL ), modelPose( skel ) ) );
+
+    SECTION( "Single bone edition" ) {
+        const uint bone    = numBones / 2;
+        const Pose before  = skel.getPose( Space::MODEL );
+        const auto version = skel.getPoseVersion();
+        skel.setTransform( bone, randomTransform(), Space::LOCAL );
+        REQUIRE( skel.getPoseVersion() != version );
+        REQUIRE( !skel.isModelSpaceOutdated() );
+        REQUIRE( areEqual( skel.getPose( Space::MODEL ), modelPose( skel ) ) );
+        // the bones out of the subtree are left untouched.
+        for ( uint i = 0; i < bone; ++i ) {
+            REQUIRE( skel.getTransform( i, Space::MODEL ).matrix() == before[i].matrix() );
+        }
+    }
+
+    SECTION( "Deferred edition" ) {
+        for ( int k = 0; k < 20; ++k ) {
+            skel.setLocalTransformDeferred( uint( gen() ) % numBones, randomTransform() );
+        }
+        REQUIRE( skel.isModelSpaceOutdated() );
+        skel.updateModelSpace();
+        REQUIRE( !skel.isModelSpaceOutdated() );
+        REQUIRE( areEqual( skel.getPose( Space::MODEL ), modelPose( skel ) ) );
+    }
+
+    SECTION( "Pose edition" ) {
+        Pose pose          = skel.getPose( Space::LOCAL );
+        const auto version = skel.getPoseVersion();
+        skel.setPose( pose, Space::LOCAL );
+        REQUIRE( skel.getPoseVersion() == version );
+        pose[1] = randomTransform();
+        pose[7] = randomTransform();
+        skel.setPose( pose, Space::LOCAL );
+        REQUIRE( skel.getPoseVersion() != version );
+        REQUIRE( areEqual( skel.getPose( Space::MODEL ), modelPose( skel ) ) );
+
+        // Model-space edition keeps the descendants in place.
+        const Pose before = skel.getPose( Space::MODEL );
+        skel.setTransform( 3, randomTransform(), Space::MODEL );
+        for ( uint i = 0; i < skel.size(); ++i ) {
+            if ( i != 3 ) { REQUIRE( skel.getTransform( i, Space::MODEL ).isApprox( before[i] ) ); }
+        }
+        REQUIRE( areEqual( skel.getPose( Space::MODEL ), modelPose( skel ) ) );
+    }
+}
+
 TEST_CASE( "Core/Animation/DualQuaternionSkinning",
            "[Core][Core/Animation][DualQuaternionSkinning]" ) {
     // initialize the pose
@@ -1016,3 +1119,663 @@ TEST_CASE( "Core/Animation/DualQuaternionSkinning",
     auto dq_n = Ra::Core::Animation::computeDQ( pose, weights );
     REQUIRE( q3.toRotationMatrix().isApprox( dq_n[2].getTransform().linear() ) );
 }
+
+namespace {
+/// A chain of bones along X, bent, skinning a cylinder with random weights.
+void makeSkinnedChain( SkinningRefData& refData,
+                       SkinningFrameData& frameData,
+                       Vector3Array& tangents,
+                       Vector3Array& bitangents ) {
+    using Space          = HandleArray::SpaceType;
+    Skeleton& skel       = refData.m_skeleton;
+    Transform localT     = Transform::Identity();
+    localT.translation() = Vector3::UnitX();
+    skel.addRoot( Transform::Identity(), "root" );
+    for ( uint i = 1; i < 4; ++i ) {
+        skel.addBone( i - 1, localT, Space::LOCAL, "bone" + std::to_string( i ) );
+    }
+    refData.m_referenceMesh =
+        Geometry::makeCylinder( Vector3::Zero(), 4_ra * Vector3::UnitX(), 0.5_ra, 16 );
+    refData.m_meshTransformInverse = Transform( Eigen::Translation<Scalar, 3>( 0_ra, 1_ra, 0_ra ) );
+    for ( uint i = 0; i < skel.size(); ++i ) {
+        refData.m_bindMatrices.push_back( skel.getTransform( i, Space::MODEL ).inverse() );
+    }
+
+    // Random weights on 1 to 3 consecutive bones.
+    const auto& vertices = refData.m_referenceMesh.vertices();
+    const int n          = int( vertices.size() );
+    std::mt19937 gen( 0 );
+    std::uniform_real_distribution<Scalar> dist( 0.1_ra, 1_ra );
+    refData.m_weights.resize( n, int( skel.size() ) );
+    for ( int i = 0; i < n; ++i ) {
+        const int first = std::min( int( vertices[i].x() ), 3 );
+        for ( int j = first; j < std::min( first + 1 + i % 3, 4 ); ++j ) {
+            refData.m_weights.insert( i, j ) = dist( gen );
+        }
+    }
+    normalizeWeights( refData.m_weights );
+
+    // Bend the chain.
+    frameData.m_skeleton = skel;
+    const Transform bend( AngleAxis( Scalar( M_PI / 5. ), Vector3::UnitZ() ) );
+    for ( uint i = 1; i < 4; ++i ) {
+        frameData.m_skeleton.setTransform( i, localT * bend, Space::LOCAL );
+    }
+    frameData.m_currentPosition.resize( vertices.size() );
+    frameData.m_currentNormal.resize( vertices.size() );
+    frameData.m_currentTangent.resize( vertices.size() );
+    frameData.m_currentBitangent.resize( vertices.size() );
+    tangents.resize( vertices.size() );
+    bitangents.resize( vertices.size() );
+    for ( int i = 0; i < n; ++i ) {
+        tangents[i]   = Vector3::Random();
+        bitangents[i] = Vector3::Random();
+    }
+}
+} // namespace
+
+TEST_CASE( "Core/Animation/LinearBlendSkinning",
+           "[Core][Core/Animation][LinearBlendSkinning]" ) {
+    using Space = HandleArray::SpaceType;
+    SkinningRefData refData;
+    SkinningFrameData frameData;
+    Vector3Array tangents, bitangents;
+    makeSkinnedChain( refData, frameData, tangents, bitangents );
+    const auto& vertices = refData.m_referenceMesh.vertices();
+    const int n          = int( vertices.size() );
+
+    SECTION( "Packed weights" ) {
+        const PackedWeights packed = packWeights( refData.m_weights );
+        REQUIRE( packed.m_influenceCount == 3 );
+        REQUIRE( packed.size() == size_t( n ) );
+        for ( int i = 0; i < n; ++i ) {
+            Scalar sum = 0_ra;
+            for ( uint k = 0; k < packed.m_influenceCount; ++k ) {
+                const auto& w = packed.m_influences[i * packed.m_influenceCount + k];
+                // Padding influences have null weights.
+                if ( w.second != 0_ra ) {
+                    REQUIRE( w.second == refData.m_weights.coeff( i, w.first ) );
+                }
+                sum += w.second;
+            }
+            REQUIRE( sum == Approx( 1_ra ) );
+        }
+    }
+
+    SECTION( "Same as the per bone blending" ) {
+        linearBlendSkinning( refData, tangents, bitangents, frameData );
+
+        // Blend the transformed vectors, bone by bone.
+        const auto& normals = refData.m_referenceMesh.normals();
+        const auto& pose    = frameData.m_skeleton.getPose( Space::MODEL );
+        Vector3Array positions( size_t( n ), Vector3::Zero() );
+        Vector3Array skinnedNormals( size_t( n ), Vector3::Zero() );
+        Vector3Array skinnedTangents( size_t( n ), Vector3::Zero() );
+        Vector3Array skinnedBitangents( size_t( n ), Vector3::Zero() );
+        for ( int j = 0; j < refData.m_weights.outerSize(); ++j ) {
+            const Transform M =
+                refData.m_meshTransformInverse * pose[j] * refData.m_bindMatrices[j];
+            for ( WeightMatrix::InnerIterator it( refData.m_weights, j ); it; ++it ) {
+                const int i = int( it.row() );
+                positions[i] += it.value() * ( M * vertices[i] );
+                skinnedNormals[i] += it.value() * ( M.linear() * normals[i] );
+                skinnedTangents[i] += it.value() * ( M.linear() * tangents[i] );
+                skinnedBitangents[i] += it.value() * ( M.linear() * bitangents[i] );
+            }
+        }
+        for ( int i = 0; i < n; ++i ) {
+            REQUIRE( frameData.m_currentPosition[i].isApprox( positions[i] ) );
+            REQUIRE( frameData.m_currentNormal[i].isApprox( skinnedNormals[i] ) );
+            REQUIRE( frameData.m_currentTangent[i].isApprox( skinnedTangents[i] ) );
+            REQUIRE( frameData.m_currentBitangent[i].isApprox( skinnedBitangents[i] ) );
+        }
+        // The root is not moved.
+        REQUIRE( frameData.m_currentPosition[0].isApprox( vertices[0] + Vector3::UnitY() ) );
+    }
+}
+
+TEST_CASE( "Core/Animation/DualQuaternionSkinning/Vertex parallel",
+           "[Core][Core/Animation][DualQuaternionSkinning]" ) {
+    SkinningRefData refData;
+    SkinningFrameData frameData;
+    Vector3Array tangents, bitangents;
+    makeSkinnedChain( refData, frameData, tangents, bitangents );
+    const auto& vertices = refData.m_referenceMesh.vertices();
+    const auto& normals  = refData.m_referenceMesh.normals();
+
+    auto pose = frameData.m_skeleton.getPose( HandleArray::SpaceType::MODEL );
+    for ( size_t i = 0; i < pose.size(); ++i ) {
+        pose[i] = refData.m_meshTransformInverse * pose[i] * refData.m_bindMatrices[i];
+    }
+    const auto naive = computeDQ_naive( pose, refData.m_weights );
+
+    SECTION( "Same as the naive blending" ) {
+        const auto DQ = computeDQ( pose, refData.m_weights );
+        REQUIRE( DQ.size() == naive.size() );
+        for ( size_t i = 0; i < DQ.size(); ++i ) {
+            REQUIRE( DQ[i].getTransform().isApprox( naive[i].getTransform() ) );
+        }
+        // Same result for each run.
+        const auto DQ2 = computeDQ( pose, packWeights( refData.m_weights ) );
+        for ( size_t i = 0; i < DQ.size(); ++i ) {
+            REQUIRE( DQ[i].getQ0().coeffs() == DQ2[i].getQ0().coeffs() );
+            REQUIRE( DQ[i].getQe().coeffs() == DQ2[i].getQe().coeffs() );
+        }
+    }
+
+    SECTION( "Fused skinning" ) {
+        dualQuaternionSkinning( refData, tangents, bitangents, frameData );
+        for ( size_t i = 0; i < vertices.size(); ++i ) {
+            const auto& DQi = naive[i];
+            REQUIRE( frameData.m_currentPosition[i].isApprox( DQi.transform( vertices[i] ) ) );
+            REQUIRE( frameData.m_currentNormal[i].isApprox( DQi.rotate( normals[i] ) ) );
+            REQUIRE( frameData.m_currentTangent[i].isApprox( DQi.rotate( tangents[i] ) ) );
+            REQUIRE( frameData.m_currentBitangent[i].isApprox( DQi.rotate( bitangents[i] ) ) );
+        }
+    }
+}
+
+TEST_CASE( "Core/Animation/RotationCenterSkinning",
+           "[Core][Core/Animation][RotationCenterSkinning]" ) {
+    SkinningRefData refData;
+    SkinningFrameData frameData;
+    Vector3Array tangents, bitangents;
+    makeSkinnedChain( refData, frameData, tangents, bitangents );
+    const auto& vertices = refData.m_referenceMesh.vertices();
+    const int n          = int( vertices.size() );
+    const auto isZero    = []( const Vector3& cor ) { return cor.isZero(); };
+
+    SECTION( "Same as the naive computation" ) {
+        // Random weights, then weights shared by the vertices of each ring of the cylinder, so
+        // that the vertices and triangles are clustered.
+        for ( int shared = 0; shared < 2; ++shared ) {
+            if ( shared == 1 ) {
+                WeightMatrix weights( n, refData.m_weights.cols() );
+                for ( int i = 0; i < n; ++i ) {
+                    const int first = std::min( int( std::lround( vertices[i].x() ) ), 3 );
+                    weights.insert( i, first )                     = 0.7_ra;
+                    weights.insert( i, first < 3 ? first + 1 : 2 ) = 0.3_ra;
+                }
+                refData.m_weights = weights;
+            }
+            computeCoR_naive( refData );
+            const Vector3Array naive = refData.m_CoR;
+            computeCoR( refData );
+            REQUIRE( refData.m_CoR.size() == size_t( n ) );
+            REQUIRE( naive.size() == size_t( n ) );
+            REQUIRE( !std::all_of( naive.begin(), naive.end(), isZero ) );
+            for ( int i = 0; i < n; ++i ) {
+                REQUIRE( ( refData.m_CoR[i] - naive[i] ).norm() < 1e-3_ra );
+            }
+        }
+    }
+
+    SECTION( "Skinning" ) {
+        computeCoR( refData );
+        const auto& normals = refData.m_referenceMesh.normals();
+        const auto& CoR     = refData.m_CoR;
+        auto pose           = frameData.m_skeleton.getPose( HandleArray::SpaceType::MODEL );
+        for ( size_t i = 0; i < pose.size(); ++i ) {
+            pose[i] = refData.m_meshTransformInverse * pose[i] * refData.m_bindMatrices[i];
+        }
+        const auto DQ = computeDQ_naive( pose, refData.m_weights );
+        Vector3Array positions( n, Vector3::Zero() );
+        for ( int k = 0; k < refData.m_weights.outerSize(); ++k ) {
+            for ( WeightMatrix::InnerIterator it( refData.m_weights, k ); it; ++it ) {
+                positions[it.row()] += it.value() * ( pose[it.col()] * CoR[it.row()] );
+            }
+        }
+
+        // The packed weights give the same result as the weight matrix.
+        centerOfRotationSkinning(
+            refData, packWeights( refData.m_weights ), tangents, bitangents, frameData );
+        for ( int i = 0; i < n; ++i ) {
+            const Vector3 position = positions[i] + DQ[i].rotate( vertices[i] - CoR[i] );
+            REQUIRE( frameData.m_currentPosition[i].isApprox( position ) );
+            REQUIRE( frameData.m_currentNormal[i].isApprox( DQ[i].rotate( normals[i] ) ) );
+            REQUIRE( frameData.m_currentTangent[i].isApprox( DQ[i].rotate( tangents[i] ) ) );
+            REQUIRE( frameData.m_currentBitangent[i].isApprox( DQ[i].rotate( bitangents[i] ) ) );
+        }
+        const Vector3Array packed = frameData.m_currentPosition;
+        centerOfRotationSkinning( refData, tangents, bitangents, frameData );
+        REQUIRE( frameData.m_currentPosition == packed );
+    }
+
+    SECTION( "Cache files" ) {
+        namespace fs             = std::filesystem;
+        const fs::path directory = fs::temp_directory_path() / "radium_cor_cache_test";
+        fs::remove_all( directory );
+        fs::create_directories( directory );
+
+        computeCoR( refData );
+        const Vector3Array expected = refData.m_CoR;
+        REQUIRE( !std::all_of( expected.begin(), expected.end(), isZero ) );
+
+        // The first call computes and stores the CoRs.
+        refData.m_CoR.clear();
+        computeCoR( refData, directory.string() );
+        REQUIRE( refData.m_CoR == expected );
+        std::vector<fs::path> files { fs::directory_iterator( directory ),
+                                      fs::directory_iterator() };
+        REQUIRE( files.size() == 1 );
+        const std::string file   = files.front().string();
+        const size_t headerCount = 7;
+        const size_t headerSize  = headerCount * sizeof( uint64_t );
+        const size_t dataSize    = expected.size() * 3 * sizeof( Scalar );
+        REQUIRE( fs::file_size( file ) == headerSize + dataSize );
+
+        const auto readHeader = [&file]( size_t index ) {
+            std::ifstream stream( file, std::ios::binary );
+            stream.seekg( std::streamoff( index * sizeof( uint64_t ) ) );
+            uint64_t value = 0;
+            stream.read( reinterpret_cast<char*>( &value ), sizeof( value ) );
+            return value;
+        };
+        const auto overwrite = [&file]( size_t offset, const char* bytes, size_t size ) {
+            std::fstream stream( file, std::ios::in | std::ios::out | std::ios::binary );
+            stream.seekp( std::streamoff( offset ) );
+            stream.write( bytes, std::streamsize( size ) );
+            REQUIRE( stream );
+        };
+        const std::vector<char> zeros( dataSize, 0 );
+
+        // The next calls load the stored CoRs, whatever their values.
+        overwrite( headerSize, zeros.data(), dataSize );
+        computeCoR( refData, directory.string() );
+        REQUIRE( refData.m_CoR.size() == expected.size() );
+        REQUIRE( std::all_of( refData.m_CoR.begin(), refData.m_CoR.end(), isZero ) );
+
+        // A file of another version, or whose key or sizes do not match, is recomputed and
+        // overwritten.
+        for ( size_t index = 0; index < headerCount; ++index ) {
+            overwrite( headerSize, zeros.data(), dataSize );
+            const uint64_t value = readHeader( index );
+            const uint64_t stale = value + 1;
+            overwrite( index * sizeof( uint64_t ),
+                       reinterpret_cast<const char*>( &stale ),
+                       sizeof( stale ) );
+            computeCoR( refData, directory.string() );
+            REQUIRE( refData.m_CoR == expected );
+            REQUIRE( readHeader( index ) == value );
+            refData.m_CoR.clear();
+            computeCoR( refData, directory.string() );
+            REQUIRE( refData.m_CoR == expected );
+        }
+
+        fs::remove_all( directory );
+    }
+}
+
+TEST_CASE( "Core/Animation/AnimationCache", "[Core][Core/Animation][AnimationCache]" ) {
+    SECTION( "Pose keys" ) {
+        PoseCache exact;
+        Scalar t1 = 0.25_ra, t2 = 0.25_ra, t3 = 0.26_ra;
+        REQUIRE( exact.getKey( 1, 0, t1 ) == exact.getKey( 1, 0, t2 ) );
+        REQUIRE( !( exact.getKey( 1, 0, t1 ) == exact.getKey( 1, 0, t3 ) ) );
+        REQUIRE( !( exact.getKey( 1, 0, t1 ) == exact.getKey( 1, 1, t2 ) ) );
+        REQUIRE( !( exact.getKey( 1, 0, t1 ) == exact.getKey( 2, 0, t2 ) ) );
+        REQUIRE( t1 == 0.25_ra );
+
+        PoseCache quantized( 0.1_ra );
+        Scalar q1 = 0.26_ra, q2 = 0.34_ra, q3 = 0.36_ra;
+        REQUIRE( quantized.getKey( 1, 0, q1 ) == quantized.getKey( 1, 0, q2 ) );
+        REQUIRE( !( quantized.getKey( 1, 0, q1 ) == quantized.getKey( 1, 0, q3 ) ) );
+        // the pose is evaluated at the quantized time.
+        REQUIRE( Math::areApproxEqual( q1, 0.3_ra ) );
+        REQUIRE( q1 == q2 );
+
+        REQUIRE( !PoseKey {}.isValid() );
+        REQUIRE( !SkinKey { 1, PoseKey {} }.isValid() );
+        REQUIRE( SkinKey { 1, quantized.getKey( 1, 0, q1 ) }.isValid() );
+    }
+
+    SECTION( "Hits and misses" ) {
+        PoseCache cache;
+        Scalar t      = 1_ra;
+        const auto k1 = cache.getKey( 1, 0, t );
+        const auto k2 = cache.getKey( 2, 0, t );
+        Pose pose( 3, Transform::Identity() );
+        pose[1].translate( Vector3::UnitX() );
+
+        REQUIRE( cache.find( k1 ) == nullptr );
+        cache.insert( k1, pose );
+        auto cached = cache.find( k1 );
+        REQUIRE( cached != nullptr );
+        REQUIRE( cached->size() == 3 );
+        REQUIRE( ( *cached )[1].isApprox( pose[1] ) );
+        REQUIRE( cache.find( k2 ) == nullptr );
+        REQUIRE( cache.getHitCount() == 1 );
+        REQUIRE( cache.getMissCount() == 2 );
+
+        // the first inserted value is kept.
+        auto kept = cache.insert( k1, Pose( 1, Transform::Identity() ) );
+        REQUIRE( kept->size() == 3 );
+        REQUIRE( cache.size() == 1 );
+
+        cache.clear();
+        REQUIRE( cache.size() == 0 );
+        REQUIRE( cache.find( k1 ) == nullptr );
+        REQUIRE( cache.getMissCount() == 3 );
+        cache.resetCounters();
+        REQUIRE( cache.getHitCount() == 0 );
+        REQUIRE( cache.getMissCount() == 0 );
+        // the cached values outlive the cache entries.
+        REQUIRE( ( *cached )[1].isApprox( pose[1] ) );
+    }
+
+    SECTION( "Content keys" ) {
+        SkinCache cache;
+        const std::vector<Scalar> values { 1_ra, 2_ra, 3_ra };
+        std::string content1, content2, content3;
+        appendBytes( content1, values.data(), values.size() );
+        appendBytes( content2, values.data(), values.size() );
+        appendBytes( content3, values.data(), 2 );
+        REQUIRE( content1.size() == 3 * sizeof( Scalar ) );
+
+        // equal contents share their key, different contents do not, whatever their hash.
+        auto k1 = cache.getContentKey( content1 );
+        REQUIRE( *k1 != 0 );
+        REQUIRE( cache.getContentKey( content2 ) == k1 );
+        auto k3 = cache.getContentKey( content3 );
+        REQUIRE( *k3 != 0 );
+        REQUIRE( *k3 != *k1 );
+        REQUIRE( cache.getContentCount() == 2 );
+        // the keys are kept when the cached values are erased.
+        cache.clear();
+        REQUIRE( cache.getContentKey( content1 ) == k1 );
+
+        // the contents are released with their last key, and get a new key afterwards.
+        const size_t released = *k3;
+        k3.reset();
+        REQUIRE( cache.getContentCount() == 1 );
+        k3 = cache.getContentKey( content3 );
+        REQUIRE( *k3 != released );
+        REQUIRE( *k3 != *k1 );
+        // the keys may outlive the cache.
+        {
+            SkinCache other;
+            k3 = other.getContentKey( content3 );
+        }
+        k3.reset();
+
+        // the skinning method is part of the skinned vertices key.
+        PoseCache poses;
+        Scalar t            = 0_ra;
+        const PoseKey pose  = poses.getKey( 1, 0, t );
+        const SkinKey lbs   = { *k1, pose, 0 };
+        const SkinKey dqs   = { *k1, pose, 2 };
+        const SkinKey other = { released, pose, 0 };
+        cache.insert( lbs, SkinnedVertices { Vector3Array( 1 ), {}, {}, {} } );
+        REQUIRE( cache.find( lbs ) != nullptr );
+        REQUIRE( cache.find( dqs ) == nullptr );
+        REQUIRE( cache.find( other ) == nullptr );
+    }
+}
+
+TEST_CASE( "Core/Animation/AnimationClip", "[Core][Core/Animation][AnimationClip]" ) {
+    std::mt19937 gen( 0 );
+    std::uniform_real_distribution<Scalar> dis( 0_ra, 1_ra );
+    // 3 tracks with random keyframes.
+    std::vector<KeyFramedValue<Scalar>> tracks;
+    for ( int i = 0; i < 3; ++i ) {
+        tracks.emplace_back( Scalar( i ), dis( gen ) );
+        for ( int k = 0; k < 20 + 10 * i; ++k ) {
+            tracks.back().insertKeyFrame( Scalar( i ) + 10_ra * dis( gen ), dis( gen ) );
+        }
+    }
+
+    SECTION( "Cursors" ) {
+        const auto& track = tracks[2];
+        size_t cursor     = 0;
+        // forward, backward and random times give the same ranges as without cursor.
+        std::vector<Scalar> times;
+        for ( int i = -5; i < 150; ++i ) {
+            times.push_back( Scalar( i ) / 10_ra );
+        }
+        for ( int i = 150; i > -5; --i ) {
+            times.push_back( Scalar( i ) / 13_ra );
+        }
+        for ( int i = 0; i < 100; ++i ) {
+            times.push_back( 15_ra * dis( gen ) - 1_ra );
+        }
+        for ( const auto& kf : track.getKeyFrames() ) {
+            times.push_back( kf.first );
+        }
+        for ( const auto& t : times ) {
+            REQUIRE( track.findRange( t, cursor ) == track.findRange( t ) );
+            REQUIRE( Math::areApproxEqual( track.at<LinearInterpolator>( t, cursor ),
+                                           track.at( t, linearInterpolate<Scalar> ) ) );
+        }
+    }
+
+    SECTION( "Sampling" ) {
+        AnimationClip<Scalar> clip( &tracks );
+        REQUIRE( clip.getNumTracks() == 3 );
+        Scalar start = tracks[0].getKeyFrames().front().first;
+        Scalar end   = tracks[0].getKeyFrames().back().first;
+        for ( const auto& track : tracks ) {
+            start = std::min( start, track.getKeyFrames().front().first );
+            end   = std::max( end, track.getKeyFrames().back().first );
+        }
+        REQUIRE( clip.getStartTime() == start );
+        REQUIRE( clip.getEndTime() == end );
+        REQUIRE( Math::areApproxEqual( clip.getDuration(), end - start ) );
+
+        std::vector<Scalar> values( 3 );
+        for ( Scalar t = -1_ra; t < 13_ra; t += 0.05_ra ) {
+            clip.sample( t, values );
+            for ( size_t i = 0; i < 3; ++i ) {
+                REQUIRE( Math::areApproxEqual( values[i],
+                                               tracks[i].at( t, linearInterpolate<Scalar> ) ) );
+            }
+        }
+
+        AnimationClip<Scalar, StepInterpolator> stepClip( &tracks );
+        for ( Scalar t = -1_ra; t < 13_ra; t += 0.05_ra ) {
+            auto [i, j, dt] = tracks[1].findRange( t );
+            REQUIRE( stepClip.sample( 1, t ) == tracks[1][i].second );
+        }
+    }
+
+    SECTION( "Edits" ) {
+        AnimationClip<Scalar> clip( &tracks );
+        const size_t version = tracks[1].getVersion();
+        tracks[1].insertKeyFrame( 100_ra, 5_ra );
+        REQUIRE( tracks[1].getVersion() > version );
+        // edits are taken into account by setTracks().
+        REQUIRE( clip.getEndTime() < 100_ra );
+        clip.setTracks( &tracks );
+        REQUIRE( clip.getEndTime() == 100_ra );
+        REQUIRE( clip.sample( 1, 100_ra ) == 5_ra );
+        tracks[1].removeKeyFrame( tracks[1].size() - 1 );
+        clip.setTracks( &tracks );
+        REQUIRE( clip.getEndTime() < 100_ra );
+
+        clip.setTracks( nullptr );
+        REQUIRE( clip.getNumTracks() == 0 );
+        REQUIRE( clip.getDuration() == 0_ra );
+    }
+}
+
+TEST_CASE( "Core/Animation/CompressedAnimation", "[Core][Core/Animation][CompressedAnimation]" ) {
+    // 10 s of motion capture like tracks at 30 fps.
+    const int numBones = 20;
+    const int numKeys  = 300;
+    CompressedAnimation::Tracks tracks;
+    for ( int b = 0; b < numBones; ++b ) {
+        const Vector3 axis = Vector3( 1_ra, Scalar( b ), 0.5_ra ).normalized();
+        const auto pose    = [b, &axis]( Scalar t ) {
+            Transform T = Transform::Identity();
+            // bone 0 moves, the last bone is constant.
+            if ( b == 0 ) { T.translate( Vector3( std::sin( t ), 0.1_ra * t, std::cos( t ) ) ); }
+            else { T.translate( Vector3( 0_ra, 1_ra, 0_ra ) ); }
+            if ( b != numBones - 1 ) {
+                T.rotate( AngleAxis( 0.5_ra * std::sin( 2_ra * t + Scalar( b ) ), axis ) );
+            }
+            return T;
+        };
+        tracks.emplace_back( 0_ra, pose( 0_ra ) );
+        for ( int k = 1; k < numKeys; ++k ) {
+            const Scalar t = Scalar( k ) / 30_ra;
+            tracks.back().insertKeyFrame( t, pose( t ) );
+        }
+    }
+
+    CompressedAnimation::Settings settings;
+    CompressedAnimation compressed( tracks, settings );
+    REQUIRE( compressed.getNumTracks() == size_t( numBones ) );
+    REQUIRE( compressed.getStartTime() == 0_ra );
+    REQUIRE( Math::areApproxEqual( compressed.getEndTime(), Scalar( numKeys - 1 ) / 30_ra ) );
+
+    SECTION( "Errors and memory" ) {
+        REQUIRE( compressed.getErrors().size() == size_t( numBones ) );
+        for ( const auto& error : compressed.getErrors() ) {
+            REQUIRE( error.m_translation <= settings.m_translationError );
+            REQUIRE( error.m_rotation <= settings.m_rotationError );
+            REQUIRE( error.m_scale <= settings.m_scaleError );
+        }
+        // constant channels keep a single key.
+        REQUIRE( compressed.getNumKeys( numBones - 1 ) == 3 );
+        REQUIRE( compressed.getNumKeys( 1 ) < size_t( numKeys ) + 2 );
+        const size_t ratio =
+            CompressedAnimation::getMemorySize( tracks ) / compressed.getMemorySize();
+        REQUIRE( ratio >= 10 );
+    }
+
+    SECTION( "Sampling" ) {
+        std::mt19937 gen( 0 );
+        std::uniform_real_distribution<Scalar> dis( -1_ra, 11_ra );
+        Pose pose( numBones );
+        CompressedAnimation::Cursors cursors;
+        std::vector<Scalar> times;
+        for ( int i = 0; i < 200; ++i ) {
+            times.push_back( Scalar( i ) / 20_ra - 0.5_ra );
+        }
+        for ( int i = 0; i < 50; ++i ) {
+            times.push_back( dis( gen ) );
+        }
+        for ( const auto& t : times ) {
+            compressed.sample( t, cursors, pose );
+            for ( int b = 0; b < numBones; ++b ) {
+                const Transform expected = tracks[b].at( t, linearInterpolate<Transform> );
+                REQUIRE( pose[b].isApprox( compressed.sample( b, t ) ) );
+                REQUIRE( ( pose[b].translation() - expected.translation() ).norm() <
+                         4_ra * settings.m_translationError );
+                REQUIRE( Quaternion( pose[b].rotation() )
+                             .angularDistance( Quaternion( expected.rotation() ) ) <
+                         4_ra * settings.m_rotationError );
+            }
+        }
+    }
+
+    SECTION( "Decompression" ) {
+        const auto decompressed = compressed.decompress();
+        REQUIRE( decompressed.size() == tracks.size() );
+        REQUIRE( decompressed[numBones - 1].size() == 1 );
+        for ( int b = 0; b < numBones; ++b ) {
+            for ( const auto& kf : decompressed[b].getKeyFrames() ) {
+                REQUIRE( kf.second.isApprox( compressed.sample( b, kf.first ) ) );
+            }
+        }
+    }
+}
+
+TEST_CASE( "Core/Animation/CompactPose", "[Core][Core/Animation][CompactPose]" ) {
+    using Space = HandleArray::SpaceType;
+    // a small tree: each bone is attached to a random previous bone.
+    const int numBones = 30;
+    std::mt19937 gen( 0 );
+    std::uniform_real_distribution<Scalar> dis( -1_ra, 1_ra );
+    const auto randomTransform = [&]() {
+        Transform T = Transform::Identity();
+        T.translate( Vector3( dis( gen ), dis( gen ), dis( gen ) ) );
+        T.rotate( AngleAxis( dis( gen ), Vector3( dis( gen ), dis( gen ), 1_ra ).normalized() ) );
+        T.scale( Vector3( 1.2_ra + dis( gen ) / 5_ra, 1_ra, 1_ra - dis( gen ) / 5_ra ) );
+        return T;
+    };
+    Skeleton skel;
+    skel.addRoot( randomTransform() );
+    for ( int i = 1; i < numBones; ++i ) {
+        skel.addBone( uint( gen() ) % i, randomTransform() );
+    }
+    Pose localPose( numBones );
+    Pose otherPose( numBones );
+    for ( int i = 0; i < numBones; ++i ) {
+        localPose[i] = randomTransform();
+        otherPose[i] = randomTransform();
+    }
+    const QTPose qtPose( localPose );
+
+    SECTION( "Conversions" ) {
+        REQUIRE( sizeof( Transform3x4 ) < sizeof( Transform ) );
+        REQUIRE( qtPose.size() == size_t( numBones ) );
+        Pose pose;
+        qtPose.getPose( pose );
+        REQUIRE( areEqual( pose, localPose ) );
+        PackedPose packed;
+        qtPose.getPackedPose( packed );
+        toPose( packed, pose );
+        REQUIRE( areEqual( pose, localPose ) );
+        toPackedPose( localPose, packed );
+        for ( int i = 0; i < numBones; ++i ) {
+            REQUIRE( toTransform( packed[i] ).isApprox( localPose[i] ) );
+        }
+    }
+
+    SECTION( "Hierarchy propagation" ) {
+        Skeleton reference = skel;
+        reference.setPose( localPose, Space::LOCAL );
+        skel.setPose( qtPose );
+        REQUIRE( areEqual( skel.getPose( Space::LOCAL ), reference.getPose( Space::LOCAL ) ) );
+        REQUIRE( areEqual( skel.getPose( Space::MODEL ), reference.getPose( Space::MODEL ) ) );
+
+        PackedPose model;
+        PackedPose local;
+        toPackedPose( reference.getPose( Space::MODEL ), model );
+        modelToLocal( model, skel.m_graph.parents(), local );
+        for ( int i = 0; i < numBones; ++i ) {
+            REQUIRE( toTransform( local[i] ).isApprox( localPose[i] ) );
+        }
+    }
+
+    SECTION( "Pose operations" ) {
+        PackedPose a;
+        PackedPose b;
+        PackedPose result;
+        toPackedPose( localPose, a );
+        toPackedPose( otherPose, b );
+        Pose pose;
+        relativePose( a, b, result );
+        toPose( result, pose );
+        REQUIRE( areEqual( pose, relativePose( localPose, otherPose ) ) );
+        applyTransformation( a, b, result );
+        toPose( result, pose );
+        REQUIRE( areEqual( pose, applyTransformation( localPose, otherPose ) ) );
+
+        const Transform meshTransform = randomTransform();
+        skinningMatrices( a, b, toTransform3x4( meshTransform.inverse() ), result );
+        for ( int i = 0; i < numBones; ++i ) {
+            const Transform expected = meshTransform.inverse() * localPose[i] * otherPose[i];
+            REQUIRE( toTransform( result[i] ).isApprox( expected ) );
+        }
+    }
+
+    SECTION( "Interpolation" ) {
+        const QTPose other( otherPose );
+        QTPose result;
+        Pose pose;
+        // normalized-linear interpolation matches the spherical one at t in { 0, 0.5, 1 }.
+        for ( const Scalar t : { 0_ra, 0.5_ra, 1_ra } ) {
+            interpolatePoses( qtPose, other, t, result );
+            result.getPose( pose );
+            REQUIRE( areEqual( pose, interpolatePoses( localPose, otherPose, t ) ) );
+        }
+        interpolatePoses( qtPose, other, 0.25_ra, result );
+        const auto expected = interpolatePoses( localPose, otherPose, 0.25_ra );
+        for ( int i = 0; i < numBones; ++i ) {
+            const Quaternion q( expected[i].rotation() );
+            REQUIRE( result.m_rotations[i].angularDistance( q ) < 0.1_ra );
+            REQUIRE( result.m_translations[i].isApprox( expected[i].translation() ) );
+        }
+    }
+}
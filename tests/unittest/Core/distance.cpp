@@ -1,8 +1,11 @@
 #include <Core/Geometry/DistanceQueries.hpp>
+#include <Core/Geometry/MeshPrimitives.hpp>
 #include <Core/Math/LinearAlgebra.hpp> // Math::getOrthogonalVectors
 #include <Core/Math/Math.hpp>          //  Math::areApproxEqual
 #include <catch2/catch.hpp>
 
+#include <random>
+
 TEST_CASE( "Core/Geometry/DistanceQueries", "[Core][Core/Geometry][DistanceQueries]" ) {
 
     using namespace Ra::Core;
@@ -143,3 +146,147 @@ TEST_CASE( "Core/Geometry/DistanceQueries", "[Core][Core/Geometry][DistanceQueri
         REQUIRE( dg.flags == Geometry::FlagsInternal::HIT_FACE );
     }
 }
+
+namespace {
+// Distances from q to all the triangles of the mesh, ordered by distance then by index.
+std::vector<Ra::Core::Geometry::PointToMeshOutput>
+bruteForceDistances( const Ra::Core::Vector3& q, const Ra::Core::Geometry::TriangleMesh& mesh ) {
+    using namespace Ra::Core;
+    std::vector<Geometry::PointToMeshOutput> distances( mesh.getIndices().size() );
+    for ( uint i = 0; i < distances.size(); ++i ) {
+        const auto& t = mesh.getIndices()[i];
+        static_cast<Geometry::PointToTriangleOutput&>( distances[i] ) = Geometry::pointToTriSq(
+            q, mesh.vertices()[t[0]], mesh.vertices()[t[1]], mesh.vertices()[t[2]] );
+        distances[i].triangleIndex = i;
+    }
+    std::sort( distances.begin(), distances.end(), []( const auto& a, const auto& b ) {
+        return a.distanceSquared < b.distanceSquared ||
+               ( a.distanceSquared == b.distanceSquared && a.triangleIndex < b.triangleIndex );
+    } );
+    return distances;
+}
+
+bool isSameResult( const Ra::Core::Geometry::PointToMeshOutput& a,
+                   const Ra::Core::Geometry::PointToMeshOutput& b ) {
+    return a.triangleIndex == b.triangleIndex && a.distanceSquared == b.distanceSquared &&
+           a.meshPoint == b.meshPoint && a.flags == b.flags;
+}
+
+bool isSameResult( const std::vector<Ra::Core::Geometry::PointToMeshOutput>& a,
+                   const std::vector<Ra::Core::Geometry::PointToMeshOutput>& b ) {
+    return std::equal( a.begin(), a.end(), b.begin(), b.end(), []( const auto& x, const auto& y ) {
+        return isSameResult( x, y );
+    } );
+}
+
+// Random points around the mesh bounding box, and the mesh vertices.
+Ra::Core::Vector3Array queryPoints( const Ra::Core::Geometry::TriangleMesh& mesh, size_t count ) {
+    using namespace Ra::Core;
+    const Aabb aabb = mesh.computeAabb();
+    std::mt19937 gen( 0 );
+    std::uniform_real_distribution<Scalar> dist( -.5_ra, 1.5_ra );
+    Vector3Array points;
+    for ( size_t i = 0; i < count; ++i ) {
+        const Vector3 p( dist( gen ), dist( gen ), dist( gen ) );
+        points.push_back( aabb.min() + p.cwiseProduct( aabb.sizes() ) );
+    }
+    points.insert( points.end(), mesh.vertices().begin(), mesh.vertices().begin() + 10 );
+    return points;
+}
+} // namespace
+
+TEST_CASE( "Core/Geometry/DistanceQueries/Mesh", "[Core][Core/Geometry][DistanceQueries]" ) {
+    using namespace Ra::Core;
+    using Geometry::PointToMeshOutput;
+
+    const Geometry::TriangleMesh sphere = Geometry::makeGeodesicSphere( 1_ra, 3 );
+    const Geometry::TriangleMesh torus  = Geometry::makeParametricTorus<32, 16>( 1_ra, .3_ra );
+    const Geometry::TriangleMesh box    = Geometry::makeBox();
+
+    for ( const auto* mesh : { &sphere, &torus, &box } ) {
+        const Vector3Array queries = queryPoints( *mesh, 200 );
+        const Scalar radius        = .1_ra * mesh->computeAabb().sizes().norm();
+
+        std::vector<PointToMeshOutput> closest;
+        std::vector<std::vector<PointToMeshOutput>> kNearest, withinRadius;
+        Geometry::pointToMeshSq( queries, *mesh, closest );
+        Geometry::kNearestTriangles( queries, *mesh, 7, kNearest );
+        Geometry::trianglesWithinRadius( queries, *mesh, radius, withinRadius );
+        REQUIRE( closest.size() == queries.size() );
+
+        for ( size_t i = 0; i < queries.size(); ++i ) {
+            const Vector3& q    = queries[i];
+            const auto expected = bruteForceDistances( q, *mesh );
+
+            // Closest point.
+            REQUIRE( isSameResult( closest[i], expected.front() ) );
+            REQUIRE( isSameResult( Geometry::pointToMeshSq( q, *mesh ), expected.front() ) );
+            const Scalar maxDistanceSquared = expected.front().distanceSquared;
+            REQUIRE( isSameResult( Geometry::pointToMeshSq( q, *mesh, maxDistanceSquared ),
+                                   expected.front() ) );
+            if ( maxDistanceSquared > 0_ra ) {
+                REQUIRE( !Geometry::pointToMeshSq( q, *mesh, .5_ra * maxDistanceSquared )
+                              .isValid() );
+            }
+
+            // K nearest triangles, with less triangles than k for the box.
+            std::vector<PointToMeshOutput> nearest;
+            Geometry::kNearestTriangles( q, *mesh, 20, nearest );
+            const size_t k = std::min( size_t( 20 ), expected.size() );
+            REQUIRE( isSameResult(
+                nearest, { expected.begin(), expected.begin() + std::ptrdiff_t( k ) } ) );
+            REQUIRE( isSameResult( kNearest[i], { expected.begin(), expected.begin() + 7 } ) );
+            Geometry::kNearestTriangles( q, *mesh, 0, nearest );
+            REQUIRE( nearest.empty() );
+
+            // Triangles within the radius.
+            const auto end =
+                std::find_if( expected.begin(), expected.end(), [radius]( const auto& d ) {
+                    return d.distanceSquared > radius * radius;
+                } );
+            REQUIRE( isSameResult( withinRadius[i], { expected.begin(), end } ) );
+        }
+    }
+
+    SECTION( "Empty mesh" ) {
+        const Geometry::TriangleMesh empty;
+        REQUIRE( !Geometry::pointToMeshSq( Vector3::Zero(), empty ).isValid() );
+        std::vector<PointToMeshOutput> output;
+        Geometry::kNearestTriangles( Vector3::Zero(), empty, 3, output );
+        REQUIRE( output.empty() );
+        Geometry::trianglesWithinRadius( Vector3::Zero(), empty, 1_ra, output );
+        REQUIRE( output.empty() );
+    }
+}
+
+TEST_CASE( "Core/Geometry/DistanceQueries/Mesh/Benchmark",
+           "[Core][Core/Geometry][DistanceQueries][!benchmark]" ) {
+    using namespace Ra::Core;
+    const Geometry::TriangleMesh mesh = Geometry::makeGeodesicSphere( 1_ra, 6 );
+    const Vector3Array queries        = queryPoints( mesh, 100 );
+    mesh.getBvh();
+
+    BENCHMARK( "Brute force, closest point" ) {
+        Scalar sum = 0_ra;
+        for ( const auto& q : queries ) {
+            Scalar closest = std::numeric_limits<Scalar>::max();
+            for ( const auto& t : mesh.getIndices() ) {
+                const auto& v = mesh.vertices();
+                const auto d  = Geometry::pointToTriSq( q, v[t[0]], v[t[1]], v[t[2]] );
+                closest       = std::min( closest, d.distanceSquared );
+            }
+            sum += closest;
+        }
+        return sum;
+    };
+    std::vector<Geometry::PointToMeshOutput> closest;
+    BENCHMARK( "Bvh, closest point" ) {
+        Geometry::pointToMeshSq( queries, mesh, closest );
+        return closest.size();
+    };
+    std::vector<std::vector<Geometry::PointToMeshOutput>> nearest;
+    BENCHMARK( "Bvh, 8 nearest triangles" ) {
+        Geometry::kNearestTriangles( queries, mesh, 8, nearest );
+        return nearest.size();
+    };
+}
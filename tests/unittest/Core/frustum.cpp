@@ -0,0 +1,42 @@
+#include <Core/Asset/Camera.hpp>
+#include <Core/Geometry/Frustum.hpp>
+#include <Core/Math/Math.hpp>
+#include <Core/Types.hpp>
+#include <catch2/catch.hpp>
+
+TEST_CASE( "Core/Geometry/Frustum", "[Core][Core/Geometry][Frustum]" ) {
+    using namespace Ra::Core;
+    // camera at (0, 0, 5) looking towards -z, 90 degrees horizontal fov.
+    const Matrix4 proj = Asset::Camera::perspective( 1_ra, Math::PiDiv2, 1_ra, 100_ra );
+    Transform view     = Transform::Identity();
+    view.translate( Vector3( 0_ra, 0_ra, -5_ra ) );
+    const Geometry::Frustum frustum( proj * view.matrix() );
+
+    const auto box = []( const Vector3& center, Scalar halfSize ) {
+        const Vector3 h = Vector3::Constant( halfSize );
+        return Aabb( center - h, center + h );
+    };
+
+    SECTION( "Inside and outside boxes" ) {
+        REQUIRE( frustum.intersects( box( Vector3::Zero(), 1_ra ) ) );
+        // behind the camera
+        REQUIRE( !frustum.intersects( box( Vector3( 0_ra, 0_ra, 10_ra ), 1_ra ) ) );
+        // beyond the far plane
+        REQUIRE( !frustum.intersects( box( Vector3( 0_ra, 0_ra, -200_ra ), 1_ra ) ) );
+        // on the sides
+        REQUIRE( !frustum.intersects( box( Vector3( 20_ra, 0_ra, 0_ra ), 1_ra ) ) );
+        REQUIRE( !frustum.intersects( box( Vector3( 0_ra, -20_ra, 0_ra ), 1_ra ) ) );
+    }
+
+    SECTION( "Boxes crossing the planes" ) {
+        // the camera position is inside this box
+        REQUIRE( frustum.intersects( box( Vector3( 0_ra, 0_ra, 5_ra ), 2_ra ) ) );
+        // crossing the right plane, at distance d from the camera the half width is d
+        REQUIRE( frustum.intersects( box( Vector3( 5.5_ra, 0_ra, 0_ra ), 1_ra ) ) );
+        REQUIRE( !frustum.intersects( box( Vector3( 7.5_ra, 0_ra, 0_ra ), 1_ra ) ) );
+        // crossing the far plane
+        REQUIRE( frustum.intersects( box( Vector3( 0_ra, 0_ra, -95.5_ra ), 1_ra ) ) );
+    }
+
+    SECTION( "Empty boxes" ) { REQUIRE( frustum.intersects( Aabb() ) ); }
+}
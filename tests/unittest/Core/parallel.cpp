@@ -0,0 +1,157 @@
+#include <Core/Tasks/Parallel.hpp>
+#include <Core/Tasks/Task.hpp>
+#include <Core/Tasks/TaskQueue.hpp>
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <numeric>
+#include <vector>
+
+using namespace Ra::Core;
+
+TEST_CASE( "Core/Parallel/For", "[Core][Parallel]" ) {
+    for ( uint numThreads : { 0u, 1u, 4u } ) {
+        TaskQueue taskQueue( numThreads );
+        setParallelTaskQueue( &taskQueue );
+
+        const int size = 10007;
+        for ( int grain : { 0, 1, 13, 20000 } ) {
+            std::vector<std::atomic<int>> visits( size );
+            parallelFor( 0, size, [&visits]( int i ) { ++visits[i]; }, grain );
+            int wrong = 0;
+            for ( const auto& v : visits ) {
+                if ( v != 1 ) { ++wrong; }
+            }
+            REQUIRE( wrong == 0 );
+        }
+
+        // Chunks cover the range without overlap.
+        std::atomic<size_t> total { 0 };
+        std::atomic<bool> emptyChunk { false };
+        parallelForChunks(
+            size_t( 5 ), size_t( 1005 ), [&total, &emptyChunk]( size_t b, size_t e ) {
+                if ( b >= e ) { emptyChunk = true; }
+                total += e - b;
+            } );
+        REQUIRE( total == 1000 );
+        REQUIRE( !emptyChunk );
+
+        // Empty range.
+        bool called = false;
+        parallelFor( 10, 10, [&called]( int ) { called = true; } );
+        REQUIRE( !called );
+        setParallelTaskQueue( nullptr );
+    }
+}
+
+TEST_CASE( "Core/Parallel/Reduce", "[Core][Parallel]" ) {
+    TaskQueue taskQueue( 4 );
+    setParallelTaskQueue( &taskQueue );
+
+    std::vector<double> values( 100000 );
+    std::iota( values.begin(), values.end(), 0. );
+    auto sumChunk = [&values]( size_t b, size_t e, double init ) {
+        for ( size_t i = b; i < e; ++i ) {
+            init += values[i] * 0.1;
+        }
+        return init;
+    };
+    auto sum = []( double a, double b ) { return a + b; };
+
+    const double expected = sumChunk( 0, values.size(), 0. );
+    const double result   = parallelReduce( size_t( 0 ), values.size(), 0., sumChunk, sum );
+    REQUIRE( std::abs( result - expected ) < 1e-6 * expected );
+
+    // Deterministic for a given grain size.
+    const size_t grain = 7;
+    const double first = parallelReduce( size_t( 0 ), values.size(), 0., sumChunk, sum, grain );
+    for ( int i = 0; i < 10; ++i ) {
+        REQUIRE( parallelReduce( size_t( 0 ), values.size(), 0., sumChunk, sum, grain ) == first );
+    }
+    REQUIRE( parallelReduce( 3, 3, 42., sumChunk, sum ) == 42. );
+    setParallelTaskQueue( nullptr );
+}
+
+TEST_CASE( "Core/Parallel/InTasks", "[Core][Parallel]" ) {
+    for ( auto mode :
+          { TaskQueue::ExecutionMode::GlobalQueue, TaskQueue::ExecutionMode::WorkStealing } ) {
+        TaskQueue taskQueue( 4, mode );
+        setParallelTaskQueue( &taskQueue );
+
+        // Tasks running nested parallel loops on the same workers.
+        const int numTasks = 16;
+        const int size     = 1000;
+        std::vector<std::vector<std::atomic<int>>> results( numTasks );
+        for ( auto& r : results ) {
+            r = std::vector<std::atomic<int>>( size );
+        }
+        for ( int t = 0; t < numTasks; ++t ) {
+            taskQueue.registerTask( std::make_unique<FunctionTask>(
+                [&results, t]() {
+                    parallelFor( 0, size, [&results, t]( int i ) {
+                        parallelFor( 0, 4, [&results, t, i]( int ) { ++results[t][i]; } );
+                    } );
+                },
+                "loop" ) );
+        }
+        for ( int run = 0; run < 3; ++run ) {
+            taskQueue.startTasks();
+            taskQueue.waitForTasks();
+        }
+        int wrong = 0;
+        for ( const auto& r : results ) {
+            for ( const auto& v : r ) {
+                if ( v != 12 ) { ++wrong; }
+            }
+        }
+        REQUIRE( wrong == 0 );
+        taskQueue.flushTaskQueue();
+        setParallelTaskQueue( nullptr );
+    }
+}
+
+TEST_CASE( "Core/Parallel/InThisThreadTasks", "[Core][Parallel]" ) {
+    // Tasks run by runTasksInThisThread on a queue with workers, sharing their loops with them.
+    TaskQueue taskQueue( 4 );
+    setParallelTaskQueue( &taskQueue );
+
+    const int numTasks = 4;
+    const int size     = 1000;
+    std::vector<std::atomic<int>> visits( size );
+    std::atomic<int> sum { 0 };
+    for ( int t = 0; t < numTasks; ++t ) {
+        taskQueue.registerTask( std::make_unique<FunctionTask>(
+            [&visits, &sum]() {
+                parallelFor( 0, size, [&visits]( int i ) { ++visits[i]; } );
+                sum += parallelReduce(
+                    0,
+                    size,
+                    0,
+                    []( int b, int e, int init ) { return init + ( e - b ); },
+                    []( int a, int b ) { return a + b; } );
+            },
+            "loop" ) );
+    }
+    taskQueue.runTasksInThisThread();
+
+    int wrong = 0;
+    for ( const auto& v : visits ) {
+        if ( v != numTasks ) { ++wrong; }
+    }
+    REQUIRE( wrong == 0 );
+    REQUIRE( sum == numTasks * size );
+    REQUIRE( taskQueue.getNumTasks() == 0 );
+    setParallelTaskQueue( nullptr );
+}
+
+TEST_CASE( "Core/Parallel/DefaultQueue", "[Core][Parallel]" ) {
+    setParallelTaskQueue( nullptr );
+    REQUIRE( getParallelTaskQueue() != nullptr );
+    const int result = parallelReduce(
+        0,
+        1000,
+        0,
+        []( int b, int e, int init ) { return init + ( e - b ); },
+        []( int a, int b ) { return a + b; } );
+    REQUIRE( result == 1000 );
+}
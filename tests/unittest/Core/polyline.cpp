@@ -1,6 +1,8 @@
 #include <Core/Geometry/PolyLine.hpp>
 #include <catch2/catch.hpp>
 
+#include <random>
+
 TEST_CASE( "Core/Geometry/Polyline", "[Core][Core/Geometry][Polyline]" ) {
     using namespace Ra::Core;
     SECTION( "2 points polyline" ) {
@@ -31,4 +33,30 @@ TEST_CASE( "Core/Geometry/Polyline", "[Core][Core/Geometry][Polyline]" ) {
             REQUIRE( Math::areApproxEqual( p.distance( x ), 0_ra ) );
         }
     }
+    SECTION( "Long polyline" ) {
+        // Random walk, whose nearest segments are found with a Bvh.
+        std::mt19937 gen( 0 );
+        std::uniform_real_distribution<Scalar> dist( -1_ra, 1_ra );
+        Vector3Array points { Vector3::Zero() };
+        for ( int i = 0; i < 300; ++i ) {
+            points.push_back( points.back() + Vector3( dist( gen ), dist( gen ), dist( gen ) ) );
+        }
+        Geometry::PolyLine p( points );
+
+        for ( int i = 0; i < 200; ++i ) {
+            const Vector3 q = points[size_t( i )] + Vector3( dist( gen ), dist( gen ), 0_ra );
+            Scalar sqDist   = std::numeric_limits<Scalar>::max();
+            uint segment    = 0;
+            for ( uint s = 0; s + 1 < points.size(); ++s ) {
+                const Vector3 ab = points[s + 1] - points[s];
+                const Scalar d   = Geometry::pointToSegmentSq( q, points[s], ab );
+                if ( d < sqDist ) {
+                    sqDist  = d;
+                    segment = s;
+                }
+            }
+            REQUIRE( p.getNearestSegment( q ) == segment );
+            REQUIRE( p.squaredDistance( q ) == sqDist );
+        }
+    }
 }
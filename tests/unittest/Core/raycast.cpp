@@ -1,7 +1,12 @@
+#include <Core/Geometry/MeshPrimitives.hpp>
 #include <Core/Geometry/RayCast.hpp>
+#include <Core/Geometry/RayPacket.hpp>
 #include <Core/Math/Math.hpp>
 #include <catch2/catch.hpp>
 
+#include <limits>
+#include <random>
+
 TEST_CASE( "Core/Geometry/RayCast", "[Core][Core/Geometry][RayCast]" ) {
     using namespace Ra::Core;
     Aabb ones( -Vector3::Ones(), Vector3::Ones() );
@@ -71,3 +76,324 @@ TEST_CASE( "Core/Geometry/RayCast", "[Core][Core/Geometry][RayCast]" ) {
         }
     }
 }
+
+namespace {
+// Random rays whose origins are around the mesh, aiming at points of the mesh bounding box.
+std::vector<Ra::Core::Ray>
+randomRays( const Ra::Core::Geometry::TriangleMesh& mesh, size_t count, unsigned int seed ) {
+    using namespace Ra::Core;
+    const Aabb aabb = mesh.computeAabb();
+    std::mt19937 gen( seed );
+    std::uniform_real_distribution<Scalar> dist( 0_ra, 1_ra );
+    const auto randomPoint = [&]( Scalar scale ) {
+        const Vector3 p( dist( gen ), dist( gen ), dist( gen ) );
+        return Vector3( aabb.center() +
+                        scale * ( aabb.min() + p.cwiseProduct( aabb.sizes() ) - aabb.center() ) );
+    };
+    std::vector<Ray> rays;
+    rays.reserve( count );
+    for ( size_t i = 0; i < count; ++i ) {
+        const Vector3 origin = randomPoint( 3_ra );
+        const Vector3 target = randomPoint( 1_ra );
+        rays.emplace_back( origin, ( target - origin ).normalized() );
+    }
+    // Axis aligned rays, whose direction have null components.
+    rays.emplace_back( aabb.center() - 2_ra * aabb.sizes().x() * Vector3::UnitX(),
+                       Vector3::UnitX() );
+    rays.emplace_back( aabb.center(), Vector3::UnitY() );
+    rays.emplace_back( aabb.center() + 2_ra * aabb.sizes().z() * Vector3::UnitZ(),
+                       -Vector3::UnitZ() );
+    return rays;
+}
+
+// Checks that the Bvh ray casts give the same hits as the brute force one.
+void checkRayCasts( const Ra::Core::Geometry::TriangleMesh& mesh,
+                    const std::vector<Ra::Core::Ray>& rays ) {
+    using namespace Ra::Core;
+    size_t numHits = 0;
+    for ( const auto& r : rays ) {
+        std::vector<Scalar> hits, bruteForceHits;
+        std::vector<Vector3ui> triangles, bruteForceTriangles;
+        const bool hit = Geometry::RayCastTriangleMesh( r, mesh, hits, triangles );
+        const bool bruteForceHit =
+            Geometry::RayCastTriangleMeshBruteForce( r, mesh, bruteForceHits, bruteForceTriangles );
+        REQUIRE( hit == bruteForceHit );
+        REQUIRE( hits == bruteForceHits );
+        REQUIRE( triangles == bruteForceTriangles );
+
+        Scalar firstHit;
+        Vector3ui firstTriangle;
+        REQUIRE( Geometry::RayCastTriangleMesh( r, mesh, firstHit, firstTriangle ) == hit );
+        if ( hit ) {
+            const auto closest = std::min_element( hits.begin(), hits.end() );
+            REQUIRE( firstHit == *closest );
+            REQUIRE( firstTriangle == triangles[size_t( closest - hits.begin() )] );
+            ++numHits;
+        }
+    }
+    // Make sure the test is not trivial.
+    REQUIRE( numHits > rays.size() / 4 );
+}
+
+// Checks that the packet triangle kernel finds the same hits as the single ray one, for full and
+// partial packets.
+template <int N>
+void checkRayPacketTriangles( const Ra::Core::Geometry::TriangleMesh& mesh,
+                              const std::vector<Ra::Core::Ray>& rays ) {
+    using namespace Ra::Core;
+    using Packet          = Geometry::RayPacket<N>;
+    const auto& triangles = mesh.getIndices();
+    const auto& vertices  = mesh.vertices();
+    size_t numHits        = 0;
+    for ( size_t first = 0; first < rays.size(); first += N ) {
+        // Every other packet is partial.
+        const size_t available = std::min( size_t( N ), rays.size() - first );
+        const int count        = int( available - ( first / N ) % 2 );
+        const Packet packet( rays.data() + first, count );
+        for ( const auto& t : triangles ) {
+            const Vector3& a            = vertices[t[0]];
+            const Vector3& b            = vertices[t[1]];
+            const Vector3& c            = vertices[t[2]];
+            typename Packet::Lanes hits = Packet::Lanes::Constant( -1_ra );
+            const auto isHit            = Geometry::RayCastTriangle( packet, a, b, c, hits );
+            for ( int i = 0; i < N; ++i ) {
+                Scalar hit          = -1_ra;
+                const bool expected =
+                    i < count && Geometry::RayCastTriangle( rays[first + i], a, b, c, hit );
+                REQUIRE( isHit[i] == expected );
+                // The dot products may be rounded differently.
+                REQUIRE( hits[i] == Approx( hit ) );
+                numHits += expected;
+            }
+        }
+    }
+    REQUIRE( numHits > 0 );
+}
+
+// Checks that the batched ray casts give the same closest hits as the single ray one.
+void checkRayCastBatch( const Ra::Core::Geometry::TriangleMesh& mesh,
+                        const std::vector<Ra::Core::Ray>& rays ) {
+    using namespace Ra::Core;
+    VectorN hits( rays.size() );
+    VectorNi triangles( rays.size() );
+    const size_t numHits = Geometry::RayCastTriangleMesh( rays, mesh, hits, triangles );
+
+    size_t expectedHits = 0;
+    for ( size_t i = 0; i < rays.size(); ++i ) {
+        Scalar hit;
+        Vector3ui triangle;
+        if ( Geometry::RayCastTriangleMesh( rays[i], mesh, hit, triangle ) ) {
+            REQUIRE( hits[i] == Approx( hit ) );
+            REQUIRE( triangles[i] >= 0 );
+            REQUIRE( mesh.getIndices()[size_t( triangles[i] )] == triangle );
+            ++expectedHits;
+        }
+        else {
+            REQUIRE( hits[i] == std::numeric_limits<Scalar>::infinity() );
+            REQUIRE( triangles[i] == -1 );
+        }
+    }
+    REQUIRE( numHits == expectedHits );
+}
+
+// Coherent rays from a pinhole camera looking at the origin from \p eye.
+std::vector<Ra::Core::Ray> cameraRays( const Ra::Core::Vector3& eye, int width, int height ) {
+    using namespace Ra::Core;
+    const Vector3 forward = -eye.normalized();
+    const Vector3 right   = forward.cross( Vector3::UnitY() ).normalized();
+    const Vector3 up      = right.cross( forward );
+    std::vector<Ray> rays;
+    rays.reserve( size_t( width * height ) );
+    for ( int y = 0; y < height; ++y ) {
+        for ( int x = 0; x < width; ++x ) {
+            const Scalar u = ( Scalar( x ) + .5_ra ) / Scalar( width ) - .5_ra;
+            const Scalar v = ( Scalar( y ) + .5_ra ) / Scalar( height ) - .5_ra;
+            rays.emplace_back( eye, ( forward + u * right + v * up ).normalized() );
+        }
+    }
+    return rays;
+}
+} // namespace
+
+TEST_CASE( "Core/Geometry/RayCastTriangleMesh", "[Core][Core/Geometry][RayCast]" ) {
+    using namespace Ra::Core;
+    using Geometry::TriangleMesh;
+
+    SECTION( "Bvh structure" ) {
+        TriangleMesh mesh = Geometry::makeGeodesicSphere( 1_ra, 4 );
+        const auto& bvh   = mesh.getBvh();
+        REQUIRE( bvh.getNumPrimitives() == mesh.getIndices().size() );
+
+        // Each primitive is in exactly one leaf, whose box contains the primitive.
+        std::vector<int> leafCount( bvh.getNumPrimitives(), 0 );
+        for ( const auto& node : bvh.getNodes() ) {
+            if ( !node.isLeaf() ) { continue; }
+            REQUIRE( node.count <= Geometry::Bvh::s_maxLeafSize );
+            for ( uint i = node.index; i < node.index + node.count; ++i ) {
+                const uint p = bvh.getPrimitiveIndices()[i];
+                ++leafCount[p];
+                for ( int v = 0; v < 3; ++v ) {
+                    REQUIRE( node.aabb.contains( mesh.vertices()[mesh.getIndices()[p][v]] ) );
+                }
+            }
+        }
+        REQUIRE(
+            std::all_of( leafCount.begin(), leafCount.end(), []( int c ) { return c == 1; } ) );
+        // Second children follow the first ones, in depth first order.
+        for ( size_t i = 0; i < bvh.getNodes().size(); ++i ) {
+            const auto& node = bvh.getNodes()[i];
+            if ( node.isLeaf() ) { continue; }
+            REQUIRE( node.index > i + 1 );
+            REQUIRE( node.index < bvh.getNodes().size() );
+            REQUIRE( node.aabb.contains( bvh.getNodes()[i + 1].aabb ) );
+            REQUIRE( node.aabb.contains( bvh.getNodes()[node.index].aabb ) );
+        }
+    }
+
+    SECTION( "Same hits as brute force" ) {
+        const TriangleMesh sphere = Geometry::makeGeodesicSphere( 1_ra, 3 );
+        checkRayCasts( sphere, randomRays( sphere, 500, 0 ) );
+
+        // Several hits per ray, and triangles lying on the box faces.
+        const TriangleMesh torus = Geometry::makeParametricTorus<32, 16>( 1_ra, .3_ra );
+        checkRayCasts( torus, randomRays( torus, 500, 1 ) );
+        const TriangleMesh box = Geometry::makeBox();
+        checkRayCasts( box, randomRays( box, 500, 2 ) );
+
+        // Empty mesh.
+        const TriangleMesh empty;
+        std::vector<Scalar> hits;
+        std::vector<Vector3ui> triangles;
+        REQUIRE( !Geometry::RayCastTriangleMesh(
+            Ray( Vector3::Zero(), Vector3::UnitX() ), empty, hits, triangles ) );
+    }
+
+    SECTION( "Ray packets" ) {
+        const TriangleMesh sphere = Geometry::makeGeodesicSphere( 1_ra, 2 );
+        const auto rays           = randomRays( sphere, 61, 3 );
+        checkRayPacketTriangles<4>( sphere, rays );
+        checkRayPacketTriangles<8>( sphere, rays );
+
+        // Ray counts which are not multiple of the packet size.
+        checkRayCastBatch( sphere, randomRays( sphere, 500, 4 ) );
+        const TriangleMesh torus = Geometry::makeParametricTorus<32, 16>( 1_ra, .3_ra );
+        checkRayCastBatch( torus, randomRays( torus, 500, 5 ) );
+        checkRayCastBatch( torus, cameraRays( Vector3( 1_ra, 2_ra, 3_ra ), 37, 23 ) );
+        const TriangleMesh box = Geometry::makeBox();
+        checkRayCastBatch( box, randomRays( box, 500, 6 ) );
+
+        // Empty mesh and empty batch.
+        const TriangleMesh empty;
+        const std::vector<Ray> rayBatch { Ray( Vector3::Zero(), Vector3::UnitX() ) };
+        VectorN hits( 1 );
+        VectorNi triangles( 1 );
+        REQUIRE( Geometry::RayCastTriangleMesh( rayBatch, empty, hits, triangles ) == 0 );
+        REQUIRE( triangles[0] == -1 );
+        hits.resize( 0 );
+        triangles.resize( 0 );
+        REQUIRE( Geometry::RayCastTriangleMesh( {}, sphere, hits, triangles ) == 0 );
+    }
+
+    SECTION( "Bvh invalidation" ) {
+        TriangleMesh mesh = Geometry::makeGeodesicSphere( 1_ra, 2 );
+        const Ray r( Vector3( 0_ra, 0_ra, -5_ra ), Vector3::UnitZ() );
+        Scalar hit;
+        Vector3ui triangle;
+        REQUIRE( Geometry::RayCastTriangleMesh( r, mesh, hit, triangle ) );
+        REQUIRE( Math::areApproxEqual( hit, 4_ra, 1e-2_ra ) );
+
+        // Moving the vertices through the geometry.
+        auto vertices = mesh.vertices();
+        for ( auto& v : vertices ) {
+            v += Vector3( 0_ra, 0_ra, 2_ra );
+        }
+        mesh.setVertices( vertices );
+        REQUIRE( Geometry::RayCastTriangleMesh( r, mesh, hit, triangle ) );
+        REQUIRE( Math::areApproxEqual( hit, 6_ra, 1e-2_ra ) );
+
+        // Moving the vertices through the attrib.
+        for ( auto& v : mesh.verticesWithLock() ) {
+            v += Vector3( 10_ra, 0_ra, 0_ra );
+        }
+        mesh.verticesUnlock();
+        REQUIRE( !Geometry::RayCastTriangleMesh( r, mesh, hit, triangle ) );
+
+        // Changing the indices.
+        mesh.setIndices( Geometry::makeBox().getIndices() );
+        mesh.setVertices( Geometry::makeBox().vertices() );
+        REQUIRE( mesh.getBvh().getNumPrimitives() == 12 );
+        REQUIRE( Geometry::RayCastTriangleMesh( r, mesh, hit, triangle ) );
+        REQUIRE( Math::areApproxEqual( hit, 4.5_ra ) );
+
+        // Copies have their own Bvh, and replacing the attribs invalidates it.
+        TriangleMesh copy { mesh };
+        copy.copyAllAttributes( Geometry::makeBox( Vector3( 1_ra, 1_ra, 1_ra ) ) );
+        REQUIRE( Geometry::RayCastTriangleMesh( r, copy, hit, triangle ) );
+        REQUIRE( Math::areApproxEqual( hit, 4_ra ) );
+        REQUIRE( Geometry::RayCastTriangleMesh( r, mesh, hit, triangle ) );
+        REQUIRE( Math::areApproxEqual( hit, 4.5_ra ) );
+    }
+}
+
+TEST_CASE( "Core/Geometry/RayCastTriangleMesh/Benchmark",
+           "[Core][Core/Geometry][RayCast][!benchmark]" ) {
+    using namespace Ra::Core;
+    const Geometry::TriangleMesh mesh = Geometry::makeGeodesicSphere( 1_ra, 6 );
+    const auto rays                   = randomRays( mesh, 32, 0 );
+    std::vector<Scalar> hits;
+    std::vector<Vector3ui> triangles;
+
+    BENCHMARK( "Brute force, all hits" ) {
+        hits.clear();
+        triangles.clear();
+        for ( const auto& r : rays ) {
+            Geometry::RayCastTriangleMeshBruteForce( r, mesh, hits, triangles );
+        }
+        return hits.size();
+    };
+    BENCHMARK( "Bvh build" ) {
+        Geometry::Bvh bvh;
+        bvh.build( mesh.vertices(), mesh.getIndices() );
+        return bvh.getNodes().size();
+    };
+    mesh.getBvh();
+    BENCHMARK( "Bvh, all hits" ) {
+        hits.clear();
+        triangles.clear();
+        for ( const auto& r : rays ) {
+            Geometry::RayCastTriangleMesh( r, mesh, hits, triangles );
+        }
+        return hits.size();
+    };
+    BENCHMARK( "Bvh, first hit" ) {
+        Scalar hit;
+        Vector3ui triangle;
+        size_t numHits = 0;
+        for ( const auto& r : rays ) {
+            numHits += Geometry::RayCastTriangleMesh( r, mesh, hit, triangle );
+        }
+        return numHits;
+    };
+    VectorN packetHits( rays.size() );
+    VectorNi packetTriangles( rays.size() );
+    BENCHMARK( "Bvh, first hit, packets" ) {
+        return Geometry::RayCastTriangleMesh( rays, mesh, packetHits, packetTriangles );
+    };
+
+    // Coherent rays, as generated by a camera or a picking brush.
+    const auto cameraBatch = cameraRays( Vector3( 0_ra, 0_ra, 3_ra ), 32, 32 );
+    BENCHMARK( "Bvh, first hit, camera rays" ) {
+        Scalar hit;
+        Vector3ui triangle;
+        size_t numHits = 0;
+        for ( const auto& r : cameraBatch ) {
+            numHits += Geometry::RayCastTriangleMesh( r, mesh, hit, triangle );
+        }
+        return numHits;
+    };
+    packetHits.resize( Eigen::Index( cameraBatch.size() ) );
+    packetTriangles.resize( Eigen::Index( cameraBatch.size() ) );
+    BENCHMARK( "Bvh, first hit, camera rays, packets" ) {
+        return Geometry::RayCastTriangleMesh( cameraBatch, mesh, packetHits, packetTriangles );
+    };
+}
@@ -0,0 +1,80 @@
+#include <Core/Geometry/MeshPrimitives.hpp>
+#include <Core/Geometry/SplitNormals.hpp>
+#include <Core/Math/Math.hpp>
+#include <catch2/catch.hpp>
+
+using namespace Ra::Core;
+using namespace Ra::Core::Geometry;
+
+namespace {
+/// Area weighted normals, summing the faces around each position whose corner has the same
+/// reference normal.
+Vector3Array bruteForceNormals( const TriangleMesh& mesh, const Vector3Array& vertices ) {
+    const auto& normals   = mesh.normals();
+    const auto& triangles = mesh.getIndices();
+    Vector3Array result( vertices.size(), Vector3::Zero() );
+    for ( size_t v = 0; v < vertices.size(); ++v ) {
+        for ( const auto& t : triangles ) {
+            for ( int k = 0; k < 3; ++k ) {
+                const auto& ref = mesh.vertices();
+                if ( ref[t( k )] == ref[v] && normals[t( k )] == normals[v] ) {
+                    result[v] += ( vertices[t( 1 )] - vertices[t( 0 )] )
+                                     .cross( vertices[t( 2 )] - vertices[t( 0 )] );
+                }
+            }
+        }
+        result[v].normalize();
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE( "Core/Geometry/SplitNormals", "[Core][Core/Geometry][SplitNormals]" ) {
+    SECTION( "Sharp box" ) {
+        TriangleMesh box = makeSharpBox();
+        SplitNormals splitNormals;
+        splitNormals.build( box );
+        REQUIRE( splitNormals.getNumVertices() == box.vertices().size() );
+        REQUIRE( splitNormals.getNumGroups() == 24 );
+
+        Vector3Array normals, tangents, bitangents;
+        splitNormals.computeNormals( box.vertices(), normals, tangents, bitangents );
+        REQUIRE( normals.size() == box.vertices().size() );
+        for ( size_t i = 0; i < normals.size(); ++i ) {
+            REQUIRE( normals[i].isApprox( box.normals()[i] ) );
+            REQUIRE( std::abs( normals[i].dot( tangents[i] ) ) < 1e-5_ra );
+            REQUIRE( std::abs( normals[i].dot( bitangents[i] ) ) < 1e-5_ra );
+            REQUIRE( std::abs( tangents[i].dot( bitangents[i] ) ) < 1e-5_ra );
+            REQUIRE( Math::areApproxEqual( tangents[i].norm(), 1_ra ) );
+        }
+    }
+
+    SECTION( "Deformed mesh" ) {
+        for ( const auto& mesh : { makeGeodesicSphere( 1_ra, 2 ), makeSharpBox() } ) {
+            SplitNormals splitNormals;
+            splitNormals.build( mesh );
+
+            Vector3Array vertices = mesh.vertices();
+            for ( auto& v : vertices ) {
+                v = Vector3( 2_ra * v.x(), v.y() + v.x() * v.x(), v.z() );
+            }
+            Vector3Array normals;
+            splitNormals.computeNormals( vertices, normals );
+            const Vector3Array expected = bruteForceNormals( mesh, vertices );
+            for ( size_t i = 0; i < normals.size(); ++i ) {
+                REQUIRE( normals[i].isApprox( expected[i] ) );
+            }
+        }
+    }
+
+    SECTION( "Clear" ) {
+        SplitNormals splitNormals;
+        splitNormals.build( makeSharpBox() );
+        splitNormals.clear();
+        REQUIRE( splitNormals.getNumVertices() == 0 );
+        REQUIRE( splitNormals.getNumGroups() == 0 );
+        Vector3Array normals;
+        splitNormals.computeNormals( Vector3Array {}, normals );
+        REQUIRE( normals.empty() );
+    }
+}
@@ -1,9 +1,16 @@
 #include <Core/Tasks/Task.hpp>
 #include <Core/Tasks/TaskQueue.hpp>
+#include <Core/Tasks/TraceRecorder.hpp>
 
+#include <atomic>
 #include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 
 using namespace Ra::Core;
 using namespace Ra::Core::Utils;
@@ -92,3 +99,222 @@ TEST_CASE( "Core/TaskQueue", "[Core][TaskQueue]" ) {
         REQUIRE( array[6] == 6 ); // 5+1
     }
 }
+
+TEST_CASE( "Core/TaskQueue/WorkStealing", "[Core][TaskQueue]" ) {
+    TaskQueue taskQueue( 4, TaskQueue::ExecutionMode::WorkStealing );
+    REQUIRE( taskQueue.getExecutionMode() == TaskQueue::ExecutionMode::WorkStealing );
+
+    SECTION( "dependencies" ) {
+        // diamond graph, run several times to reuse the worker deques.
+        for ( int run = 0; run < 10; ++run ) {
+            int array[4] = { 0, 0, 0, 0 };
+            auto t0      = taskQueue.registerTask(
+                std::make_unique<FunctionTask>( [&array]() { array[0] = 1; }, "task 0" ) );
+            auto t1 = taskQueue.registerTask( std::make_unique<FunctionTask>(
+                [&array]() { array[1] = array[0] + 1; }, "task 1" ) );
+            auto t2 = taskQueue.registerTask( std::make_unique<FunctionTask>(
+                [&array]() { array[2] = array[0] + 2; }, "task 2" ) );
+            auto t3 = taskQueue.registerTask( std::make_unique<FunctionTask>(
+                [&array]() { array[3] = array[1] + array[2]; }, "task 3" ) );
+            taskQueue.addDependency( t0, t1 );
+            taskQueue.addDependency( t0, t2 );
+            taskQueue.addPendingDependency( "task 1", t3 );
+            taskQueue.addPendingDependency( t2, "task 3" );
+
+            taskQueue.startTasks();
+            taskQueue.waitForTasks();
+            taskQueue.flushTaskQueue();
+
+            REQUIRE( array[0] == 1 );
+            REQUIRE( array[1] == 2 );
+            REQUIRE( array[2] == 3 );
+            REQUIRE( array[3] == 5 );
+        }
+    }
+
+    SECTION( "empty run" ) {
+        taskQueue.startTasks();
+        taskQueue.waitForTasks();
+        taskQueue.flushTaskQueue();
+    }
+
+    SECTION( "mode switch" ) {
+        int value = 0;
+        taskQueue.setExecutionMode( TaskQueue::ExecutionMode::GlobalQueue );
+        taskQueue.registerTask( std::make_unique<FunctionTask>( [&value]() { ++value; }, "inc" ) );
+        taskQueue.startTasks();
+        taskQueue.waitForTasks();
+        taskQueue.flushTaskQueue();
+        taskQueue.setExecutionMode( TaskQueue::ExecutionMode::WorkStealing );
+        taskQueue.registerTask( std::make_unique<FunctionTask>( [&value]() { ++value; }, "inc" ) );
+        taskQueue.startTasks();
+        taskQueue.waitForTasks();
+        taskQueue.flushTaskQueue();
+        REQUIRE( value == 2 );
+    }
+}
+
+TEST_CASE( "Core/TaskQueue/Chains", "[Core][TaskQueue]" ) {
+    // Many small tasks organized as independent chains joined by a final task, run with an
+    // increasing number of threads in both execution modes. Each task must run exactly once and
+    // after its predecessor. Timings are only reported, as they depend on the test machine.
+    const uint numChains   = 64;
+    const uint chainLength = 16;
+    const uint numTasks    = numChains * chainLength;
+
+    for ( auto mode :
+          { TaskQueue::ExecutionMode::GlobalQueue, TaskQueue::ExecutionMode::WorkStealing } ) {
+        for ( uint numThreads : { 1u, 2u, 4u, 8u } ) {
+            TaskQueue taskQueue( numThreads, mode );
+            std::vector<std::atomic<uint>> runs( numTasks );
+            std::vector<uint> order( numTasks, 0 );
+            std::atomic<uint> counter { 0 };
+            std::atomic<uint> badOrder { 0 };
+            uint joined = 0;
+
+            for ( auto& r : runs ) {
+                r = 0;
+            }
+            std::vector<TaskQueue::TaskId> lasts;
+            for ( uint c = 0; c < numChains; ++c ) {
+                TaskQueue::TaskId prev;
+                for ( uint l = 0; l < chainLength; ++l ) {
+                    const uint idx = c * chainLength + l;
+                    auto tid       = taskQueue.registerTask( std::make_unique<FunctionTask>(
+                        [&, idx, l]() {
+                            // a bit of work
+                            volatile Scalar acc = 0;
+                            for ( int k = 0; k < 1000; ++k ) {
+                                acc = acc + std::sqrt( Scalar( k ) );
+                            }
+                            ++runs[idx];
+                            order[idx] = ++counter;
+                            if ( l > 0 && order[idx - 1] >= order[idx] ) { ++badOrder; }
+                        },
+                        "chain " + std::to_string( c ) ) );
+                    if ( prev.isValid() ) { taskQueue.addDependency( prev, tid ); }
+                    prev = tid;
+                }
+                lasts.push_back( prev );
+            }
+            auto join = taskQueue.registerTask( std::make_unique<FunctionTask>(
+                [&joined, &counter]() { joined = counter; }, "join" ) );
+            for ( const auto& last : lasts ) {
+                taskQueue.addDependency( last, join );
+            }
+
+            auto start = Clock::now();
+            taskQueue.startTasks();
+            taskQueue.waitForTasks();
+            auto end = Clock::now();
+            INFO( "mode " << int( mode ) << ", " << numThreads << " threads : "
+                          << getIntervalMicro( start, end ) << " us" );
+
+            // check thread ids recorded in timer data
+            for ( const auto& td : taskQueue.getTimerData() ) {
+                REQUIRE( td.threadId < numThreads );
+            }
+            taskQueue.flushTaskQueue();
+
+            REQUIRE( counter == numTasks );
+            REQUIRE( joined == numTasks );
+            REQUIRE( badOrder == 0 );
+            for ( const auto& r : runs ) {
+                REQUIRE( r == 1 );
+            }
+        }
+    }
+}
+
+TEST_CASE( "Core/TaskQueue/Replay", "[Core][TaskQueue]" ) {
+    for ( auto mode :
+          { TaskQueue::ExecutionMode::GlobalQueue, TaskQueue::ExecutionMode::WorkStealing } ) {
+        TaskQueue taskQueue( 4, mode );
+        int array[4] = { 0, 0, 0, 0 };
+        int runs     = 0;
+        auto t0      = taskQueue.registerTask(
+            std::make_unique<FunctionTask>( [&array]() { array[0] += 1; }, "task 0" ) );
+        auto t1 = taskQueue.registerTask( std::make_unique<FunctionTask>(
+            [&array]() { array[1] = array[0] * 10; }, "task 1" ) );
+        taskQueue.addPendingDependency( t0, "task 1" );
+
+        // the graph is recorded once, and replayed several times.
+        for ( ; runs < 5; ++runs ) {
+            taskQueue.startTasks();
+            taskQueue.waitForTasks();
+            REQUIRE( taskQueue.getNumTasks() == 2 );
+            REQUIRE( array[0] == runs + 1 );
+            REQUIRE( array[1] == array[0] * 10 );
+        }
+
+        // modifying the graph triggers a new compilation at next run.
+        auto t2 = taskQueue.registerTask( std::make_unique<FunctionTask>(
+            [&array]() { array[2] = array[1] + 1; }, "task 2" ) );
+        taskQueue.addDependency( t1, t2 );
+        for ( ; runs < 10; ++runs ) {
+            taskQueue.startTasks();
+            taskQueue.waitForTasks();
+            REQUIRE( array[0] == runs + 1 );
+            REQUIRE( array[2] == array[1] + 1 );
+        }
+        taskQueue.flushTaskQueue();
+        REQUIRE( taskQueue.getNumTasks() == 0 );
+
+        // after flush, new tasks are run alone
+        taskQueue.registerTask(
+            std::make_unique<FunctionTask>( [&array]() { array[3] = 1; }, "task 3" ) );
+        taskQueue.startTasks();
+        taskQueue.waitForTasks();
+        taskQueue.flushTaskQueue();
+        REQUIRE( array[0] == 10 );
+        REQUIRE( array[3] == 1 );
+    }
+}
+
+TEST_CASE( "Core/TaskQueue/TraceRecorder", "[Core][TaskQueue]" ) {
+    TaskQueue taskQueue( 2 );
+    auto t0 = taskQueue.registerTask( std::make_unique<FunctionTask>( []() {}, "task \"0\"" ) );
+    auto t1 = taskQueue.registerTask( std::make_unique<FunctionTask>( []() {}, "task 1" ) );
+    auto t2 = taskQueue.registerTask( std::make_unique<FunctionTask>( []() {}, "task 2" ) );
+    taskQueue.addDependency( t0, t1 );
+    taskQueue.addDependency( t0, t2 );
+
+    const std::string filename = "taskqueue_trace.json";
+    TraceRecorder recorder;
+    REQUIRE( recorder.start( filename, 3 ) );
+    for ( int frame = 0; frame < 5; ++frame ) {
+        auto frameStart = Clock::now();
+        taskQueue.startTasks();
+        taskQueue.waitForTasks();
+        recorder.addSpan( "Frame " + std::to_string( frame ), "frame", frameStart, Clock::now() );
+        recorder.addTasks( taskQueue );
+        recorder.endFrame();
+    }
+    // stops by itself after the requested number of frames.
+    REQUIRE( !recorder.isRecording() );
+    REQUIRE( recorder.getNumRecordedFrames() == 3 );
+    taskQueue.flushTaskQueue();
+
+    std::stringstream content;
+    content << std::ifstream( filename ).rdbuf();
+    const std::string trace = content.str();
+    std::remove( filename.c_str() );
+
+    auto count = [&trace]( const std::string& pattern ) {
+        size_t n = 0;
+        for ( size_t pos = trace.find( pattern ); pos != std::string::npos;
+              pos        = trace.find( pattern, pos + 1 ) ) {
+            ++n;
+        }
+        return n;
+    };
+    REQUIRE( trace.front() == '{' );
+    REQUIRE( trace.find( "]}" ) != std::string::npos );
+    // 3 frames of 1 frame span and 3 task spans
+    REQUIRE( count( "\"ph\":\"X\"" ) == 3 * 4 );
+    // 2 dependencies per frame, each a start and an end flow event
+    REQUIRE( count( "\"ph\":\"s\"" ) == 3 * 2 );
+    REQUIRE( count( "\"ph\":\"f\"" ) == 3 * 2 );
+    REQUIRE( count( "Frame " ) == 3 );
+    REQUIRE( count( "task \\\"0\\\"" ) == 3 );
+}
@@ -0,0 +1,262 @@
+#include <Core/Geometry/Volume.hpp>
+#include <catch2/catch.hpp>
+
+#include <map>
+#include <random>
+
+TEST_CASE( "Core/Geometry/VolumeSparse", "[Core][Core/Geometry][Volume]" ) {
+    using namespace Ra::Core;
+    using Geometry::VolumeGrid;
+    using Geometry::VolumeSparse;
+
+    const Vector3i size( 40, 30, 20 );
+    VolumeSparse volume;
+    volume.setSize( size );
+    volume.setBinSize( Vector3( .5_ra, 1_ra, 2_ra ) );
+
+    // Random insertions, with duplicates, compared to a map.
+    std::mt19937 gen( 0 );
+    std::uniform_int_distribution<int> dist( 0, 19 );
+    std::map<int, Scalar> expected;
+    std::vector<Vector3i> bins;
+    std::vector<Scalar> values;
+    for ( int i = 0; i < 5000; ++i ) {
+        const Vector3i bin( 2 * dist( gen ), dist( gen ) + 5, dist( gen ) );
+        const Scalar value = Scalar( i % 7 ) + 1_ra;
+        const int index    = bin.x() + size.x() * ( bin.y() + size.y() * bin.z() );
+        expected[index] += value;
+        if ( i % 2 == 0 ) { REQUIRE( volume.addToBin( value, bin ) ); }
+        else {
+            bins.push_back( bin );
+            values.push_back( value );
+        }
+    }
+    REQUIRE( volume.addToBins( bins, values ) );
+
+    SECTION( "Lookups" ) {
+        REQUIRE( volume.data().size() == expected.size() );
+        for ( const auto& sample : volume.data() ) {
+            REQUIRE( expected.at( sample.index ) == sample.value );
+        }
+        for ( int z = 0; z < size.z(); ++z ) {
+            for ( int y = 0; y < size.y(); ++y ) {
+                for ( int x = 0; x < size.x(); ++x ) {
+                    const int index = x + size.x() * ( y + size.y() * z );
+                    const auto v    = volume.getBinValue( Vector3i( x, y, z ) );
+                    const auto it   = expected.find( index );
+                    REQUIRE( bool( v ) == ( it != expected.end() ) );
+                    if ( v ) { REQUIRE( *v == it->second ); }
+                }
+            }
+        }
+        // Out of bounds bins.
+        REQUIRE( !volume.addToBin( 1_ra, Vector3i( 40, 0, 0 ) ) );
+        REQUIRE( !volume.getBinValue( Vector3i( 0, 30, 0 ) ) );
+        const std::vector<Vector3i> outOfBounds { Vector3i( 0, 0, 0 ), Vector3i( 0, 0, 20 ) };
+        REQUIRE( !volume.addToBins( outOfBounds, { 1_ra, 1_ra } ) );
+        REQUIRE( *volume.getBinValue( Vector3i( 0, 0, 0 ) ) == expected[0] + 1_ra );
+    }
+
+    SECTION( "Spatial order" ) {
+        volume.sortSamples();
+        REQUIRE( volume.data().size() == expected.size() );
+        for ( const auto& sample : volume.data() ) {
+            REQUIRE( expected.at( sample.index ) == sample.value );
+            const Vector3i bin( sample.index % size.x(),
+                                ( sample.index / size.x() ) % size.y(),
+                                sample.index / ( size.x() * size.y() ) );
+            REQUIRE( *volume.getBinValue( bin ) == sample.value );
+        }
+        // Bins of a 2x2x2 block, in Z order.
+        VolumeSparse block;
+        block.setSize( Vector3i( 2, 2, 2 ) );
+        for ( int i = 7; i >= 0; --i ) {
+            block.addToBin( Scalar( i ), Vector3i( i & 1, ( i >> 1 ) & 1, i >> 2 ) );
+        }
+        block.sortSamples();
+        for ( int i = 0; i < 8; ++i ) {
+            REQUIRE( block.data()[size_t( i )].index == i );
+        }
+    }
+
+    SECTION( "Grid conversions" ) {
+        VolumeGrid grid( -1_ra );
+        volume.toGrid( grid );
+        REQUIRE( grid.size() == size );
+        REQUIRE( grid.binSize() == volume.binSize() );
+        for ( size_t i = 0; i < grid.data().size(); ++i ) {
+            const auto it = expected.find( int( i ) );
+            REQUIRE( grid.data()[i] == ( it == expected.end() ? -1_ra : it->second ) );
+        }
+
+        VolumeSparse sparse;
+        sparse.fromGrid( grid, -1_ra );
+        REQUIRE( sparse.size() == size );
+        REQUIRE( sparse.binSize() == volume.binSize() );
+        REQUIRE( sparse.data().size() == expected.size() );
+        auto it = expected.begin();
+        for ( const auto& sample : sparse.data() ) {
+            REQUIRE( sample.index == it->first );
+            REQUIRE( sample.value == it->second );
+            ++it;
+        }
+    }
+}
+
+TEST_CASE( "Core/Geometry/VolumeBricked", "[Core][Core/Geometry][Volume]" ) {
+    using namespace Ra::Core;
+    using Geometry::VolumeBricked;
+    using Geometry::VolumeGrid;
+
+    // Bricks of noise (x >= 32), of blocks of 4^3 equal values (z < 16) and uniform bricks.
+    const Vector3i size( 37, 20, 33 );
+    VolumeGrid grid;
+    grid.setSize( size );
+    grid.setBinSize( Vector3( .5_ra, 1_ra, 2_ra ) );
+    std::mt19937 gen( 0 );
+    std::uniform_real_distribution<Scalar> dist( -1_ra, 1_ra );
+    for ( int z = 0; z < size.z(); ++z ) {
+        for ( int y = 0; y < size.y(); ++y ) {
+            for ( int x = 0; x < size.x(); ++x ) {
+                Scalar value = 0_ra;
+                if ( x >= 32 ) { value = dist( gen ); }
+                else if ( z < 16 ) { value = Scalar( ( x / 4 + y / 4 + z / 4 ) % 3 ); }
+                grid.addToBin( value, Vector3i( x, y, z ) );
+            }
+        }
+    }
+    VolumeBricked volume;
+    volume.fromGrid( grid );
+
+    const auto checkValues = [&size, &grid]( const VolumeBricked& v ) {
+        REQUIRE( v.size() == size );
+        REQUIRE( v.binSize() == grid.binSize() );
+        for ( int z = 0; z < size.z(); ++z ) {
+            for ( int y = 0; y < size.y(); ++y ) {
+                for ( int x = 0; x < size.x(); ++x ) {
+                    const Vector3i bin( x, y, z );
+                    REQUIRE( *v.getBinValue( bin ) == *grid.getBinValue( bin ) );
+                }
+            }
+        }
+    };
+
+    SECTION( "Bricks" ) {
+        checkValues( volume );
+        REQUIRE( volume.brickCount() == Vector3i( 3, 2, 3 ) );
+        REQUIRE( volume.getBrickSize( Vector3i( 2, 1, 2 ) ) == Vector3i( 5, 4, 1 ) );
+        for ( int z = 0; z < 3; ++z ) {
+            for ( int y = 0; y < 2; ++y ) {
+                for ( int x = 0; x < 3; ++x ) {
+                    const Vector3i b( x, y, z );
+                    const auto& brick = volume.getBrick( b );
+                    VolumeBricked::Container values;
+                    volume.getBrickValues( b, values );
+                    REQUIRE( values.size() == size_t( volume.getBrickSize( b ).prod() ) );
+                    const auto range = std::minmax_element( values.begin(), values.end() );
+                    REQUIRE( brick.min == *range.first );
+                    REQUIRE( brick.max == *range.second );
+                    const bool uniform = x < 2 && z > 0;
+                    REQUIRE( ( brick.storage == VolumeBricked::UNIFORM ) == uniform );
+                    REQUIRE( volume.isBrickModified( b ) );
+                }
+            }
+        }
+        volume.resetModifiedBricks();
+        REQUIRE( !volume.isBrickModified( Vector3i( 0, 0, 0 ) ) );
+    }
+
+    SECTION( "Compression" ) {
+        const size_t rawMemory = volume.getMemorySize();
+        volume.compress();
+        REQUIRE( volume.getMemorySize() < rawMemory );
+        REQUIRE( volume.getBrick( Vector3i( 0, 0, 0 ) ).storage == VolumeBricked::COMPRESSED );
+        REQUIRE( volume.getBrick( Vector3i( 2, 0, 0 ) ).storage == VolumeBricked::RAW );
+        checkValues( volume );
+
+        VolumeGrid copy;
+        volume.toGrid( copy );
+        REQUIRE( copy.size() == size );
+        REQUIRE( copy.binSize() == grid.binSize() );
+        REQUIRE( copy.data() == grid.data() );
+
+        volume.decompress();
+        REQUIRE( volume.getBrick( Vector3i( 0, 0, 0 ) ).storage == VolumeBricked::RAW );
+        checkValues( volume );
+    }
+
+    SECTION( "Modifications" ) {
+        volume.compress();
+        volume.resetModifiedBricks();
+        // Bins of a compressed and of an uniform brick.
+        const Vector3i compressedBin( 3, 17, 5 ), uniformBin( 20, 3, 30 );
+        REQUIRE( volume.addToBin( 5_ra, compressedBin ) );
+        REQUIRE( volume.addToBin( -2_ra, uniformBin ) );
+        grid.addToBin( 5_ra, compressedBin );
+        grid.addToBin( -2_ra, uniformBin );
+        checkValues( volume );
+        const Vector3i compressedBrick( 0, 1, 0 ), uniformBrick( 1, 0, 1 );
+        REQUIRE( volume.isBrickModified( compressedBrick ) );
+        REQUIRE( volume.isBrickModified( uniformBrick ) );
+        REQUIRE( !volume.isBrickModified( Vector3i( 0, 0, 0 ) ) );
+        REQUIRE( volume.getBrick( compressedBrick ).storage == VolumeBricked::RAW );
+        REQUIRE( volume.getBrick( compressedBrick ).max == 7_ra );
+        REQUIRE( volume.getBrick( uniformBrick ).min == -2_ra );
+        REQUIRE( volume.getBrick( uniformBrick ).max == 0_ra );
+        // Going back to the former value shrinks the range.
+        volume.addToBin( 2_ra, uniformBin );
+        REQUIRE( volume.getBrick( uniformBrick ).min == 0_ra );
+    }
+
+    SECTION( "Gradients" ) {
+        volume.compress();
+        grid.computeGradients();
+        VolumeBricked::GradientContainer gradients;
+        for ( int z = 0; z < 3; ++z ) {
+            for ( int y = 0; y < 2; ++y ) {
+                for ( int x = 0; x < 3; ++x ) {
+                    const Vector3i b( x, y, z );
+                    volume.computeBrickGradients( b, gradients );
+                    const Vector3i origin = volume.getBrickOrigin( b );
+                    const Vector3i s      = volume.getBrickSize( b );
+                    REQUIRE( gradients.size() == size_t( s.prod() ) );
+                    size_t i = 0;
+                    for ( int k = 0; k < s.z(); ++k ) {
+                        for ( int j = 0; j < s.y(); ++j ) {
+                            for ( int l = 0; l < s.x(); ++l ) {
+                                const Vector3i bin = origin + Vector3i( l, j, k );
+                                const int index =
+                                    bin.x() + size.x() * ( bin.y() + size.y() * bin.z() );
+                                REQUIRE( gradients[i++] == grid.gradient()[size_t( index )] );
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION( "Mip pyramid" ) {
+        volume.computeMipmaps();
+        REQUIRE( volume.getNumMipLevels() == 7 );
+        REQUIRE( &volume.getMipLevel( 0 ) == &volume );
+        const auto& level1 = volume.getMipLevel( 1 );
+        REQUIRE( level1.size() == Vector3i( 19, 10, 17 ) );
+        REQUIRE( level1.binSize() == 2_ra * grid.binSize() );
+        REQUIRE( volume.getMipLevel( 6 ).size() == Vector3i( 1, 1, 1 ) );
+        // Full and border bins.
+        Scalar sum = 0_ra;
+        for ( int i = 0; i < 8; ++i ) {
+            sum += *grid.getBinValue( Vector3i( 34 + ( i & 1 ), 6 + ( ( i >> 1 ) & 1 ), i >> 2 ) );
+        }
+        REQUIRE( *level1.getBinValue( Vector3i( 17, 3, 0 ) ) == Approx( sum / 8_ra ) );
+        const Scalar border = ( *grid.getBinValue( Vector3i( 36, 0, 32 ) ) +
+                                *grid.getBinValue( Vector3i( 36, 1, 32 ) ) ) /
+                              2_ra;
+        REQUIRE( *level1.getBinValue( Vector3i( 18, 0, 16 ) ) == Approx( border ) );
+        // The last level is the mean of the volume, up to the border weights.
+        const Scalar coarse = *volume.getMipLevel( 6 ).getBinValue( Vector3i( 0, 0, 0 ) );
+        REQUIRE( coarse > 0_ra );
+        REQUIRE( coarse < 2_ra );
+    }
+}
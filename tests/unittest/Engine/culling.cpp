@@ -0,0 +1,89 @@
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Core/Geometry/Frustum.hpp>
+#include <Core/Geometry/MeshPrimitives.hpp>
+
+#include <Engine/Data/Mesh.hpp>
+#include <Engine/RadiumEngine.hpp>
+#include <Engine/Rendering/RenderObject.hpp>
+#include <Engine/Rendering/Renderer.hpp>
+#include <Engine/Scene/Component.hpp>
+#include <Engine/Scene/Entity.hpp>
+#include <Engine/Scene/EntityManager.hpp>
+
+using namespace Ra::Core;
+using namespace Ra::Engine;
+using namespace Ra::Engine::Rendering;
+
+class CullingComponent : public Scene::Component
+{
+  public:
+    using Component::Component;
+    void initialize() override {};
+};
+
+TEST_CASE( "Engine/Rendering/Renderer/Culling", "[Engine][Engine/Rendering][Renderer]" ) {
+    auto engine = RadiumEngine::createInstance();
+    engine->initialize();
+    {
+        auto entity    = engine->getEntityManager()->createEntity( "culling entity" );
+        auto component = new CullingComponent( "culling component", entity );
+
+        // A unit box centered at position, rotated by angle around z and scaled by scale.
+        std::vector<std::unique_ptr<RenderObject>> objects;
+        const auto addObject =
+            [&]( const std::string& name, const Vector3& position, Scalar angle, Scalar scale ) {
+                objects.push_back( std::make_unique<RenderObject>(
+                    name, component, RenderObjectType::Geometry ) );
+                objects.back()->setMesh(
+                    std::make_shared<Data::Mesh>( name, Geometry::makeSharpBox() ) );
+                Transform T = Transform::Identity();
+                T.translate( position );
+                T.rotate( AngleAxis( angle, Vector3::UnitZ() ) );
+                T.scale( scale );
+                objects.back()->setLocalTransform( T );
+                return objects.back().get();
+            };
+        const Scalar quarter = Scalar( M_PI / 4 );
+        auto inside          = addObject( "inside", Vector3( 0_ra, 0_ra, 0_ra ), 0_ra, 1_ra );
+        auto right           = addObject( "right", Vector3( 3_ra, 0_ra, 0_ra ), 0_ra, 1_ra );
+        auto crossing        = addObject( "crossing", Vector3( 1.4_ra, 0_ra, 0_ra ), 0_ra, 1_ra );
+        auto behind          = addObject( "behind", Vector3( 0_ra, 0_ra, -3_ra ), 0_ra, 1_ra );
+        auto scaled          = addObject( "scaled", Vector3( 1.4_ra, 0_ra, 0_ra ), 0_ra, 0.5_ra );
+        // The rotation widens the box along x.
+        auto rotated   = addObject( "rotated", Vector3( 1.6_ra, 0_ra, 0_ra ), quarter, 1_ra );
+        auto unrotated = addObject( "unrotated", Vector3( 1.6_ra, 0_ra, 0_ra ), 0_ra, 1_ra );
+        objects.push_back(
+            std::make_unique<RenderObject>( "no mesh", component, RenderObjectType::Geometry ) );
+        auto noMesh = objects.back().get();
+
+        // The clipping volume of the identity projection is the [-1, 1]^3 cube.
+        const Geometry::Frustum frustum( Matrix4::Identity() );
+        std::vector<RenderObject*> queue {
+            inside, right, crossing, behind, scaled, rotated, unrotated, noMesh };
+        std::vector<RenderObject*> culled;
+
+        // The boxes follow the object transforms, the kept objects stay in order.
+        REQUIRE( Renderer::cullRenderQueue( frustum, queue, culled ) == 4 );
+        REQUIRE( queue == std::vector<RenderObject*> { inside, crossing, rotated, noMesh } );
+        REQUIRE( culled == std::vector<RenderObject*> { right, behind, scaled, unrotated } );
+
+        // Culled objects are appended, and the boxes follow the entity transform.
+        entity->setTransform( Transform( Translation( Vector3( -3_ra, 0_ra, 0_ra ) ) ) );
+        entity->swapTransformBuffers();
+        queue = { inside, right, crossing };
+        REQUIRE( Renderer::cullRenderQueue( frustum, queue, culled ) == 2 );
+        REQUIRE( queue == std::vector<RenderObject*> { right } );
+        REQUIRE( culled.size() == 6 );
+        REQUIRE( culled[4] == inside );
+        REQUIRE( culled[5] == crossing );
+
+        objects.clear();
+    }
+    engine->cleanup();
+    RadiumEngine::destroyInstance();
+}
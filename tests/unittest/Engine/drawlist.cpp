@@ -0,0 +1,142 @@
+#include <catch2/catch.hpp>
+
+#include <Engine/Rendering/DrawList.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace Ra::Core;
+using namespace Ra::Engine;
+using namespace Ra::Engine::Rendering;
+using Order = DrawList::Order;
+
+TEST_CASE( "Engine/Rendering/DrawList/Sort keys", "[Engine][Engine/Rendering][DrawList]" ) {
+    SECTION( "State front to back" ) {
+        const auto key = []( uint64_t shader, uint64_t parameters, Scalar depth ) {
+            return DrawList::makeSortKey( shader, parameters, depth, Order::StateFrontToBack );
+        };
+        // the shader comes first, then the parameters, then the depth
+        REQUIRE( key( 0, 5, 100_ra ) < key( 1, 0, 1_ra ) );
+        REQUIRE( key( 1, 0, 100_ra ) < key( 1, 1, 1_ra ) );
+        REQUIRE( key( 1, 1, 1_ra ) < key( 1, 1, 2_ra ) );
+        REQUIRE( key( 1, 1, 0.5_ra ) < key( 1, 1, 1000_ra ) );
+        REQUIRE( key( 1, 1, 1e-6_ra ) < key( 1, 1, 1e-5_ra ) );
+        // negative depths are clamped to 0
+        REQUIRE( key( 1, 1, -1_ra ) == key( 1, 1, 0_ra ) );
+        REQUIRE( key( 1, 1, 0_ra ) < key( 1, 1, 1e-3_ra ) );
+    }
+
+    SECTION( "Back to front" ) {
+        const auto key = []( uint64_t shader, uint64_t parameters, Scalar depth ) {
+            return DrawList::makeSortKey( shader, parameters, depth, Order::BackToFront );
+        };
+        // the depth comes first, decreasing, then the shader and the parameters
+        REQUIRE( key( 1, 1, 2_ra ) < key( 0, 0, 1_ra ) );
+        REQUIRE( key( 1, 1, 1000_ra ) < key( 0, 0, 0.5_ra ) );
+        REQUIRE( key( 0, 1, 1_ra ) < key( 1, 0, 1_ra ) );
+        REQUIRE( key( 1, 0, 1_ra ) < key( 1, 1, 1_ra ) );
+        REQUIRE( key( 1, 1, -1_ra ) == key( 1, 1, 0_ra ) );
+    }
+
+    SECTION( "Id masks" ) {
+        // ids beyond 16 bits of shader and 24 bits of parameters wrap around, without changing
+        // the other fields
+        for ( auto order : { Order::StateFrontToBack, Order::BackToFront } ) {
+            const auto key = [order]( uint64_t shader, uint64_t parameters ) {
+                return DrawList::makeSortKey( shader, parameters, 1_ra, order );
+            };
+            REQUIRE( key( 0x10000, 3 ) == key( 0, 3 ) );
+            REQUIRE( key( 0x1ffff, 3 ) == key( 0xffff, 3 ) );
+            REQUIRE( key( 2, 0x1000000 ) == key( 2, 0 ) );
+            REQUIRE( key( 2, 0xffffff ) < key( 3, 0 ) );
+            REQUIRE( key( 0xffff, 0xffffff ) > key( 0xfffe, 0xffffff ) );
+        }
+        // the depth does not overflow on the state
+        REQUIRE( DrawList::makeSortKey( 0, 0, 1e30_ra, Order::StateFrontToBack ) <
+                 DrawList::makeSortKey( 0, 1, 0_ra, Order::StateFrontToBack ) );
+        REQUIRE( DrawList::makeSortKey( 0xffff, 0xffffff, 1e30_ra, Order::BackToFront ) <
+                 DrawList::makeSortKey( 0, 0, 1e29_ra, Order::BackToFront ) );
+    }
+}
+
+TEST_CASE( "Engine/Rendering/DrawList/Bind filter", "[Engine][Engine/Rendering][DrawList]" ) {
+    // the filter only compares the addresses of the shaders and parameters
+    std::array<char, 2> shaderStorage;
+    std::array<char, 3> parameterStorage;
+    const auto shader = [&shaderStorage]( int i ) {
+        return reinterpret_cast<const Data::ShaderProgram*>( &shaderStorage[i] );
+    };
+    const auto parameters = [&parameterStorage]( int i ) {
+        return reinterpret_cast<const Data::RenderParameters*>( &parameterStorage[i] );
+    };
+    struct Draw {
+        int m_shader;
+        int m_parameters; // -1 for none
+        Scalar m_depth;
+    };
+    const auto countBinds = [&]( const std::vector<Draw>& draws ) {
+        DrawStatistics statistics;
+        DrawList::BindFilter filter( statistics );
+        for ( const auto& draw : draws ) {
+            filter.bindShader( shader( draw.m_shader ) );
+            filter.bindParameters( draw.m_parameters < 0 ? nullptr
+                                                         : parameters( draw.m_parameters ) );
+        }
+        return statistics;
+    };
+
+    SECTION( "Skipped binds" ) {
+        DrawStatistics statistics;
+        DrawList::BindFilter filter( statistics );
+        REQUIRE( filter.bindShader( shader( 0 ) ) );
+        REQUIRE( filter.bindParameters( parameters( 0 ) ) );
+        REQUIRE( !filter.bindShader( shader( 0 ) ) );
+        REQUIRE( !filter.bindParameters( parameters( 0 ) ) );
+        REQUIRE( !filter.bindParameters( nullptr ) );
+        REQUIRE( filter.bindParameters( parameters( 1 ) ) );
+        // parameters are bound again after a shader change
+        REQUIRE( filter.bindShader( shader( 1 ) ) );
+        REQUIRE( filter.bindParameters( parameters( 1 ) ) );
+        REQUIRE( statistics.m_shaderBinds == 2 );
+        REQUIRE( statistics.m_parameterBinds == 3 );
+        REQUIRE( statistics.m_draws == 0 );
+    }
+
+    SECTION( "Sorted draws" ) {
+        std::vector<Draw> draws { { 1, 2, 5_ra },  { 0, 0, 3_ra }, { 1, 1, 2_ra },
+                                  { 0, -1, 1_ra }, { 1, 2, 1_ra }, { 0, 0, 4_ra },
+                                  { 1, 1, 6_ra },  { 0, -1, 2_ra } };
+        const auto unsorted = countBinds( draws );
+        REQUIRE( unsorted.m_shaderBinds == 8 );
+        REQUIRE( unsorted.m_parameterBinds == 6 );
+
+        // draws sorted by state are bound once per shader and per parameters of each shader
+        const auto sortBy = [&draws]( Order order ) {
+            std::stable_sort( draws.begin(), draws.end(), [order]( const Draw& a, const Draw& b ) {
+                const auto key = [order]( const Draw& d ) {
+                    return DrawList::makeSortKey(
+                        uint64_t( d.m_shader ), uint64_t( d.m_parameters + 1 ), d.m_depth, order );
+                };
+                return key( a ) < key( b );
+            } );
+        };
+        sortBy( Order::StateFrontToBack );
+        const auto sorted = countBinds( draws );
+        REQUIRE( sorted.m_shaderBinds == 2 );
+        REQUIRE( sorted.m_parameterBinds == 3 );
+        // front to back within a state
+        REQUIRE( draws[0].m_parameters == -1 );
+        REQUIRE( draws[0].m_depth == 1_ra );
+        REQUIRE( draws[1].m_depth == 2_ra );
+
+        // back to front only groups the draws of equal depths
+        sortBy( Order::BackToFront );
+        for ( size_t i = 1; i < draws.size(); ++i ) {
+            REQUIRE( draws[i - 1].m_depth >= draws[i].m_depth );
+        }
+        REQUIRE( draws.front().m_depth == 6_ra );
+        REQUIRE( draws.back().m_depth == 1_ra );
+        REQUIRE( draws.back().m_shader == 1 );
+    }
+}
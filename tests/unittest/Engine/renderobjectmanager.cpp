@@ -0,0 +1,92 @@
+#include <catch2/catch.hpp>
+
+#include <Engine/RadiumEngine.hpp>
+#include <Engine/Rendering/RenderObject.hpp>
+#include <Engine/Rendering/RenderObjectManager.hpp>
+#include <Engine/Scene/Component.hpp>
+#include <Engine/Scene/Entity.hpp>
+#include <Engine/Scene/EntityManager.hpp>
+
+using namespace Ra::Engine::Rendering;
+
+class RenderObjectCounter
+{
+  public:
+    int m_added { 0 };
+    int m_removed { 0 };
+    int m_changed { 0 };
+    RenderObject* m_last { nullptr };
+    void added( RenderObject* ro ) {
+        ++m_added;
+        m_last = ro;
+    }
+    void removed( RenderObject* ro ) {
+        ++m_removed;
+        m_last = ro;
+    }
+    void changed( RenderObject* ro ) {
+        ++m_changed;
+        m_last = ro;
+    }
+};
+
+class EmptyComponent : public Ra::Engine::Scene::Component
+{
+  public:
+    using Component::Component;
+    void initialize() override {};
+};
+
+TEST_CASE( "Engine/Rendering/RenderObjectManager/Notifications",
+           "[Engine][Engine/Rendering][RenderObjectManager]" ) {
+    auto engine = Ra::Engine::RadiumEngine::createInstance();
+    engine->initialize();
+
+    auto roMgr     = engine->getRenderObjectManager();
+    auto entity    = engine->getEntityManager()->createEntity( "test entity" );
+    auto component = new EmptyComponent( "test component", entity );
+
+    RenderObjectCounter counter;
+    auto& addNotifier    = roMgr->getRenderObjectAddedNotifier();
+    auto& removeNotifier = roMgr->getRenderObjectRemovedNotifier();
+    auto& changeNotifier = roMgr->getRenderObjectChangedNotifier();
+    int ia               = addNotifier.attachMember( &counter, &RenderObjectCounter::added );
+    int ir               = removeNotifier.attachMember( &counter, &RenderObjectCounter::removed );
+    int ic               = changeNotifier.attachMember( &counter, &RenderObjectCounter::changed );
+
+    auto ro  = new RenderObject( "test ro", component, RenderObjectType::Geometry );
+    auto idx = roMgr->addRenderObject( ro );
+    REQUIRE( counter.m_added == 1 );
+    REQUIRE( counter.m_last == ro );
+
+    // queue related changes are notified, others are not
+    ro->setXRay( true );
+    REQUIRE( counter.m_changed == 1 );
+    ro->setXRay( true );
+    REQUIRE( counter.m_changed == 1 );
+    ro->toggleXRay();
+    REQUIRE( counter.m_changed == 2 );
+    ro->setType( RenderObjectType::Debug );
+    REQUIRE( counter.m_changed == 3 );
+    ro->setVisible( false );
+    REQUIRE( counter.m_changed == 3 );
+
+    // the type index follows the type changes
+    std::vector<std::shared_ptr<RenderObject>> objects;
+    roMgr->getRenderObjectsByType( objects, RenderObjectType::Geometry );
+    REQUIRE( objects.empty() );
+    roMgr->getRenderObjectsByType( objects, RenderObjectType::Debug );
+    REQUIRE( objects.size() == 1 );
+    objects.clear();
+
+    roMgr->removeRenderObject( idx );
+    REQUIRE( counter.m_removed == 1 );
+    REQUIRE( counter.m_last == ro );
+
+    addNotifier.detach( ia );
+    removeNotifier.detach( ir );
+    changeNotifier.detach( ic );
+
+    engine->cleanup();
+    Ra::Engine::RadiumEngine::destroyInstance();
+}
@@ -190,6 +190,40 @@ TEST_CASE( "Engine/Data/RenderParameters", "[Engine][Engine/Data][RenderParamete
                  p1.getParameterSet<RP::IntParameter>().at( "Bar" ).m_value );
     }
 
+    SECTION( "Parameter versions" ) {
+        RP params;
+        auto version = params.getVersion();
+        params.addParameter( "IntParameter", 1 );
+        REQUIRE( params.getVersion() != version );
+
+        // same value, no change
+        version = params.getVersion();
+        params.addParameter( "IntParameter", 1 );
+        params.addParameter( "IntParameter", 1 );
+        REQUIRE( params.getVersion() == version );
+
+        params.addParameter( "IntParameter", 2 );
+        REQUIRE( params.getVersion() != version );
+
+        version = params.getVersion();
+        params.addParameter( "ColorParameter", Color::Red() );
+        params.addParameter( "Mat3Parameter", Matrix3 { Matrix3::Identity() } );
+        REQUIRE( params.getVersion() != version );
+        version = params.getVersion();
+        params.addParameter( "ColorParameter", Color::Red() );
+        params.addParameter( "Mat3Parameter", Matrix3 { Matrix3::Identity() } );
+        REQUIRE( params.getVersion() == version );
+
+        Texture tex1 { { "texture1" } };
+        params.addParameter( "TextureParameter", &tex1, 1 );
+        REQUIRE( params.getVersion() != version );
+        version = params.getVersion();
+        params.addParameter( "TextureParameter", &tex1, 1 );
+        REQUIRE( params.getVersion() == version );
+        params.addParameter( "TextureParameter", &tex1, 2 );
+        REQUIRE( params.getVersion() != version );
+    }
+
     SECTION( "Enum parameter" ) {
         RP params;
 
@@ -0,0 +1,121 @@
+#include <catch2/catch.hpp>
+
+#include <Engine/RadiumEngine.hpp>
+#include <Engine/Rendering/RenderObject.hpp>
+#include <Engine/Rendering/RenderObjectManager.hpp>
+#include <Engine/Rendering/RenderQueues.hpp>
+#include <Engine/Scene/Component.hpp>
+#include <Engine/Scene/Entity.hpp>
+#include <Engine/Scene/EntityManager.hpp>
+
+using namespace Ra::Engine::Rendering;
+using Queue = RenderQueues::Queue;
+
+class QueuesComponent : public Ra::Engine::Scene::Component
+{
+  public:
+    using Component::Component;
+    void initialize() override {};
+};
+
+TEST_CASE( "Engine/Rendering/RenderQueues", "[Engine][Engine/Rendering][Renderer]" ) {
+    auto engine = Ra::Engine::RadiumEngine::createInstance();
+    engine->initialize();
+
+    auto roMgr     = engine->getRenderObjectManager();
+    auto entity    = engine->getEntityManager()->createEntity( "queues entity" );
+    auto component = new QueuesComponent( "queues component", entity );
+
+    RenderQueues queues;
+    auto& addNotifier    = roMgr->getRenderObjectAddedNotifier();
+    auto& removeNotifier = roMgr->getRenderObjectRemovedNotifier();
+    auto& changeNotifier = roMgr->getRenderObjectChangedNotifier();
+    int ia               = addNotifier.attachMember( &queues, &RenderQueues::add );
+    int ir               = removeNotifier.attachMember( &queues, &RenderQueues::remove );
+    int ic               = changeNotifier.attachMember( &queues, &RenderQueues::update );
+
+    auto a    = new RenderObject( "a", component, RenderObjectType::Geometry );
+    auto b    = new RenderObject( "b", component, RenderObjectType::Geometry );
+    auto c    = new RenderObject( "c", component, RenderObjectType::Geometry );
+    auto d    = new RenderObject( "d", component, RenderObjectType::Debug );
+    auto u    = new RenderObject( "u", component, RenderObjectType::UI );
+    auto aIdx = component->addRenderObject( a );
+    auto bIdx = component->addRenderObject( b );
+    auto cIdx = component->addRenderObject( c );
+    component->addRenderObject( d );
+    component->addRenderObject( u );
+
+    SECTION( "Add and remove" ) {
+        REQUIRE( queues.getQueue( RenderQueues::Fancy ) == Queue { a, b, c } );
+        REQUIRE( queues.getQueue( RenderQueues::Debug ) == Queue { d } );
+        REQUIRE( queues.getQueue( RenderQueues::XRay ).empty() );
+        REQUIRE( queues.getQueue( RenderQueues::Ui ) == Queue { u } );
+        REQUIRE( queues.takeRemoved().empty() );
+
+        // adding twice does nothing
+        queues.add( a );
+        REQUIRE( queues.getQueue( RenderQueues::Fancy ) == Queue { a, b, c } );
+
+        // the last object of the queue takes the place of a middle one
+        component->removeRenderObject( aIdx );
+        REQUIRE( queues.getQueue( RenderQueues::Fancy ) == Queue { c, b } );
+        component->removeRenderObject( bIdx );
+        REQUIRE( queues.getQueue( RenderQueues::Fancy ) == Queue { c } );
+        REQUIRE( queues.contains( c ) );
+        REQUIRE( queues.takeRemoved() == Queue { a, b } );
+        REQUIRE( queues.takeRemoved().empty() );
+
+        // removing the last object
+        component->removeRenderObject( cIdx );
+        REQUIRE( queues.getQueue( RenderQueues::Fancy ).empty() );
+        REQUIRE( !queues.contains( c ) );
+        REQUIRE( queues.takeRemoved() == Queue { c } );
+
+        // removing an object not in the queues is not recorded
+        queues.remove( c );
+        REQUIRE( queues.takeRemoved().empty() );
+    }
+
+    SECTION( "Type and xray changes" ) {
+        // xray objects go in the xray queue, whatever their type
+        a->setXRay( true );
+        REQUIRE( queues.getQueue( RenderQueues::Fancy ) == Queue { c, b } );
+        REQUIRE( queues.getQueue( RenderQueues::XRay ) == Queue { a } );
+        d->toggleXRay();
+        REQUIRE( queues.getQueue( RenderQueues::Debug ).empty() );
+        REQUIRE( queues.getQueue( RenderQueues::XRay ) == Queue { a, d } );
+        a->setType( RenderObjectType::Debug );
+        REQUIRE( queues.getQueue( RenderQueues::XRay ) == Queue { d, a } );
+        a->setXRay( false );
+        REQUIRE( queues.getQueue( RenderQueues::XRay ) == Queue { d } );
+        REQUIRE( queues.getQueue( RenderQueues::Debug ) == Queue { a } );
+
+        b->setType( RenderObjectType::UI );
+        REQUIRE( queues.getQueue( RenderQueues::Fancy ) == Queue { c } );
+        REQUIRE( queues.getQueue( RenderQueues::Ui ) == Queue { u, b } );
+
+        // moves are not removals
+        REQUIRE( queues.contains( a ) );
+        REQUIRE( queues.takeRemoved().empty() );
+    }
+
+    SECTION( "Lifetime" ) {
+        auto e = new RenderObject( "e", component, RenderObjectType::Geometry );
+        e->setLifetime( 2 );
+        component->addRenderObject( e );
+        REQUIRE( queues.getQueue( RenderQueues::Fancy ) == Queue { a, b, c, e } );
+
+        e->hasBeenRenderedOnce();
+        REQUIRE( queues.contains( e ) );
+        e->hasBeenRenderedOnce();
+        REQUIRE( queues.getQueue( RenderQueues::Fancy ) == Queue { a, b, c } );
+        REQUIRE( queues.takeRemoved() == Queue { e } );
+    }
+
+    addNotifier.detach( ia );
+    removeNotifier.detach( ir );
+    changeNotifier.detach( ic );
+
+    engine->cleanup();
+    Ra::Engine::RadiumEngine::destroyInstance();
+}
@@ -0,0 +1,202 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <Core/Animation/Pose.hpp>
+#include <Core/Animation/Skeleton.hpp>
+#include <Core/Asset/HandleData.hpp>
+#include <Core/Geometry/MeshPrimitives.hpp>
+#include <Core/Tasks/TaskQueue.hpp>
+
+#include <Engine/FrameInfo.hpp>
+#include <Engine/RadiumEngine.hpp>
+#include <Engine/Rendering/RenderObject.hpp>
+#include <Engine/Rendering/RenderObjectManager.hpp>
+#include <Engine/Scene/ComponentMessenger.hpp>
+#include <Engine/Scene/Entity.hpp>
+#include <Engine/Scene/EntityManager.hpp>
+#include <Engine/Scene/GeometryComponent.hpp>
+#include <Engine/Scene/SkeletonBasedAnimationSystem.hpp>
+#include <Engine/Scene/SkinningComponent.hpp>
+
+using namespace Ra::Core;
+using namespace Ra::Engine;
+using namespace Ra::Engine::Scene;
+using SpaceType = Animation::HandleArray::SpaceType;
+
+/// Gives the SkinningComponent of its entity a two bones skeleton, as a SkeletonComponent does.
+class SkeletonProvider : public Component
+{
+  public:
+    SkeletonProvider( const std::string& name, Entity* entity ) : Component( name, entity ) {
+        m_skeleton.addRoot( Transform::Identity(), "bone0" );
+        m_skeleton.addBone( 0, Transform::Identity(), SpaceType::LOCAL, "bone1" );
+        m_refPose = m_skeleton.getPose( SpaceType::MODEL );
+
+        auto cm = ComponentMessenger::getInstance();
+        cm->registerOutput<Animation::Skeleton>(
+            entity, this, name, [this]() { return &m_skeleton; } );
+        cm->registerOutput<Animation::Pose>( entity, this, name, [this]() { return &m_refPose; } );
+        cm->registerOutput<bool>( entity, this, name, [this]() { return &m_wasReset; } );
+    }
+    void initialize() override {}
+
+    Animation::Skeleton m_skeleton;
+    Animation::RefPose m_refPose;
+    bool m_wasReset { false };
+};
+
+struct SkinnedCharacter {
+    SurfaceMeshComponent<Geometry::TriangleMesh>* m_mesh;
+    SkeletonProvider* m_skeleton;
+    SkinningComponent* m_skinning;
+    Rendering::RenderObject* m_ro;
+};
+
+/// Creates an entity with a \p gridSize x \p gridSize plane in the z = 0 plane, whose vertices
+/// with x > 0 follow bone1 and the other ones bone0.
+static SkinnedCharacter createCharacter( RadiumEngine* engine,
+                                         const std::string& name,
+                                         uint gridSize ) {
+    auto entity = engine->getEntityManager()->createEntity( name );
+    auto mesh   = Geometry::makePlaneGrid( gridSize, gridSize );
+
+    Asset::HandleComponentData bone0, bone1;
+    bone0.m_name = "bone0";
+    bone1.m_name = "bone1";
+    std::vector<std::pair<uint, Scalar>> weights0, weights1;
+    for ( uint i = 0; i < mesh.vertices().size(); ++i ) {
+        if ( mesh.vertices()[i].x() > 0_ra ) { weights1.emplace_back( i, 1_ra ); }
+        else { weights0.emplace_back( i, 1_ra ); }
+    }
+    bone0.m_weights["mesh"]      = weights0;
+    bone1.m_weights["mesh"]      = weights1;
+    bone0.m_bindMatrices["mesh"] = Transform::Identity();
+    bone1.m_bindMatrices["mesh"] = Transform::Identity();
+    Asset::HandleData handleData( "skeleton", Asset::HandleData::SKELETON );
+    handleData.setComponents( { bone0, bone1 } );
+
+    SkinnedCharacter character;
+    character.m_mesh =
+        new SurfaceMeshComponent<Geometry::TriangleMesh>( "mesh", entity, std::move( mesh ) );
+    character.m_skeleton = new SkeletonProvider( "skeleton", entity );
+    character.m_skinning = new SkinningComponent( "skinning", SkinningComponent::LBS, entity );
+    character.m_skinning->handleSkinDataLoading( &handleData, "mesh" );
+    character.m_skinning->initialize();
+
+    const auto roIndex = ComponentMessenger::getInstance()->get<Utils::Index>( entity, "mesh" );
+    character.m_ro     = engine->getRenderObjectManager()->getRenderObject( roIndex ).get();
+    return character;
+}
+
+/// Moves bone1 by \p offset along z.
+static void moveBone( SkinnedCharacter& character, Scalar offset ) {
+    Transform T( Translation( Vector3( 0_ra, 0_ra, offset ) ) );
+    character.m_skeleton->m_skeleton.setTransform( 1, T, SpaceType::MODEL );
+}
+
+TEST_CASE( "Engine/Scene/SkinningComponent/Aabb", "[Engine][Engine/Scene][Skinning]" ) {
+    auto engine = RadiumEngine::createInstance();
+    engine->initialize();
+    {
+        auto character = createCharacter( engine, "character", 4 );
+
+        // the bounding boxes are cached at the bind pose.
+        REQUIRE( character.m_mesh->getCoreGeometry().computeAabb().max().z() == Approx( 0 ) );
+        REQUIRE( character.m_ro->computeAabb().max().z() == Approx( 0 ) );
+
+        // they follow the skinned pose.
+        moveBone( character, 2_ra );
+        character.m_skinning->skin();
+        character.m_skinning->endSkinning();
+        const auto aabb = character.m_mesh->getCoreGeometry().computeAabb();
+        REQUIRE( aabb.min().z() == Approx( 0 ) );
+        REQUIRE( aabb.max().z() == Approx( 2 ) );
+        REQUIRE( character.m_ro->computeAabb().max().z() == Approx( 2 ) );
+
+        moveBone( character, -1_ra );
+        character.m_skinning->skin();
+        character.m_skinning->endSkinning();
+        REQUIRE( character.m_mesh->getCoreGeometry().computeAabb().min().z() == Approx( -1 ) );
+        REQUIRE( character.m_ro->computeAabb().max().z() == Approx( 0 ) );
+    }
+    engine->cleanup();
+    RadiumEngine::destroyInstance();
+}
+
+TEST_CASE( "Engine/Scene/SkeletonBasedAnimationSystem/BatchedSkinning",
+           "[Engine][Engine/Scene][Skinning]" ) {
+    auto engine = RadiumEngine::createInstance();
+    engine->initialize();
+    {
+        // the same characters, skinned by one task per component or by work packets.
+        SkeletonBasedAnimationSystem perComponentSystem;
+        SkeletonBasedAnimationSystem batchedSystem;
+        batchedSystem.setBatchedSkinning( true );
+        REQUIRE( batchedSystem.isBatchedSkinning() );
+
+        const size_t numCharacters = 6;
+        const size_t hidden        = 2;
+        std::vector<SkinnedCharacter> perComponent, batched;
+        for ( size_t i = 0; i < numCharacters; ++i ) {
+            const std::string index = std::to_string( i );
+            perComponent.push_back( createCharacter( engine, "perComponent_" + index, 50 ) );
+            batched.push_back( createCharacter( engine, "batched_" + index, 50 ) );
+            moveBone( perComponent.back(), Scalar( i + 1 ) );
+            moveBone( batched.back(), Scalar( i + 1 ) );
+            perComponentSystem.addComponent( perComponent.back().m_skinning->getEntity(),
+                                             perComponent.back().m_skinning );
+            batchedSystem.addComponent( batched.back().m_skinning->getEntity(),
+                                        batched.back().m_skinning );
+        }
+        batched[hidden].m_ro->setVisible( false );
+        const auto bindPose      = batched[hidden].m_mesh->getCoreGeometry().vertices();
+        const size_t numVertices = bindPose.size();
+
+        TaskQueue taskQueue( 0 );
+        FrameInfo frameInfo;
+        perComponentSystem.generateTasks( &taskQueue, frameInfo );
+        taskQueue.runTasksInThisThread();
+        batchedSystem.generateTasks( &taskQueue, frameInfo );
+        taskQueue.runTasksInThisThread();
+
+        // visible meshes are skinned as by the per component tasks, the hidden one is skipped.
+        for ( size_t i = 0; i < numCharacters; ++i ) {
+            const auto& expected = perComponent[i].m_mesh->getCoreGeometry().vertices();
+            const auto& skinned  = batched[i].m_mesh->getCoreGeometry().vertices();
+            REQUIRE( skinned.size() == numVertices );
+            bool sameVertices = true;
+            for ( size_t v = 0; v < numVertices; ++v ) {
+                sameVertices &= skinned[v] == ( i == hidden ? bindPose[v] : expected[v] );
+            }
+            REQUIRE( sameVertices );
+        }
+
+        // the packets are filled with whole meshes up to s_packetVertexCount vertices.
+        const size_t meshesPerPacket =
+            ( SkeletonBasedAnimationSystem::s_packetVertexCount + numVertices - 1 ) / numVertices;
+        const size_t numPackets = ( numCharacters + meshesPerPacket - 1 ) / meshesPerPacket;
+        auto stats              = batchedSystem.getSkinningStatistics();
+        REQUIRE( stats.m_packetCount == numPackets );
+        REQUIRE( stats.m_packetTimes.size() == numPackets );
+        REQUIRE( stats.m_skinnedMeshes == numCharacters - 1 );
+        REQUIRE( stats.m_skippedMeshes == 1 );
+        REQUIRE( stats.m_skinnedVertices == ( numCharacters - 1 ) * numVertices );
+
+        // the hidden mesh is skinned once visible again, the other ones are up to date.
+        batched[hidden].m_ro->setVisible( true );
+        batchedSystem.generateTasks( &taskQueue, frameInfo );
+        taskQueue.runTasksInThisThread();
+        const auto& expected = perComponent[hidden].m_mesh->getCoreGeometry().vertices();
+        const auto& skinned  = batched[hidden].m_mesh->getCoreGeometry().vertices();
+        REQUIRE( std::equal( skinned.begin(), skinned.end(), expected.begin() ) );
+        stats = batchedSystem.getSkinningStatistics();
+        REQUIRE( stats.m_skinnedMeshes == 1 );
+        REQUIRE( stats.m_skippedMeshes == 0 );
+        REQUIRE( stats.m_skinnedVertices == numVertices );
+    }
+    engine->cleanup();
+    RadiumEngine::destroyInstance();
+}